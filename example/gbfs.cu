@@ -14,6 +14,7 @@
 
 #include "graphblas/graphblas.hpp"
 #include "graphblas/algorithm/bfs.hpp"
+#include "graphblas/algorithm/autotune.hpp"
 #include "test/test.hpp"
 
 bool debug_;
@@ -70,6 +71,9 @@ int main(int argc, char** argv) {
   CHECK(a.nvals(&nvals));
   if (debug) CHECK(a.print());
 
+  // Tuned settings for graph, if asked for with --autotune
+  graphblas::algorithm::autotune(&a, &desc);
+
   // Vector v
   graphblas::Vector<float> v(nrows);
 
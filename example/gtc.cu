@@ -0,0 +1,116 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <iostream>
+#include <algorithm>
+#include <string>
+
+#include <cstdio>
+#include <cstdlib>
+
+// #include <cuda_profiler_api.h>
+
+#include <boost/program_options.hpp>
+
+#include "graphblas/graphblas.hpp"
+#include "graphblas/algorithm/tc.hpp"
+#include "test/test.hpp"
+
+bool debug_;
+bool memory_;
+
+int main(int argc, char** argv) {
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+
+  // Parse arguments
+  bool debug;
+  bool mtxinfo;
+  int  niter;
+  char* dat_name;
+  po::variables_map vm;
+
+  // Read in sparse matrix
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s [matrix-market-filename]\n", argv[0]);
+    exit(1);
+  } else {
+    parseArgs(argc, argv, &vm);
+    debug      = vm["debug"    ].as<bool>();
+    mtxinfo    = vm["mtxinfo"  ].as<bool>();
+    niter      = vm["niter"    ].as<int>();
+
+    // Triangles are only defined on undirected graph
+    readMtx(argv[argc-1], &row_indices, &col_indices, &values, &nrows, &ncols,
+        &nvals, 2, mtxinfo, &dat_name);
+  }
+
+  // Descriptor desc
+  graphblas::Descriptor desc;
+  CHECK(desc.loadArgs(vm));
+
+  // Matrix A
+  graphblas::Matrix<float> a(nrows, ncols);
+  values.clear();
+  values.resize(nvals, 1.f);
+  CHECK(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      dat_name));
+  CHECK(a.nrows(&nrows));
+  CHECK(a.ncols(&ncols));
+  CHECK(a.nvals(&nvals));
+  if (debug) CHECK(a.print());
+
+  // Cpu triangle counting
+  CpuTimer tc_cpu;
+  tc_cpu.Start();
+  int64_t ntris_cpu = graphblas::algorithm::tcCpu(&a);
+  tc_cpu.Stop();
+
+  // Degree-ordered lower triangle, built once and shared by every run
+  CpuTimer relabel;
+  relabel.Start();
+  graphblas::Matrix<float> l(nrows, ncols);
+  CHECK(graphblas::algorithm::tcLower(&l, &a, &desc));
+  relabel.Stop();
+
+  // Warmup
+  CpuTimer warmup;
+  int64_t ntris = 0;
+  warmup.Start();
+  graphblas::algorithm::tc(&ntris, &l, &desc);
+  warmup.Stop();
+  BOOST_ASSERT( ntris == ntris_cpu );
+
+  // Benchmark both intersection on CPU and SpGEMM on GPU
+  graphblas::Desc_value backends[] = {graphblas::GrB_SEQUENTIAL,
+      graphblas::GrB_CUDA};
+  const char* names[] = {"cpu intersect", "gpu spgemm"};
+  for (int b = 0; b < 2; ++b) {
+    CHECK(desc.set(graphblas::GrB_BACKEND, backends[b]));
+    CpuTimer tc_timer;
+    // cudaProfilerStart();
+    tc_timer.Start();
+    float tight = 0.f;
+    for (int i = 0; i < niter; i++) {
+      tight += graphblas::algorithm::tc(&ntris, &l, &desc);
+      BOOST_ASSERT( ntris == ntris_cpu );
+    }
+    // cudaProfilerStop();
+    tc_timer.Stop();
+
+    if (niter) {
+      float elapsed = tc_timer.ElapsedMillis()/niter;
+      std::cout << names[b] << ", " << elapsed << ", "
+          << ntris/elapsed/1000.f << " Mtri/s\n";
+      std::cout << "tight, " << tight/niter << "\n";
+    }
+  }
+
+  std::cout << "triangles, " << ntris_cpu << "\n";
+  std::cout << "cpu, " << tc_cpu.ElapsedMillis() << ", \n";
+  std::cout << "relabel, " << relabel.ElapsedMillis() << "\n";
+  std::cout << "warmup, " << warmup.ElapsedMillis() << "\n";
+  return 0;
+}
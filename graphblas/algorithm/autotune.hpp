@@ -0,0 +1,115 @@
+#ifndef GRAPHBLAS_ALGORITHM_AUTOTUNE_HPP_
+#define GRAPHBLAS_ALGORITHM_AUTOTUNE_HPP_
+
+#include <string>
+#include <vector>
+
+#include "graphblas/algorithm/bfs.hpp"
+#include "graphblas/backend/cuda/util.hpp"
+
+namespace graphblas {
+namespace algorithm {
+
+// Total time of BFS from every source using settings in profile
+template <typename a>
+float autotuneRun(const TuneProfile&        profile,
+                  const Matrix<a>*          A,
+                  const std::vector<Index>& sources,
+                  Vector<float>*            v,
+                  Descriptor*               desc) {
+  CHECK(desc->descriptor_.setProfile(profile));
+
+  // First run is warmup, e.g. for memory pool and buffers
+  float time = 0.f;
+  bfs<float>(v, A, sources[0], desc);
+  for (size_t i = 0; i < sources.size(); ++i)
+    time += bfs<float>(v, A, sources[i], desc);
+  return time;
+}
+
+// Picks mxvmode, switchpoint and operand reuse for A by timing BFS from
+// nsample sources, one setting at a time in that order, and keeps the best
+// in desc. Settings are saved next to binary cache of graph
+// read last by readMtx, where Descriptor::loadArgs finds them on later runs.
+// Does nothing unless "autotune" is set, or if loadArgs found tuned settings
+// already and "autotune" is 1. memusage is saved as given, since it trades
+// memory and not time. Returns time spent tuning
+template <typename a>
+float autotune(const Matrix<a>* A,
+               Descriptor*      desc,
+               int              nsample = 4) {
+  backend::Descriptor& desc_t = desc->descriptor_;
+  if (desc_t.autotune() == 0 || (desc_t.autotune() == 1 && desc_t.tuned()))
+    return 0.f;
+
+  Index A_nrows;
+  CHECK(A->nrows(&A_nrows));
+
+  // Sources spread evenly over vertex ids
+  std::vector<Index> sources;
+  for (int i = 0; i < nsample && i < A_nrows; ++i)
+    sources.push_back(static_cast<int64_t>(i)*A_nrows/nsample);
+  if (sources.empty())
+    return 0.f;
+
+  // Timing and progress output of every run would only get in the way
+  int  timing  = desc_t.timing_;
+  bool verbose = desc_t.verbose_;
+  desc_t.timing_  = 0;
+  desc_t.verbose_ = false;
+
+  backend::GpuTimer gpu_tight;
+  gpu_tight.Start();
+
+  // Load-balance mode is not tuned, since merge is the only one vxm
+  // implements. Others leave output unwritten, so would look fastest
+  Vector<float> v(A_nrows);
+  TuneProfile best = desc_t.getProfile();
+  best.lbmode = backend::GrB_LOAD_BALANCE_MERGE;
+  float best_time = autotuneRun(best, A, sources, &v, desc);
+
+  // mxvmode and switchpoint
+  const int   mxvmodes[]     = {1, 2, 0, 0, 0, 0};
+  const float switchpoints[] = {0.01f, 0.01f, 0.001f, 0.01f, 0.05f, 0.1f};
+  TuneProfile trial = best;
+  for (int i = 0; i < 6; ++i) {
+    trial.mxvmode     = mxvmodes[i];
+    trial.switchpoint = switchpoints[i];
+    float time = autotuneRun(trial, A, sources, &v, desc);
+    if (time < best_time) {
+      best      = trial;
+      best_time = time;
+    }
+  }
+
+  trial = best;
+  trial.opreuse = !best.opreuse;
+  float time = autotuneRun(trial, A, sources, &v, desc);
+  if (time < best_time) {
+    best      = trial;
+    best_time = time;
+  }
+
+  CHECK(desc_t.setProfile(best));
+  desc_t.timing_  = timing;
+  desc_t.verbose_ = verbose;
+  gpu_tight.Stop();
+
+  // Only saved if A is the graph whose fingerprint it gets
+  const TuneGraph& graph = tuneGraph();
+  if (!graph.profile.empty() && graph.nrows == A_nrows) {
+    best.fingerprint = graph.fingerprint;
+    CHECK(best.save(graph.profile));
+  }
+
+  if (verbose)
+    std::cout << "autotune: mxvmode " << best.mxvmode << ", switchpoint "
+        << best.switchpoint << ", lbmode " << best.lbmode << ", opreuse "
+        << best.opreuse << " (" << best_time/sources.size() << " ms per BFS, "
+        << gpu_tight.ElapsedMillis() << " ms tuning)\n";
+  return gpu_tight.ElapsedMillis();
+}
+}  // namespace algorithm
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_ALGORITHM_AUTOTUNE_HPP_
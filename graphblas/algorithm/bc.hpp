@@ -0,0 +1,122 @@
+#ifndef GRAPHBLAS_ALGORITHM_BC_HPP_
+#define GRAPHBLAS_ALGORITHM_BC_HPP_
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "graphblas/algorithm/test_bc.hpp"
+#include "graphblas/backend/cuda/util.hpp"
+
+namespace graphblas {
+namespace algorithm {
+
+// Betweenness centrality from given sources, multiplied by scale, into v
+template <typename T, typename a>
+Info bcSources(Vector<T>*                v,
+               const Matrix<a>*          A,
+               const std::vector<Index>& sources,
+               T                         scale,
+               Descriptor*               desc) {
+  Index A_nrows;
+  CHECK(A->nrows(&A_nrows));
+
+  std::vector<T> h_bc(A_nrows);
+  CHECK(graphblas::bcBatch(h_bc.data(), sources.data(), sources.size(), A,
+      desc));
+  if (scale != static_cast<T>(1))
+    for (T& val : h_bc)
+      val *= scale;
+  CHECK(v->build(&h_bc, A_nrows));
+  return GrB_SUCCESS;
+}
+
+// Sources sampled without replacement from vertices of A
+inline std::vector<Index> bcSample(Index A_nrows,
+                                   Index nsamples,
+                                   int   seed) {
+  std::vector<Index> sources(A_nrows);
+  std::iota(sources.begin(), sources.end(), 0);
+  std::mt19937 gen(seed);
+  nsamples = std::min(nsamples, A_nrows);
+  for (Index i = 0; i < nsamples; ++i) {
+    std::uniform_int_distribution<Index> dist(i, A_nrows - 1);
+    std::swap(sources[i], sources[dist(gen)]);
+  }
+  sources.resize(nsamples);
+  return sources;
+}
+
+/*!
+ * \brief Exact betweenness centrality of every vertex of A
+ *
+ * Brandes from every vertex, batched into masked SpMM passes over A by
+ * bcBatch(). v[u] is number of shortest paths between other vertices s and t
+ * through u, each counted as 1/(number of shortest s-t paths). Every ordered
+ * pair is counted, so BC of undirected A is twice its usual value
+ * \param v output BC
+ * \param A graph, with edge i -> j as A(i, j)
+ * \param desc pointer to descriptor
+ */
+template <typename T, typename a>
+float bc(Vector<T>*       v,
+         const Matrix<a>* A,
+         Descriptor*      desc) {
+  Index A_nrows;
+  CHECK(A->nrows(&A_nrows));
+
+  std::vector<Index> sources(A_nrows);
+  std::iota(sources.begin(), sources.end(), 0);
+
+  backend::GpuTimer gpu_tight;
+  gpu_tight.Start();
+  CHECK(bcSources(v, A, sources, static_cast<T>(1), desc));
+  gpu_tight.Stop();
+
+  if (desc->descriptor_.timing_ > 0)
+    std::cout << "bc, " << gpu_tight.ElapsedMillis() << "\n";
+  return gpu_tight.ElapsedMillis();
+}
+
+/*!
+ * \brief Approximate betweenness centrality from nsamples random sources
+ *
+ * Dependencies of nsamples distinct sources, drawn by mt19937(seed), are
+ * scaled by A.nrows/nsamples, which is unbiased estimate of bc(). Cost is
+ * nsamples/A.nrows of that of bc()
+ */
+template <typename T, typename a>
+float bcApprox(Vector<T>*       v,
+               const Matrix<a>* A,
+               Index            nsamples,
+               int              seed,
+               Descriptor*      desc) {
+  Index A_nrows;
+  CHECK(A->nrows(&A_nrows));
+  std::vector<Index> sources = bcSample(A_nrows, nsamples, seed);
+  T scale = (sources.empty()) ? static_cast<T>(0) :
+      static_cast<T>(A_nrows)/static_cast<T>(sources.size());
+
+  backend::GpuTimer gpu_tight;
+  gpu_tight.Start();
+  CHECK(bcSources(v, A, sources, scale, desc));
+  gpu_tight.Stop();
+
+  if (desc->descriptor_.timing_ > 0)
+    std::cout << "bc approx, " << sources.size() << ", "
+        << gpu_tight.ElapsedMillis() << "\n";
+  return gpu_tight.ElapsedMillis();
+}
+
+template <typename T, typename a>
+void bcCpu(std::vector<T>*           h_bc_cpu,
+           Matrix<a>*                A,
+           const std::vector<Index>& sources) {
+  SimpleReferenceBc(A->matrix_.nrows_, A->matrix_.sparse_.h_csrRowPtr_,
+      A->matrix_.sparse_.h_csrColInd_, sources, h_bc_cpu);
+}
+}  // namespace algorithm
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_ALGORITHM_BC_HPP_
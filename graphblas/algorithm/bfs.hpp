@@ -10,40 +10,48 @@
 namespace graphblas {
 namespace algorithm {
 
-// Use float for now for both v and A
-float bfs(Vector<float>*       v,
-          const Matrix<float>* A,
-          Index                s,
-          Descriptor*          desc) {
+// Depth of each vertex reached from s is written to v, with s at depth 1 and
+// unreached vertices at 0. Frontiers only hold 0 or 1, so FrontierT can be a
+// narrow type (bool or uint8_t) and depths fit in e.g. uint32_t. Defaults keep
+// the original all-float behaviour for Vector<float> callers
+template <typename FrontierT = float, typename DepthT, typename a>
+float bfs(Vector<DepthT>*  v,
+          const Matrix<a>* A,
+          Index            s,
+          Descriptor*      desc) {
   Index A_nrows;
   CHECK(A->nrows(&A_nrows));
 
-  // Visited vector (use float for now)
-  CHECK(v->fill(0.f));
+  // Visited vector
+  CHECK(v->fill(static_cast<DepthT>(0)));
+  CHECK(v->setElement(static_cast<DepthT>(1), s));
 
-  // Frontier vectors (use float for now)
-  Vector<float> f1(A_nrows);
-  Vector<float> f2(A_nrows);
+  // Frontier vectors
+  PooledVector<FrontierT> f1_pool(desc->pool(), A_nrows);
+  PooledVector<FrontierT> f2_pool(desc->pool(), A_nrows);
+  Vector<FrontierT>& f1 = *f1_pool;
+  Vector<FrontierT>& f2 = *f2_pool;
 
   Desc_value desc_value;
   CHECK(desc->get(GrB_MXVMODE, &desc_value));
   if (desc_value == GrB_PULLONLY) {
-    CHECK(f1.fill(0.f));
-    CHECK(f1.setElement(1.f, s));
+    CHECK(f1.fill(static_cast<FrontierT>(0)));
+    CHECK(f1.setElement(static_cast<FrontierT>(1), s));
   } else {
-    std::vector<Index> indices(1, s);
-    std::vector<float>  values(1, 1.f);
+    std::vector<Index>     indices(1, s);
+    std::vector<FrontierT> values(1, static_cast<FrontierT>(1));
     CHECK(f1.build(&indices, &values, 1, GrB_NULL));
   }
 
-  float iter;
-  float succ = 0.f;
+  Index iter;
+  Index succ = 0;
   Index unvisited = A_nrows;
   backend::GpuTimer gpu_tight;
   float gpu_tight_time = 0.f;
   gpu_tight.Start();
 
-  for (iter = 1; iter <= desc->descriptor_.max_niter_; ++iter) {
+  // Source is at depth 1, so level iter discovers vertices at depth iter+1
+  for (iter = 1; iter < desc->descriptor_.max_niter_; ++iter) {
     if (desc->descriptor_.debug()) {
       std::cout << "=====BFS Iteration " << iter - 1 << "=====\n";
       v->print();
@@ -59,17 +67,13 @@ float bfs(Vector<float>*       v,
             << gpu_tight.ElapsedMillis() << "\n";
       gpu_tight_time += gpu_tight.ElapsedMillis();
     }
-    unvisited -= static_cast<int>(succ);
+    unvisited -= succ;
     gpu_tight.Start();
 
-    assign<float, float>(v, &f1, GrB_NULL, iter, GrB_ALL, A_nrows, desc);
-    CHECK(desc->toggle(GrB_MASK));
-    vxm<float, float, float, float>(&f2, v, GrB_NULL,
-        LogicalOrAndSemiring<float>(), &f1, A, desc);
-    CHECK(desc->toggle(GrB_MASK));
-
+    // Same as assign, masked vxm and reduce, but fused into one pass
+    CHECK(traverse(&f2, v, &succ, static_cast<DepthT>(iter+1), &f1, A,
+        desc));
     CHECK(f2.swap(&f1));
-    reduce<float, float>(&succ, GrB_NULL, PlusMonoid<float>(), &f1, desc);
 
     if (desc->descriptor_.debug())
       std::cout << "succ: " << succ << std::endl;
@@ -87,6 +91,64 @@ float bfs(Vector<float>*       v,
   return gpu_tight_time;
 }
 
+/*!
+ * \brief BFS tree from s: parent of each reached vertex is written to p
+ *
+ * s is its own parent and unreached vertices get -1. Each level is one fused
+ * traverseParent step, which gives each new vertex smallest frontier vertex
+ * with an edge to it as parent, in either direction
+ */
+template <typename FrontierT = float, typename a>
+float bfsParent(Vector<Index>*   p,
+                const Matrix<a>* A,
+                Index            s,
+                Descriptor*      desc) {
+  Index A_nrows;
+  CHECK(A->nrows(&A_nrows));
+
+  CHECK(p->fill(static_cast<Index>(-1)));
+  CHECK(p->setElement(s, s));
+
+  PooledVector<FrontierT> f1_pool(desc->pool(), A_nrows);
+  PooledVector<FrontierT> f2_pool(desc->pool(), A_nrows);
+  Vector<FrontierT>& f1 = *f1_pool;
+  Vector<FrontierT>& f2 = *f2_pool;
+
+  Desc_value desc_value;
+  CHECK(desc->get(GrB_MXVMODE, &desc_value));
+  if (desc_value == GrB_PULLONLY) {
+    CHECK(f1.fill(static_cast<FrontierT>(0)));
+    CHECK(f1.setElement(static_cast<FrontierT>(1), s));
+  } else {
+    std::vector<Index>     indices(1, s);
+    std::vector<FrontierT> values(1, static_cast<FrontierT>(1));
+    CHECK(f1.build(&indices, &values, 1, GrB_NULL));
+  }
+
+  Index iter;
+  Index succ = 0;
+  backend::GpuTimer gpu_tight;
+  gpu_tight.Start();
+  for (iter = 1; iter < desc->descriptor_.max_niter_; ++iter) {
+    if (desc->descriptor_.debug()) {
+      std::cout << "=====BFS Parent Iteration " << iter - 1 << "=====\n";
+      p->print();
+      f1.print();
+    }
+
+    CHECK(traverseParent(&f2, p, &succ, &f1, A, desc));
+    CHECK(f2.swap(&f1));
+    if (succ == 0)
+      break;
+  }
+  gpu_tight.Stop();
+
+  if (desc->descriptor_.timing_ == 1)
+    std::cout << "bfs parent, " << iter << ", " << gpu_tight.ElapsedMillis()
+        << "\n";
+  return gpu_tight.ElapsedMillis();
+}
+
 template <typename T, typename a>
 int bfsCpu(Index        source,
            Matrix<a>*   A,
@@ -107,6 +169,23 @@ int bfsCpu(Index        source,
 
   return max_depth;
 }
+
+// Checks BFS tree h_parent from source against CPU reference BFS
+template <typename a>
+int bfsVerifyTree(Index                     source,
+                  Matrix<a>*                A,
+                  const std::vector<Index>& h_parent,
+                  bool                      transpose = false) {
+  Index nrows = A->matrix_.nrows_;
+  std::vector<Index> h_depth(nrows);
+  bfsCpu(source, A, h_depth.data(), nrows + 1, transpose);
+
+  const backend::SparseMatrix<a>& A_sparse = A->matrix_.sparse_;
+  return SimpleVerifyBfsTree(nrows,
+      (transpose) ? A_sparse.h_cscColPtr_ : A_sparse.h_csrRowPtr_,
+      (transpose) ? A_sparse.h_cscRowInd_ : A_sparse.h_csrColInd_,
+      source, h_parent, h_depth.data());
+}
 }  // namespace algorithm
 }  // namespace graphblas
 
@@ -37,7 +37,8 @@ float bfsSimple(Vector<float>*       v,
         LogicalOrAndSemiring<float>(), &q1, A, desc);
     CHECK(desc->toggle(GrB_MASK));
     CHECK(q2.swap(&q1));
-    reduce<float, float>(&succ, GrB_NULL, PlusMonoid<float>(), &q1, desc);
+    reduce<float, float>(&succ, GrB_NULL, LogicalOrMonoid<float>(), &q1,
+        desc);
 
     iter++;
   } while (succ > 0);
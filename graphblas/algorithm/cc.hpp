@@ -0,0 +1,256 @@
+#ifndef GRAPHBLAS_ALGORITHM_CC_HPP_
+#define GRAPHBLAS_ALGORITHM_CC_HPP_
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "graphblas/algorithm/test_cc.hpp"
+#include "graphblas/backend/cuda/util.hpp"
+
+namespace graphblas {
+namespace algorithm {
+
+/*!
+ * \brief FastSV connected components on undirected A, starting from parent
+ * vector f
+ *
+ * Each iteration takes grandparents gp = f[f] and, through a min-second vxm,
+ * mngp(u) = min of gp over neighbours of u. Then:
+ *   1) stochastic hooking  f[f[u]] = min(f[f[u]], mngp[u])  (assign, accum)
+ *   2) aggressive hooking  f[u]    = min(f[u], mngp[u])     (eWiseAdd)
+ *   3) shortcutting        f[u]    = min(f[u], gp[u])       (eWiseAdd)
+ * until grandparents stop changing, when f[u] is smallest vertex of component
+ * of u. f must start as a forest whose trees lie inside components, e.g.
+ * identity, or labels of a subgraph
+ */
+template <typename a>
+Info ccFastSv(Vector<int>*     f,
+              const Matrix<a>* A,
+              Descriptor*      desc) {
+  Index A_nrows;
+  CHECK(A->nrows(&A_nrows));
+
+  Vector<int> gp(A_nrows);
+  Vector<int> gp_new(A_nrows);
+  Vector<int> mngp(A_nrows);
+  Vector<int> parent(A_nrows);
+
+  CHECK((extract<int, int, int>(&gp, GrB_NULL, GrB_NULL, f, f, desc)));
+
+  int iter = 0;
+  int diff = 0;
+  do {
+    if (desc->descriptor_.debug()) {
+      std::cout << "=====CC Iteration " << iter << "=====\n";
+      CHECK(f->print());
+      CHECK(gp.print());
+    }
+
+    CHECK((vxm<int, int, int, a>(&mngp, GrB_NULL, GrB_NULL,
+        MinimumSelectSecondSemiring<int>(), &gp, A, desc)));
+
+    // Scatter needs its indices apart from f, which it writes
+    CHECK(parent.dup(f));
+    CHECK((assign<int, int, int>(f, GrB_NULL, MinimumMonoid<int>(), &mngp,
+        &parent, desc)));
+    CHECK((eWiseAdd<int, int, int, int>(f, GrB_NULL, GrB_NULL,
+        MinimumPlusSemiring<int>(), f, &mngp, desc)));
+    CHECK((eWiseAdd<int, int, int, int>(f, GrB_NULL, GrB_NULL,
+        MinimumPlusSemiring<int>(), f, &gp, desc)));
+
+    CHECK((extract<int, int, int>(&gp_new, GrB_NULL, GrB_NULL, f, f, desc)));
+    CHECK((eWiseAddReduce<int, int, int>(&diff, GrB_NULL, PlusMonoid<int>(),
+        NotEqualToPlusSemiring<int>(), &gp_new, &gp, desc)));
+    CHECK(gp.swap(&gp_new));
+    iter++;
+  } while (diff > 0 && iter < desc->descriptor_.max_niter_);
+  return GrB_SUCCESS;
+}
+
+// Symmetric subgraph of undirected A that keeps first nsample edges of each
+// row, which in most graphs already links up most of largest component
+template <typename a>
+Info ccSample(Matrix<a>*       S,
+              const Matrix<a>* A,
+              int              nsample) {
+  backend::SparseMatrix<a>* A_sparse =
+      const_cast<backend::SparseMatrix<a>*>(&A->matrix_.sparse_);
+  CHECK(A_sparse->gpuToCpu());
+  Index        A_nrows = A_sparse->nrows_;
+  const Index* A_ptr   = A_sparse->h_csrRowPtr_;
+  const Index* A_ind   = A_sparse->h_csrColInd_;
+
+  std::vector<Index> S_ptr(A_nrows + 1, 0);
+  for (Index u = 0; u < A_nrows; ++u)
+    S_ptr[u + 1] = S_ptr[u] +
+        2*std::min<Index>(nsample, A_ptr[u+1] - A_ptr[u]);
+
+  // Each sampled edge goes in both directions, so S is undirected
+  Index S_nvals = S_ptr[A_nrows];
+  std::vector<Index> S_row(S_nvals), S_col(S_nvals);
+  std::vector<a> S_val(S_nvals, static_cast<a>(1));
+  threadPool().parallelFor(0, A_nrows, [&](Index begin, Index end) {
+    for (Index u = begin; u < end; ++u) {
+      Index dest = S_ptr[u];
+      for (Index edge = A_ptr[u]; dest < S_ptr[u+1]; ++edge) {
+        S_row[dest]   = u;
+        S_col[dest++] = A_ind[edge];
+        S_row[dest]   = A_ind[edge];
+        S_col[dest++] = u;
+      }
+    }
+  }, 4096);
+
+  CHECK(S->build(&S_row, &S_col, &S_val, S_nvals, GrB_NULL));
+  return GrB_SUCCESS;
+}
+
+// Most frequent of labels of 1024 random vertices, which is label of largest
+// component with high probability when that component is large
+inline int ccLargest(const std::vector<int>& h_cc) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<Index> dist(0, h_cc.size() - 1);
+  std::vector<int> samples(1024);
+  for (int& sample : samples)
+    sample = h_cc[dist(gen)];
+  std::sort(samples.begin(), samples.end());
+
+  int largest = samples[0];
+  int count   = 0;
+  for (size_t k = 0; k < samples.size();) {
+    size_t next = k;
+    while (next < samples.size() && samples[next] == samples[k])
+      next++;
+    if (static_cast<int>(next - k) > count) {
+      largest = samples[k];
+      count   = static_cast<int>(next - k);
+    }
+    k = next;
+  }
+  return largest;
+}
+
+// Edges of A except those with both ends labeled c, which cannot change any
+// label once every vertex labeled c is known to be in one component
+template <typename a>
+Info ccSkip(Matrix<a>*              T,
+            Index*                  T_nvals,
+            const Matrix<a>*        A,
+            const std::vector<int>& h_cc,
+            int                     c) {
+  backend::SparseMatrix<a>* A_sparse =
+      const_cast<backend::SparseMatrix<a>*>(&A->matrix_.sparse_);
+  CHECK(A_sparse->gpuToCpu());
+  Index        A_nrows = A_sparse->nrows_;
+  const Index* A_ptr   = A_sparse->h_csrRowPtr_;
+  const Index* A_ind   = A_sparse->h_csrColInd_;
+
+  std::vector<Index> T_ptr(A_nrows + 1, 0);
+  threadPool().parallelFor(0, A_nrows, [&](Index begin, Index end) {
+    for (Index u = begin; u < end; ++u) {
+      Index count = A_ptr[u+1] - A_ptr[u];
+      if (h_cc[u] == c) {
+        count = 0;
+        for (Index edge = A_ptr[u]; edge < A_ptr[u+1]; ++edge)
+          if (h_cc[A_ind[edge]] != c)
+            count++;
+      }
+      T_ptr[u + 1] = count;
+    }
+  }, 1024);
+  for (Index u = 0; u < A_nrows; ++u)
+    T_ptr[u + 1] += T_ptr[u];
+
+  *T_nvals = T_ptr[A_nrows];
+  std::vector<Index> T_row(*T_nvals), T_col(*T_nvals);
+  std::vector<a> T_val(*T_nvals, static_cast<a>(1));
+  threadPool().parallelFor(0, A_nrows, [&](Index begin, Index end) {
+    for (Index u = begin; u < end; ++u) {
+      Index dest = T_ptr[u];
+      for (Index edge = A_ptr[u]; edge < A_ptr[u+1]; ++edge) {
+        Index v = A_ind[edge];
+        if (h_cc[u] != c || h_cc[v] != c) {
+          T_row[dest]   = u;
+          T_col[dest++] = v;
+        }
+      }
+    }
+  }, 1024);
+
+  if (*T_nvals > 0)
+    CHECK(T->build(&T_row, &T_col, &T_val, *T_nvals, GrB_NULL));
+  return GrB_SUCCESS;
+}
+
+/*!
+ * \brief Connected components of undirected A
+ *
+ * v[u] comes out as smallest vertex in component of u. With nsample > 0,
+ * Afforest-style sampling runs FastSV first on subgraph of nsample edges per
+ * vertex, which usually finds most of largest component c cheaply. Edges
+ * inside c are then dropped, and FastSV finishes from those labels on what is
+ * left, so that most edges of graph are never read by vxm. Edges that leave
+ * c are kept, so rest of graph can still join c. nsample = 0 runs FastSV on A
+ * \param v output labels
+ * \param A undirected graph, which must have every edge in both directions
+ * \param nsample number of edges per vertex sampled before full graph
+ * \param desc pointer to descriptor
+ */
+template <typename a>
+float cc(Vector<int>*     v,
+         const Matrix<a>* A,
+         int              nsample,
+         Descriptor*      desc) {
+  Index A_nrows;
+  CHECK(A->nrows(&A_nrows));
+
+  // Min-second relies on pull order mul_op(A(i,j), gp(i)), while push kernels
+  // multiply the other way around
+  Descriptor desc_t(*desc);
+  CHECK(desc_t.set(GrB_MXVMODE, GrB_PULLONLY));
+
+  backend::GpuTimer gpu_tight;
+  gpu_tight.Start();
+  CHECK(v->fillAscending(A_nrows));
+  if (nsample > 0 && A_nrows > 0) {
+    Matrix<a> S(A_nrows, A_nrows);
+    CHECK(ccSample(&S, A, nsample));
+    Index S_nvals;
+    CHECK(S.nvals(&S_nvals));
+    if (S_nvals > 0)
+      CHECK(ccFastSv(v, &S, &desc_t));
+
+    std::vector<int> h_cc;
+    Index nvals = A_nrows;
+    CHECK(v->extractTuples(&h_cc, &nvals));
+    int c = ccLargest(h_cc);
+
+    Matrix<a> T(A_nrows, A_nrows);
+    Index T_nvals;
+    CHECK(ccSkip(&T, &T_nvals, A, h_cc, c));
+    if (desc->descriptor_.debug())
+      std::cout << "cc skips component " << c << ", " << T_nvals
+          << " edges left\n";
+    if (T_nvals > 0)
+      CHECK(ccFastSv(v, &T, &desc_t));
+  } else {
+    CHECK(ccFastSv(v, A, &desc_t));
+  }
+  gpu_tight.Stop();
+
+  if (desc->descriptor_.timing_ > 0)
+    std::cout << "cc, " << gpu_tight.ElapsedMillis() << "\n";
+  return gpu_tight.ElapsedMillis();
+}
+
+template <typename a>
+void ccCpu(std::vector<int>* h_cc_cpu,
+           Matrix<a>*        A) {
+  SimpleReferenceCc(A->matrix_.nrows_, A->matrix_.sparse_.h_csrRowPtr_,
+      A->matrix_.sparse_.h_csrColInd_, h_cc_cpu);
+}
+}  // namespace algorithm
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_ALGORITHM_CC_HPP_
@@ -3,74 +3,54 @@
 
 #include <vector>
 #include <utility>
+#include <algorithm>
 
-#include "graphblas/algorithm/test_bfs.hpp"
+#include "graphblas/algorithm/bfs.hpp"
+#include "graphblas/algorithm/msbfs.hpp"
 #include "graphblas/backend/cuda/util.hpp"
 
 namespace graphblas {
 namespace algorithm {
 
-// Use float for now for both v and A
-std::pair<int, int> diameter(Vector<float>*       v,
-             const Matrix<float>* A,
-             Index                s_start,
-             Index                s_end,
-             Descriptor*          desc) {
+// Largest eccentricity over sources [s_start, s_end), and last source that
+// has it. Eccentricities come from msbfs(), which runs 64 sources per pass
+// over A instead of one BFS per source. v gets depths from s_end - 1, same as
+// bfs() from it
+template <typename DepthT, typename a>
+std::pair<int, int> diameter(Vector<DepthT>*  v,
+                             const Matrix<a>* A,
+                             Index            s_start,
+                             Index            s_end,
+                             Descriptor*      desc) {
   Index A_nrows;
   A->nrows(&A_nrows);
 
-  // Frontier vectors (use float for now)
-  Vector<float> q1(A_nrows);
-  Vector<float> q2(A_nrows);
-
   int diameter_max = 0;
   int diameter_ind = -1;
-
-  for (int s = s_start; s < s_end; ++s) {
-    v->fill(0.f);
-
-    std::vector<Index> indices(1, s);
-    std::vector<float>  values(1, 1.f);
-    q1.build(&indices, &values, 1, GrB_NULL);
-
-    int iter = 1;
-    float succ = 0.f;
-    do {
-      assign<float, float>(v, &q1, GrB_NULL, iter, GrB_ALL, A_nrows, desc);
-      desc->toggle(GrB_MASK);
-      vxm<float, float, float, float>(&q2, v, GrB_NULL,
-          LogicalOrAndSemiring<float>(), &q1, A, desc);
-      desc->toggle(GrB_MASK);
-      q2.swap(&q1);
-      reduce<float, float>(&succ, GrB_NULL, PlusMonoid<float>(), &q1, desc);
-      iter++;
-    } while (succ > 0);
-    diameter_max = std::max(diameter_max, iter - 2);
-    diameter_ind = (iter - 2 == diameter_max) ? s : diameter_ind;
+  if (s_end <= s_start)
+    return std::make_pair(diameter_max, diameter_ind);
+
+  Index nsources = s_end - s_start;
+  std::vector<Index> sources(nsources);
+  for (Index i = 0; i < nsources; ++i)
+    sources[i] = s_start + i;
+
+  // Depths are only kept for s_end - 1, which gets a pass of its own
+  Index nhead = nsources - 1;
+  std::vector<Index>  ecc(nsources);
+  std::vector<DepthT> last(A_nrows);
+  graphblas::msbfs(static_cast<DepthT*>(NULL), ecc.data(), sources.data(),
+      nhead, A, desc);
+  graphblas::msbfs(last.data(), ecc.data() + nhead, sources.data() + nhead,
+      1, A, desc);
+  v->build(&last, A_nrows);
+
+  for (Index i = 0; i < nsources; ++i) {
+    diameter_max = std::max(diameter_max, static_cast<int>(ecc[i]));
+    diameter_ind = (ecc[i] == diameter_max) ? s_start + i : diameter_ind;
   }
   return std::make_pair(diameter_max, diameter_ind);
 }
-
-template <typename T, typename a>
-int bfsCpu(Index        source,
-           Matrix<a>*   A,
-           T*           h_bfs_cpu,
-           Index        depth,
-           bool         transpose = false) {
-  Index* reference_check_preds = NULL;
-  int max_depth;
-
-  if (transpose)
-    max_depth = SimpleReferenceBfs<T>(A->matrix_.nrows_,
-        A->matrix_.sparse_.h_cscColPtr_, A->matrix_.sparse_.h_cscRowInd_,
-        h_bfs_cpu, reference_check_preds, source, depth);
-  else
-    max_depth = SimpleReferenceBfs<T>(A->matrix_.nrows_,
-        A->matrix_.sparse_.h_csrRowPtr_, A->matrix_.sparse_.h_csrColInd_,
-        h_bfs_cpu, reference_check_preds, source, depth);
-
-  return max_depth;
-}
 }  // namespace algorithm
 }  // namespace graphblas
 
@@ -292,9 +292,6 @@ float gcJP(Vector<int>*       v,
   Vector<int> ascending(max_colors);
   CHECK(ascending.fillAscending(max_colors));
 
-  // Array for finding smallest color (min_array)
-  Vector<int> min_array(max_colors);
-
   // Set seed
   setEnv("GRB_SEED", seed);
 
@@ -365,16 +362,13 @@ float gcJP(Vector<int>*       v,
     scatter<int, int, int, int>(&d, GrB_NULL, &n, static_cast<int>(max_colors),
         desc);
 
-    // TODO(@ctcyang): this eWiseMult and reduce could be changed into single
-    // reduce with argmin Monoid
-    // map boolean bit array to element id
-    eWiseMult<int, int, int, int>(&min_array, GrB_NULL, GrB_NULL,
-        MinimumPlusSemiring<int>(), &d, &ascending, desc);
-    CHECK(min_array.setElement(max_colors, 0));
+    // color 0 means uncolored, so it must never be picked
+    CHECK(d.setElement(max_colors, 0));
 
-    // compute min color
-    reduce<int, int>(&min_color, GrB_NULL, MinimumMonoid<int>(),
-        &min_array, desc);
+    // compute min color i.e. argmin of d(i) + i, where d(i) is 0 for colors
+    // not used by any neighbor
+    eWiseMultReduce<int, int, int>(&min_color, GrB_NULL,
+        MinimumPlusSemiring<int>(), &d, &ascending, desc);
 
     // assign new color
     assign<int, int>(v, &f, GrB_NULL, min_color, GrB_ALL, A_nrows, desc);
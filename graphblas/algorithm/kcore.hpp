@@ -0,0 +1,115 @@
+#ifndef GRAPHBLAS_ALGORITHM_KCORE_HPP_
+#define GRAPHBLAS_ALGORITHM_KCORE_HPP_
+
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "graphblas/algorithm/test_kcore.hpp"
+#include "graphblas/backend/cuda/util.hpp"
+
+namespace graphblas {
+namespace algorithm {
+
+/*!
+ * \brief Core number of each vertex of A is written to v
+ *
+ * Parallel peeling: all vertices of degree <= k are removed at once, with
+ * core number k, and degrees of their neighbours are lowered by one vxm and
+ * eWiseAdd, until no vertex of degree <= k is left. k then jumps to
+ * smallest degree left, so empty buckets are skipped. Removed vertices are
+ * reset to largest value of T after every round, so they stay above any k,
+ * and peeling ends once smallest degree left is that sentinel. A must be
+ * undirected without self-loops, with 1 for each edge, as read for tc
+ * \param v output core numbers
+ * \param A graph, with edge i -> j as A(i, j)
+ * \param desc pointer to descriptor
+ */
+template <typename MaskT = float, typename T, typename a>
+float kcore(Vector<T>*       v,
+            const Matrix<a>* A,
+            Descriptor*      desc) {
+  Index A_nrows;
+  CHECK(A->nrows(&A_nrows));
+  const T removed = std::numeric_limits<T>::max();
+
+  PooledVector<T>     d_pool(desc->pool(), A_nrows);
+  PooledVector<T>     p_pool(desc->pool(), A_nrows);
+  PooledVector<T>     r_pool(desc->pool(), A_nrows);
+  PooledVector<T>     b_pool(desc->pool(), A_nrows);
+  PooledVector<MaskT> m_pool(desc->pool(), A_nrows);
+  PooledVector<MaskT> g_pool(desc->pool(), A_nrows);
+  Vector<T>&     d = *d_pool;
+  Vector<T>&     p = *p_pool;
+  Vector<T>&     r = *r_pool;
+  Vector<T>&     b = *b_pool;
+  Vector<MaskT>& m = *m_pool;
+  Vector<MaskT>& g = *g_pool;
+
+  backend::GpuTimer gpu_tight;
+  gpu_tight.Start();
+
+  CHECK((reduce<T, T, a>(&d, GrB_NULL, GrB_NULL, PlusMonoid<T>(), A,
+      desc)));
+  CHECK(v->fill(static_cast<T>(0)));
+  CHECK(g.fill(static_cast<MaskT>(0)));
+
+  T     k = static_cast<T>(0);
+  int   iter = 0;
+  Index nbucket = 0;
+  while (true) {
+    // Vertices left with degree <= k, i.e. d < k+1
+    CHECK(b.fill(k + static_cast<T>(1)));
+    CHECK((eWiseAdd<MaskT, T, T, T>(&m, GrB_NULL, GrB_NULL,
+        CustomLessPlusSemiring<T>(), &d, &b, desc)));
+    Index npeel = 0;
+    CHECK((reduce<Index, MaskT>(&npeel, GrB_NULL, PlusMonoid<Index>(), &m,
+        desc)));
+
+    if (npeel == 0) {
+      T k_next = removed;
+      CHECK((reduce<T, T>(&k_next, GrB_NULL, MinimumMonoid<T>(), &d, desc)));
+      if (k_next == removed)
+        break;
+      k = k_next;
+      nbucket++;
+      continue;
+    }
+    if (desc->descriptor_.debug())
+      std::cout << "=====k-core Iteration " << iter << ": k = " << k << ", "
+          << npeel << " peeled=====\n";
+    iter++;
+
+    // d -= number of peeled neighbours, then all removed so far are reset
+    // to sentinel, since they were lowered too
+    CHECK((assign<T, MaskT>(v, &m, GrB_NULL, k, GrB_ALL, A_nrows, desc)));
+    CHECK(p.fill(static_cast<T>(0)));
+    CHECK((assign<T, MaskT>(&p, &m, GrB_NULL, static_cast<T>(-1), GrB_ALL,
+        A_nrows, desc)));
+    CHECK((vxm<T, T, T, a>(&r, GrB_NULL, GrB_NULL,
+        PlusMultipliesSemiring<T>(), &p, A, desc)));
+    CHECK((eWiseAdd<T, T, T, T>(&d, GrB_NULL, GrB_NULL,
+        PlusMultipliesSemiring<T>(), &d, &r, desc)));
+    CHECK((assign<MaskT, MaskT>(&g, &m, GrB_NULL, static_cast<MaskT>(1),
+        GrB_ALL, A_nrows, desc)));
+    CHECK((assign<T, MaskT>(&d, &g, GrB_NULL, removed, GrB_ALL, A_nrows,
+        desc)));
+  }
+  gpu_tight.Stop();
+
+  if (desc->descriptor_.timing_ > 0)
+    std::cout << "kcore, " << k << ", " << nbucket << ", " << iter << ", "
+        << gpu_tight.ElapsedMillis() << "\n";
+  return gpu_tight.ElapsedMillis();
+}
+
+template <typename T, typename a>
+void kcoreCpu(std::vector<T>* h_core_cpu,
+              Matrix<a>*      A) {
+  SimpleReferenceKcore(A->matrix_.nrows_, A->matrix_.sparse_.h_csrRowPtr_,
+      A->matrix_.sparse_.h_csrColInd_, h_core_cpu);
+}
+}  // namespace algorithm
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_ALGORITHM_KCORE_HPP_
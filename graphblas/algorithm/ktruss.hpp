@@ -0,0 +1,86 @@
+#ifndef GRAPHBLAS_ALGORITHM_KTRUSS_HPP_
+#define GRAPHBLAS_ALGORITHM_KTRUSS_HPP_
+
+#include <iostream>
+#include <vector>
+
+#include "graphblas/algorithm/test_ktruss.hpp"
+#include "graphblas/backend/cuda/util.hpp"
+
+namespace graphblas {
+namespace algorithm {
+
+/*!
+ * \brief k-truss of A, i.e. largest subgraph in which every edge is in at
+ * least k-2 triangles, is written to C
+ *
+ * Support of every edge is masked SpGEMM C .* (C plus.pair C), which only
+ * forms entries of C and leaves out those in no triangle. Edges with support
+ * below k-2 are then dropped in place by select, and this repeats until
+ * select drops nothing. pair ignores values, so support left in C from one
+ * round does not skew the next, and C comes out holding support of each edge
+ * within k-truss. A must be undirected without self-loops, as read for tc
+ * \param C output k-truss, with support as values
+ * \param A graph, with edge i -> j as A(i, j)
+ * \param k at least 3, since 2-truss is A itself
+ * \param desc pointer to descriptor
+ */
+template <typename T, typename a>
+float ktruss(Matrix<T>*       C,
+             const Matrix<a>* A,
+             Index            k,
+             Descriptor*      desc) {
+  Index A_nrows;
+  CHECK(A->nrows(&A_nrows));
+  if (k < 3) {
+    std::cout << "Error: ktruss needs k >= 3!\n";
+    return 0.f;
+  }
+  const T thunk = static_cast<T>(k - 2);
+
+  backend::GpuTimer gpu_tight;
+  gpu_tight.Start();
+
+  CHECK((mxm<T, a, a, a>(C, A, GrB_NULL, PlusPairSemiring<a, a, T>(), A, A,
+      desc)));
+  CHECK((select<T, T, T>(C, GrB_NULL, GrB_NULL, greater_equal<T>(), C, thunk,
+      desc)));
+  Index C_nvals;
+  CHECK(C->nvals(&C_nvals));
+
+  Matrix<T> S(A_nrows, A_nrows);
+  Index S_nvals;
+  int   iter;
+  for (iter = 1; C_nvals > 0; ++iter) {
+    if (desc->descriptor_.debug())
+      std::cout << "=====k-truss Iteration " << iter << ": " << C_nvals
+          << " edges=====\n";
+    CHECK((mxm<T, T, T, T>(&S, C, GrB_NULL, PlusPairSemiring<T>(), C, C,
+        desc)));
+    CHECK((select<T, T, T>(&S, GrB_NULL, GrB_NULL, greater_equal<T>(), &S,
+        thunk, desc)));
+    CHECK(S.nvals(&S_nvals));
+    CHECK(C->swap(&S));
+    if (S_nvals == C_nvals)
+      break;
+    C_nvals = S_nvals;
+  }
+  gpu_tight.Stop();
+
+  if (desc->descriptor_.timing_ > 0)
+    std::cout << "ktruss, " << k << ", " << C_nvals << ", " << iter << ", "
+        << gpu_tight.ElapsedMillis() << "\n";
+  return gpu_tight.ElapsedMillis();
+}
+
+template <typename a>
+void ktrussCpu(std::vector<Index>* h_support_cpu,
+               Matrix<a>*          A,
+               Index               k) {
+  SimpleReferenceKtruss(A->matrix_.nrows_, A->matrix_.sparse_.h_csrRowPtr_,
+      A->matrix_.sparse_.h_csrColInd_, k, h_support_cpu);
+}
+}  // namespace algorithm
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_ALGORITHM_KTRUSS_HPP_
@@ -21,7 +21,8 @@ float lgc(Vector<float>*       p,      // PageRank result
   CHECK(A->nrows(&A_nrows));
 
   // degrees: compute the degree of each node
-  Vector<float> degrees(A_nrows);
+  PooledVector<float> degrees_pool(desc->pool(), A_nrows);
+  Vector<float>& degrees = *degrees_pool;
   reduce<float, float, float>(&degrees, GrB_NULL, GrB_NULL,
       PlusMonoid<float>(), A, desc);
 
@@ -29,12 +30,14 @@ float lgc(Vector<float>*       p,      // PageRank result
   CHECK(p->fill(0.f));
 
   // residual (r): initialized to 0 except source to 1
-  Vector<float> r(A_nrows);
+  PooledVector<float> r_pool(desc->pool(), A_nrows);
+  Vector<float>& r = *r_pool;
   std::vector<Index> indices(1, s);
   std::vector<float> values(1, 1.f);
 
   // residual2 (r2)
-  Vector<float> r2(A_nrows);
+  PooledVector<float> r2_pool(desc->pool(), A_nrows);
+  Vector<float>& r2 = *r2_pool;
   CHECK(r2.fill(0.f));
 
   Desc_value desc_value;
@@ -47,21 +50,26 @@ float lgc(Vector<float>*       p,      // PageRank result
   }
 
   // degrees_eps (d x eps): precompute degree of each node times eps
-  Vector<float> eps_vector(A_nrows);
-  Vector<float> degrees_eps(A_nrows);
+  PooledVector<float> eps_vector_pool(desc->pool(), A_nrows);
+  PooledVector<float> degrees_eps_pool(desc->pool(), A_nrows);
+  Vector<float>& eps_vector  = *eps_vector_pool;
+  Vector<float>& degrees_eps = *degrees_eps_pool;
   CHECK(eps_vector.fill(eps));
   eWiseMult<float, float, float, float>(&degrees_eps, GrB_NULL, GrB_NULL,
       PlusMultipliesSemiring<float>(), &degrees, &eps_vector, desc);
 
   // frontier (f): portion of r(v) >= degrees(v) x eps
   // (use float for now)
-  Vector<float> f(A_nrows);
+  PooledVector<float> f_pool(desc->pool(), A_nrows);
+  Vector<float>& f = *f_pool;
   CHECK(f.build(&indices, &values, 1, GrB_NULL));
 
   // alpha: TODO(@ctcyang): introduce vector-constant eWiseMult
-  Vector<float> alpha_vector(A_nrows);
+  PooledVector<float> alpha_vector_pool(desc->pool(), A_nrows);
+  Vector<float>& alpha_vector = *alpha_vector_pool;
   CHECK(alpha_vector.fill(alpha));
-  Vector<float> alpha_vector2(A_nrows);
+  PooledVector<float> alpha_vector2_pool(desc->pool(), A_nrows);
+  Vector<float>& alpha_vector2 = *alpha_vector2_pool;
   CHECK(alpha_vector2.fill((1.-alpha)/2.));
 
   Index nvals;
@@ -0,0 +1,44 @@
+#ifndef GRAPHBLAS_ALGORITHM_MSBFS_HPP_
+#define GRAPHBLAS_ALGORITHM_MSBFS_HPP_
+
+#include <vector>
+
+#include "graphblas/backend/cuda/util.hpp"
+
+namespace graphblas {
+namespace algorithm {
+
+// BFS from every vertex in sources, advancing 64 of them per pass over A.
+// Depths from sources[i] are written to (*depths)[i*A.nrows, (i+1)*A.nrows),
+// with the source at depth 1 and unreached vertices at 0, like bfs(), and
+// eccentricities to (*ecc)[i]. depths may be NULL, since it holds
+// sources.size()*A.nrows elements
+template <typename DepthT, typename a>
+float msbfs(std::vector<DepthT>*      depths,
+            std::vector<Index>*       ecc,
+            const Matrix<a>*          A,
+            const std::vector<Index>& sources,
+            Descriptor*               desc) {
+  Index A_nrows;
+  CHECK(A->nrows(&A_nrows));
+  Index nsources = sources.size();
+
+  ecc->resize(nsources);
+  if (depths != NULL)
+    depths->resize(static_cast<size_t>(nsources)*A_nrows);
+
+  backend::GpuTimer gpu_tight;
+  gpu_tight.Start();
+  CHECK(graphblas::msbfs((depths == NULL) ? NULL : depths->data(),
+      ecc->data(), sources.data(), nsources, A, desc));
+  gpu_tight.Stop();
+
+  if (desc->descriptor_.timing_ == 1)
+    std::cout << "msbfs, " << nsources << ", " << gpu_tight.ElapsedMillis()
+        << "\n";
+  return gpu_tight.ElapsedMillis();
+}
+}  // namespace algorithm
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_ALGORITHM_MSBFS_HPP_
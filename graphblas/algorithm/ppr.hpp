@@ -0,0 +1,83 @@
+#ifndef GRAPHBLAS_ALGORITHM_PPR_HPP_
+#define GRAPHBLAS_ALGORITHM_PPR_HPP_
+
+#include <string>
+#include <vector>
+
+#include "graphblas/algorithm/test_ppr.hpp"
+#include "graphblas/backend/cuda/util.hpp"
+
+namespace graphblas {
+namespace algorithm {
+
+// Personalized PageRank of every seed, with A scaled same as for pr(). Seeds
+// are iterated together, so each pass over A serves up to 32 of them. Column
+// i of P (A.nrows x seeds.size()) gets result of seeds[i]
+template <typename T, typename a>
+float pprBatch(Matrix<T>*                P,
+               const Matrix<a>*          A,
+               const std::vector<Index>& seeds,
+               T                         alpha,
+               T                         eps,
+               Descriptor*               desc) {
+  backend::GpuTimer gpu_tight;
+  gpu_tight.Start();
+  CHECK(graphblas::pprBatch(P, static_cast<Index*>(NULL),
+      static_cast<T*>(NULL), 0, seeds.data(), seeds.size(), alpha, eps, A,
+      desc));
+  gpu_tight.Stop();
+
+  if (desc->descriptor_.timing_ == 1)
+    std::cout << "ppr, " << seeds.size() << ", " << gpu_tight.ElapsedMillis()
+        << "\n";
+  return gpu_tight.ElapsedMillis();
+}
+
+// Same as above, but only keeps k largest entries of every seed, so memory
+// does not grow with A.nrows x seeds.size(). Entries of seeds[i] are at
+// [i*k, (i+1)*k) of ind and val, largest first
+template <typename T, typename a>
+float pprBatchTopK(std::vector<Index>*       ind,
+                   std::vector<T>*           val,
+                   Index                     k,
+                   const Matrix<a>*          A,
+                   const std::vector<Index>& seeds,
+                   T                         alpha,
+                   T                         eps,
+                   Descriptor*               desc) {
+  ind->resize(seeds.size()*k);
+  val->resize(seeds.size()*k);
+
+  backend::GpuTimer gpu_tight;
+  gpu_tight.Start();
+  CHECK(graphblas::pprBatch(static_cast<Matrix<T>*>(NULL), ind->data(),
+      val->data(), k, seeds.data(), seeds.size(), alpha, eps, A, desc));
+  gpu_tight.Stop();
+
+  if (desc->descriptor_.timing_ == 1)
+    std::cout << "ppr top-" << k << ", " << seeds.size() << ", "
+        << gpu_tight.ElapsedMillis() << "\n";
+  return gpu_tight.ElapsedMillis();
+}
+
+template <typename T, typename a>
+int pprCpu(T*         h_ppr_cpu,
+           Matrix<a>* A,
+           Index      seed,
+           float      alpha,
+           float      eps,
+           int        max_niter,
+           bool       transpose = false) {
+  if (transpose)
+    return SimpleReferencePpr<T>(A->matrix_.nrows_,
+        A->matrix_.sparse_.h_cscColPtr_, A->matrix_.sparse_.h_cscRowInd_,
+        A->matrix_.sparse_.h_cscVal_, h_ppr_cpu, seed, alpha, eps, max_niter);
+  else
+    return SimpleReferencePpr<T>(A->matrix_.nrows_,
+        A->matrix_.sparse_.h_csrRowPtr_, A->matrix_.sparse_.h_csrColInd_,
+        A->matrix_.sparse_.h_csrVal_, h_ppr_cpu, seed, alpha, eps, max_niter);
+}
+}  // namespace algorithm
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_ALGORITHM_PPR_HPP_
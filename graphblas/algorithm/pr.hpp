@@ -26,17 +26,12 @@ float pr(Vector<float>*       p,
   CHECK(p->fill(1.f/A_nrows));
 
   // Previous pagerank vector (p_prev)
-  Vector<float> p_prev(A_nrows);
+  PooledVector<float> p_prev_pool(desc->pool(), A_nrows);
+  Vector<float>& p_prev = *p_prev_pool;
 
   // Temporary pagerank (p_temp)
-  Vector<float> p_swap(A_nrows);
-
-  // Residual vector (r)
-  Vector<float> r(A_nrows);
-  r.fill(1.f);
-
-  // Temporary residual (r_temp)
-  Vector<float> r_temp(A_nrows);
+  PooledVector<float> p_swap_pool(desc->pool(), A_nrows);
+  Vector<float>& p_swap = *p_swap_pool;
 
   int iter;
   float error_last = 0.f;
@@ -63,7 +58,9 @@ float pr(Vector<float>*       p,
     unvisited -= static_cast<int>(error);
     gpu_tight.Start();
     error_last = error;
-    p_prev = *p;
+    // p_prev takes over memory of p rather than copying it, since p is
+    // overwritten below
+    CHECK(p_prev.swap(p));
 
     // p = A*p + (1-alpha)*1
     vxm<float, float, float, float>(&p_swap, GrB_NULL, GrB_NULL,
@@ -71,12 +68,9 @@ float pr(Vector<float>*       p,
     eWiseAdd<float, float, float, float>(p, GrB_NULL, GrB_NULL,
         PlusMultipliesSemiring<float>(), &p_swap, (1.f-alpha)/A_nrows, desc);
 
-    // error = l2loss(p, p_prev)
-    eWiseMult<float, float, float, float>(&r, GrB_NULL, GrB_NULL,
-        PlusMinusSemiring<float>(), p, &p_prev, desc);
-    eWiseAdd<float, float, float, float>(&r_temp, GrB_NULL, GrB_NULL,
-        MultipliesMultipliesSemiring<float>(), &r, &r, desc);
-    reduce<float, float>(&error, GrB_NULL, PlusMonoid<float>(), &r_temp, desc);
+    // error = l2loss(p, p_prev), in one pass without residual vector
+    eWiseMultReduce<float, float, float>(&error, GrB_NULL,
+        PlusSquaredDifferenceSemiring<float>(), p, &p_prev, desc);
     error = sqrt(error);
 
     if (desc->descriptor_.debug())
@@ -93,6 +87,97 @@ float pr(Vector<float>*       p,
   return gpu_tight_time;
 }
 
+/*!
+ * \brief Same PageRank as pr(), but only pushes from vertices whose residual
+ * is still above threshold, and only visits those and their neighbours
+ *
+ * p starts at 0 and residual r at 0, and teleport mass (1-alpha)/nrows is
+ * spread into r as if pushed from nowhere. Frontier f is then kept as sparse
+ * vector of active vertices {v | r(v) > eps*outdegree(v)/||outdegree||_2}
+ * holding r(v). Each round, t = f*A pushes it along out-edges by sparse vxm,
+ * and residualUpdate moves f into p and adds t to r, both at touched
+ * vertices only, and picks next frontier out of those t reached. vxm pulls
+ * instead while f is above switchpoint.
+ *
+ * eps has the same meaning as for pr(). Pushing every vertex once more would
+ * add exactly r to p, as p_k - p_{k-1} is added by a pr() iteration, and on
+ * return every r(v) is below its threshold, so ||r||_2 <= eps. Thresholds
+ * are still proportional to outdegree, so each push does about the same work
+ * per unit of residual moved
+ * \param p output PageRank
+ * \param A column stochastic matrix scaled by alpha, same as for pr()
+ * \param alpha teleportation constant
+ * \param eps threshold on l2 norm of change, same as for pr()
+ * \param desc pointer to descriptor
+ */
+float prResidual(Vector<float>*       p,
+                 const Matrix<float>* A,
+                 float                alpha,
+                 float                eps,
+                 Descriptor*          desc) {
+  Index A_nrows;
+  CHECK(A->nrows(&A_nrows));
+
+  PooledVector<float> r_pool(desc->pool(), A_nrows);
+  PooledVector<float> t_pool(desc->pool(), A_nrows);
+  PooledVector<float> b_pool(desc->pool(), A_nrows);
+  PooledVector<float> f_pool(desc->pool(), A_nrows);
+  Vector<float>& r = *r_pool;
+  Vector<float>& t = *t_pool;
+  Vector<float>& b = *b_pool;
+  Vector<float>& f = *f_pool;
+
+  // b = eps*outdegree/||outdegree||_2, where outdegree counts entries of
+  // each row
+  CHECK(f.fill(1.f));
+  CHECK((mxv<float, float, float, float>(&t, GrB_NULL, GrB_NULL,
+      PlusPairSemiring<float>(), A, &f, desc)));
+  float outdegree_norm = 0.f;
+  CHECK((eWiseMultReduce<float, float, float>(&outdegree_norm, GrB_NULL,
+      PlusMultipliesSemiring<float>(), &t, &t, desc)));
+  outdegree_norm = sqrt(outdegree_norm);
+  CHECK(f.fill(outdegree_norm > 0.f ? eps/outdegree_norm : 0.f));
+  CHECK((eWiseMult<float, float, float, float>(&b, GrB_NULL, GrB_NULL,
+      PlusMultipliesSemiring<float>(), &t, &f, desc)));
+
+  int   iter;
+  Index active = 0;
+
+  backend::GpuTimer gpu_tight;
+  gpu_tight.Start();
+
+  // Teleport gives first frontier
+  CHECK(p->fill(0.f));
+  CHECK(r.fill(0.f));
+  CHECK(f.clear());
+  CHECK(t.fill((1.f-alpha)/A_nrows));
+  CHECK(residualUpdate(p, &r, &f, &active, &t, &b, desc));
+
+  for (iter = 1; active > 0 && iter <= desc->descriptor_.max_niter_; ++iter) {
+    if (desc->descriptor_.debug())
+      std::cout << "=====PR residual Iteration " << iter - 1 << ": " << active
+          << " active=====\n";
+
+    // t = f*A, then p(f) += f, r(f) = 0, r += t and f = active among t
+    CHECK((vxm<float, float, float, float>(&t, GrB_NULL, GrB_NULL,
+        PlusMultipliesSemiring<float>(), &f, A, desc)));
+    CHECK(residualUpdate(p, &r, &f, &active, &t, &b, desc));
+
+    if (desc->descriptor_.timing_ == 2) {
+      std::string vxm_mode = (desc->descriptor_.lastmxv_ == GrB_PUSHONLY) ?
+          "push" : "pull";
+      std::cout << iter << ", " << active << "/" << A_nrows << ", "
+          << vxm_mode << "\n";
+    }
+  }
+  gpu_tight.Stop();
+
+  if (desc->descriptor_.timing_ > 0)
+    std::cout << "pr residual, " << iter << ", " << active << ", "
+        << gpu_tight.ElapsedMillis() << "\n";
+  return gpu_tight.ElapsedMillis();
+}
+
 template <typename T, typename a>
 int prCpu(T*         h_pr_cpu,
           Matrix<a>* A,
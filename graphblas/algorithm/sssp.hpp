@@ -1,7 +1,11 @@
 #ifndef GRAPHBLAS_ALGORITHM_SSSP_HPP_
 #define GRAPHBLAS_ALGORITHM_SSSP_HPP_
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <limits>
+#include <map>
 #include <vector>
 #include <string>
 
@@ -11,37 +15,44 @@
 namespace graphblas {
 namespace algorithm {
 
-// Use float for now for both v and A
-float sssp(Vector<float>*       v,
-           const Matrix<float>* A,
-           Index                s,
-           Descriptor*          desc) {
+// Distance of each vertex from s is written to v. Frontiers carry distances,
+// so they have the same type T as v, but the mask of vertices whose distance
+// improved only holds 0 or 1, so MaskT can be a narrow type (bool or uint8_t).
+// Defaults keep the original all-float behaviour for Vector<float> callers
+template <typename MaskT = float, typename T, typename a>
+float sssp(Vector<T>*       v,
+           const Matrix<a>* A,
+           Index            s,
+           Descriptor*      desc) {
   Index A_nrows;
   CHECK(A->nrows(&A_nrows));
 
-  // Visited vector (use float for now)
-  CHECK(v->fill(std::numeric_limits<float>::max()));
-  CHECK(v->setElement(0.f, s));
+  // Visited vector
+  CHECK(v->fill(std::numeric_limits<T>::max()));
+  CHECK(v->setElement(static_cast<T>(0), s));
 
-  // Frontier vectors (use float for now)
-  Vector<float> f1(A_nrows);
-  Vector<float> f2(A_nrows);
+  // Frontier vectors
+  PooledVector<T> f1_pool(desc->pool(), A_nrows);
+  PooledVector<T> f2_pool(desc->pool(), A_nrows);
+  Vector<T>& f1 = *f1_pool;
+  Vector<T>& f2 = *f2_pool;
 
   Desc_value desc_value;
   CHECK(desc->get(GrB_MXVMODE, &desc_value));
 
-  // Visited vector (use float for now)
+  // Visited vector
   if (desc_value == GrB_PULLONLY) {
-    CHECK(f1.fill(std::numeric_limits<float>::max()));
-    CHECK(f1.setElement(0.f, s));
+    CHECK(f1.fill(std::numeric_limits<T>::max()));
+    CHECK(f1.setElement(static_cast<T>(0), s));
   } else {
     std::vector<Index> indices(1, s);
-    std::vector<float>  values(1, 0.f);
+    std::vector<T>     values(1, static_cast<T>(0));
     CHECK(f1.build(&indices, &values, 1, GrB_NULL));
   }
 
   // Mask vector
-  Vector<float> m(A_nrows);
+  PooledVector<MaskT> m_pool(desc->pool(), A_nrows);
+  Vector<MaskT>& m = *m_pool;
 
   Index iter;
   Index f1_nvals = 1;
@@ -64,28 +75,28 @@ float sssp(Vector<float>*       v,
     }
     gpu_tight.Start();
 
-    vxm<float, float, float, float>(&f2, GrB_NULL, GrB_NULL,
-        MinimumPlusSemiring<float>(), &f1, A, desc);
+    vxm<T, T, T, a>(&f2, GrB_NULL, GrB_NULL,
+        MinimumPlusSemiring<T>(), &f1, A, desc);
 
     //eWiseMult<float, float, float, float>(&m, GrB_NULL, GrB_NULL,
     //    PlusLessSemiring<float>(), &f2, v, desc);
-    eWiseAdd<float, float, float, float>(&m, GrB_NULL, GrB_NULL,
-        CustomLessPlusSemiring<float>(), &f2, v, desc);
+    eWiseAdd<MaskT, T, T, T>(&m, GrB_NULL, GrB_NULL,
+        CustomLessPlusSemiring<T>(), &f2, v, desc);
 
-    eWiseAdd<float, float, float, float>(v, GrB_NULL, GrB_NULL,
-        MinimumPlusSemiring<float>(), v, &f2, desc);
+    eWiseAdd<T, T, T, T>(v, GrB_NULL, GrB_NULL,
+        MinimumPlusSemiring<T>(), v, &f2, desc);
 
     // Similar to BFS, except we need to filter out the unproductive vertices
     // here rather than as part of masked vxm
     CHECK(desc->toggle(GrB_MASK));
-    assign<float, float>(&f2, &m, GrB_NULL, std::numeric_limits<float>::max(),
+    assign<T, MaskT>(&f2, &m, GrB_NULL, std::numeric_limits<T>::max(),
         GrB_ALL, A_nrows, desc);
     CHECK(desc->toggle(GrB_MASK));
 
     CHECK(f2.swap(&f1));
 
     CHECK(f1.nvals(&f1_nvals));
-    reduce<float, float>(&succ, GrB_NULL, PlusMonoid<float>(), &m, desc);
+    reduce<float, MaskT>(&succ, GrB_NULL, PlusMonoid<float>(), &m, desc);
 
     if (desc->descriptor_.debug())
       std::cout << succ << std::endl;
@@ -102,6 +113,173 @@ float sssp(Vector<float>*       v,
   return gpu_tight_time;
 }
 
+// Relaxes edges of A out of listed vertices, each at its distance in h_dist,
+// and appends every vertex that improved to list of its bucket. Frontier is
+// built sparse from list, so push vxm and readback scale with list and its
+// edges. r is scratch
+template <typename T, typename a>
+Info ssspDeltaRelax(const std::vector<Index>&                list,
+                    const Matrix<a>*                         A,
+                    T                                        delta,
+                    std::vector<T>*                          h_dist,
+                    std::map<int64_t, std::vector<Index> >*  buckets,
+                    Vector<T>*                               r,
+                    Descriptor*                              desc) {
+  if (list.empty())
+    return GrB_SUCCESS;
+  Index A_nrows;
+  CHECK(A->nrows(&A_nrows));
+
+  Index list_nvals = list.size();
+  std::vector<T> list_val(list_nvals);
+  for (Index k = 0; k < list_nvals; ++k)
+    list_val[k] = (*h_dist)[list[k]];
+  PooledVector<T> f_pool(desc->pool(), A_nrows);
+  Vector<T>& f = *f_pool;
+  CHECK(f.build(&list, &list_val, list_nvals, GrB_NULL));
+  CHECK((vxm<T, T, T, a>(r, GrB_NULL, GrB_NULL, MinimumPlusSemiring<T>(), &f,
+      A, desc)));
+
+  // Result is dense only if vxm switched to pull, which it does when list is
+  // already a large part of nrows
+  Storage r_type;
+  Index   r_nvals;
+  std::vector<Index> r_ind;
+  std::vector<T>     r_val;
+  CHECK(r->getStorage(&r_type));
+  if (r_type == GrB_SPARSE) {
+    CHECK(r->nvals(&r_nvals));
+    CHECK(r->extractTuples(&r_ind, &r_val, &r_nvals));
+  } else {
+    r_nvals = A_nrows;
+    CHECK(r->extractTuples(&r_val, &r_nvals));
+  }
+  for (Index k = 0; k < r_nvals; ++k) {
+    Index i = (r_type == GrB_SPARSE) ? r_ind[k] : k;
+    if (r_val[k] < (*h_dist)[i]) {
+      (*h_dist)[i] = r_val[k];
+      (*buckets)[static_cast<int64_t>(r_val[k]/delta)].push_back(i);
+    }
+  }
+  return GrB_SUCCESS;
+}
+
+/*!
+ * \brief Delta-stepping SSSP: distance of each vertex from s written to v
+ *
+ * Edges are split by select into light (weight <= delta) and heavy ones.
+ * Tentative distances are bucketed by width delta, and bucket [lo, lo+delta)
+ * is settled by relaxing light edges out of vertices that improved into it,
+ * until none does, and only then heavy edges out of whole bucket, since those
+ * cannot land back in it. Buckets are host index lists keyed by bucket
+ * number, so empty buckets are skipped, and every round pushes from a sparse
+ * frontier of listed vertices only. Work per bucket thus scales with its
+ * vertices and their edges rather than nrows, and v is written once at end.
+ * A vertex is listed again each time it improves, and entries left stale by
+ * a later improvement are dropped when their bucket comes up. Small delta
+ * relaxes each edge about once, like Dijkstra, while large delta gives
+ * Bellman-Ford with fewer, larger rounds
+ * \param delta bucket width, where 0 takes mean edge weight
+ */
+template <typename T, typename a>
+float ssspDelta(Vector<T>*       v,
+                const Matrix<a>* A,
+                Index            s,
+                T                delta,
+                Descriptor*      desc) {
+  Index A_nrows, A_nvals;
+  CHECK(A->nrows(&A_nrows));
+  CHECK(A->nvals(&A_nvals));
+  const T inf = std::numeric_limits<T>::max();
+
+  backend::GpuTimer gpu_tight;
+  gpu_tight.Start();
+
+  if (delta <= static_cast<T>(0) && A_nvals > 0) {
+    T weight = static_cast<T>(0);
+    CHECK((reduce<T, a>(&weight, GrB_NULL, PlusMonoid<T>(), A, desc)));
+    delta = weight/A_nvals;
+  }
+  if (delta <= static_cast<T>(0))
+    delta = static_cast<T>(1);
+
+  Matrix<a> AL(A_nrows, A_nrows);
+  Matrix<a> AH(A_nrows, A_nrows);
+  Index AL_nvals, AH_nvals;
+  CHECK((select<a, a, a>(&AL, GrB_NULL, GrB_NULL, less_equal<a, T>(), A,
+      delta, desc)));
+  CHECK((select<a, a, a>(&AH, GrB_NULL, GrB_NULL, greater<a, T>(), A,
+      delta, desc)));
+  CHECK(AL.nvals(&AL_nvals));
+  CHECK(AH.nvals(&AH_nvals));
+
+  PooledVector<T> r_pool(desc->pool(), A_nrows);
+  Vector<T>& r = *r_pool;
+
+  std::vector<T> h_dist(A_nrows, inf);
+  std::map<int64_t, std::vector<Index> > buckets;
+  h_dist[s] = static_cast<T>(0);
+  buckets[0].push_back(s);
+
+  // Stamps dedupe a vertex listed more than once in a round, and in the set
+  // of vertices settled by a bucket, without clearing anything per bucket
+  std::vector<Index> h_round(A_nrows, std::numeric_limits<Index>::max());
+  std::vector<Index> h_settled(A_nrows, std::numeric_limits<Index>::max());
+  std::vector<Index> list, settled, entries;
+
+  Index nbucket = 0;
+  Index nround  = 0;
+  int   iter = 0;
+  while (!buckets.empty()) {
+    const int64_t bucket = buckets.begin()->first;
+    if (desc->descriptor_.debug())
+      std::cout << "=====SSSP Bucket " << nbucket << ": [" << bucket*delta
+          << ", " << (bucket+1)*delta << ")=====\n";
+
+    // Light edges, from vertices that entered bucket in previous round
+    settled.clear();
+    for (int round = 0; round < desc->descriptor_.max_niter_; ++round) {
+      auto it = buckets.find(bucket);
+      if (it == buckets.end())
+        break;
+      entries.swap(it->second);
+      buckets.erase(it);
+
+      list.clear();
+      for (Index i : entries) {
+        if (static_cast<int64_t>(h_dist[i]/delta) != bucket ||
+            h_round[i] == nround)
+          continue;
+        h_round[i] = nround;
+        list.push_back(i);
+        if (h_settled[i] != nbucket) {
+          h_settled[i] = nbucket;
+          settled.push_back(i);
+        }
+      }
+      nround++;
+      if (list.empty() || AL_nvals == 0)
+        continue;
+      iter++;
+      CHECK(ssspDeltaRelax(list, &AL, delta, &h_dist, &buckets, &r, desc));
+    }
+
+    // Heavy edges, once from every vertex settled in bucket
+    if (AH_nvals > 0)
+      CHECK(ssspDeltaRelax(settled, &AH, delta, &h_dist, &buckets, &r, desc));
+    nbucket++;
+  }
+
+  CHECK(v->fill(inf));
+  CHECK(v->build(&h_dist, A_nrows));
+  gpu_tight.Stop();
+
+  if (desc->descriptor_.timing_ > 0)
+    std::cout << "sssp delta, " << delta << ", " << nbucket << ", " << iter
+        << ", " << gpu_tight.ElapsedMillis() << "\n";
+  return gpu_tight.ElapsedMillis();
+}
+
 template <typename T, typename a>
 int ssspCpu(Index        source,
             Matrix<a>*   A,
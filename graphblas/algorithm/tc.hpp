@@ -0,0 +1,209 @@
+#ifndef GRAPHBLAS_ALGORITHM_TC_HPP_
+#define GRAPHBLAS_ALGORITHM_TC_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "graphblas/algorithm/test_tc.hpp"
+#include "graphblas/backend/cuda/util.hpp"
+
+namespace graphblas {
+namespace algorithm {
+
+/*!
+ * \brief Builds L = tril(P A P^T) of undirected A, where P relabels vertices
+ * by decreasing degree (ties by id)
+ *
+ * Each undirected edge is kept once, in row of its lower-degree end, so row of
+ * a vertex only holds its higher-degree neighbours. This orients graph as a
+ * DAG whose out-degrees are at most sqrt(2*nedges), which bounds work of
+ * every row in tc. Relabeling and filling of L run on threadPool, and rows of
+ * L come out sorted. A must have every edge in both directions
+ */
+template <typename T, typename a>
+Info tcLower(Matrix<T>*       L,
+             const Matrix<a>* A,
+             Descriptor*      desc) {
+  Index A_nrows;
+  CHECK(A->nrows(&A_nrows));
+  backend::SparseMatrix<a>* A_sparse =
+      const_cast<backend::SparseMatrix<a>*>(&A->matrix_.sparse_);
+  CHECK(A_sparse->gpuToCpu());
+  const Index* A_ptr = A_sparse->h_csrRowPtr_;
+  const Index* A_ind = A_sparse->h_csrColInd_;
+
+  // rank[v] is new id of v, with highest degree first
+  std::vector<Index> order(A_nrows), rank(A_nrows);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](Index u, Index v) {
+    Index u_deg = A_ptr[u+1] - A_ptr[u];
+    Index v_deg = A_ptr[v+1] - A_ptr[v];
+    return (u_deg != v_deg) ? u_deg > v_deg : u < v;
+  });
+  threadPool().parallelFor(0, A_nrows, [&](Index begin, Index end) {
+    for (Index k = begin; k < end; ++k)
+      rank[order[k]] = k;
+  }, 4096);
+
+  // Row rank[u] of L holds neighbours of u that come before it
+  std::vector<Index> L_ptr(A_nrows + 1, 0);
+  threadPool().parallelFor(0, A_nrows, [&](Index begin, Index end) {
+    for (Index u = begin; u < end; ++u) {
+      Index count = 0;
+      for (Index edge = A_ptr[u]; edge < A_ptr[u+1]; ++edge)
+        if (rank[A_ind[edge]] < rank[u])
+          count++;
+      L_ptr[rank[u] + 1] = count;
+    }
+  }, 1024);
+  for (Index row = 0; row < A_nrows; ++row)
+    L_ptr[row + 1] += L_ptr[row];
+
+  Index L_nvals = L_ptr[A_nrows];
+  std::vector<Index> L_row(L_nvals), L_col(L_nvals);
+  std::vector<T> L_val(L_nvals, static_cast<T>(1));
+  threadPool().parallelFor(0, A_nrows, [&](Index begin, Index end) {
+    for (Index u = begin; u < end; ++u) {
+      Index row  = rank[u];
+      Index dest = L_ptr[row];
+      for (Index edge = A_ptr[u]; edge < A_ptr[u+1]; ++edge) {
+        Index col = rank[A_ind[edge]];
+        if (col < row) {
+          L_row[dest] = row;
+          L_col[dest] = col;
+          dest++;
+        }
+      }
+      std::sort(L_col.begin() + L_ptr[row], L_col.begin() + dest);
+    }
+  }, 1024);
+
+  CHECK(L->build(&L_row, &L_col, &L_val, L_nvals, GrB_NULL));
+  return GrB_SUCCESS;
+}
+
+// Number of common entries of sorted lists [a, a_end) and [b, b_end). Merges
+// lists of similar length, and gallops through longer one otherwise, so cost
+// is O(short*log(long)) when a hub meets a low-degree vertex
+inline int64_t tcIntersect(const Index* a,
+                           const Index* a_end,
+                           const Index* b,
+                           const Index* b_end) {
+  if (a_end - a > b_end - b) {
+    std::swap(a, b);
+    std::swap(a_end, b_end);
+  }
+  int64_t count = 0;
+  if ((b_end - b) > 32*(a_end - a)) {
+    for (; a < a_end && b < b_end; ++a) {
+      // Exponential search for first entry of b not less than *a
+      Index step = 1;
+      const Index* hi = b;
+      while (hi < b_end && *hi < *a) {
+        b   = hi;
+        hi += step;
+        step *= 2;
+      }
+      b = std::lower_bound(b, std::min(hi, b_end), *a);
+      if (b < b_end && *b == *a)
+        count++;
+    }
+  } else {
+    while (a < a_end && b < b_end) {
+      if (*a < *b) {
+        ++a;
+      } else if (*b < *a) {
+        ++b;
+      } else {
+        count++;
+        ++a;
+        ++b;
+      }
+    }
+  }
+  return count;
+}
+
+// Triangles of L from tcLower on CPU: for every L(i,j), common entries of rows
+// i and j, which is sum(L .* (L * L^T)). Only entries of row i before j can
+// match, since row j has nothing past j
+template <typename T>
+Info tcCpuInner(int64_t*         ntris,
+                const Matrix<T>* L) {
+  backend::SparseMatrix<T>* L_sparse =
+      const_cast<backend::SparseMatrix<T>*>(&L->matrix_.sparse_);
+  CHECK(L_sparse->gpuToCpu());
+  const Index* L_ptr = L_sparse->h_csrRowPtr_;
+  const Index* L_ind = L_sparse->h_csrColInd_;
+
+  std::atomic<int64_t> total(0);
+  threadPool().parallelFor(0, L_sparse->nrows_, [&](Index begin, Index end) {
+    int64_t count = 0;
+    for (Index i = begin; i < end; ++i) {
+      for (Index edge = L_ptr[i]; edge < L_ptr[i+1]; ++edge) {
+        Index j = L_ind[edge];
+        count += tcIntersect(L_ind + L_ptr[i], L_ind + edge, L_ind + L_ptr[j],
+            L_ind + L_ptr[j+1]);
+      }
+    }
+    total.fetch_add(count);
+  }, 64);
+  *ntris = total.load();
+  return GrB_SUCCESS;
+}
+
+/*!
+ * \brief Counts triangles of L built by tcLower
+ *
+ * Non-sequential path is masked SpGEMM sum(L .* (L * L)): C<L> = L * L with
+ * pair semiring only forms entries of C under mask L, each of which counts
+ * triangles on that edge, and reduce sums them. C and the sum are double, so
+ * counts stay exact past 2^24. Under GrB_SEQUENTIAL, tcCpuInner intersects
+ * sorted rows instead, without any C
+ * \param ntris output number of triangles
+ * \param L lower-triangular DAG from tcLower
+ * \param desc pointer to descriptor
+ */
+template <typename T>
+float tc(int64_t*         ntris,
+         const Matrix<T>* L,
+         Descriptor*      desc) {
+  Index L_nrows;
+  CHECK(L->nrows(&L_nrows));
+  Desc_value backend_mode;
+  CHECK(desc->get(GrB_BACKEND, &backend_mode));
+
+  backend::GpuTimer gpu_tight;
+  gpu_tight.Start();
+  if (backend_mode == GrB_SEQUENTIAL) {
+    CHECK(tcCpuInner(ntris, L));
+  } else {
+    Matrix<double> C(L_nrows, L_nrows);
+    CHECK((mxm<double, T, T, T>(&C, L, GrB_NULL,
+        PlusPairSemiring<T, T, double>(), L, L, desc)));
+    double val = 0.;
+    CHECK((reduce<double, double>(&val, GrB_NULL, PlusMonoid<double>(), &C,
+        desc)));
+    *ntris = static_cast<int64_t>(val);
+  }
+  gpu_tight.Stop();
+
+  if (desc->descriptor_.timing_ > 0)
+    std::cout << "tc, " << *ntris << ", " << gpu_tight.ElapsedMillis()
+        << "\n";
+  return gpu_tight.ElapsedMillis();
+}
+
+template <typename a>
+int64_t tcCpu(Matrix<a>* A) {
+  return SimpleReferenceTc(A->matrix_.nrows_, A->matrix_.sparse_.h_csrRowPtr_,
+      A->matrix_.sparse_.h_csrColInd_);
+}
+}  // namespace algorithm
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_ALGORITHM_TC_HPP_
@@ -0,0 +1,104 @@
+#ifndef GRAPHBLAS_ALGORITHM_TEST_BC_HPP_
+#define GRAPHBLAS_ALGORITHM_TEST_BC_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <queue>
+#include <vector>
+
+namespace graphblas {
+namespace algorithm {
+
+// A simple CPU-based reference BC implementation, which runs serial Brandes
+// from each of sources in turn: BFS counting shortest paths, then dependencies
+// accumulated in reverse BFS order. h_bc_cpu[v] comes out as sum over sources
+// of their dependency on v
+template <typename T>
+void SimpleReferenceBc(Index                     nrows,
+                       const Index*              h_csrRowPtr,
+                       const Index*              h_csrColInd,
+                       const std::vector<Index>& sources,
+                       std::vector<T>*           h_bc_cpu) {
+  h_bc_cpu->assign(nrows, static_cast<T>(0));
+  std::vector<Index>  depth(nrows);
+  std::vector<double> sigma(nrows);
+  std::vector<double> delta(nrows);
+  std::vector<Index>  order;
+  order.reserve(nrows);
+
+  CpuTimer cpu_timer;
+  cpu_timer.Start();
+
+  for (Index source : sources) {
+    std::fill(depth.begin(), depth.end(), -1);
+    std::fill(sigma.begin(), sigma.end(), 0.);
+    std::fill(delta.begin(), delta.end(), 0.);
+    order.clear();
+
+    std::queue<Index> queue;
+    depth[source] = 0;
+    sigma[source] = 1.;
+    queue.push(source);
+    while (!queue.empty()) {
+      Index v = queue.front();
+      queue.pop();
+      order.push_back(v);
+      for (Index edge = h_csrRowPtr[v]; edge < h_csrRowPtr[v+1]; ++edge) {
+        Index w = h_csrColInd[edge];
+        if (depth[w] < 0) {
+          depth[w] = depth[v] + 1;
+          queue.push(w);
+        }
+        if (depth[w] == depth[v] + 1)
+          sigma[w] += sigma[v];
+      }
+    }
+
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+      Index v = *it;
+      for (Index edge = h_csrRowPtr[v]; edge < h_csrRowPtr[v+1]; ++edge) {
+        Index w = h_csrColInd[edge];
+        if (depth[w] == depth[v] + 1)
+          delta[v] += sigma[v]/sigma[w]*(1. + delta[w]);
+      }
+      if (v != source)
+        (*h_bc_cpu)[v] += static_cast<T>(delta[v]);
+    }
+  }
+
+  cpu_timer.Stop();
+  float elapsed = cpu_timer.ElapsedMillis();
+
+  std::cout << "CPU BC finished in " << elapsed << " msec.\n";
+}
+
+// Checks h_bc against h_bc_cpu within relative tolerance tol. Returns number
+// of errors
+template <typename T>
+int SimpleVerifyBc(Index                 nrows,
+                   const std::vector<T>& h_bc,
+                   const std::vector<T>& h_bc_cpu,
+                   double                tol = 1e-4) {
+  int errors = 0;
+  for (Index v = 0; v < nrows; ++v) {
+    double diff  = std::fabs(static_cast<double>(h_bc[v]) - h_bc_cpu[v]);
+    double scale = std::max(1., std::fabs(static_cast<double>(h_bc_cpu[v])));
+    if (diff > tol*scale) {
+      if (errors == 0)
+        std::cout << "\nINCORRECT: [" << v << "]: " << h_bc[v]
+            << " vs. reference " << h_bc_cpu[v] << ".\n";
+      errors++;
+    }
+  }
+
+  if (errors == 0)
+    std::cout << "\nCORRECT\n";
+  else
+    std::cout << errors << " errors occurred.\n";
+  return errors;
+}
+}  // namespace algorithm
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_ALGORITHM_TEST_BC_HPP_
@@ -1,12 +1,17 @@
 #ifndef GRAPHBLAS_ALGORITHM_TEST_BFS_HPP_
 #define GRAPHBLAS_ALGORITHM_TEST_BFS_HPP_
 
+#include <algorithm>
 #include <deque>
+#include <iostream>
+#include <vector>
 
 namespace graphblas {
 namespace algorithm {
 
-// A simple CPU-based reference BFS ranking implementation
+// A simple CPU-based reference BFS ranking implementation. If predecessor is
+// not NULL, it gets parent of each reached vertex in BFS tree, with source as
+// its own parent and -1 for unreached vertices
 template <typename T>
 int SimpleReferenceBfs(Index        nrows,
                        const Index* h_rowPtr,
@@ -20,6 +25,11 @@ int SimpleReferenceBfs(Index        nrows,
     source_path[i] = 0;
   source_path[src] = 1;
   Index search_depth = 1;
+  if (predecessor != NULL) {
+    for (Index i = 0; i < nrows; ++i)
+      predecessor[i] = -1;
+    predecessor[src] = src;
+  }
 
   // Initialize queue for managing previously-discovered nodes
   std::deque<Index> frontier;
@@ -45,6 +55,8 @@ int SimpleReferenceBfs(Index        nrows,
       Index neighbor = h_colInd[edge];
       if (source_path[neighbor] == 0) {
         source_path[neighbor] = neighbor_dist;
+        if (predecessor != NULL)
+          predecessor[neighbor] = dequeued_node;
         if (search_depth < neighbor_dist)
           search_depth = neighbor_dist;
         frontier.push_back(neighbor);
@@ -59,6 +71,46 @@ int SimpleReferenceBfs(Index        nrows,
 
   return search_depth;
 }
+
+// Graph500-style check of BFS tree h_parent from src against depths h_depth
+// of reference BFS (src at 1, unreached at 0): src is its own parent, same
+// vertices are reached, and every other reached vertex hangs off an edge of
+// graph from vertex one level up. Returns number of errors
+template <typename T>
+int SimpleVerifyBfsTree(Index                     nrows,
+                        const Index*              h_rowPtr,
+                        const Index*              h_colInd,
+                        Index                     src,
+                        const std::vector<Index>& h_parent,
+                        const T*                  h_depth) {
+  int errors = 0;
+  for (Index v = 0; v < nrows; ++v) {
+    Index parent = h_parent[v];
+    bool  ok;
+    if (v == src) {
+      ok = (parent == src);
+    } else if (h_depth[v] == 0) {
+      ok = (parent == -1);
+    } else {
+      ok = (parent >= 0 && parent < nrows &&
+          h_depth[parent] + 1 == h_depth[v] &&
+          std::binary_search(h_colInd + h_rowPtr[parent],
+              h_colInd + h_rowPtr[parent+1], v));
+    }
+    if (!ok) {
+      if (errors == 0)
+        std::cout << "\nINCORRECT: [" << v << "]: parent " << parent
+            << " at depth " << h_depth[v] << ".\n";
+      errors++;
+    }
+  }
+
+  if (errors == 0)
+    std::cout << "\nCORRECT\n";
+  else
+    std::cout << errors << " errors occurred.\n";
+  return errors;
+}
 }  // namespace algorithm
 }  // namespace graphblas
 
@@ -0,0 +1,110 @@
+#ifndef GRAPHBLAS_ALGORITHM_TEST_CC_HPP_
+#define GRAPHBLAS_ALGORITHM_TEST_CC_HPP_
+
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+namespace graphblas {
+namespace algorithm {
+
+// Hooks trees of u and v together, always pointing larger root at smaller
+// one, so that every tree stays rooted at its smallest vertex. Only a root is
+// ever moved, and only by compare-and-swap, so links may run concurrently
+inline void ccLink(std::vector<std::atomic<Index>>* parent,
+                   Index                            u,
+                   Index                            v) {
+  Index p1 = (*parent)[u].load();
+  Index p2 = (*parent)[v].load();
+  while (p1 != p2) {
+    Index high   = (p1 > p2) ? p1 : p2;
+    Index low    = (p1 > p2) ? p2 : p1;
+    Index p_high = (*parent)[high].load();
+    if (p_high == low)
+      break;
+    if (p_high == high &&
+        (*parent)[high].compare_exchange_strong(p_high, low))
+      break;
+    p1 = (*parent)[(*parent)[high].load()].load();
+    p2 = (*parent)[low].load();
+  }
+}
+
+// A simple CPU-based reference connected components implementation, which
+// runs lock-free union-find on threadPool: every edge is linked in parallel,
+// then every vertex is pointed straight at its root. h_cc_cpu[v] comes out as
+// smallest vertex of component of v. Graph must be undirected
+void SimpleReferenceCc(Index             nrows,
+                       const Index*      h_csrRowPtr,
+                       const Index*      h_csrColInd,
+                       std::vector<int>* h_cc_cpu) {
+  std::vector<std::atomic<Index>> parent(nrows);
+  for (Index v = 0; v < nrows; ++v)
+    parent[v].store(v);
+
+  CpuTimer cpu_timer;
+  cpu_timer.Start();
+
+  threadPool().parallelFor(0, nrows, [&](Index begin, Index end) {
+    for (Index u = begin; u < end; ++u)
+      for (Index edge = h_csrRowPtr[u]; edge < h_csrRowPtr[u+1]; ++edge)
+        ccLink(&parent, u, h_csrColInd[edge]);
+  }, 256);
+
+  h_cc_cpu->resize(nrows);
+  threadPool().parallelFor(0, nrows, [&](Index begin, Index end) {
+    for (Index v = begin; v < end; ++v) {
+      Index root = parent[v].load();
+      while (root != parent[root].load())
+        root = parent[root].load();
+      (*h_cc_cpu)[v] = root;
+    }
+  }, 4096);
+
+  cpu_timer.Stop();
+  float elapsed = cpu_timer.ElapsedMillis();
+
+  std::cout << "CPU CC finished in " << elapsed << " msec.\n";
+}
+
+// Checks that h_cc and h_cc_cpu split vertices into same components, i.e.
+// that one labeling maps onto the other both ways. Returns number of errors
+int SimpleVerifyCc(Index                   nrows,
+                   const std::vector<int>& h_cc,
+                   const std::vector<int>& h_cc_cpu) {
+  std::vector<Index> to_cpu(nrows, -1);
+  std::vector<Index> to_gpu(nrows, -1);
+  int errors = 0;
+
+  for (Index v = 0; v < nrows; ++v) {
+    int label = h_cc[v];
+    int ref   = h_cc_cpu[v];
+    if (label < 0 || label >= nrows) {
+      if (errors == 0)
+        std::cout << "\nINCORRECT: [" << v << "]: label " << label
+            << " out of range.\n";
+      errors++;
+      continue;
+    }
+    if (to_cpu[label] == -1)
+      to_cpu[label] = ref;
+    if (to_gpu[ref] == -1)
+      to_gpu[ref] = label;
+    if (to_cpu[label] != ref || to_gpu[ref] != label) {
+      if (errors == 0)
+        std::cout << "\nINCORRECT: [" << v << "]: label " << label
+            << " vs. reference " << ref << ".\n";
+      errors++;
+    }
+  }
+
+  if (errors == 0)
+    std::cout << "\nCORRECT\n";
+  else
+    std::cout << errors << " errors occurred.\n";
+  return errors;
+}
+}  // namespace algorithm
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_ALGORITHM_TEST_CC_HPP_
@@ -0,0 +1,74 @@
+#ifndef GRAPHBLAS_ALGORITHM_TEST_KCORE_HPP_
+#define GRAPHBLAS_ALGORITHM_TEST_KCORE_HPP_
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace graphblas {
+namespace algorithm {
+
+// A simple CPU-based reference k-core implementation (Batagelj-Zaversnik),
+// which keeps vertices bucket-sorted by degree and removes one of least degree
+// at a time, moving its remaining neighbours down one bucket. Core number of a
+// vertex is its degree when removed. Graph must be undirected, i.e. CSR
+// symmetric, without self-loops
+template <typename T>
+void SimpleReferenceKcore(Index           nrows,
+                          const Index*    h_csrRowPtr,
+                          const Index*    h_csrColInd,
+                          std::vector<T>* h_core_cpu) {
+  std::vector<Index> degree(nrows), bucket_ptr, order(nrows), pos(nrows);
+  Index max_degree = 0;
+  for (Index v = 0; v < nrows; ++v) {
+    degree[v]  = h_csrRowPtr[v+1] - h_csrRowPtr[v];
+    max_degree = std::max(max_degree, degree[v]);
+  }
+
+  CpuTimer cpu_timer;
+  cpu_timer.Start();
+
+  // order holds vertices by degree, bucket_ptr[d] is start of degree d
+  bucket_ptr.assign(max_degree + 2, 0);
+  for (Index v = 0; v < nrows; ++v)
+    bucket_ptr[degree[v] + 1]++;
+  for (Index d = 0; d <= max_degree; ++d)
+    bucket_ptr[d + 1] += bucket_ptr[d];
+  std::vector<Index> next(bucket_ptr.begin(), bucket_ptr.end() - 1);
+  for (Index v = 0; v < nrows; ++v) {
+    pos[v] = next[degree[v]]++;
+    order[pos[v]] = v;
+  }
+
+  for (Index i = 0; i < nrows; ++i) {
+    Index v = order[i];
+    for (Index edge = h_csrRowPtr[v]; edge < h_csrRowPtr[v+1]; ++edge) {
+      Index u = h_csrColInd[edge];
+      if (degree[u] > degree[v]) {
+        // Swap u with first vertex of its bucket, then shrink bucket
+        Index d = degree[u];
+        Index w = order[bucket_ptr[d]];
+        if (u != w) {
+          std::swap(order[pos[u]], order[bucket_ptr[d]]);
+          pos[w] = pos[u];
+          pos[u] = bucket_ptr[d];
+        }
+        bucket_ptr[d]++;
+        degree[u]--;
+      }
+    }
+  }
+
+  h_core_cpu->resize(nrows);
+  for (Index v = 0; v < nrows; ++v)
+    (*h_core_cpu)[v] = static_cast<T>(degree[v]);
+
+  cpu_timer.Stop();
+  float elapsed = cpu_timer.ElapsedMillis();
+
+  std::cout << "CPU k-core finished in " << elapsed << " msec.\n";
+}
+}  // namespace algorithm
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_ALGORITHM_TEST_KCORE_HPP_
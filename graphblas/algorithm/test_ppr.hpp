@@ -0,0 +1,51 @@
+#ifndef GRAPHBLAS_ALGORITHM_TEST_PPR_HPP_
+#define GRAPHBLAS_ALGORITHM_TEST_PPR_HPP_
+
+#include <cmath>
+#include <vector>
+
+namespace graphblas {
+namespace algorithm {
+
+// A simple CPU-based reference personalized PR implementation, for one seed
+// and with same update as pprBatch: p = pA + (1-alpha)*e_seed
+template <typename T>
+int SimpleReferencePpr(Index        nrows,
+                       const Index* h_rowPtr,
+                       const Index* h_colInd,
+                       const T*     h_val,
+                       T*           pagerank,
+                       Index        seed,
+                       float        alpha,
+                       float        eps,
+                       int          max_niter) {
+  for (Index i = 0; i < nrows; ++i)
+    pagerank[i] = 0.f;
+  pagerank[seed] = 1.f;
+
+  std::vector<T> next(nrows, 0.f);
+  int iter;
+  for (iter = 1; iter <= max_niter; ++iter) {
+    for (Index node = 0; node < nrows; ++node)
+      next[node] = 0.f;
+    next[seed] = 1.f - alpha;
+
+    for (Index node = 0; node < nrows; ++node)
+      for (Index edge = h_rowPtr[node]; edge < h_rowPtr[node+1]; ++edge)
+        next[h_colInd[edge]] += h_val[edge]*pagerank[node];
+
+    T error = 0.f;
+    for (Index node = 0; node < nrows; ++node) {
+      T diff = next[node] - pagerank[node];
+      error += diff*diff;
+      pagerank[node] = next[node];
+    }
+    if (std::sqrt(error) <= eps)
+      break;
+  }
+  return iter;
+}
+}  // namespace algorithm
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_ALGORITHM_TEST_PPR_HPP_
@@ -0,0 +1,47 @@
+#ifndef GRAPHBLAS_ALGORITHM_TEST_TC_HPP_
+#define GRAPHBLAS_ALGORITHM_TEST_TC_HPP_
+
+#include <cstdint>
+#include <vector>
+
+namespace graphblas {
+namespace algorithm {
+
+// A simple CPU-based reference triangle counting implementation, which marks
+// neighbours of each vertex u and, for every neighbour v > u, counts marked
+// neighbours w > v of v. Graph must be undirected, i.e. CSR symmetric
+int64_t SimpleReferenceTc(Index        nrows,
+                          const Index* h_csrRowPtr,
+                          const Index* h_csrColInd) {
+  std::vector<Index> marked(nrows, -1);
+  int64_t ntris = 0;
+
+  CpuTimer cpu_timer;
+  cpu_timer.Start();
+
+  for (Index u = 0; u < nrows; ++u) {
+    for (Index edge = h_csrRowPtr[u]; edge < h_csrRowPtr[u+1]; ++edge)
+      marked[h_csrColInd[edge]] = u;
+
+    for (Index edge = h_csrRowPtr[u]; edge < h_csrRowPtr[u+1]; ++edge) {
+      Index v = h_csrColInd[edge];
+      if (v <= u)
+        continue;
+      for (Index jj = h_csrRowPtr[v]; jj < h_csrRowPtr[v+1]; ++jj) {
+        Index w = h_csrColInd[jj];
+        if (w > v && marked[w] == u)
+          ntris++;
+      }
+    }
+  }
+
+  cpu_timer.Stop();
+  float elapsed = cpu_timer.ElapsedMillis();
+
+  std::cout << "CPU TC finished in " << elapsed << " msec.\n";
+  return ntris;
+}
+}  // namespace algorithm
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_ALGORITHM_TEST_TC_HPP_
@@ -20,9 +20,9 @@ Info applyDense(DenseVector<W>*  w,
   CHECK(desc->get(GrB_OUTP, &repl_mode));
   CHECK(desc->get(GrB_BACKEND, &backend));
 
-  // TODO(@ctcyang): add accum and replace support
+  // TODO: add accum and replace support to GPU path
   bool use_mask  = (mask != NULL);
-  bool use_accum = (accum != NULL);
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
   bool use_scmp  = (scmp_mode == GrB_SCMP);
   bool use_repl  = (repl_mode == GrB_REPLACE);
 
@@ -32,14 +32,25 @@ Info applyDense(DenseVector<W>*  w,
   }
 
   if (backend == GrB_SEQUENTIAL) {
-    if (use_mask) {
-      std::cout << "Error: DeVec apply masked not implemented yet!\n";
-    } else {
-      CHECK(u->gpuToCpu());
-      for (Index i = 0; i < u->nvals_; ++i)
-        w->h_val_[i] = op(u->h_val_[i]);
-      CHECK(w->cpuToGpu());
-    }
+    // Unary op has no identity, so entries cleared by mask are zero, which is
+    // what dense vector holds for no entry elsewhere
+    bool in_place = (static_cast<void*>(w) == u);
+    OutputCpu<W, BinaryOpT> out(accum, use_repl, static_cast<W>(0));
+    WorkspaceScope scope(desc->workspace());
+    MaskCpu<M> mask_cpu;
+    CHECK(mask_cpu.init(mask, use_scmp, out.needLookup(in_place),
+        desc->workspace()));
+    CHECK(u->gpuToCpu());
+    if (out.accumulates())
+      CHECK(w->gpuToCpu());
+
+    forEachOutputCpu(mask_cpu, out, w->h_val_, u->nvals_, in_place,
+        [&](Index i) {
+      out.write(w->h_val_ + i, op(u->h_val_[i]));
+    });
+    w->nvals_ = u->nvals_;
+    CHECK(w->cpuToGpu());
+    w->need_update_ = false;
   } else {
     std::cout << "DeVec apply CPU\n";
     std::cout << "Error: Feature not implemented yet!\n";
@@ -90,7 +101,7 @@ Info applySparse(SparseMatrix<c>* C,
 
   // TODO(@ctcyang): add accum and replace support
   bool use_mask  = (mask != NULL);
-  bool use_accum = (accum != NULL);
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
   bool use_scmp  = (scmp_mode == GrB_SCMP);
   bool use_repl  = (repl_mode == GrB_REPLACE);
 
@@ -104,8 +115,10 @@ Info applySparse(SparseMatrix<c>* C,
       std::cout << "Error: SpMat apply masked not implemented yet!\n";
     } else {
       CHECK(A->gpuToCpu());
-      for (Index i = 0; i < A->nvals_; ++i)
-        C->h_csrVal_[i] = op(A->h_csrVal_[i]);
+      threadPool().parallelFor(0, A->nvals_, [&](Index begin, Index end) {
+        for (Index i = begin; i < end; ++i)
+          C->h_csrVal_[i] = op(A->h_csrVal_[i]);
+      }, 4096);
       CHECK(C->syncCpu());
       CHECK(C->cpuToGpu());
     }
@@ -9,6 +9,68 @@
 namespace graphblas {
 namespace backend {
 
+/*!
+ * \brief CPU assign w(indices) = w(indices) + mask .* val of dense w
+ *
+ * Entries left out by mask or indices keep w, as in GPU path, except that
+ * GrB_REPLACE clears ones left out by mask to zero. accum is applied by
+ * OutputCpu in same pass. Non-complemented sparse mask over all indices only
+ * touches entries of mask
+ */
+template <typename W, typename T, typename M,
+          typename BinaryOpT>
+Info assignDenseCpu(DenseVector<W>*           w,
+                    Vector<M>*                mask,
+                    BinaryOpT                 accum,
+                    T                         val,
+                    const std::vector<Index>* indices,
+                    Index                     nindices,
+                    bool                      use_scmp,
+                    bool                      use_repl,
+                    Descriptor*               desc) {
+  bool use_all = (indices == NULL);
+  OutputCpu<W, BinaryOpT> out(accum, use_repl, static_cast<W>(0));
+  WorkspaceScope scope(desc->workspace());
+  MaskCpu<M> mask_cpu;
+  CHECK(mask_cpu.init(mask, use_scmp, !use_all || use_repl,
+      desc->workspace()));
+  CHECK(w->gpuToCpu());
+
+  W* w_val = w->h_val_;
+  Index w_nvals = w->nvals_;
+  if (use_all && mask_cpu.indexed() && !use_repl) {
+    threadPool().parallelFor(0, mask_cpu.nindex(), [&](Index begin,
+        Index end) {
+      for (Index k = begin; k < end; ++k)
+        out.write(w_val + mask_cpu.index(k), val);
+    }, 4096);
+  } else if (use_all || use_repl) {
+    threadPool().parallelFor(0, w_nvals, [&](Index begin, Index end) {
+      for (Index i = begin; i < end; ++i) {
+        if (!mask_cpu.allowed(i)) {
+          if (use_repl)
+            w_val[i] = static_cast<W>(0);
+        } else if (use_all) {
+          out.write(w_val + i, val);
+        }
+      }
+    }, 4096);
+  }
+
+  // Indices may repeat, which would race under accum, so one thread
+  if (!use_all) {
+    for (Index k = 0; k < nindices; ++k) {
+      Index i = (*indices)[k];
+      if (i < w_nvals && mask_cpu.allowed(i))
+        out.write(w_val + i, val);
+    }
+  }
+
+  CHECK(w->cpuToGpu());
+  w->need_update_ = false;
+  return GrB_SUCCESS;
+}
+
 template <typename W, typename T, typename M,
           typename BinaryOpT>
 Info assignDense(DenseVector<W>*           w,
@@ -23,12 +85,12 @@ Info assignDense(DenseVector<W>*           w,
   CHECK(desc->get(GrB_MASK, &scmp_mode));
   CHECK(desc->get(GrB_OUTP, &repl_mode));
 
-  // TODO(@ctcyang): add accum and replace support
+  // TODO: add accum and replace support to GPU path
   // -have masked variants as separate kernel
   // -accum and replace as parts in flow
   // -no need to copy indices from cpuToGpu if user selected all indices
   bool use_mask = (mask != NULL);
-  bool use_accum= (accum != NULL);
+  bool use_accum= AccumTraits<BinaryOpT>::enabled;
   bool use_all  = (indices == NULL);
   bool use_scmp = (scmp_mode == GrB_SCMP);
   bool use_repl = (repl_mode == GrB_REPLACE);
@@ -38,6 +100,12 @@ Info assignDense(DenseVector<W>*           w,
     printState(use_mask, use_accum, use_scmp, use_repl, false);
   }
 
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+  if (backend == GrB_SEQUENTIAL)
+    return assignDenseCpu(w, mask, accum, val, indices, nindices, use_scmp,
+        use_repl, desc);
+
   Index* indices_t = NULL;
   if (!use_all && nindices > 0) {
     desc->resize(nindices*sizeof(Index), "buffer");
@@ -104,6 +172,85 @@ Info assignDense(DenseVector<W>*           w,
   return GrB_SUCCESS;
 }
 
+/*!
+ * \brief Scatter w[indices] = w[indices] + u of dense w and u
+ *
+ * u[k] goes to w[indices[k]] for k < nindices, and entries of w not in
+ * indices keep their value. Indices may repeat, in which case accum combines
+ * all of them (with atomics on both paths), and without accum any one of them
+ * wins. Indices past end of w are skipped. CPU path reads h_indices, while GPU
+ * path reads d_indices, or copies h_indices to device buffer if none is given.
+ * w must not alias u or indices
+ */
+template <typename W, typename U,
+          typename BinaryOpT>
+Info assignDenseVector(DenseVector<W>*       w,
+                       BinaryOpT             accum,
+                       const DenseVector<U>* u,
+                       const Index*          h_indices,
+                       const Index*          d_indices,
+                       Index                 nindices,
+                       Descriptor*           desc) {
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
+  if (desc->debug()) {
+    std::cout << "Executing assignDenseVector\n";
+    printState(false, use_accum, false, false, false);
+  }
+
+  Index w_nvals = w->nvals_;
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+  if (backend == GrB_SEQUENTIAL) {
+    OutputCpu<W, BinaryOpT> out(accum, false, static_cast<W>(0));
+    CHECK(const_cast<DenseVector<U>*>(u)->gpuToCpu());
+    CHECK(w->gpuToCpu());
+
+    W*       w_val = w->h_val_;
+    const U* u_val = u->h_val_;
+    threadPool().parallelFor(0, nindices, [&](Index begin, Index end) {
+      for (Index k = begin; k < end; ++k) {
+        Index ind = h_indices[k];
+        if (ind >= 0 && ind < w_nvals)
+          out.writeAtomic(w_val + ind, u_val[k]);
+      }
+    }, 4096);
+
+    CHECK(w->cpuToGpu());
+    w->need_update_ = false;
+    return GrB_SUCCESS;
+  }
+
+  if (d_indices == NULL && nindices > 0) {
+    CHECK(desc->resize(nindices*sizeof(Index), "buffer"));
+    Index* indices_t = reinterpret_cast<Index*>(desc->d_buffer_);
+    CUDA_CALL(cudaMemcpy(indices_t, h_indices, nindices*sizeof(Index),
+        cudaMemcpyHostToDevice));
+    d_indices = indices_t;
+  }
+
+  // Get descriptor parameters for nthreads
+  Desc_value nt_mode;
+  CHECK(desc->get(GrB_NT, &nt_mode));
+  const int nt = static_cast<int>(nt_mode);
+  dim3 NT, NB;
+  NT.x = nt;
+  NT.y = 1;
+  NT.z = 1;
+  NB.x = (nindices+nt-1)/nt;
+  NB.y = 1;
+  NB.z = 1;
+
+  if (nindices > 0)
+    assignDenseVectorKernel<AccumTraits<BinaryOpT>::enabled><<<NB, NT>>>(
+        w->d_val_, w_nvals, AccumOrSecond<W, BinaryOpT>::get(accum),
+        u->d_val_, d_indices, nindices);
+
+  if (desc->debug())
+    printDevice("w_val", w->d_val_, w_nvals);
+  w->need_update_ = true;
+  return GrB_SUCCESS;
+}
+
 template <typename W, typename T, typename M,
           typename BinaryOpT>
 Info assignSparse(SparseVector<W>*          w,
@@ -118,14 +265,13 @@ Info assignSparse(SparseVector<W>*          w,
   CHECK(desc->get(GrB_MASK, &scmp_mode));
   CHECK(desc->get(GrB_OUTP, &repl_mode));
 
-  std::string accum_type = typeid(accum).name();
   // TODO(@ctcyang): add accum and replace support
   // -have masked variants as separate kernel
   // -accum and replace as parts in flow
   // -special case of inverting GrB_SCMP since we are using it to zero out
   // values in GrB_assign instead of passing them through
   bool use_mask  = (mask != NULL);
-  bool use_accum = (accum_type.size() > 1);
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
   bool use_scmp  = (scmp_mode == GrB_SCMP);
   bool use_allowdupl;
 
@@ -214,7 +360,7 @@ Info assignSparse(SparseVector<W>*          w,
 	mgpu::ScanPrealloc<mgpu::MgpuScanTypeExc>(d_flag, w_nvals, (Index)0,
 			mgpu::plus<Index>(),  // NOLINT(build/include_what_you_use)
 			reinterpret_cast<Index*>(0), &temp_nvals, d_scan,
-			d_temp, *(desc->d_context_));
+			d_temp, desc->context());
 
 	if (desc->debug()) {
 		printDevice("d_flag", d_flag, w_nvals);
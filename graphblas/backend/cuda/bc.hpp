@@ -0,0 +1,336 @@
+#ifndef GRAPHBLAS_BACKEND_CUDA_BC_HPP_
+#define GRAPHBLAS_BACKEND_CUDA_BC_HPP_
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+#include <vector>
+
+namespace graphblas {
+namespace backend {
+
+// Most sources advanced together, one per bit of a frontier word
+const Index kBcBatch = 64;
+
+// Sparse frontier of one BFS level: ind[j] was first reached at this level
+// from the sources in bits of bits[j]
+struct BcLevel {
+  std::vector<Index>    ind;
+  std::vector<uint64_t> bits;
+};
+
+inline BcLevel bcConcat(BcLevel x, const BcLevel& y) {
+  x.ind.insert(x.ind.end(), y.ind.begin(), y.ind.end());
+  x.bits.insert(x.bits.end(), y.bits.begin(), y.bits.end());
+  return x;
+}
+
+inline void bcAtomicAdd(double* out, double val) {
+  double expected, desired;
+  __atomic_load(out, &expected, __ATOMIC_RELAXED);
+  do {
+    desired = expected + val;
+  } while (!__atomic_compare_exchange(out, &expected, &desired, true,
+      __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+/*!
+ * \brief Number of sources run per batch, from memory left to use
+ *
+ * Each source needs a row of path counts and dependencies (2 doubles per
+ * vertex) and, over all levels, at most one frontier entry per vertex. Each
+ * batch also needs three frontier words per vertex. Half of free_bytes is
+ * given to batch, and result is within [1, min(kBcBatch, nsources)]
+ */
+inline Index bcBatchWidth(Index  nrows,
+                          Index  nsources,
+                          size_t free_bytes) {
+  size_t fixed      = 3*sizeof(uint64_t)*static_cast<size_t>(nrows);
+  size_t per_source = (2*sizeof(double) + sizeof(Index) + sizeof(uint64_t))*
+      static_cast<size_t>(std::max<Index>(nrows, 1));
+  size_t budget = free_bytes/2;
+  size_t width  = (budget > fixed) ? (budget - fixed)/per_source : 0;
+  width = std::min(width, static_cast<size_t>(std::min(kBcBatch, nsources)));
+  return std::max(static_cast<Index>(width), static_cast<Index>(1));
+}
+
+// Free host memory in bytes
+inline size_t bcFreeBytes() {
+  long pages     = sysconf(_SC_AVPHYS_PAGES);
+  long page_size = sysconf(_SC_PAGESIZE);
+  if (pages <= 0 || page_size <= 0)
+    return 0;
+  return static_cast<size_t>(pages)*static_cast<size_t>(page_size);
+}
+
+/*!
+ * \brief Brandes BC from k <= kBcBatch sources at once, added to bc
+ *
+ * Path counts of the batch form n x k block sigma (row-major). Forward sweep
+ * is masked SpMM with plus-times semiring on sparse frontier F of each level:
+ *   F_(l+1) = !seen .* (F_l A)     sigma += F_(l+1)
+ * where F_l only has rows of vertices first reached at level l, along with
+ * which sources reached them, and is kept for backward sweep. F_l A is pushed
+ * along out-edges of F_l while it has at most switchpoint*n rows, and pulled
+ * through in-edges (if there are any) otherwise. Backward sweep goes through
+ * stored levels from deepest up, and every vertex v of level l gathers
+ *   delta(v, s) = \sum_w sigma(v, s)/sigma(w, s) * (1 + delta(w, s))
+ * over out-neighbours w found at level l+1 from same source s.
+ */
+template <typename T>
+Info bcBatch(T*           bc,
+             const Index* sources,
+             Index        k,
+             Index        nrows,
+             float        switchpoint,
+             const Index* out_ptr,
+             const Index* out_ind,
+             const Index* in_ptr,
+             const Index* in_ind,
+             double*      sigma,
+             double*      delta,
+             uint64_t*    seen,
+             uint64_t*    cur,
+             uint64_t*    next) {
+  uint64_t all = (k == kBcBatch) ? ~static_cast<uint64_t>(0) :
+      (static_cast<uint64_t>(1) << k) - 1;
+
+  threadPool().parallelFor(0, nrows, [&](Index begin, Index end) {
+    std::fill(sigma + static_cast<size_t>(begin)*k,
+              sigma + static_cast<size_t>(end)*k, 0.);
+    std::fill(delta + static_cast<size_t>(begin)*k,
+              delta + static_cast<size_t>(end)*k, 0.);
+    std::fill(seen + begin, seen + end, 0);
+    std::fill(cur  + begin, cur  + end, 0);
+    std::fill(next + begin, next + end, 0);
+  }, 4096);
+
+  // Level 0 holds sources, once each even if several sources share a vertex
+  std::vector<BcLevel> levels(1);
+  for (Index i = 0; i < k; ++i) {
+    Index source = sources[i];
+    if (seen[source] == 0)
+      levels[0].ind.push_back(source);
+    seen[source] |= static_cast<uint64_t>(1) << i;
+    sigma[static_cast<size_t>(source)*k + i] = 1.;
+  }
+  for (Index source : levels[0].ind)
+    levels[0].bits.push_back(seen[source]);
+
+  while (true) {
+    const BcLevel& frontier = levels.back();
+    Index nfrontier = frontier.ind.size();
+    bool  use_push  = (in_ptr == NULL || nfrontier <= switchpoint*nrows);
+
+    BcLevel found;
+    if (use_push) {
+      // seen is only read here, and rows of sigma only get sources that have
+      // not reached them, which no frontier row reads
+      found = threadPool().parallelReduce(0, nfrontier, BcLevel(),
+          [&](Index begin, Index end) {
+        BcLevel found;
+        for (Index j = begin; j < end; ++j) {
+          Index         row = frontier.ind[j];
+          uint64_t      bits = frontier.bits[j];
+          const double* in  = sigma + static_cast<size_t>(row)*k;
+          for (Index edge = out_ptr[row]; edge < out_ptr[row+1]; ++edge) {
+            Index    col = out_ind[edge];
+            uint64_t add = bits & ~seen[col];
+            if (add == 0)
+              continue;
+            double* out = sigma + static_cast<size_t>(col)*k;
+            for (uint64_t left = add; left != 0; left &= left - 1) {
+              Index s = __builtin_ctzll(left);
+              bcAtomicAdd(out + s, in[s]);
+            }
+            if (__atomic_fetch_or(next + col, add, __ATOMIC_RELAXED) == 0)
+              found.ind.push_back(col);
+          }
+        }
+        return found;
+      }, bcConcat, 64);
+
+      found.bits.resize(found.ind.size());
+      threadPool().parallelFor(0, found.ind.size(), [&](Index begin,
+          Index end) {
+        for (Index j = begin; j < end; ++j) {
+          Index col     = found.ind[j];
+          found.bits[j] = next[col];
+          seen[col]    |= next[col];
+          next[col]     = 0;
+        }
+      }, 4096);
+    } else {
+      threadPool().parallelFor(0, nfrontier, [&](Index begin, Index end) {
+        for (Index j = begin; j < end; ++j)
+          cur[frontier.ind[j]] = frontier.bits[j];
+      }, 4096);
+
+      // Each vertex only writes its own row of sigma and word of seen
+      found = threadPool().parallelReduce(0, nrows, BcLevel(),
+          [&](Index begin, Index end) {
+        BcLevel found;
+        for (Index col = begin; col < end; ++col) {
+          if (seen[col] == all)
+            continue;
+          uint64_t bits = 0;
+          double*  out  = sigma + static_cast<size_t>(col)*k;
+          for (Index edge = in_ptr[col]; edge < in_ptr[col+1]; ++edge) {
+            Index    row = in_ind[edge];
+            uint64_t add = cur[row] & ~seen[col];
+            if (add == 0)
+              continue;
+            const double* in = sigma + static_cast<size_t>(row)*k;
+            for (uint64_t left = add; left != 0; left &= left - 1) {
+              Index s = __builtin_ctzll(left);
+              out[s] += in[s];
+            }
+            bits |= add;
+          }
+          if (bits != 0) {
+            seen[col] |= bits;
+            found.ind.push_back(col);
+            found.bits.push_back(bits);
+          }
+        }
+        return found;
+      }, bcConcat, 1024);
+
+      threadPool().parallelFor(0, nfrontier, [&](Index begin, Index end) {
+        for (Index j = begin; j < end; ++j)
+          cur[frontier.ind[j]] = 0;
+      }, 4096);
+    }
+
+    if (found.ind.empty())
+      break;
+    levels.push_back(std::move(found));
+  }
+
+  // Sources themselves get no dependency, so level 0 is skipped
+  for (Index l = static_cast<Index>(levels.size()) - 2; l >= 1; --l) {
+    const BcLevel& frontier  = levels[l];
+    const BcLevel& successor = levels[l+1];
+    threadPool().parallelFor(0, successor.ind.size(), [&](Index begin,
+        Index end) {
+      for (Index j = begin; j < end; ++j)
+        cur[successor.ind[j]] = successor.bits[j];
+    }, 4096);
+
+    // Vertex of level l only writes its own entries of delta, and only reads
+    // those of level l+1
+    threadPool().parallelFor(0, frontier.ind.size(), [&](Index begin,
+        Index end) {
+      for (Index j = begin; j < end; ++j) {
+        Index         row  = frontier.ind[j];
+        uint64_t      bits = frontier.bits[j];
+        const double* sv   = sigma + static_cast<size_t>(row)*k;
+        double*       dv   = delta + static_cast<size_t>(row)*k;
+        for (Index edge = out_ptr[row]; edge < out_ptr[row+1]; ++edge) {
+          Index    col = out_ind[edge];
+          uint64_t add = bits & cur[col];
+          const double* sw = sigma + static_cast<size_t>(col)*k;
+          const double* dw = delta + static_cast<size_t>(col)*k;
+          for (uint64_t left = add; left != 0; left &= left - 1) {
+            Index s = __builtin_ctzll(left);
+            dv[s] += sv[s]/sw[s]*(1. + dw[s]);
+          }
+        }
+      }
+    }, 64);
+
+    threadPool().parallelFor(0, successor.ind.size(), [&](Index begin,
+        Index end) {
+      for (Index j = begin; j < end; ++j)
+        cur[successor.ind[j]] = 0;
+    }, 4096);
+  }
+
+  threadPool().parallelFor(0, nrows, [&](Index begin, Index end) {
+    for (Index row = begin; row < end; ++row) {
+      const double* dv = delta + static_cast<size_t>(row)*k;
+      double sum = 0.;
+      for (Index s = 0; s < k; ++s)
+        sum += dv[s];
+      bc[row] += static_cast<T>(sum);
+    }
+  }, 4096);
+  return GrB_SUCCESS;
+}
+
+/*!
+ * \brief CPU Brandes betweenness centrality from sources[0, nsources)
+ *
+ * bc[v] (nrows elements) is set to sum over sources s of dependency of s on
+ * v, i.e. of fraction of shortest paths from s through v. Sources are run
+ * bcBatchWidth() at a time, which shrinks batch when free memory is short.
+ * Paths go along A, or A^T under GrB_TRAN, same as vxm.
+ */
+template <typename T, typename a>
+Info bcCpu(T*                     bc,
+           const Index*           sources,
+           Index                  nsources,
+           const SparseMatrix<a>* A,
+           Descriptor*            desc) {
+  Desc_value inp1_mode;
+  CHECK(desc->get(GrB_INP1, &inp1_mode));
+
+  SparseMatrixFormat A_format;
+  bool A_symmetric;
+  CHECK(A->getFormat(&A_format));
+  CHECK(A->getSymmetry(&A_symmetric));
+
+  // Forward sweep pushes along out-edges and pulls through in-edges, which
+  // are only there with CSC, symmetric A or GrB_TRAN. Backward sweep gathers
+  // along out-edges
+  bool use_tran = (inp1_mode == GrB_TRAN);
+  bool has_csc  = (A_format == GrB_SPARSE_MATRIX_CSRCSC);
+  const Index* A_csrRowPtr = A->h_csrRowPtr_;
+  const Index* A_csrColInd = A->h_csrColInd_;
+  const Index* A_cscColPtr = (A_symmetric) ? A->h_csrRowPtr_ : A->h_cscColPtr_;
+  const Index* A_cscRowInd = (A_symmetric) ? A->h_csrColInd_ : A->h_cscRowInd_;
+  bool has_in = (A_symmetric || use_tran || has_csc);
+  // BC along A^T needs CSC of A
+  if (use_tran && !(A_symmetric || has_csc))
+    return GrB_INVALID_OBJECT;
+
+  CHECK(const_cast<SparseMatrix<a>*>(A)->gpuToCpu());
+
+  const Index* out_ptr = (use_tran) ? A_cscColPtr : A_csrRowPtr;
+  const Index* out_ind = (use_tran) ? A_cscRowInd : A_csrColInd;
+  const Index* in_ptr  = NULL;
+  const Index* in_ind  = NULL;
+  if (has_in) {
+    in_ptr = (use_tran) ? A_csrRowPtr : A_cscColPtr;
+    in_ind = (use_tran) ? A_csrColInd : A_cscRowInd;
+  }
+
+  Index nrows = A->nrows_;
+  Index width = bcBatchWidth(nrows, nsources, bcFreeBytes());
+  if (desc->debug())
+    std::cout << "BC batch width: " << width << std::endl;
+
+  WorkspaceScope scope(desc->workspace());
+  size_t    nblock = static_cast<size_t>(nrows)*width;
+  double*   sigma  = desc->workspace()->allocate<double>(nblock);
+  double*   delta  = desc->workspace()->allocate<double>(nblock);
+  uint64_t* seen   = desc->workspace()->allocate<uint64_t>(nrows);
+  uint64_t* cur    = desc->workspace()->allocate<uint64_t>(nrows);
+  uint64_t* next   = desc->workspace()->allocate<uint64_t>(nrows);
+
+  std::fill(bc, bc + nrows, static_cast<T>(0));
+  for (Index start = 0; start < nsources; start += width) {
+    Index batch = std::min(width, nsources - start);
+    if (desc->debug())
+      std::cout << "BC sources " << start << ":" << start + batch << std::endl;
+    CHECK(bcBatch(bc, sources + start, batch, nrows, desc->switchpoint(),
+        out_ptr, out_ind, in_ptr, in_ind, sigma, delta, seen, cur, next));
+  }
+  return GrB_SUCCESS;
+}
+}  // namespace backend
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_BACKEND_CUDA_BC_HPP_
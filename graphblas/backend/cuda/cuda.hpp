@@ -3,8 +3,11 @@
 
 #include "graphblas/backend/cuda/types.hpp"
 #include "graphblas/backend/cuda/util.hpp"
+#include "graphblas/backend/cuda/memory.hpp"
+#include "graphblas/backend/cuda/workspace.hpp"
 #include "graphblas/backend/cuda/vector.hpp"
 #include "graphblas/backend/cuda/matrix.hpp"
+#include "graphblas/backend/cuda/mask.hpp"
 #include "graphblas/backend/cuda/transpose.hpp"
 #include "graphblas/backend/cuda/color.hpp"
 #include "graphblas/backend/cuda/spgemm.hpp"
@@ -20,7 +23,13 @@
 #include "graphblas/backend/cuda/ewiseadd.hpp"
 #include "graphblas/backend/cuda/trace.hpp"
 #include "graphblas/backend/cuda/assign.hpp"
+#include "graphblas/backend/cuda/extract.hpp"
 #include "graphblas/backend/cuda/apply.hpp"
+#include "graphblas/backend/cuda/select.hpp"
+#include "graphblas/backend/cuda/traverse.hpp"
+#include "graphblas/backend/cuda/msbfs.hpp"
+#include "graphblas/backend/cuda/ppr.hpp"
+#include "graphblas/backend/cuda/bc.hpp"
 #include "graphblas/backend/cuda/descriptor.hpp"
 #include "graphblas/backend/cuda/sparse_vector.hpp"
 #include "graphblas/backend/cuda/dense_vector.hpp"
@@ -0,0 +1,227 @@
+#ifndef GRAPHBLAS_BACKEND_CUDA_DELTA_BUFFER_HPP_
+#define GRAPHBLAS_BACKEND_CUDA_DELTA_BUFFER_HPP_
+
+#include <vector>
+#include <map>
+#include <utility>
+#include <algorithm>
+
+namespace graphblas {
+namespace backend {
+
+/*!
+ * \brief Sorted buffer of pending element insertions and deletions of a
+ *        SparseMatrix
+ *
+ * Updates are kept in an ordered map keyed by (row, col) with at most one
+ * update per element, so adding one costs O(log ndelta) however large the
+ * buffer has grown. When the same element is updated more than once, the last
+ * update wins. Kernels read updates as flat arrays sorted by (row, col), or
+ * by (col, row) to merge with CSC, which are rebuilt only after the buffer
+ * has changed, so a row of updates can be merged with the same row of CSR in
+ * a single pass.
+ */
+template <typename T>
+class DeltaBuffer {
+ public:
+  struct Update {
+    Index row;
+    Index col;
+    T     val;
+    bool  remove;  // true: delete element, false: insert or overwrite
+  };
+
+  DeltaBuffer() : row_valid_(true), col_valid_(true) {}
+
+  // Adds update to (row, col), replacing earlier one. Returns whether there
+  // was an earlier update, and if so whether it was a deletion
+  bool set(Index row, Index col, T val, bool remove, bool* prev_remove);
+  Info clear();
+
+  inline Index size()  const { return updates_.size(); }
+  inline bool  empty() const { return updates_.empty(); }
+
+  // Flat array of updates sorted by (row, col), or by (col, row) if
+  // transposed. Not thread-safe, so call before any parallel loop reading it
+  const Update* sorted(bool transposed) const;
+  // Returns range [begin, end) of updates to row (col if transposed) in
+  // sorted(transposed)
+  void range(Index major, bool transposed, Index* begin, Index* end) const;
+  // Returns update to (row, col) or NULL if there is none
+  const Update* find(Index row, Index col) const;
+
+  // Calls f(ind, val) on each element of sorted base row (ind, val) of length
+  // base_len merged with updates [upd, upd+upd_len) belonging to same row, in
+  // order of ind, until f returns false. Updates are keyed by col (CSR) or
+  // row (CSC, transposed = true)
+  template <typename FuncT>
+  static void forEachMerged(const Index*  base_ind,
+                            const T*      base_val,
+                            Index         base_len,
+                            const Update* upd,
+                            Index         upd_len,
+                            bool          transposed,
+                            FuncT         f);
+  // Writes merged row to (out_ind, out_val) and returns its length. If
+  // out_ind is NULL, only the length is computed
+  static Index mergeRow(const Index*  base_ind,
+                        const T*      base_val,
+                        Index         base_len,
+                        const Update* upd,
+                        Index         upd_len,
+                        bool          transposed,
+                        Index*        out_ind,
+                        T*            out_val);
+
+ private:
+  static bool lessRowMajor(const Update& lhs, const Update& rhs) {
+    return lhs.row < rhs.row || (lhs.row == rhs.row && lhs.col < rhs.col);
+  }
+  static bool lessColMajor(const Update& lhs, const Update& rhs) {
+    return lhs.col < rhs.col || (lhs.col == rhs.col && lhs.row < rhs.row);
+  }
+
+ private:
+  std::map<std::pair<Index, Index>, Update> updates_;
+
+  // Flat copies of updates_, rebuilt on demand
+  mutable std::vector<Update> row_major_;
+  mutable std::vector<Update> col_major_;
+  mutable bool                row_valid_;
+  mutable bool                col_valid_;
+};
+
+template <typename T>
+bool DeltaBuffer<T>::set(Index row,
+                         Index col,
+                         T     val,
+                         bool  remove,
+                         bool* prev_remove) {
+  Update update = {row, col, remove ? static_cast<T>(0) : val, remove};
+  std::pair<typename std::map<std::pair<Index, Index>, Update>::iterator,
+      bool> it = updates_.insert(std::make_pair(std::make_pair(row, col),
+      update));
+  bool found = !it.second;
+  if (found) {
+    *prev_remove = it.first->second.remove;
+    it.first->second = update;
+  }
+  row_valid_ = false;
+  col_valid_ = false;
+  return found;
+}
+
+template <typename T>
+Info DeltaBuffer<T>::clear() {
+  updates_.clear();
+  row_major_.clear();
+  col_major_.clear();
+  row_valid_ = true;
+  col_valid_ = true;
+  return GrB_SUCCESS;
+}
+
+template <typename T>
+const typename DeltaBuffer<T>::Update* DeltaBuffer<T>::sorted(
+    bool transposed) const {
+  if (!row_valid_) {
+    row_major_.clear();
+    row_major_.reserve(updates_.size());
+    for (typename std::map<std::pair<Index, Index>, Update>::const_iterator
+        it = updates_.begin(); it != updates_.end(); ++it)
+      row_major_.push_back(it->second);
+    row_valid_ = true;
+  }
+  if (!transposed)
+    return row_major_.empty() ? NULL : &row_major_[0];
+
+  if (!col_valid_) {
+    col_major_ = row_major_;
+    std::sort(col_major_.begin(), col_major_.end(), lessColMajor);
+    col_valid_ = true;
+  }
+  return col_major_.empty() ? NULL : &col_major_[0];
+}
+
+template <typename T>
+void DeltaBuffer<T>::range(Index  major,
+                           bool   transposed,
+                           Index* begin,
+                           Index* end) const {
+  const Update* upd = sorted(transposed);
+  const Update* upd_end = upd + updates_.size();
+  Update first = {major,   0, static_cast<T>(0), false};
+  Update last  = {major+1, 0, static_cast<T>(0), false};
+  if (transposed) {
+    std::swap(first.row, first.col);
+    std::swap(last.row,  last.col);
+  }
+  bool (*less)(const Update&, const Update&) = (transposed) ? lessColMajor :
+      lessRowMajor;
+  *begin = std::lower_bound(upd, upd_end, first, less) - upd;
+  *end   = std::lower_bound(upd + *begin, upd_end, last, less) - upd;
+}
+
+template <typename T>
+const typename DeltaBuffer<T>::Update* DeltaBuffer<T>::find(Index row,
+                                                            Index col) const {
+  typename std::map<std::pair<Index, Index>, Update>::const_iterator it =
+      updates_.find(std::make_pair(row, col));
+  if (it == updates_.end())
+    return NULL;
+  return &it->second;
+}
+
+template <typename T>
+template <typename FuncT>
+void DeltaBuffer<T>::forEachMerged(const Index*  base_ind,
+                                   const T*      base_val,
+                                   Index         base_len,
+                                   const Update* upd,
+                                   Index         upd_len,
+                                   bool          transposed,
+                                   FuncT         f) {
+  Index base = 0, delta = 0;
+  while (base < base_len || delta < upd_len) {
+    Index upd_ind = (delta < upd_len) ?
+        (transposed ? upd[delta].row : upd[delta].col) : 0;
+    if (delta == upd_len || (base < base_len && base_ind[base] < upd_ind)) {
+      if (!f(base_ind[base], base_val[base]))
+        return;
+      base++;
+    } else {
+      // Update replaces base element with same index
+      if (base < base_len && base_ind[base] == upd_ind)
+        base++;
+      if (!upd[delta].remove && !f(upd_ind, upd[delta].val))
+        return;
+      delta++;
+    }
+  }
+}
+
+template <typename T>
+Index DeltaBuffer<T>::mergeRow(const Index*  base_ind,
+                               const T*      base_val,
+                               Index         base_len,
+                               const Update* upd,
+                               Index         upd_len,
+                               bool          transposed,
+                               Index*        out_ind,
+                               T*            out_val) {
+  Index length = 0;
+  forEachMerged(base_ind, base_val, base_len, upd, upd_len, transposed,
+      [&](Index ind, T val) {
+    if (out_ind != NULL) {
+      out_ind[length] = ind;
+      out_val[length] = val;
+    }
+    length++;
+    return true;
+  });
+  return length;
+}
+}  // namespace backend
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_BACKEND_CUDA_DELTA_BUFFER_HPP_
@@ -23,6 +23,15 @@ class DenseMatrix {
       : nrows_(nrows), ncols_(ncols), nvals_(nrows*ncols),
         h_denseVal_(NULL), d_denseVal_(NULL), need_update_(0) {}
 
+  // Move constructor and move assignment are O(1)
+  DenseMatrix(DenseMatrix&& rhs) : DenseMatrix() {
+    swap(&rhs);
+  }
+  DenseMatrix& operator=(DenseMatrix&& rhs) {
+    swap(&rhs);
+    return *this;
+  }
+
   ~DenseMatrix() {}
 
   // C API Methods
@@ -55,10 +64,12 @@ class DenseMatrix {
   Info setNrows(Index nrows);
   Info setNcols(Index ncols);
   Info resize(Index nrows, Index ncols);
+  Info getMemory(MemorySpace space, size_t* bytes) const;
   template <typename U>
   Info fill(Index axis, Index nvals, U start);
   template <typename U>
   Info fillAscending(Index axis, Index nvals, U start);
+  Info swap(DenseMatrix* rhs);
 
  private:
   Info allocate();
@@ -105,8 +116,8 @@ Info DenseMatrix<T>::dup(const DenseMatrix* rhs) {
 
 template <typename T>
 Info DenseMatrix<T>::clear() {
-  if (h_denseVal_) free(h_denseVal_);
-  if (d_denseVal_) CUDA_CALL(cudaFree(d_denseVal_));
+  if (h_denseVal_) hostFree(h_denseVal_);
+  if (d_denseVal_) deviceFree(d_denseVal_);
   return GrB_SUCCESS;
 }
 
@@ -225,6 +236,13 @@ Info DenseMatrix<T>::resize(Index nrows, Index ncols) {
   return GrB_SUCCESS;
 }
 
+template <typename T>
+Info DenseMatrix<T>::getMemory(MemorySpace space, size_t* bytes) const {
+  *bytes = memoryTracker().bytes(
+      (space == GrB_MEMORY_HOST) ? h_denseVal_ : d_denseVal_);
+  return GrB_SUCCESS;
+}
+
 template <typename T>
 template <typename U>
 Info DenseMatrix<T>::fill(Index axis, Index nvals, U start) {
@@ -245,13 +263,13 @@ template <typename T>
 Info DenseMatrix<T>::allocate() {
   // Host alloc
   if (nvals_ != 0 && h_denseVal_ == NULL)
-    h_denseVal_ = reinterpret_cast<T*>(malloc(nvals_*sizeof(T)));
+    CHECK(hostMalloc(&h_denseVal_, nvals_, GrB_MEMORY_MATRIX));
 
   for (Index i = 0; i < nvals_; i++)
     h_denseVal_[i] = (T) 0;
 
   if (nvals_ != 0 && d_denseVal_ == NULL)
-    CUDA_CALL(cudaMalloc(&d_denseVal_, nvals_*sizeof(T)));
+    CHECK(deviceMalloc(&d_denseVal_, nvals_, GrB_MEMORY_MATRIX));
 
   if (h_denseVal_ == NULL || d_denseVal_ == NULL) return GrB_OUT_OF_MEMORY;
 
@@ -300,6 +318,17 @@ Info DenseMatrix<T>::gpuToCpu(bool force_update) {
   need_update_ = false;
   return GrB_SUCCESS;
 }
+
+template <typename T>
+Info DenseMatrix<T>::swap(DenseMatrix* rhs) {  // NOLINT(build/include_what_you_use)
+  std::swap(nrows_,       rhs->nrows_);
+  std::swap(ncols_,       rhs->ncols_);
+  std::swap(nvals_,       rhs->nvals_);
+  std::swap(h_denseVal_,  rhs->h_denseVal_);
+  std::swap(d_denseVal_,  rhs->d_denseVal_);
+  std::swap(need_update_, rhs->need_update_);
+  return GrB_SUCCESS;
+}
 }  // namespace backend
 }  // namespace graphblas
 
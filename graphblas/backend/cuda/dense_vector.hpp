@@ -29,6 +29,16 @@ class DenseVector {
     allocate();
   }
 
+  // Move constructor and move assignment are O(1). Moved-from vector is left
+  // holding this vector's old contents, which it frees on destruction
+  DenseVector(DenseVector&& rhs) : DenseVector() {
+    swap(&rhs);
+  }
+  DenseVector& operator=(DenseVector&& rhs) {
+    swap(&rhs);
+    return *this;
+  }
+
   // Need to write Default Destructor
   ~DenseVector();
 
@@ -70,6 +80,11 @@ class DenseVector {
   Info cpuToGpu();
   Info gpuToCpu(bool force_update = false);
   Info swap(DenseVector* rhs);
+  Info unshare();
+
+ private:
+  Info copy(const DenseVector* rhs);
+  int  arrays(const void** ptrs) const;
 
  private:
   // Note nsize_ is understood to be the same as nvals_, so it is omitted
@@ -85,8 +100,8 @@ class DenseVector {
 
 template <typename T>
 DenseVector<T>::~DenseVector() {
-  if (h_val_ != NULL) free(h_val_);
-  if (d_val_ != NULL) CUDA_CALL(cudaFree(d_val_));
+  if (h_val_ != NULL) hostFree(h_val_);
+  if (d_val_ != NULL) deviceFree(d_val_);
 }
 
 template <typename T>
@@ -96,9 +111,34 @@ Info DenseVector<T>::nnew(Index nsize) {
   return GrB_SUCCESS;
 }
 
+// Shares arrays of rhs rather than copying them. Whichever of the two is
+// written to first makes its own copy (see unshare())
 template <typename T>
 Info DenseVector<T>::dup(const DenseVector* rhs) {
+  if (rhs == this)
+    return GrB_SUCCESS;
+
+  // Falls back to deep copy if rhs holds memory we do not own
+  const void* ptrs[2];
+  if (!memoryTracker().retain(ptrs, rhs->arrays(ptrs))) {
+    CHECK(unshare());
+    return copy(rhs);
+  }
+
+  if (h_val_ != NULL) hostFree(h_val_);
+  if (d_val_ != NULL) deviceFree(d_val_);
+  nvals_       = rhs->nvals_;
+  nnz_         = rhs->nnz_;
+  h_val_       = rhs->h_val_;
+  d_val_       = rhs->d_val_;
+  need_update_ = rhs->need_update_;
+  return GrB_SUCCESS;
+}
+
+template <typename T>
+Info DenseVector<T>::copy(const DenseVector* rhs) {
   nvals_ = rhs->nvals_;
+  nnz_   = rhs->nnz_;
 
   if (d_val_ == NULL || h_val_ == NULL)
     CHECK(allocate());
@@ -203,6 +243,7 @@ Info DenseVector<T>::build(const std::vector<T>* values,
     return GrB_INDEX_OUT_OF_BOUNDS;
   if (d_val_ == NULL || h_val_ == NULL)
     return GrB_UNINITIALIZED_OBJECT;
+  CHECK(unshare());
 
   for (Index i = 0; i < nvals; i++)
     h_val_[i] = (*values)[i];
@@ -225,6 +266,7 @@ Info DenseVector<T>::build(T*    values,
 
 template <typename T>
 Info DenseVector<T>::setElement(T val, Index index) {
+  CHECK(unshare());
   CHECK(gpuToCpu());
   h_val_[index] = val;
   CHECK(cpuToGpu());
@@ -292,24 +334,25 @@ Info DenseVector<T>::resize(Index nsize) {
   Index to_copy = std::min(nsize, nvals_);
 
   nvals_ = nsize;
-  h_val_ = reinterpret_cast<T*>(malloc(nvals_*sizeof(T)));
+  CHECK(hostMalloc(&h_val_, nvals_, GrB_MEMORY_VECTOR));
   if (h_tempVal != NULL)
     memcpy(h_val_, h_tempVal, to_copy*sizeof(T));
 
-  CUDA_CALL(cudaMalloc(&d_val_, nvals_*sizeof(T)));
+  CHECK(deviceMalloc(&d_val_, nvals_, GrB_MEMORY_VECTOR));
   if (d_tempVal != NULL)
     CUDA_CALL(cudaMemcpy(d_val_, d_tempVal, to_copy*sizeof(T),
         cudaMemcpyDeviceToDevice));
   nvals_ = nsize;
 
-  free(h_tempVal);
-  CUDA_CALL(cudaFree(d_tempVal));
+  if (h_tempVal != NULL) hostFree(h_tempVal);
+  if (d_tempVal != NULL) deviceFree(d_tempVal);
 
   return GrB_SUCCESS;
 }
 
 template <typename T>
 Info DenseVector<T>::fill(T val) {
+  CHECK(unshare());
   for (Index i = 0; i < nvals_; i++ )
     h_val_[i] = val;
 
@@ -319,6 +362,7 @@ Info DenseVector<T>::fill(T val) {
 
 template <typename T>
 Info DenseVector<T>::fillAscending(Index nvals) {
+  CHECK(unshare());
   for (Index i = 0; i < nvals_; i++)
     h_val_[i] = i;
 
@@ -352,7 +396,7 @@ template <typename T>
 Info DenseVector<T>::allocateCpu() {
   // Host malloc
   if (nvals_ > 0 && h_val_ == NULL) {
-    h_val_ = reinterpret_cast<T*>(malloc(nvals_*sizeof(T)));
+    CHECK(hostMalloc(&h_val_, nvals_, GrB_MEMORY_VECTOR));
   } else {
     // std::cout << "Error: DeVec Host allocation unsuccessful!\n";
   }
@@ -369,7 +413,7 @@ template <typename T>
 Info DenseVector<T>::allocateGpu() {
   // GPU malloc
   if (nvals_ > 0 && d_val_ == NULL) {
-    CUDA_CALL(cudaMalloc(&d_val_, nvals_*sizeof(T)));
+    CHECK(deviceMalloc(&d_val_, nvals_, GrB_MEMORY_VECTOR));
     printMemory("DeVec");
   } else {
     // std::cout << "Error: DeVec Device allocation unsuccessful!\n";
@@ -413,8 +457,11 @@ template <typename T>
 Info DenseVector<T>::swap(DenseVector* rhs) {  // NOLINT(build/include_what_you_use)
   // Change member scalars
   Index temp_nvals = nvals_;
+  Index temp_nnz   = nnz_;
   nvals_ = rhs->nvals_;
+  nnz_   = rhs->nnz_;
   rhs->nvals_ = temp_nvals;
+  rhs->nnz_   = temp_nnz;
 
   // Change CPU pointers
   T*     temp_val_  = h_val_;
@@ -432,6 +479,28 @@ Info DenseVector<T>::swap(DenseVector* rhs) {  // NOLINT(build/include_what_you_
 
   return GrB_SUCCESS;
 }
+
+// Gives this vector its own copy of arrays it shares with a dup. Must be
+// called before writing to h_val_ or d_val_
+template <typename T>
+Info DenseVector<T>::unshare() {
+  const void* ptrs[2];
+  if (!memoryTracker().shared(ptrs, arrays(ptrs)))
+    return GrB_SUCCESS;
+
+  DenseVector<T> temp;
+  CHECK(temp.copy(this));
+  CHECK(swap(&temp));
+  return GrB_SUCCESS;
+}
+
+// Arrays owned by this vector i.e. freed by its destructor
+template <typename T>
+int DenseVector<T>::arrays(const void** ptrs) const {
+  ptrs[0] = h_val_;
+  ptrs[1] = d_val_;
+  return 2;
+}
 }  // namespace backend
 }  // namespace graphblas
 
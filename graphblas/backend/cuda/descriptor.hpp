@@ -6,29 +6,57 @@
 #include <vector>
 #include <string>
 
+#include "graphblas/thread_pool.hpp"
+#include "graphblas/tune_profile.hpp"
 #include "graphblas/backend/cuda/util.hpp"
+#include "graphblas/backend/cuda/memory.hpp"
+#include "graphblas/backend/cuda/workspace.hpp"
 
 namespace graphblas {
 namespace backend {
 
+/*!
+ * \brief Settings and scratch memory used by every operation
+ *
+ * Construction and copying do no device work, so a Descriptor can be made
+ * per query on the CPU (GrB_SEQUENTIAL) path. mgpu context and device
+ * buffers are only created when a GPU code path first asks for them, via
+ * context() and resize(). A copy gets settings of its source, but its own
+ * (empty) buffers.
+ *
+ * Settings come from typed setters below, or from loadArgs, which reads them
+ * from command line options. To avoid parsing these per query, loadArgs once
+ * into one Descriptor and copy it.
+ */
 class Descriptor {
  public:
+  // Initial size of device buffers, which are grown by resize() as needed
+  static const size_t kBufferSize = 183551;
+
   // Descriptions of these default settings are in "graphblas/types.hpp"
   Descriptor() : desc_{ GrB_DEFAULT, GrB_DEFAULT, GrB_DEFAULT, GrB_DEFAULT,
-    GrB_FIXEDROW, GrB_32, GrB_32, GrB_128, GrB_PUSHPULL, GrB_16, GrB_CUDA},
-    d_context_(mgpu::CreateCudaDevice(0)), ta_(0), tb_(0), mode_(""), split_(0),
+    GrB_FIXEDROW, GrB_32, GrB_32, GrB_128, GrB_PUSHPULL, GrB_16, GrB_CUDA,
+    GrB_BLOCKING},
+    d_buffer_(NULL), d_buffer_size_(0), d_temp_(NULL), d_temp_size_(0),
+    ta_(0), tb_(0), mode_(""), split_(0),
     enable_split_(0), niter_(0), max_niter_(0), directed_(0), timing_(0),
     transpose_(0), mtxinfo_(0), verbose_(0), mxvmode_(0), switchpoint_(0),
     lastmxv_(GrB_PUSHONLY), dirinfo_(0), struconly_(0), opreuse_(0),
-    memusage_(0), endbit_(0), sort_(0), atomic_(0), earlyexit_(0),
-    fusedmask_(0), nthread_(0), ndevice_(0), debug_(0), memory_(0) {
-    // Preallocate d_buffer_size
-    d_buffer_size_ = 183551;
-    CUDA_CALL(cudaMalloc(&d_buffer_, d_buffer_size_));
-
-    // Preallocate d_temp_size
-    d_temp_size_ = 183551;
-    CUDA_CALL(cudaMalloc(&d_temp_, d_temp_size_));
+    memusage_(0), lbmode_(getEnv("GRB_LOAD_BALANCE_MODE",
+    GrB_LOAD_BALANCE_MERGE)), endbit_(0), sort_(0), atomic_(0), earlyexit_(0),
+    fusedmask_(0), compactratio_(0.1), autotune_(0), tuned_(0),
+    nonblocking_(0), cputhread_(0),
+    affinity_(0), nthread_(0), ndevice_(0), debug_(0), memory_(0) {}
+
+  Descriptor(const Descriptor& rhs)
+      : d_buffer_(NULL), d_buffer_size_(0), d_temp_(NULL), d_temp_size_(0) {
+    CHECKVOID(copySettings(rhs));
+  }
+
+  Descriptor& operator=(const Descriptor& rhs) {
+    if (this != &rhs)
+      copySettings(rhs);
+    return *this;
   }
 
   // Default Destructor
@@ -41,11 +69,21 @@ class Descriptor {
   // Useful methods
   Info toggle(Desc_field field);
   Info loadArgs(const po::variables_map& vm);
+  // Copies fields and params of rhs, but not its buffers, so that a worker
+  // Descriptor can run operations with the same settings as rhs
+  Info copySettings(const Descriptor& rhs);
+  // Tuned settings, which override the ones from loadArgs
+  Info setProfile(const TuneProfile& profile);
+  TuneProfile getProfile() const;
 
-  // TODO(@ctcyang): make this static so printMemory can use it
   inline bool debug()  { return debug_;  }
   inline bool memory() { return memory_; }
 
+  // Bytes currently and at most allocated by graphblas in memory space for
+  // given category of object (process-wide, not only by this Descriptor)
+  Info getMemory(MemorySpace space, MemoryCategory category,
+                 MemoryStats* stats) const;
+
   // TODO(@ctcyang): use this in lieu of GrB_BOOL detector for now
   inline bool struconly()    { return struconly_; }
   inline bool split()        { return split_ && enable_split_; }
@@ -58,6 +96,53 @@ class Descriptor {
   inline bool atomic()       { return atomic_; }
   inline float switchpoint() { return switchpoint_; }
   inline float memusage()    { return memusage_; }
+  inline LoadBalanceMode lbmode() { return lbmode_; }
+  inline float compactratio() { return compactratio_; }
+  inline int   autotune()     { return autotune_; }
+  inline bool  tuned()        { return tuned_; }
+
+  // Typed setters for settings read by loadArgs, under the same names
+  Info setMxvMode(int mxvmode);
+  Info setNthread(int nthread);
+  Info setNonblocking(bool nonblocking);
+  // Thread pool is shared by all Descriptors, so this resizes it for all
+  Info setCpuThread(int cputhread, bool affinity);
+  inline Info setSwitchpoint(float x) { switchpoint_ = x; return GrB_SUCCESS; }
+  inline Info setMemusage(float x) { memusage_ = x; return GrB_SUCCESS; }
+  Info setLbmode(int lbmode);
+  inline Info setCompactRatio(float x) {
+    compactratio_ = x;
+    return GrB_SUCCESS;
+  }
+  inline Info setDirinfo(bool x) { dirinfo_ = x; return GrB_SUCCESS; }
+  inline Info setStruconly(bool x) { struconly_ = x; return GrB_SUCCESS; }
+  inline Info setOpreuse(bool x) { opreuse_ = x; return GrB_SUCCESS; }
+  inline Info setEndbit(bool x) { endbit_ = x; return GrB_SUCCESS; }
+  inline Info setSort(bool x) { sort_ = x; return GrB_SUCCESS; }
+  inline Info setAtomic(bool x) { atomic_ = x; return GrB_SUCCESS; }
+  inline Info setEarlyexit(bool x) { earlyexit_ = x; return GrB_SUCCESS; }
+  inline Info setFusedmask(bool x) { fusedmask_ = x; return GrB_SUCCESS; }
+  inline Info setAutotune(int x) { autotune_ = x; return GrB_SUCCESS; }
+  inline Info setNiter(int x) { niter_ = x; return GrB_SUCCESS; }
+  inline Info setMaxNiter(int x) { max_niter_ = x; return GrB_SUCCESS; }
+  inline Info setDirected(int x) { directed_ = x; return GrB_SUCCESS; }
+  inline Info setTiming(int x) { timing_ = x; return GrB_SUCCESS; }
+  inline Info setTranspose(bool x) { transpose_ = x; return GrB_SUCCESS; }
+  inline Info setMtxinfo(bool x) { mtxinfo_ = x; return GrB_SUCCESS; }
+  inline Info setVerbose(bool x) { verbose_ = x; return GrB_SUCCESS; }
+  inline Info setDebug(bool x) { debug_ = x; return GrB_SUCCESS; }
+  inline Info setTa(int x) { ta_ = x; return GrB_SUCCESS; }
+  inline Info setTb(int x) { tb_ = x; return GrB_SUCCESS; }
+  inline Info setMode(const std::string& x) { mode_ = x; return GrB_SUCCESS; }
+  inline Info setSplit(bool x) { split_ = x; return GrB_SUCCESS; }
+  inline Info setNdevice(int x) { ndevice_ = x; return GrB_SUCCESS; }
+  Info setMemory(bool memory);
+
+  // mgpu context, created on first use
+  mgpu::CudaContext& context();
+
+  // Host scratch memory for CPU backend
+  inline Workspace* workspace() { return &workspace_; }
 
  private:
   Info resize(size_t target, std::string field);
@@ -72,6 +157,9 @@ class Descriptor {
   void*       d_temp_;        // Used for CUB calls
   size_t      d_temp_size_;
 
+  // CPU workspace memory
+  Workspace   workspace_;
+
   // MGPU context
   mgpu::ContextPtr d_context_;
 
@@ -101,6 +189,7 @@ class Descriptor {
 
   // mxv (spmspv/push) params
   float       memusage_;
+  LoadBalanceMode lbmode_;  // defaults to GRB_LOAD_BALANCE_MODE
   bool        endbit_;
   bool        sort_;
   bool        atomic_;
@@ -109,6 +198,20 @@ class Descriptor {
   bool        earlyexit_;
   bool        fusedmask_;
 
+  // Matrix update params
+  float       compactratio_;
+
+  // Tuning params
+  int         autotune_;
+  bool        tuned_;      // settings come from a TuneProfile
+
+  // Execution params
+  bool        nonblocking_;
+
+  // CPU params
+  int         cputhread_;
+  bool        affinity_;
+
   // GPU params
   int         nthread_;
   int         ndevice_;
@@ -117,8 +220,12 @@ class Descriptor {
 };
 
 Descriptor::~Descriptor() {
-  if (d_buffer_ != NULL) CUDA_CALL(cudaFree(d_buffer_));
-  if (d_temp_   != NULL) CUDA_CALL(cudaFree(d_temp_));
+  if (memory_) {
+    workspace_.print("desc_workspace");
+    memoryTracker().print("graphblas_memory");
+  }
+  if (d_buffer_ != NULL) deviceFree(d_buffer_);
+  if (d_temp_   != NULL) deviceFree(d_temp_);
 }
 
 Info Descriptor::set(Desc_field field, Desc_value value) {
@@ -147,6 +254,59 @@ Info Descriptor::toggle(Desc_field field) {
   return GrB_SUCCESS;
 }
 
+Info Descriptor::copySettings(const Descriptor& rhs) {
+  for (int field = 0; field < GrB_NDESCFIELD; ++field)
+    desc_[field] = rhs.desc_[field];
+
+  ta_           = rhs.ta_;
+  tb_           = rhs.tb_;
+  mode_         = rhs.mode_;
+  split_        = rhs.split_;
+  enable_split_ = rhs.enable_split_;
+  niter_        = rhs.niter_;
+  max_niter_    = rhs.max_niter_;
+  directed_     = rhs.directed_;
+  timing_       = rhs.timing_;
+  transpose_    = rhs.transpose_;
+  mtxinfo_      = rhs.mtxinfo_;
+  verbose_      = rhs.verbose_;
+  mxvmode_      = rhs.mxvmode_;
+  lastmxv_      = rhs.lastmxv_;
+  switchpoint_  = rhs.switchpoint_;
+  dirinfo_      = rhs.dirinfo_;
+  struconly_    = rhs.struconly_;
+  opreuse_      = rhs.opreuse_;
+  memusage_     = rhs.memusage_;
+  lbmode_       = rhs.lbmode_;
+  endbit_       = rhs.endbit_;
+  sort_         = rhs.sort_;
+  atomic_       = rhs.atomic_;
+  earlyexit_    = rhs.earlyexit_;
+  fusedmask_    = rhs.fusedmask_;
+  compactratio_ = rhs.compactratio_;
+  autotune_     = rhs.autotune_;
+  tuned_        = rhs.tuned_;
+  nonblocking_  = rhs.nonblocking_;
+  cputhread_    = rhs.cputhread_;
+  affinity_     = rhs.affinity_;
+  nthread_      = rhs.nthread_;
+  ndevice_      = rhs.ndevice_;
+  debug_        = rhs.debug_;
+
+  // Only owner of rhs prints memory report on destruction
+  memory_       = false;
+  return GrB_SUCCESS;
+}
+
+Info Descriptor::getMemory(MemorySpace     space,
+                           MemoryCategory  category,
+                           MemoryStats*    stats) const {
+  if (space < 0 || space >= GrB_MEMORY_NSPACE || category < 0 ||
+      category > GrB_MEMORY_ALL)
+    return GrB_INVALID_VALUE;
+  return memoryTracker().getStats(space, category, stats);
+}
+
 Info Descriptor::resize(size_t target, std::string field) {
   void*   d_temp_buffer;
   size_t* d_size;
@@ -159,41 +319,42 @@ Info Descriptor::resize(size_t target, std::string field) {
   }
 
   if (target > *d_size) {
-    if (GrB_MEMORY) {
+    // First allocation is made at least kBufferSize, so that small calls
+    // after it do not each grow buffer
+    if (d_temp_buffer == NULL && target < kBufferSize)
+      target = kBufferSize;
+    if (memory_) {
       std::cout << "Resizing "+field+" from " << *d_size << " to " <<
           target << "!\n";
     }
     if (field == "buffer") {
-      CUDA_CALL(cudaMalloc(&d_buffer_, target));
-      if (GrB_MEMORY)
-        printMemory("desc_buffer");
+      CHECK(deviceMalloc(&d_buffer_, target, GrB_MEMORY_DESCRIPTOR));
+      printMemory("desc_buffer");
       if (d_temp_buffer != NULL)
         CUDA_CALL(cudaMemcpy(d_buffer_, d_temp_buffer, *d_size,
             cudaMemcpyDeviceToDevice));
     } else if (field == "temp") {
-      CUDA_CALL(cudaMalloc(&d_temp_, target));
-      if (GrB_MEMORY)
-        printMemory("desc_temp");
+      CHECK(deviceMalloc(&d_temp_, target, GrB_MEMORY_DESCRIPTOR));
+      printMemory("desc_temp");
       if (d_temp_buffer != NULL)
         CUDA_CALL(cudaMemcpy(d_temp_, d_temp_buffer, *d_size,
             cudaMemcpyDeviceToDevice));
     }
     *d_size = target;
 
-    CUDA_CALL(cudaFree(d_temp_buffer));
+    if (d_temp_buffer != NULL) deviceFree(d_temp_buffer);
   }
   return GrB_SUCCESS;
 }
 
 Info Descriptor::clear(std::string field) {
-  if (d_buffer_size_ > 0) {
-    if (field == "buffer")
-      CUDA_CALL(cudaMemset(d_buffer_, 0, d_buffer_size_));
-      // CUDA_CALL( cudaMemsetAsync(d_buffer_, 0, d_buffer_size_) );
-    else if (field == "temp")
-      CUDA_CALL(cudaMemset(d_temp_, 0, d_temp_size_));
-      // CUDA_CALL( cudaMemsetAsync(d_temp_,   0, d_temp_size_) );
-  }
+  // Buffers are allocated on first resize, so there may be nothing to clear
+  if (field == "buffer" && d_buffer_size_ > 0)
+    CUDA_CALL(cudaMemset(d_buffer_, 0, d_buffer_size_));
+    // CUDA_CALL( cudaMemsetAsync(d_buffer_, 0, d_buffer_size_) );
+  else if (field == "temp" && d_temp_size_ > 0)
+    CUDA_CALL(cudaMemset(d_temp_, 0, d_temp_size_));
+    // CUDA_CALL( cudaMemsetAsync(d_temp_,   0, d_temp_size_) );
 
   return GrB_SUCCESS;
 }
@@ -231,13 +392,45 @@ Info Descriptor::loadArgs(const po::variables_map& vm) {
   earlyexit_      = vm["earlyexit"     ].as<bool>();
   fusedmask_      = vm["fusedmask"     ].as<bool>();
 
+  // Matrix update params
+  compactratio_   = vm["compactratio"  ].as<float>();
+
+  // Tuning params
+  autotune_       = vm["autotune"      ].as<int>();
+  tuned_          = false;
+
+  // Execution params
+  CHECK(setNonblocking(vm["nonblocking"].as<bool>()));
+
+  // CPU params
+  CHECK(setCpuThread(vm["cputhread"].as<int>(), vm["affinity"].as<bool>()));
+
   // GPU params
-  nthread_        = vm["nthread"       ].as<int>();
   ndevice_        = vm["ndevice"       ].as<int>();
   debug_          = vm["debug"         ].as<bool>();
-  memory_         = vm["memory"        ].as<bool>();
+  CHECK(setMemory(vm["memory"].as<bool>()));
+  CHECK(setNthread(vm["nthread"].as<int>()));
+  CHECK(setMxvMode(mxvmode_));
+
+  // Settings tuned before for graph read last by readMtx replace ones above
+  if (autotune_ == 1) {
+    TuneProfile profile;
+    const TuneGraph& graph = tuneGraph();
+    if (profile.load(graph.profile, graph.fingerprint) == GrB_SUCCESS) {
+      if (verbose_)
+        std::cout << "Using tuned settings from " << graph.profile << "\n";
+      CHECK(setProfile(profile));
+    }
+  }
 
-  switch (mxvmode_) {
+  // TODO(@ctcyang): Enable device selection using ndevice_
+  // if( ndevice_!=0 )
+
+  return GrB_SUCCESS;
+}
+
+Info Descriptor::setMxvMode(int mxvmode) {
+  switch (mxvmode) {
     case 0:
       CHECK(set(GrB_MXVMODE, GrB_PUSHPULL));
       break;
@@ -249,9 +442,14 @@ Info Descriptor::loadArgs(const po::variables_map& vm) {
       break;
     default:
       std::cout << "Error: incorrect mxvmode selection!\n";
+      return GrB_INVALID_VALUE;
   }
+  mxvmode_ = mxvmode;
+  return GrB_SUCCESS;
+}
 
-  switch (nthread_) {
+Info Descriptor::setNthread(int nthread) {
+  switch (nthread) {
     case 32:
       CHECK(set(GrB_NT, GrB_32));
       break;
@@ -272,13 +470,62 @@ Info Descriptor::loadArgs(const po::variables_map& vm) {
       break;
     default:
       std::cout << "Error: incorrect nthread selection!\n";
+      return GrB_INVALID_VALUE;
   }
+  nthread_ = nthread;
+  return GrB_SUCCESS;
+}
 
-  // TODO(@ctcyang): Enable device selection using ndevice_
-  // if( ndevice_!=0 )
+Info Descriptor::setNonblocking(bool nonblocking) {
+  nonblocking_ = nonblocking;
+  return set(GrB_EXECMODE, nonblocking_ ? GrB_NONBLOCKING : GrB_BLOCKING);
+}
 
+Info Descriptor::setCpuThread(int cputhread, bool affinity) {
+  cputhread_ = cputhread;
+  affinity_  = affinity;
+  return threadPool().resize(cputhread_, affinity_);
+}
+
+Info Descriptor::setMemory(bool memory) {
+  memory_ = memory;
+  memoryTracker().setVerbose(memory_);
   return GrB_SUCCESS;
 }
+
+mgpu::CudaContext& Descriptor::context() {
+  if (d_context_.get() == NULL)
+    d_context_ = mgpu::CreateCudaDevice(0);
+  return *d_context_;
+}
+
+Info Descriptor::setLbmode(int lbmode) {
+  if (lbmode < GrB_LOAD_BALANCE_SIMPLE || lbmode > GrB_LOAD_BALANCE_MERGE)
+    return GrB_INVALID_VALUE;
+  lbmode_ = static_cast<LoadBalanceMode>(lbmode);
+  return GrB_SUCCESS;
+}
+
+Info Descriptor::setProfile(const TuneProfile& profile) {
+  CHECK(setLbmode(profile.lbmode));
+  mxvmode_     = profile.mxvmode;
+  switchpoint_ = profile.switchpoint;
+  memusage_    = profile.memusage;
+  opreuse_     = profile.opreuse;
+  tuned_       = true;
+  return setMxvMode(mxvmode_);
+}
+
+TuneProfile Descriptor::getProfile() const {
+  TuneProfile profile;
+  profile.fingerprint = tuneGraph().fingerprint;
+  profile.mxvmode     = mxvmode_;
+  profile.switchpoint = switchpoint_;
+  profile.memusage    = memusage_;
+  profile.lbmode      = lbmode_;
+  profile.opreuse     = opreuse_;
+  return profile;
+}
 }  // namespace backend
 }  // namespace graphblas
 
@@ -1,6 +1,8 @@
 #ifndef GRAPHBLAS_BACKEND_CUDA_EWISEADD_HPP_
 #define GRAPHBLAS_BACKEND_CUDA_EWISEADD_HPP_
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -8,6 +10,115 @@
 
 namespace graphblas {
 namespace backend {
+/*!
+ * \brief CPU eWiseAdd w = w + mask .* (u + v) of dense u and v
+ *
+ * accum and GrB_REPLACE are applied by OutputCpu as each entry is written.
+ * Non-complemented sparse mask only computes its own entries, unless w is
+ * also an input, in which case mask is looked up in a bitmap instead, so
+ * inputs are not overwritten before read
+ */
+template <typename W, typename U, typename V, typename M,
+          typename BinaryOpT,     typename SemiringT>
+Info eWiseAddDenseDenseCpu(DenseVector<W>*       w,
+                           const Vector<M>*      mask,
+                           bool                  use_scmp,
+                           bool                  use_repl,
+                           BinaryOpT             accum,
+                           SemiringT             op,
+                           const DenseVector<U>* u,
+                           const DenseVector<V>* v,
+                           Descriptor*           desc) {
+  bool in_place = (static_cast<const void*>(w) == u ||
+      static_cast<const void*>(w) == v);
+  OutputCpu<W, BinaryOpT> out(accum, use_repl, op.identity());
+  WorkspaceScope scope(desc->workspace());
+  MaskCpu<M> mask_cpu;
+  CHECK(mask_cpu.init(mask, use_scmp, out.needLookup(in_place),
+      desc->workspace()));
+  CHECK(const_cast<DenseVector<U>*>(u)->gpuToCpu());
+  CHECK(const_cast<DenseVector<V>*>(v)->gpuToCpu());
+  if (out.accumulates())
+    CHECK(w->gpuToCpu());
+
+  auto add_op = extractAdd(op);
+  Index u_nvals = u->nvals_;
+  forEachOutputCpu(mask_cpu, out, w->h_val_, u_nvals, in_place,
+      [&](Index i) {
+    out.write(w->h_val_ + i, add_op(u->h_val_[i], v->h_val_[i]));
+  });
+
+  w->nvals_ = u_nvals;
+  CHECK(w->cpuToGpu());
+  w->need_update_ = false;
+  return GrB_SUCCESS;
+}
+
+/*!
+ * \brief CPU eWiseAdd w = w + mask .* (u + v) of sparse u and dense v
+ *
+ * Same as dense x dense, and reverse swaps operands as in GPU path, which
+ * matters for ops where op(a,b) != op(b,a). Indices of u are marked in a
+ * bitmap, so every entry of w is written once and accum sees whole of u + v
+ */
+template <typename W, typename U, typename V, typename M,
+          typename BinaryOpT,     typename SemiringT>
+Info eWiseAddSparseDenseCpu(DenseVector<W>*        w,
+                            const Vector<M>*       mask,
+                            bool                   use_scmp,
+                            bool                   use_repl,
+                            BinaryOpT              accum,
+                            SemiringT              op,
+                            const SparseVector<U>* u,
+                            const DenseVector<V>*  v,
+                            bool                   reverse,
+                            Descriptor*            desc) {
+  bool in_place = (static_cast<const void*>(w) == v);
+  OutputCpu<W, BinaryOpT> out(accum, use_repl, op.identity());
+  WorkspaceScope scope(desc->workspace());
+  MaskCpu<M> mask_cpu;
+  CHECK(mask_cpu.init(mask, use_scmp, true, desc->workspace()));
+  CHECK(const_cast<SparseVector<U>*>(u)->gpuToCpu());
+  CHECK(const_cast<DenseVector<V>*>(v)->gpuToCpu());
+  if (out.accumulates())
+    CHECK(w->gpuToCpu());
+
+  auto add_op = extractAdd(op);
+  const W identity = op.identity();
+  Index v_nvals = v->nvals_;
+  size_t nword = (static_cast<size_t>(v_nvals) + 63)/64;
+  uint64_t* in_u = desc->workspace()->allocate<uint64_t>(nword + 1);
+  std::memset(in_u, 0, (nword + 1)*sizeof(uint64_t));
+  for (Index k = 0; k < u->nvals_; ++k) {
+    Index i = u->h_ind_[k];
+    in_u[i >> 6] |= static_cast<uint64_t>(1) << (i & 63);
+  }
+
+  // Entries only in v get v(i) + identity, which is v(i) for monoid identity
+  forEachOutputCpu(mask_cpu, out, w->h_val_, v_nvals, in_place,
+      [&](Index i) {
+    if ((in_u[i >> 6] >> (i & 63)) & 1)
+      return;
+    out.write(w->h_val_ + i, (reverse) ? add_op(identity, v->h_val_[i]) :
+        add_op(v->h_val_[i], identity));
+  });
+
+  // Left untouched above, so v(i) is still there if w is v
+  threadPool().parallelFor(0, u->nvals_, [&](Index begin, Index end) {
+    for (Index k = begin; k < end; ++k) {
+      Index i = u->h_ind_[k];
+      if (mask_cpu.allowed(i))
+        out.write(w->h_val_ + i, (reverse) ? add_op(v->h_val_[i],
+            u->h_val_[k]) : add_op(u->h_val_[k], v->h_val_[i]));
+    }
+  }, 4096);
+
+  w->nvals_ = v_nvals;
+  CHECK(w->cpuToGpu());
+  w->need_update_ = false;
+  return GrB_SUCCESS;
+}
+
 /*
  * \brief 4 vector variants
  */
@@ -41,13 +152,12 @@ Info eWiseAddInner(DenseVector<W>*       w,
   CHECK(desc->get(GrB_MASK, &scmp_mode));
   CHECK(desc->get(GrB_OUTP, &repl_mode));
 
-  std::string accum_type = typeid(accum).name();
   // TODO(@ctcyang): add accum and replace support
   // -have masked variants as separate kernel
   // -have scmp as template parameter
   // -accum and replace as parts in flow
   bool use_mask  = (mask != NULL);
-  bool use_accum = (accum_type.size() > 1);
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
   bool use_scmp  = (scmp_mode == GrB_SCMP);
   bool use_repl  = (repl_mode == GrB_REPLACE);
 
@@ -56,6 +166,12 @@ Info eWiseAddInner(DenseVector<W>*       w,
     printState(use_mask, use_accum, use_scmp, use_repl, 0);
   }
 
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+  if (backend == GrB_SEQUENTIAL)
+    return eWiseAddDenseDenseCpu(w, mask, use_scmp, use_repl, accum, op, u,
+        v, desc);
+
   // Get descriptor parameters for nthreads
   Desc_value nt_mode;
   CHECK(desc->get(GrB_NT, &nt_mode));
@@ -103,13 +219,12 @@ Info eWiseAddInner(DenseVector<W>*        w,
   CHECK(desc->get(GrB_MASK, &scmp_mode));
   CHECK(desc->get(GrB_OUTP, &repl_mode));
 
-  std::string accum_type = typeid(accum).name();
   // TODO(@ctcyang): add accum and replace support
   // -have masked variants as separate kernel
   // -have scmp as template parameter
   // -accum and replace as parts in flow
   bool use_mask  = (mask != NULL);
-  bool use_accum = (accum_type.size() > 1);
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
   bool use_scmp  = (scmp_mode == GrB_SCMP);
   bool use_repl  = (repl_mode == GrB_REPLACE);
 
@@ -118,6 +233,12 @@ Info eWiseAddInner(DenseVector<W>*        w,
     printState(use_mask, use_accum, use_scmp, use_repl, 0);
   }
 
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+  if (backend == GrB_SEQUENTIAL)
+    return eWiseAddSparseDenseCpu(w, mask, use_scmp, use_repl, accum, op, u,
+        v, reverse, desc);
+
   // Get descriptor parameters for nthreads
   Desc_value nt_mode;
   CHECK(desc->get(GrB_NT, &nt_mode));
@@ -132,9 +253,6 @@ Info eWiseAddInner(DenseVector<W>*        w,
   if (use_mask) {
     std::cout << "Error: Masked eWiseAdd sparse-dense not implemented yet!\n";
   } else {
-    if (v != w)
-      w->dup(v);
-
     dim3 NT, NB;
     NT.x = nt;
     NT.y = 1;
@@ -144,8 +262,10 @@ Info eWiseAddInner(DenseVector<W>*        w,
     NB.z = 1;
 
     // Need to consider cases where op(a,b) != op (b,a) e.g. LessMonoid
+    // v is read in its own type rather than copied into w first, so w can be
+    // narrower than v (e.g. Boolean mask computed from float distances)
     eWiseAddDenseConstantKernel<<<NB, NT>>>(w->d_val_, extractAdd(op),
-        op.identity(), reverse, v_nvals);
+        op.identity(), reverse, v->d_val_, v_nvals);
 
     NB.x = (u_nvals + nt - 1) / nt;
     eWiseAddSparseDenseKernel<<<NB, NT>>>(w->d_val_, NULL, extractAdd(op),
@@ -170,13 +290,12 @@ Info eWiseAddInner(DenseVector<W>*        w,
   CHECK(desc->get(GrB_MASK, &scmp_mode));
   CHECK(desc->get(GrB_OUTP, &repl_mode));
 
-  std::string accum_type = typeid(accum).name();
   // TODO(@ctcyang): add accum and replace support
   // -have masked variants as separate kernel
   // -have scmp as template parameter
   // -accum and replace as parts in flow
   bool use_mask  = (mask != NULL);
-  bool use_accum = (accum_type.size() > 1);
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
   bool use_scmp  = (scmp_mode == GrB_SCMP);
   bool use_repl  = (repl_mode == GrB_REPLACE);
 
@@ -232,13 +351,12 @@ Info eWiseAddInner(DenseVector<W>*       w,
   CHECK(desc->get(GrB_MASK, &scmp_mode));
   CHECK(desc->get(GrB_OUTP, &repl_mode));
 
-  std::string accum_type = typeid(accum).name();
   // TODO(@ctcyang): add accum and replace support
   // -have masked variants as separate kernel
   // -have scmp as template parameter
   // -accum and replace as parts in flow
   bool use_mask  = (mask != NULL);
-  bool use_accum = (accum_type.size() > 1);
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
   bool use_scmp  = (scmp_mode == GrB_SCMP);
   bool use_repl  = (repl_mode == GrB_REPLACE);
 
@@ -260,8 +378,11 @@ Info eWiseAddInner(DenseVector<W>*       w,
     std::cout << "eWiseMult Sparse Matrix Broadcast Scalar with Mask\n";
     std::cout << "Error: Feature not implemented yet!\n";
   } else {
-    if (u != w)
+    // Written in place below, so must not share memory with input
+    if (u != w) {
       CHECK(w->dup(u));
+      CHECK(w->unshare());
+    }
 
     dim3 NT, NB;
     NT.x = nt;
@@ -8,6 +8,48 @@
 
 namespace graphblas {
 namespace backend {
+/*!
+ * \brief CPU eWiseMult w = w + mask .* (u .* v) of dense u and v
+ *
+ * Entries left out by mask are identity, or keep w under accum without
+ * GrB_REPLACE. accum is applied by OutputCpu as each entry is written
+ */
+template <typename W, typename U, typename V, typename M,
+          typename BinaryOpT,     typename SemiringT>
+Info eWiseMultDenseDenseCpu(DenseVector<W>*       w,
+                            const Vector<M>*      mask,
+                            bool                  use_scmp,
+                            bool                  use_repl,
+                            BinaryOpT             accum,
+                            SemiringT             op,
+                            const DenseVector<U>* u,
+                            const DenseVector<V>* v,
+                            Descriptor*           desc) {
+  bool in_place = (static_cast<const void*>(w) == u ||
+      static_cast<const void*>(w) == v);
+  OutputCpu<W, BinaryOpT> out(accum, use_repl, op.identity());
+  WorkspaceScope scope(desc->workspace());
+  MaskCpu<M> mask_cpu;
+  CHECK(mask_cpu.init(mask, use_scmp, out.needLookup(in_place),
+      desc->workspace()));
+  CHECK(const_cast<DenseVector<U>*>(u)->gpuToCpu());
+  CHECK(const_cast<DenseVector<V>*>(v)->gpuToCpu());
+  if (out.accumulates())
+    CHECK(w->gpuToCpu());
+
+  auto mul_op = extractMul(op);
+  Index u_nvals = u->nvals_;
+  forEachOutputCpu(mask_cpu, out, w->h_val_, u_nvals, in_place,
+      [&](Index i) {
+    out.write(w->h_val_ + i, mul_op(u->h_val_[i], v->h_val_[i]));
+  });
+
+  w->nvals_ = u_nvals;
+  CHECK(w->cpuToGpu());
+  w->need_update_ = false;
+  return GrB_SUCCESS;
+}
+
 /*!
  * \brief 4 vector variants
  */
@@ -41,13 +83,12 @@ Info eWiseMultInner(DenseVector<W>*       w,
   CHECK(desc->get(GrB_MASK, &scmp_mode));
   CHECK(desc->get(GrB_OUTP, &repl_mode));
 
-  std::string accum_type = typeid(accum).name();
   // TODO(@ctcyang): add accum and replace support
   // -have masked variants as separate kernel
   // -have scmp as template parameter
   // -accum and replace as parts in flow
   bool use_mask  = (mask != NULL);
-  bool use_accum = (accum_type.size() > 1);
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
   bool use_scmp  = (scmp_mode == GrB_SCMP);
   bool use_repl  = (repl_mode == GrB_REPLACE);
 
@@ -56,6 +97,12 @@ Info eWiseMultInner(DenseVector<W>*       w,
     printState(use_mask, use_accum, use_scmp, use_repl, 0);
   }
 
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+  if (backend == GrB_SEQUENTIAL)
+    return eWiseMultDenseDenseCpu(w, mask, use_scmp, use_repl, accum, op, u,
+        v, desc);
+
   // Get descriptor parameters for nthreads
   Desc_value nt_mode;
   CHECK(desc->get(GrB_NT, &nt_mode));
@@ -118,13 +165,12 @@ Info eWiseMultInner(SparseVector<W>*       w,
   CHECK(desc->get(GrB_MASK, &scmp_mode));
   CHECK(desc->get(GrB_OUTP, &repl_mode));
 
-  std::string accum_type = typeid(accum).name();
   // TODO(@ctcyang): add accum and replace support
   // -have masked variants as separate kernel
   // -have scmp as template parameter
   // -accum and replace as parts in flow
   bool use_mask  = (mask != NULL);
-  bool use_accum = (accum_type.size() > 1);
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
   bool use_scmp  = (scmp_mode == GrB_SCMP);
   bool use_repl  = (repl_mode == GrB_REPLACE);
 
@@ -184,13 +230,12 @@ Info eWiseMultInner(SparseVector<W>*       w,
   CHECK(desc->get(GrB_MASK, &scmp_mode));
   CHECK(desc->get(GrB_OUTP, &repl_mode));
 
-  std::string accum_type = typeid(accum).name();
   // TODO(@ctcyang): add accum and replace support
   // -have masked variants as separate kernel
   // -have scmp as template parameter
   // -accum and replace as parts in flow
   bool use_mask  = (mask != NULL);
-  bool use_accum = (accum_type.size() > 1);
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
   bool use_scmp  = (scmp_mode == GrB_SCMP);
   bool use_repl  = (repl_mode == GrB_REPLACE);
 
@@ -279,13 +324,12 @@ Info eWiseMultInner(SparseMatrix<c>*       C,
   CHECK(desc->get(GrB_MASK, &scmp_mode));
   CHECK(desc->get(GrB_OUTP, &repl_mode));
 
-  std::string accum_type = typeid(accum).name();
   // TODO(@ctcyang): add accum and replace support
   // -have masked variants as separate kernel
   // -have scmp as template parameter
   // -accum and replace as parts in flow
   bool use_mask  = (mask != NULL);
-  bool use_accum = (accum_type.size() > 1);
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
   bool use_scmp  = (scmp_mode == GrB_SCMP);
   bool use_repl  = (repl_mode == GrB_REPLACE);
 
@@ -307,8 +351,11 @@ Info eWiseMultInner(SparseMatrix<c>*       C,
     std::cout << "eWiseMult Sparse Matrix Broadcast Scalar with Mask\n";
     std::cout << "Error: Feature not implemented yet!\n";
   } else {
-    if (A != C)
+    // Written in place below, so must not share memory with input
+    if (A != C) {
       CHECK(C->dup(A));
+      CHECK(C->unshare());
+    }
 
     dim3 NT, NB;
     NT.x = nt;
@@ -345,13 +392,12 @@ Info eWiseMultInner(SparseVector<W>*       w,
   CHECK(desc->get(GrB_MASK, &scmp_mode));
   CHECK(desc->get(GrB_OUTP, &repl_mode));
 
-  std::string accum_type = typeid(accum).name();
   // TODO(@ctcyang): add accum and replace support
   // -have masked variants as separate kernel
   // -have scmp as template parameter
   // -accum and replace as parts in flow
   bool use_mask  = (mask != NULL);
-  bool use_accum = (accum_type.size() > 1);
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
   bool use_scmp  = (scmp_mode == GrB_SCMP);
   bool use_repl  = (repl_mode == GrB_REPLACE);
 
@@ -373,8 +419,11 @@ Info eWiseMultInner(SparseVector<W>*       w,
     std::cout << "eWiseMult Sparse Matrix Broadcast Scalar with Mask\n";
     std::cout << "Error: Feature not implemented yet!\n";
   } else {
-    if (u != w)
+    // Written in place below, so must not share memory with input
+    if (u != w) {
       CHECK(w->dup(u));
+      CHECK(w->unshare());
+    }
 
     dim3 NT, NB;
     NT.x = nt;
@@ -407,13 +456,12 @@ Info eWiseMultInner(DenseVector<W>*       w,
   CHECK(desc->get(GrB_MASK, &scmp_mode));
   CHECK(desc->get(GrB_OUTP, &repl_mode));
 
-  std::string accum_type = typeid(accum).name();
   // TODO(@ctcyang): add accum and replace support
   // -have masked variants as separate kernel
   // -have scmp as template parameter
   // -accum and replace as parts in flow
   bool use_mask  = (mask != NULL);
-  bool use_accum = (accum_type.size() > 1);
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
   bool use_scmp  = (scmp_mode == GrB_SCMP);
   bool use_repl  = (repl_mode == GrB_REPLACE);
 
@@ -435,8 +483,11 @@ Info eWiseMultInner(DenseVector<W>*       w,
     std::cout << "eWiseMult Sparse Matrix Broadcast Scalar with Mask\n";
     std::cout << "Error: Feature not implemented yet!\n";
   } else {
-    if (u != w)
+    // Written in place below, so must not share memory with input
+    if (u != w) {
       CHECK(w->dup(u));
+      CHECK(w->unshare());
+    }
 
     dim3 NT, NB;
     NT.x = nt;
@@ -469,13 +520,12 @@ Info eWiseMultColInner(SparseMatrix<c>*       C,
   CHECK(desc->get(GrB_MASK, &scmp_mode));
   CHECK(desc->get(GrB_OUTP, &repl_mode));
 
-  std::string accum_type = typeid(accum).name();
   // TODO(@ctcyang): add accum and replace support
   // -have masked variants as separate kernel
   // -have scmp as template parameter
   // -accum and replace as parts in flow
   bool use_mask  = (mask != NULL);
-  bool use_accum = (accum_type.size() > 1);
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
   bool use_scmp  = (scmp_mode == GrB_SCMP);
   bool use_repl  = (repl_mode == GrB_REPLACE);
 
@@ -498,8 +548,11 @@ Info eWiseMultColInner(SparseMatrix<c>*       C,
     std::cout << "eWiseMult Sparse Matrix Broadcast Col Vector with Mask\n";
     std::cout << "Error: Feature not implemented yet!\n";
   } else {
-    if (A != C)
+    // Written in place below, so must not share memory with input
+    if (A != C) {
       CHECK(C->dup(A));
+      CHECK(C->unshare());
+    }
 
     dim3 NT, NB;
     NT.x = nt;
@@ -540,13 +593,12 @@ Info eWiseMultRowInner(SparseMatrix<c>*       C,
   CHECK(desc->get(GrB_MASK, &scmp_mode));
   CHECK(desc->get(GrB_OUTP, &repl_mode));
 
-  std::string accum_type = typeid(accum).name();
   // TODO(@ctcyang): add accum and replace support
   // -have masked variants as separate kernel
   // -have scmp as template parameter
   // -accum and replace as parts in flow
   bool use_mask  = (mask != NULL);
-  bool use_accum = (accum_type.size() > 1);
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
   bool use_scmp  = (scmp_mode == GrB_SCMP);
   bool use_repl  = (repl_mode == GrB_REPLACE);
 
@@ -569,8 +621,11 @@ Info eWiseMultRowInner(SparseMatrix<c>*       C,
     std::cout << "eWiseMult Sparse Matrix Broadcast Row Vector with Mask\n";
     std::cout << "Error: Feature not implemented yet!\n";
   } else {
-    if (A != C)
+    // Written in place below, so must not share memory with input
+    if (A != C) {
       CHECK(C->dup(A));
+      CHECK(C->unshare());
+    }
 
     dim3 NT, NB;
     NT.x = nt;
@@ -0,0 +1,93 @@
+#ifndef GRAPHBLAS_BACKEND_CUDA_EXTRACT_HPP_
+#define GRAPHBLAS_BACKEND_CUDA_EXTRACT_HPP_
+
+#include <iostream>
+
+#include "graphblas/backend/cuda/kernels/kernels.hpp"
+
+namespace graphblas {
+namespace backend {
+
+/*!
+ * \brief Gather w = w + u[indices] of dense w and u
+ *
+ * w[k] is u[indices[k]] for k < nindices, applied through accum if there is
+ * one. Indices past end of u leave w[k] untouched. CPU path reads h_indices,
+ * while GPU path reads d_indices, or copies h_indices to device buffer if none
+ * is given. w must not alias u or indices
+ */
+template <typename W, typename U,
+          typename BinaryOpT>
+Info extractDense(DenseVector<W>*       w,
+                  BinaryOpT             accum,
+                  const DenseVector<U>* u,
+                  const Index*          h_indices,
+                  const Index*          d_indices,
+                  Index                 nindices,
+                  Descriptor*           desc) {
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
+  if (desc->debug()) {
+    std::cout << "Executing extractDense\n";
+    printState(false, use_accum, false, false, false);
+  }
+
+  Index u_nvals = u->nvals_;
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+  if (backend == GrB_SEQUENTIAL) {
+    OutputCpu<W, BinaryOpT> out(accum, false, static_cast<W>(0));
+    CHECK(const_cast<DenseVector<U>*>(u)->gpuToCpu());
+    if (use_accum)
+      CHECK(w->gpuToCpu());
+
+    W*       w_val = w->h_val_;
+    const U* u_val = u->h_val_;
+    threadPool().parallelFor(0, nindices, [&](Index begin, Index end) {
+      for (Index k = begin; k < end; ++k) {
+        Index ind = h_indices[k];
+        if (ind >= 0 && ind < u_nvals)
+          out.write(w_val + k, u_val[ind]);
+      }
+    }, 4096);
+
+    w->nvals_ = nindices;
+    CHECK(w->cpuToGpu());
+    w->need_update_ = false;
+    return GrB_SUCCESS;
+  }
+
+  if (d_indices == NULL && nindices > 0) {
+    CHECK(desc->resize(nindices*sizeof(Index), "buffer"));
+    Index* indices_t = reinterpret_cast<Index*>(desc->d_buffer_);
+    CUDA_CALL(cudaMemcpy(indices_t, h_indices, nindices*sizeof(Index),
+        cudaMemcpyHostToDevice));
+    d_indices = indices_t;
+  }
+
+  // Get descriptor parameters for nthreads
+  Desc_value nt_mode;
+  CHECK(desc->get(GrB_NT, &nt_mode));
+  const int nt = static_cast<int>(nt_mode);
+  dim3 NT, NB;
+  NT.x = nt;
+  NT.y = 1;
+  NT.z = 1;
+  NB.x = (nindices+nt-1)/nt;
+  NB.y = 1;
+  NB.z = 1;
+
+  if (nindices > 0)
+    extractDenseVectorKernel<<<NB, NT>>>(w->d_val_,
+        AccumOrSecond<W, BinaryOpT>::get(accum), u->d_val_, u_nvals,
+        d_indices, nindices);
+
+  if (desc->debug())
+    printDevice("w_val", w->d_val_, nindices);
+  w->nvals_ = nindices;
+  w->need_update_ = true;
+  return GrB_SUCCESS;
+}
+}  // namespace backend
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_BACKEND_CUDA_EXTRACT_HPP_
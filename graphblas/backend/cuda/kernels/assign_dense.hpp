@@ -77,6 +77,29 @@ __global__ void assignDenseSparseMaskedKernel(U*           u_val,
     }
   }
 }
+
+// This is the vector variant of assignDense: w[indices[row]] gets u[row].
+// Indices may repeat, so under accum they are combined with atomics
+template <bool UseAccum,
+          typename W, typename U, typename AccumOp>
+__global__ void assignDenseVectorKernel(W*           w_val,
+                                        Index        w_nvals,
+                                        AccumOp      accum_op,
+                                        const U*     u_val,
+                                        const Index* indices,
+                                        Index        nindices) {
+  Index row = blockIdx.x*blockDim.x + threadIdx.x;
+
+  for (; row < nindices; row += gridDim.x*blockDim.x) {
+    Index ind = indices[row];
+    if (ind >= 0 && ind < w_nvals) {
+      if (UseAccum)
+        atomic(w_val + ind, static_cast<W>(u_val[row]), accum_op);
+      else
+        w_val[ind] = static_cast<W>(u_val[row]);
+    }
+  }
+}
 }  // namespace backend
 }  // namespace graphblas
 
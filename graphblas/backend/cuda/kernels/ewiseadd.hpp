@@ -61,6 +61,25 @@ __global__ void eWiseAddDenseConstantKernel(W*       w_val,
     __syncwarp();
   }
 }
+
+// constant dense no mask vector variant reading from separate input v
+// TODO(@ctcyang): add scmp, accum, repl, mask
+// template <bool UseScmp, bool UseAccum, bool UseRepl,
+template <typename W, typename T, typename V,
+          typename BinaryOp>
+__global__ void eWiseAddDenseConstantKernel(W*       w_val,
+                                            BinaryOp op,
+                                            T        identity,
+                                            bool     reverse,
+                                            const V* v_val,
+                                            Index    w_nvals) {
+  Index row = blockIdx.x * blockDim.x + threadIdx.x;
+  for (; row < w_nvals; row += blockDim.x * gridDim.x) {
+    V v_t = v_val[row];
+    w_val[row] = (reverse) ? op(identity, v_t) : op(v_t, identity);
+    __syncwarp();
+  }
+}
 }  // namespace backend
 }  // namespace graphblas
 
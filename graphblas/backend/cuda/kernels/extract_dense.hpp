@@ -0,0 +1,27 @@
+#ifndef GRAPHBLAS_BACKEND_CUDA_KERNELS_EXTRACT_DENSE_HPP_
+#define GRAPHBLAS_BACKEND_CUDA_KERNELS_EXTRACT_DENSE_HPP_
+
+namespace graphblas {
+namespace backend {
+
+// This is the vector variant of extractDense: w[row] gets u[indices[row]].
+// Each row is written by one thread, so accum needs no atomics
+template <typename W, typename U, typename AccumOp>
+__global__ void extractDenseVectorKernel(W*           w_val,
+                                         AccumOp      accum_op,
+                                         const U*     u_val,
+                                         Index        u_nvals,
+                                         const Index* indices,
+                                         Index        nindices) {
+  Index row = blockIdx.x*blockDim.x + threadIdx.x;
+
+  for (; row < nindices; row += gridDim.x*blockDim.x) {
+    Index ind = indices[row];
+    if (ind >= 0 && ind < u_nvals)
+      w_val[row] = accum_op(w_val[row], static_cast<W>(u_val[ind]));
+  }
+}
+}  // namespace backend
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_BACKEND_CUDA_KERNELS_EXTRACT_DENSE_HPP_
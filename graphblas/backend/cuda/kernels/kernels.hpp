@@ -1,14 +1,16 @@
 #ifndef GRAPHBLAS_BACKEND_CUDA_KERNELS_KERNELS_HPP_
 #define GRAPHBLAS_BACKEND_CUDA_KERNELS_KERNELS_HPP_
 
-#include "graphblas/backend/cuda/kernels/assign_dense.hpp"
-#include "graphblas/backend/cuda/kernels/assign_sparse.hpp"
 #include "graphblas/backend/cuda/kernels/util.hpp"
 #include "graphblas/backend/cuda/kernels/spmv.hpp"
 #include "graphblas/backend/cuda/kernels/spmspv.hpp"
+#include "graphblas/backend/cuda/kernels/assign_dense.hpp"
+#include "graphblas/backend/cuda/kernels/assign_sparse.hpp"
+#include "graphblas/backend/cuda/kernels/extract_dense.hpp"
 #include "graphblas/backend/cuda/kernels/ewisemult.hpp"
 #include "graphblas/backend/cuda/kernels/ewiseadd.hpp"
 #include "graphblas/backend/cuda/kernels/trace.hpp"
 #include "graphblas/backend/cuda/kernels/scatter.hpp"
+#include "graphblas/backend/cuda/kernels/reduce.hpp"
 
 #endif  // GRAPHBLAS_BACKEND_CUDA_KERNELS_KERNELS_HPP_
@@ -0,0 +1,66 @@
+#ifndef GRAPHBLAS_BACKEND_CUDA_KERNELS_REDUCE_HPP_
+#define GRAPHBLAS_BACKEND_CUDA_KERNELS_REDUCE_HPP_
+
+#include <cub.cuh>
+
+namespace graphblas {
+namespace backend {
+
+// Fused element-wise op and reduction of two vectors, where u is dense
+// (u_ind == NULL) or sparse. v is dense (v_pos == NULL) and read at index of
+// u, or sparse and looked up through v_pos, which holds position in v_val of
+// each index or -1 if v has none. Entries of u with no match in v count as u
+// itself if keep_unmatched and as identity otherwise, and matched entries
+// count as identity if skip_matched. Each block writes its partial result to
+// block_val[blockIdx.x], so no temporary of size u_nvals is needed
+template <int NT, typename T, typename U, typename V,
+          typename EWiseOp, typename ReduceOp>
+__global__ void eWiseReduceKernel(T*           block_val,
+                                  T            identity,
+                                  EWiseOp      ewise_op,
+                                  ReduceOp     reduce_op,
+                                  const Index* u_ind,
+                                  const U*     u_val,
+                                  Index        u_nvals,
+                                  const Index* v_pos,
+                                  const V*     v_val,
+                                  bool         keep_unmatched,
+                                  bool         skip_matched,
+                                  bool         reverse) {
+  typedef cub::BlockReduce<T, NT> BlockReduceT;
+  __shared__ typename BlockReduceT::TempStorage temp_storage;
+
+  T sum = identity;
+  Index row = blockIdx.x * blockDim.x + threadIdx.x;
+  for (; row < u_nvals; row += blockDim.x * gridDim.x) {
+    U u_t = u_val[row];
+    Index ind = (u_ind == NULL) ? row : u_ind[row];
+    Index pos = (v_pos == NULL) ? ind : v_pos[ind];
+    if (pos < 0) {
+      if (keep_unmatched)
+        sum = reduce_op(sum, static_cast<T>(u_t));
+    } else if (!skip_matched) {
+      V v_t = v_val[pos];
+      sum = reduce_op(sum, (reverse) ? ewise_op(v_t, u_t) :
+          ewise_op(u_t, v_t));
+    }
+  }
+
+  sum = BlockReduceT(temp_storage).Reduce(sum, reduce_op);
+  if (threadIdx.x == 0)
+    block_val[blockIdx.x] = sum;
+}
+
+// pos[u_ind[k]] = k, for lookup of sparse vector by index
+template <typename T>
+__global__ void scatterPositionKernel(T*           pos,
+                                      const Index* u_ind,
+                                      Index        u_nvals) {
+  Index row = blockIdx.x * blockDim.x + threadIdx.x;
+  for (; row < u_nvals; row += blockDim.x * gridDim.x)
+    pos[u_ind[row]] = static_cast<T>(row);
+}
+}  // namespace backend
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_BACKEND_CUDA_KERNELS_REDUCE_HPP_
@@ -83,6 +83,16 @@ __device__ float atomic(float* address, float val, AddOp add_op) {
   return __int_as_float(old);
 }
 
+template <typename AddOp>
+__device__ int atomic(int* address, int val, AddOp add_op) {
+  int old = *address, assumed;
+  do {
+    assumed = old;
+    old = atomicCAS(address, assumed, add_op(assumed, val));
+  } while (assumed != old);
+  return old;
+}
+
 /*!
  * \brief Not load-balanced, naive Sparse Matrix x Sparse Vector kernel
  *        for functors with add_op != Plus
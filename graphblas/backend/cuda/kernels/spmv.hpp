@@ -40,9 +40,11 @@ __global__ void spmvDenseMaskedOrKernel(W*           w_val,
               break;
           }
         } else {
-          val = u_val[col_ind];
+          // Load frontier in its own (possibly narrow) type U rather than
+          // converting it to mask type M
+          U u_val_t = u_val[col_ind];
           // Early exit if visited parent is discovered
-          if (val != identity) {
+          if (u_val_t != static_cast<U>(identity)) {
             discoverable = true;
             if (UseEarlyExit)
               break;
@@ -101,9 +103,9 @@ __global__ void spmvDenseMaskedOrKernelBench(W*           w_val,
               stats[row] = row_end-row_start2;
           }
         } else {
-          val           = u_val[col_ind];
+          U u_val_t     = u_val[col_ind];
           // Early exit if visited parent is discovered
-          if (val != identity) {
+          if (u_val_t != static_cast<U>(identity)) {
             discoverable = true;
             if (UseEarlyExit)
               break;
@@ -118,6 +120,44 @@ __global__ void spmvDenseMaskedOrKernelBench(W*           w_val,
       w_val[row] = (W)0;
   }
 }
+
+// Masked SpMV for any semiring. Rows left out by mask are set to identity
+// without being read, and with UseEarlyExit a row stops as soon as its sum
+// reaches terminal of add, since no later product can change it
+template <bool UseScmp, bool UseEarlyExit,
+          typename W, typename a, typename U, typename M, typename T,
+          typename MulOp, typename AddOp>
+__global__ void spmvDenseMaskedKernel(W*           w_val,
+                                      const M*     mask_val,
+                                      T            identity,
+                                      T            terminal,
+                                      MulOp        mul_op,
+                                      AddOp        add_op,
+                                      Index        A_nrows,
+                                      const Index* A_csrRowPtr,
+                                      const Index* A_csrColInd,
+                                      const a*     A_csrVal,
+                                      const U*     u_val) {
+  Index row = blockIdx.x*blockDim.x + threadIdx.x;
+
+  for (; row < A_nrows; row += gridDim.x*blockDim.x) {
+    T sum = identity;
+
+    M val = mask_val[row];
+    if (!(UseScmp^(!static_cast<bool>(val)))) {
+      Index row_start = A_csrRowPtr[row];
+      Index row_end   = A_csrRowPtr[row + 1];
+
+      for (; row_start < row_end; row_start++) {
+        Index col_ind = A_csrColInd[row_start];
+        sum = add_op(sum, mul_op(A_csrVal[row_start], u_val[col_ind]));
+        if (UseEarlyExit && sum == terminal)
+          break;
+      }
+    }
+    w_val[row] = static_cast<W>(sum);
+  }
+}
 }  // namespace backend
 }  // namespace graphblas
 
@@ -0,0 +1,225 @@
+#ifndef GRAPHBLAS_BACKEND_CUDA_MASK_HPP_
+#define GRAPHBLAS_BACKEND_CUDA_MASK_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+#include "graphblas/thread_pool.hpp"
+#include "graphblas/backend/cuda/workspace.hpp"
+
+namespace graphblas {
+namespace backend {
+
+template <typename T>
+class Vector;
+
+template <typename T>
+class SparseVector;
+
+template <typename T>
+class DenseVector;
+
+/*!
+ * \brief Host view of vector mask used by CPU (GrB_SEQUENTIAL) operations
+ *
+ * Dense mask is read in place. Sparse mask is turned into list of its indices
+ * whose value is nonzero, so that with a non-complemented sparse mask callers
+ * only run over those (see indexed()), which is O(mask nvals) work no matter
+ * how large vector is. Complemented sparse mask, or caller asking for lookups
+ * by index, gets a bitmap of same indices for allowed(). Both are taken from
+ * workspace, so caller must hold a WorkspaceScope.
+ */
+template <typename M>
+class MaskCpu {
+ public:
+  MaskCpu()
+      : dense_(NULL), ind_(NULL), nind_(0), bitmap_(NULL), scmp_(false) {}
+
+  Info init(const Vector<M>* mask,
+            bool             use_scmp,
+            bool             need_lookup,
+            Workspace*       workspace);
+
+  // Only indices index(0), ..., index(nindex()-1) are allowed
+  inline bool  indexed() const { return ind_ != NULL && !scmp_; }
+  inline Index nindex()  const { return nind_; }
+  inline Index index(Index k) const { return ind_[k]; }
+
+  // Whether index i is written, with GrB_SCMP already taken into account.
+  // Always true if there is no mask. For non-complemented sparse mask, only
+  // valid if init was asked for lookups
+  inline bool allowed(Index i) const {
+    if (dense_ != NULL)
+      return static_cast<bool>(dense_[i]) != scmp_;
+    if (bitmap_ != NULL)
+      return static_cast<bool>((bitmap_[i >> 6] >> (i & 63)) & 1) != scmp_;
+    return true;
+  }
+
+ private:
+  const M*  dense_;
+  Index*    ind_;
+  Index     nind_;
+  uint64_t* bitmap_;
+  bool      scmp_;
+};
+
+template <typename M>
+Info MaskCpu<M>::init(const Vector<M>* mask,
+                      bool             use_scmp,
+                      bool             need_lookup,
+                      Workspace*       workspace) {
+  if (mask == NULL)
+    return GrB_SUCCESS;
+  scmp_ = use_scmp;
+
+  Storage mask_vec_type;
+  CHECK(mask->getStorage(&mask_vec_type));
+  if (mask_vec_type == GrB_DENSE) {
+    CHECK(const_cast<DenseVector<M>*>(&mask->dense_)->gpuToCpu());
+    dense_ = mask->dense_.h_val_;
+    return GrB_SUCCESS;
+  } else if (mask_vec_type != GrB_SPARSE) {
+    return GrB_UNINITIALIZED_OBJECT;
+  }
+
+  const SparseVector<M>* sparse = &mask->sparse_;
+  CHECK(const_cast<SparseVector<M>*>(sparse)->gpuToCpu());
+  ind_ = workspace->allocate<Index>(sparse->nvals_ + 1);
+  for (Index k = 0; k < sparse->nvals_; ++k) {
+    if (static_cast<bool>(sparse->h_val_[k]))
+      ind_[nind_++] = sparse->h_ind_[k];
+  }
+
+  if (use_scmp || need_lookup) {
+    size_t nword = (static_cast<size_t>(sparse->nsize_) + 63)/64;
+    bitmap_ = workspace->allocate<uint64_t>(nword + 1);
+    std::memset(bitmap_, 0, (nword + 1)*sizeof(uint64_t));
+    for (Index k = 0; k < nind_; ++k)
+      bitmap_[ind_[k] >> 6] |= static_cast<uint64_t>(1) << (ind_[k] & 63);
+  }
+  return GrB_SUCCESS;
+}
+/*!
+ * \brief Epilogue of CPU operations writing dense output w
+ *
+ * Result t of an allowed entry is stored as w = accum(w, t), or just t if no
+ * accum is given, so accumulating takes no extra pass over w. Entries left out
+ * by mask keep w if there is accum and no GrB_REPLACE, and are otherwise set to
+ * identity like GPU operations do.
+ */
+template <typename W, typename BinaryOpT>
+class OutputCpu {
+ public:
+  OutputCpu(BinaryOpT accum, bool use_repl, W identity)
+      : accum_(accum), use_repl_(use_repl), identity_(identity) {}
+
+  inline bool accumulates() const { return AccumTraits<BinaryOpT>::enabled; }
+
+  // Whether entries left out by mask are left untouched
+  inline bool keepsRest() const { return accumulates() && !use_repl_; }
+
+  // Whether MaskCpu::init must be asked for lookups for forEachOutputCpu
+  inline bool needLookup(bool in_place) const {
+    return in_place || (accumulates() && use_repl_);
+  }
+
+  template <typename T>
+  inline void write(W* out, T t) const {
+    write(out, t, std::integral_constant<bool,
+        AccumTraits<BinaryOpT>::enabled>());
+  }
+
+  // Same as write, for outputs that several threads may hit at once
+  template <typename T>
+  inline void writeAtomic(W* out, T t) const {
+    writeAtomic(out, t, std::integral_constant<bool,
+        AccumTraits<BinaryOpT>::enabled>());
+  }
+
+  // Entry left out by mask
+  inline void skip(W* out) const {
+    if (!keepsRest())
+      *out = identity_;
+  }
+
+  // Allowed entry with no result, e.g. row without any edge
+  inline void empty(W* out) const {
+    if (!accumulates())
+      *out = identity_;
+  }
+
+  inline W identity() const { return identity_; }
+
+ private:
+  template <typename T>
+  inline void write(W* out, T t, std::true_type) const {
+    *out = accum_(*out, t);
+  }
+
+  template <typename T>
+  inline void write(W* out, T t, std::false_type) const { *out = t; }
+
+  template <typename T>
+  inline void writeAtomic(W* out, T t, std::true_type) const {
+    W expected, desired;
+    __atomic_load(out, &expected, __ATOMIC_RELAXED);
+    do {
+      desired = accum_(expected, t);
+    } while (!__atomic_compare_exchange(out, &expected, &desired, true,
+        __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+  }
+
+  template <typename T>
+  inline void writeAtomic(W* out, T t, std::false_type) const {
+    W desired = static_cast<W>(t);
+    __atomic_store(out, &desired, __ATOMIC_RELAXED);
+  }
+
+  BinaryOpT accum_;
+  bool      use_repl_;
+  W         identity_;
+};
+
+/*!
+ * \brief Runs f(i) on every entry of dense w_val that mask allows, and skips
+ * the rest through out
+ *
+ * With a non-complemented sparse mask, f only runs on mask indices, and the
+ * rest of w is filled with identity first unless out keeps it. in_place means
+ * f reads inputs aliased with w, which must then not be filled first, so mask
+ * must have been set up with out.needLookup(in_place).
+ */
+template <typename M, typename W, typename BinaryOpT, typename F>
+void forEachOutputCpu(const MaskCpu<M>&                mask,
+                      const OutputCpu<W, BinaryOpT>&   out,
+                      W*                               w_val,
+                      Index                            w_nvals,
+                      bool                             in_place,
+                      F                                f,
+                      Index                            grain = 4096) {
+  if (mask.indexed() && !out.needLookup(in_place)) {
+    if (!out.keepsRest())
+      std::fill(w_val, w_val + w_nvals, out.identity());
+    threadPool().parallelFor(0, mask.nindex(), [&](Index begin, Index end) {
+      for (Index k = begin; k < end; ++k)
+        f(mask.index(k));
+    }, grain);
+  } else {
+    threadPool().parallelFor(0, w_nvals, [&](Index begin, Index end) {
+      for (Index i = begin; i < end; ++i) {
+        if (mask.allowed(i))
+          f(i);
+        else
+          out.skip(w_val + i);
+      }
+    }, grain);
+  }
+}
+}  // namespace backend
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_BACKEND_CUDA_MASK_HPP_
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <iostream>
+#include <algorithm>
 
 namespace graphblas {
 namespace backend {
@@ -24,6 +25,15 @@ class Matrix {
       : nrows_(nrows), ncols_(ncols), nvals_(0), sparse_(nrows, ncols),
         dense_(nrows, ncols), mat_type_(GrB_SPARSE) {}
 
+  // O(1) moves, so Matrix can be returned by value
+  Matrix(Matrix&& rhs) : Matrix() {
+    swap(&rhs);
+  }
+  Matrix& operator=(Matrix&& rhs) {
+    swap(&rhs);
+    return *this;
+  }
+
   // Default Destructor is good enough for this layer
   ~Matrix() {}
 
@@ -51,6 +61,8 @@ class Matrix {
              T*     values,
              Index  nvals);
   Info setElement(Index row_index, Index col_index);
+  Info setElement(T val, Index row_index, Index col_index);
+  Info removeElement(Index row_index, Index col_index);
   Info extractElement(T* val, Index row_index, Index col_index);
   Info extractTuples(std::vector<Index>* row_indices,
                      std::vector<Index>* col_indices,
@@ -69,6 +81,7 @@ class Matrix {
   Info getStorage(Storage* mat_type) const;
   Info getFormat(SparseMatrixFormat* format) const;
   Info getSymmetry(bool* symmetry) const;
+  Info getMemory(MemorySpace space, size_t* bytes) const;
   template <typename MatrixT>
   MatrixT* getMatrix() const;
 
@@ -77,6 +90,19 @@ class Matrix {
   template <typename U>
   Info fillAscending(Index axis, Index nvals, U start);
 
+  // Batched dynamic updates (sparse matrices only)
+  Info setElements(const std::vector<Index>* row_indices,
+                   const std::vector<Index>* col_indices,
+                   const std::vector<T>*     values,
+                   Index                     nvals,
+                   Descriptor*               desc);
+  Info removeElements(const std::vector<Index>* row_indices,
+                      const std::vector<Index>* col_indices,
+                      Index                     nvals,
+                      Descriptor*               desc);
+  Info compact();
+  Info swap(Matrix* rhs);
+
  private:
   Index nrows_;
   Index ncols_;
@@ -97,12 +123,13 @@ Info Matrix<T>::nnew(Index nrows, Index ncols) {
   return GrB_SUCCESS;
 }
 
+// Sparse matrices are shared with rhs until either matrix is written to
 template <typename T>
 Info Matrix<T>::dup(const Matrix* rhs) {
   mat_type_ = rhs->mat_type_;
   if (mat_type_ == GrB_SPARSE)
     return sparse_.dup(&rhs->sparse_);
-  else if (mat_type_ == GrB_SPARSE)
+  else if (mat_type_ == GrB_DENSE)
     return dense_.dup(&rhs->dense_);
   std::cout << "Error: Failed to call dup!\n";
   return GrB_UNINITIALIZED_OBJECT;
@@ -210,6 +237,60 @@ Info Matrix<T>::setElement(Index row_index, Index col_index) {
   return GrB_UNINITIALIZED_OBJECT;
 }
 
+template <typename T>
+Info Matrix<T>::setElement(T val, Index row_index, Index col_index) {
+  // Empty matrix is initialized by first update, so do not allocate here
+  if (mat_type_ == GrB_UNKNOWN)
+    mat_type_ = GrB_SPARSE;
+  // Updates are buffered by sparse storage only
+  if (mat_type_ == GrB_SPARSE)
+    return sparse_.setElement(val, row_index, col_index);
+  return GrB_INVALID_OBJECT;
+}
+
+template <typename T>
+Info Matrix<T>::removeElement(Index row_index, Index col_index) {
+  if (mat_type_ == GrB_SPARSE)
+    return sparse_.removeElement(row_index, col_index);
+  else if (mat_type_ == GrB_DENSE)
+    return GrB_INVALID_OBJECT;
+  return GrB_UNINITIALIZED_OBJECT;
+}
+
+template <typename T>
+Info Matrix<T>::setElements(const std::vector<Index>* row_indices,
+                            const std::vector<Index>* col_indices,
+                            const std::vector<T>*     values,
+                            Index                     nvals,
+                            Descriptor*               desc) {
+  // Empty matrix is initialized by first update, so do not allocate here
+  if (mat_type_ == GrB_UNKNOWN)
+    mat_type_ = GrB_SPARSE;
+  if (mat_type_ == GrB_SPARSE)
+    return sparse_.setElements(row_indices, col_indices, values, nvals, desc);
+  return GrB_INVALID_OBJECT;
+}
+
+template <typename T>
+Info Matrix<T>::removeElements(const std::vector<Index>* row_indices,
+                               const std::vector<Index>* col_indices,
+                               Index                     nvals,
+                               Descriptor*               desc) {
+  if (mat_type_ == GrB_SPARSE)
+    return sparse_.removeElements(row_indices, col_indices, nvals, desc);
+  else if (mat_type_ == GrB_DENSE)
+    return GrB_INVALID_OBJECT;
+  return GrB_UNINITIALIZED_OBJECT;
+}
+
+// Merges pending updates, so that GPU kernels see them
+template <typename T>
+Info Matrix<T>::compact() {
+  if (mat_type_ == GrB_SPARSE)
+    return sparse_.compact();
+  return GrB_SUCCESS;
+}
+
 template <typename T>
 Info Matrix<T>::extractElement(T* val, Index row_index, Index col_index) {
   if (mat_type_ == GrB_SPARSE)
@@ -286,11 +367,14 @@ Info Matrix<T>::resize(Index nrows, Index ncols) {
 }
 
 // Private method that sets mat_type, clears and allocates
+// Operations call it on their output before writing, so this is also where
+// arrays shared with a dup are copied
 template <typename T>
 Info Matrix<T>::setStorage(Storage mat_type) {
   mat_type_ = mat_type;
   // Note: do not clear before calling SparseMatrix::allocate!
   if (mat_type_ == GrB_SPARSE) {
+    CHECK(sparse_.unshare());
     CHECK(sparse_.allocate());
   } else if (mat_type_ == GrB_DENSE) {
     CHECK(dense_.allocate());
@@ -321,6 +405,16 @@ inline Info Matrix<T>::getSymmetry(bool* symmetry) const {
   return GrB_SUCCESS;
 }
 
+// Matrix may hold both sparse and dense storage, so count both
+template <typename T>
+Info Matrix<T>::getMemory(MemorySpace space, size_t* bytes) const {
+  size_t sparse_bytes, dense_bytes;
+  CHECK(sparse_.getMemory(space, &sparse_bytes));
+  CHECK(dense_.getMemory(space, &dense_bytes));
+  *bytes = sparse_bytes + dense_bytes;
+  return GrB_SUCCESS;
+}
+
 template <typename T>
 template <typename MatrixT>
 MatrixT* Matrix<T>::getMatrix() const {
@@ -346,6 +440,17 @@ Info Matrix<T>::fillAscending(Index axis, Index nvals, U start) {
     return sparse_.fillAscending(axis, nvals, start);
   return GrB_UNINITIALIZED_OBJECT;
 }
+
+template <typename T>
+Info Matrix<T>::swap(Matrix* rhs) {  // NOLINT(build/include_what_you_use)
+  CHECK(sparse_.swap(&rhs->sparse_));
+  CHECK(dense_.swap(&rhs->dense_));
+  std::swap(nrows_,    rhs->nrows_);
+  std::swap(ncols_,    rhs->ncols_);
+  std::swap(nvals_,    rhs->nvals_);
+  std::swap(mat_type_, rhs->mat_type_);
+  return GrB_SUCCESS;
+}
 }  // namespace backend
 }  // namespace graphblas
 
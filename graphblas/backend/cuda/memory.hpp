@@ -0,0 +1,268 @@
+#ifndef GRAPHBLAS_BACKEND_CUDA_MEMORY_HPP_
+#define GRAPHBLAS_BACKEND_CUDA_MEMORY_HPP_
+
+#include <cuda.h>
+#include <cuda_runtime.h>
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <iostream>
+#include <cstdlib>
+
+#include "graphblas/thread_pool.hpp"
+#include "graphblas/backend/cuda/util.hpp"
+
+namespace graphblas {
+namespace backend {
+
+/*!
+ * \brief Process-wide accounting of every host and device allocation made by
+ *        the backend
+ *
+ * Counters are atomics and are updated once per allocation and free (never
+ * in inner loops), so tracking is always on. The pointer to size map is only
+ * touched on allocate and free.
+ *
+ * The map also holds a reference count per allocation, so that dup() can
+ * share arrays between objects (copy-on-write). An allocation is only freed
+ * once its last reference is removed.
+ */
+class MemoryTracker {
+ public:
+  MemoryTracker() : verbose_(false) {
+    for (int space = 0; space < GrB_MEMORY_NSPACE; ++space) {
+      for (int category = 0; category <= GrB_MEMORY_ALL; ++category) {
+        current_[space][category] = 0;
+        peak_[space][category]    = 0;
+        nalloc_[space][category]  = 0;
+        nfree_[space][category]   = 0;
+      }
+    }
+  }
+
+  void add(const void* ptr, size_t bytes, MemorySpace space,
+           MemoryCategory category);
+  // Drops one reference to ptr. Returns true if memory should be freed i.e.
+  // this was the last reference or ptr is untracked
+  bool remove(const void* ptr);
+
+  // Adds one reference to each non-NULL ptrs[i]. If any of them is untracked
+  // (e.g. user-provided device pointer), nothing is changed and false is
+  // returned
+  bool retain(const void* const* ptrs, int nptrs);
+  // True if any non-NULL ptrs[i] has more than one reference
+  bool shared(const void* const* ptrs, int nptrs);
+
+  // Size in bytes of tracked allocation ptr, or 0 if untracked
+  size_t bytes(const void* ptr);
+
+  Info getStats(MemorySpace space, MemoryCategory category,
+                MemoryStats* stats) const;
+  // Peak is set back to current, so peak of a region of code can be measured
+  Info resetPeak();
+  Info print(const char* str) const;
+
+  inline bool verbose() const     { return verbose_; }
+  inline void setVerbose(bool val) { verbose_ = val; }
+
+ private:
+  struct Allocation {
+    size_t         bytes;
+    MemorySpace    space;
+    MemoryCategory category;
+    int            refs;
+  };
+
+  void increment(MemorySpace space, int category, size_t bytes);
+
+ private:
+  std::atomic<size_t> current_[GrB_MEMORY_NSPACE][GrB_MEMORY_ALL+1];
+  std::atomic<size_t> peak_[GrB_MEMORY_NSPACE][GrB_MEMORY_ALL+1];
+  std::atomic<size_t> nalloc_[GrB_MEMORY_NSPACE][GrB_MEMORY_ALL+1];
+  std::atomic<size_t> nfree_[GrB_MEMORY_NSPACE][GrB_MEMORY_ALL+1];
+
+  std::mutex                                  mutex_;
+  std::unordered_map<const void*, Allocation> allocations_;
+
+  bool verbose_;
+};
+
+// Singleton used by all allocation paths
+MemoryTracker& memoryTracker() {
+  static MemoryTracker tracker;
+  return tracker;
+}
+
+void MemoryTracker::add(const void* ptr, size_t bytes, MemorySpace space,
+                        MemoryCategory category) {
+  if (ptr == NULL)
+    return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Allocation allocation = {bytes, space, category, 1};
+    allocations_[ptr] = allocation;
+  }
+  increment(space, category, bytes);
+  increment(space, GrB_MEMORY_ALL, bytes);
+}
+
+bool MemoryTracker::remove(const void* ptr) {
+  if (ptr == NULL)
+    return true;
+  Allocation allocation;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unordered_map<const void*, Allocation>::iterator it =
+        allocations_.find(ptr);
+    // Memory handed to us by user (e.g. Matrix::build from device pointers)
+    if (it == allocations_.end())
+      return true;
+    // Still shared with a dup
+    if (--it->second.refs > 0)
+      return false;
+    allocation = it->second;
+    allocations_.erase(it);
+  }
+  current_[allocation.space][allocation.category] -= allocation.bytes;
+  current_[allocation.space][GrB_MEMORY_ALL]      -= allocation.bytes;
+  nfree_[allocation.space][allocation.category]++;
+  nfree_[allocation.space][GrB_MEMORY_ALL]++;
+  return true;
+}
+
+bool MemoryTracker::retain(const void* const* ptrs, int nptrs) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int i = 0; i < nptrs; ++i)
+    if (ptrs[i] != NULL && allocations_.find(ptrs[i]) == allocations_.end())
+      return false;
+  for (int i = 0; i < nptrs; ++i)
+    if (ptrs[i] != NULL)
+      allocations_[ptrs[i]].refs++;
+  return true;
+}
+
+bool MemoryTracker::shared(const void* const* ptrs, int nptrs) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int i = 0; i < nptrs; ++i) {
+    if (ptrs[i] == NULL)
+      continue;
+    std::unordered_map<const void*, Allocation>::const_iterator it =
+        allocations_.find(ptrs[i]);
+    if (it != allocations_.end() && it->second.refs > 1)
+      return true;
+  }
+  return false;
+}
+
+size_t MemoryTracker::bytes(const void* ptr) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::unordered_map<const void*, Allocation>::const_iterator it =
+      allocations_.find(ptr);
+  return (it == allocations_.end()) ? 0 : it->second.bytes;
+}
+
+Info MemoryTracker::getStats(MemorySpace     space,
+                             MemoryCategory  category,
+                             MemoryStats*    stats) const {
+  if (stats == NULL)
+    return GrB_NULL_POINTER;
+  stats->current = current_[space][category];
+  stats->peak    = peak_[space][category];
+  stats->nalloc  = nalloc_[space][category];
+  stats->nfree   = nfree_[space][category];
+  return GrB_SUCCESS;
+}
+
+Info MemoryTracker::resetPeak() {
+  for (int space = 0; space < GrB_MEMORY_NSPACE; ++space)
+    for (int category = 0; category <= GrB_MEMORY_ALL; ++category)
+      peak_[space][category] = current_[space][category].load();
+  return GrB_SUCCESS;
+}
+
+Info MemoryTracker::print(const char* str) const {
+  const char* space_name[]    = {"host", "device"};
+  const char* category_name[] = {"matrix", "vector", "descriptor", "temp",
+                                 "all"};
+  std::cout << str << ":\n";
+  for (int space = 0; space < GrB_MEMORY_NSPACE; ++space) {
+    for (int category = 0; category <= GrB_MEMORY_ALL; ++category) {
+      std::cout << "  " << space_name[space] << ", "
+          << category_name[category] << ", "
+          << current_[space][category] << " bytes current, "
+          << peak_[space][category] << " bytes peak, "
+          << nalloc_[space][category] << " allocs, "
+          << nfree_[space][category] << " frees\n";
+    }
+  }
+  return GrB_SUCCESS;
+}
+
+void MemoryTracker::increment(MemorySpace space, int category, size_t bytes) {
+  size_t current = (current_[space][category] += bytes);
+  nalloc_[space][category]++;
+
+  size_t peak = peak_[space][category];
+  while (current > peak &&
+         !peak_[space][category].compare_exchange_weak(peak, current)) {}
+}
+
+// Prints device memory usage when memory tracing is on (--memory)
+void printMemory(const char* str) {
+  if (memoryTracker().verbose()) {
+    size_t free, total;
+    MemoryStats stats;
+    CUDA_CALL(cudaMemGetInfo(&free, &total));
+    memoryTracker().getStats(GrB_MEMORY_DEVICE, GrB_MEMORY_ALL, &stats);
+    std::cout << str << ": " << free << " bytes left out of " << total <<
+        " bytes, " << stats.current << " bytes allocated by graphblas\n";
+  }
+}
+
+// Tracked replacements for malloc/free and cudaMalloc/cudaFree
+Info hostMalloc(void** ptr, size_t bytes, MemoryCategory category) {
+  *ptr = malloc(bytes);
+  if (*ptr == NULL && bytes > 0) {
+    std::cout << "Error: CPU out of memory!\n";
+    return GrB_OUT_OF_MEMORY;
+  }
+  // Large arrays (CSR/CSC, vectors) are spread over NUMA nodes, one range
+  // per thread, which is the same split parallelFor starts from
+  if (bytes >= ThreadPool::kFirstTouchBytes)
+    threadPool().firstTouch(*ptr, bytes);
+  memoryTracker().add(*ptr, bytes, GrB_MEMORY_HOST, category);
+  return GrB_SUCCESS;
+}
+
+template <typename T>
+Info hostMalloc(T** ptr, size_t count, MemoryCategory category) {
+  return hostMalloc(reinterpret_cast<void**>(ptr), count*sizeof(T), category);
+}
+
+// Memory is only freed once last copy-on-write reference to it is dropped
+void hostFree(void* ptr) {
+  if (memoryTracker().remove(ptr))
+    free(ptr);
+}
+
+Info deviceMalloc(void** ptr, size_t bytes, MemoryCategory category) {
+  CUDA_CALL(cudaMalloc(ptr, bytes));
+  memoryTracker().add(*ptr, bytes, GrB_MEMORY_DEVICE, category);
+  return GrB_SUCCESS;
+}
+
+template <typename T>
+Info deviceMalloc(T** ptr, size_t count, MemoryCategory category) {
+  return deviceMalloc(reinterpret_cast<void**>(ptr), count*sizeof(T),
+      category);
+}
+
+void deviceFree(void* ptr) {
+  if (memoryTracker().remove(ptr))
+    CUDA_CALL(cudaFree(ptr));
+}
+}  // namespace backend
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_BACKEND_CUDA_MEMORY_HPP_
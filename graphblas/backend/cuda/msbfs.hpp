@@ -0,0 +1,188 @@
+#ifndef GRAPHBLAS_BACKEND_CUDA_MSBFS_HPP_
+#define GRAPHBLAS_BACKEND_CUDA_MSBFS_HPP_
+
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+
+namespace graphblas {
+namespace backend {
+
+// Number of sources advanced together, one per bit of a frontier word
+const Index kMsbfsBatch = 64;
+
+// Records that the sources in bits of vertex col were reached at level, and
+// returns bits so that caller can tell which sources are still expanding
+template <typename T>
+inline uint64_t msbfsVisit(T*       depths,
+                           Index    nrows,
+                           Index    col,
+                           Index    level,
+                           uint64_t bits) {
+  if (depths != NULL) {
+    for (uint64_t left = bits; left != 0; left &= left - 1) {
+      Index source = __builtin_ctzll(left);
+      depths[static_cast<size_t>(source)*nrows + col] =
+          static_cast<T>(level + 1);
+    }
+  }
+  return bits;
+}
+
+/*!
+ * \brief Bit-parallel BFS (MS-BFS) from up to kMsbfsBatch sources
+ *
+ * Bit i of seen[v] is set once v is reached from source i, and bit i of
+ * visit[v] if that happened in last level. One pass over the graph then
+ * advances all sources by one level, so that sources in the same component
+ * share the scan of every edge.
+ *
+ * Pull variant is used whenever in-edges are available: every vertex ORs the
+ * frontier words of its in-neighbours, and stops as soon as all sources have
+ * reached it. Otherwise frontier is pushed along out-edges by one thread.
+ */
+template <typename T>
+Info msbfsBatch(T*           depths,
+                Index*       ecc,
+                const Index* sources,
+                Index        nsources,
+                Index        nrows,
+                bool         use_push,
+                const Index* A_ptr,
+                const Index* A_ind,
+                uint64_t*    seen,
+                uint64_t*    visit,
+                uint64_t*    next) {
+  uint64_t all = (nsources == kMsbfsBatch) ? ~static_cast<uint64_t>(0) :
+      (static_cast<uint64_t>(1) << nsources) - 1;
+
+  threadPool().parallelFor(0, nrows, [&](Index begin, Index end) {
+    std::fill(seen  + begin, seen  + end, 0);
+    std::fill(visit + begin, visit + end, 0);
+  }, 4096);
+  if (depths != NULL) {
+    threadPool().parallelFor(0, nsources, [&](Index begin, Index end) {
+      std::fill(depths + static_cast<size_t>(begin)*nrows,
+                depths + static_cast<size_t>(end)*nrows, static_cast<T>(0));
+    });
+  }
+  for (Index i = 0; i < nsources; ++i) {
+    uint64_t bit = static_cast<uint64_t>(1) << i;
+    seen[sources[i]]  |= bit;
+    visit[sources[i]] |= bit;
+    msbfsVisit(depths, nrows, sources[i], 0, bit);
+    ecc[i] = 0;
+  }
+
+  for (Index level = 1; ; ++level) {
+    if (use_push) {
+      std::fill(next, next + nrows, 0);
+      for (Index row = 0; row < nrows; ++row) {
+        if (visit[row] == 0)
+          continue;
+        for (Index edge = A_ptr[row]; edge < A_ptr[row+1]; ++edge)
+          next[A_ind[edge]] |= visit[row];
+      }
+    }
+
+    // Each vertex only writes its own words of seen, next and depths
+    uint64_t reached = threadPool().parallelReduce(0, nrows,
+        static_cast<uint64_t>(0), [&](Index begin, Index end) {
+      uint64_t reached = 0;
+      for (Index col = begin; col < end; ++col) {
+        uint64_t bits = 0;
+        if (use_push) {
+          bits = next[col];
+        } else if (seen[col] != all) {
+          for (Index edge = A_ptr[col]; edge < A_ptr[col+1]; ++edge) {
+            bits |= visit[A_ind[edge]];
+            if ((bits | seen[col]) == all)
+              break;
+          }
+        }
+        bits      &= ~seen[col];
+        seen[col] |= bits;
+        next[col]  = bits;
+        if (bits != 0)
+          reached |= msbfsVisit(depths, nrows, col, level, bits);
+      }
+      return reached;
+    }, [](uint64_t x, uint64_t y) { return x | y; }, 1024);
+
+    if (reached == 0)
+      break;
+    for (uint64_t left = reached; left != 0; left &= left - 1)
+      ecc[__builtin_ctzll(left)] = level;
+    std::swap(visit, next);
+  }
+  return GrB_SUCCESS;
+}
+
+/*!
+ * \brief CPU multi-source BFS over sources[0, nsources)
+ *
+ * Sources are taken kMsbfsBatch at a time. Depth of vertex j from sources[i]
+ * goes to depths[i*nrows + j], with source at depth 1 and unreached vertices
+ * at 0, like bfs(). ecc[i] is the largest number of hops from sources[i] to a
+ * vertex it reaches. depths may be NULL when only eccentricities are needed,
+ * since it takes nsources*nrows elements.
+ */
+template <typename T, typename a>
+Info msbfsCpu(T*                     depths,
+              Index*                 ecc,
+              const Index*           sources,
+              Index                  nsources,
+              const SparseMatrix<a>* A,
+              Descriptor*            desc) {
+  Desc_value inp1_mode;
+  CHECK(desc->get(GrB_INP1, &inp1_mode));
+
+  SparseMatrixFormat A_format;
+  bool A_symmetric;
+  CHECK(A->getFormat(&A_format));
+  CHECK(A->getSymmetry(&A_symmetric));
+
+  // Traversal goes along rows of A, or columns for A^T, same as vxm. Pull
+  // needs the other one of the two
+  bool use_tran = (inp1_mode == GrB_TRAN);
+  bool has_csc  = (A_format == GrB_SPARSE_MATRIX_CSRCSC);
+  const Index* A_csrRowPtr = A->h_csrRowPtr_;
+  const Index* A_csrColInd = A->h_csrColInd_;
+  const Index* A_cscColPtr = (A_symmetric) ? A->h_csrRowPtr_ : A->h_cscColPtr_;
+  const Index* A_cscRowInd = (A_symmetric) ? A->h_csrColInd_ : A->h_cscRowInd_;
+  bool use_push = !(A_symmetric || use_tran || has_csc);
+
+  CHECK(const_cast<SparseMatrix<a>*>(A)->gpuToCpu());
+
+  WorkspaceScope scope(desc->workspace());
+  Index     nrows = A->nrows_;
+  uint64_t* seen  = desc->workspace()->allocate<uint64_t>(nrows);
+  uint64_t* visit = desc->workspace()->allocate<uint64_t>(nrows);
+  uint64_t* next  = desc->workspace()->allocate<uint64_t>(nrows);
+
+  const Index* A_ptr;
+  const Index* A_ind;
+  if (use_push) {
+    A_ptr = (use_tran) ? A_cscColPtr : A_csrRowPtr;
+    A_ind = (use_tran) ? A_cscRowInd : A_csrColInd;
+  } else {
+    A_ptr = (use_tran) ? A_csrRowPtr : A_cscColPtr;
+    A_ind = (use_tran) ? A_csrColInd : A_cscRowInd;
+  }
+
+  for (Index start = 0; start < nsources; start += kMsbfsBatch) {
+    Index batch = std::min(kMsbfsBatch, nsources - start);
+    if (desc->debug())
+      std::cout << "MS-BFS sources " << start << ":" << start + batch << ", "
+          << ((use_push) ? "push" : "pull") << std::endl;
+    CHECK(msbfsBatch((depths == NULL) ? depths :
+        depths + static_cast<size_t>(start)*nrows, ecc + start,
+        sources + start, batch, nrows, use_push, A_ptr, A_ind, seen, visit,
+        next));
+  }
+  return GrB_SUCCESS;
+}
+}  // namespace backend
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_BACKEND_CUDA_MSBFS_HPP_
@@ -15,7 +15,7 @@ class Matrix;
 template <typename c, typename a, typename b, typename m,
           typename BinaryOpT,     typename SemiringT>
 Info mxm(Matrix<c>*       C,
-         const Matrix<a>* mask,
+         const Matrix<m>* mask,
          BinaryOpT        accum,
          SemiringT        op,
          const Matrix<a>* A,
@@ -33,12 +33,28 @@ Info mxm(Matrix<c>*       C,
   Storage A_mat_type;
   Storage B_mat_type;
   CHECK(A->getStorage(&A_mat_type));
+  CHECK(const_cast<Matrix<a>*>(A)->compact());
   CHECK(B->getStorage(&B_mat_type));
+  CHECK(const_cast<Matrix<b>*>(B)->compact());
 
   if (A_mat_type == GrB_SPARSE && B_mat_type == GrB_SPARSE) {
     CHECK(C->setStorage(GrB_SPARSE));
-    CHECK(cusparse_spgemm2(&C->sparse_, mask, accum, op, &A->sparse_,
-        &B->sparse_, desc));
+    if (mask != NULL) {
+      // TODO: add accum, scmp and dense mask support
+      Storage mask_mat_type;
+      Desc_value scmp_mode;
+      CHECK(mask->getStorage(&mask_mat_type));
+      CHECK(desc->get(GrB_MASK, &scmp_mode));
+      if (mask_mat_type != GrB_SPARSE || scmp_mode == GrB_SCMP ||
+          AccumTraits<BinaryOpT>::enabled)
+        return GrB_INVALID_VALUE;
+      CHECK(const_cast<Matrix<m>*>(mask)->compact());
+      CHECK(spgemmMasked(C, &mask->sparse_, op, &A->sparse_, &B->sparse_,
+          desc));
+    } else {
+      CHECK(cusparse_spgemm2(&C->sparse_, mask, accum, op, &A->sparse_,
+          &B->sparse_, desc));
+    }
   } else {
     std::cout << "Error: SpMM and GEMM not implemented yet!\n";
     /*CHECK( C->setStorage( GrB_DENSE ) );
@@ -87,6 +103,8 @@ Info vxm(Vector<W>*       w,
   Storage A_mat_type;
   CHECK(u->getStorage(&u_vec_type));
   CHECK(A->getStorage(&A_mat_type));
+  bool use_delta;
+  CHECK(compactForSpmvCpu(A, desc, &use_delta));
 
   // Transpose
   Desc_value inp0_mode;
@@ -96,8 +114,7 @@ Info vxm(Vector<W>*       w,
   // Treat vxm as an mxv with transposed matrix
   CHECK(desc->toggle(GrB_INP1));
 
-  LoadBalanceMode lb_mode = getEnv("GRB_LOAD_BALANCE_MODE",
-      GrB_LOAD_BALANCE_MERGE);
+  LoadBalanceMode lb_mode = desc->lbmode();
 
   // Conversions
   // TODO(@ctcyang): add tol
@@ -116,8 +133,12 @@ Info vxm(Vector<W>*       w,
     std::cout << "Symmetric: " << A_symmetric << std::endl;
   }
 
-  // Fallback for lacking CSC storage overrides any mxvmode selections
-  if (!A_symmetric && A_format == GrB_SPARSE_MATRIX_CSRONLY) {
+  // Pending updates are only merged on the fly by CPU SpMV, so they keep vxm
+  // on pull. Fallback for lacking CSC storage overrides any mxvmode selections
+  if (use_delta) {
+    if (u_vec_type == GrB_SPARSE)
+      CHECK(u_t->sparse2dense(op.identity(), desc));
+  } else if (!A_symmetric && A_format == GrB_SPARSE_MATRIX_CSRONLY) {
     if (u_vec_type == GrB_DENSE)
       CHECK(u_t->dense2sparse(op.identity(), desc));
   } else if (vxm_mode == GrB_PUSHPULL) {
@@ -131,6 +152,10 @@ Info vxm(Vector<W>*       w,
   // Check if vector type was changed due to conversion!
   CHECK(u->getStorage(&u_vec_type));
 
+  // Pull with sparse mask on CPU only computes rows of mask
+  bool use_sparse_mask;
+  CHECK(useSparseMaskCpu(mask, accum, desc, &use_sparse_mask));
+
   if (desc->debug())
     std::cout << "u_vec_type: " << u_vec_type << std::endl;
 
@@ -172,11 +197,17 @@ Info vxm(Vector<W>*       w,
       std::cout << "Error: Invalid load-balance algorithm!\n";
     }
     desc->lastmxv_ = GrB_PUSHONLY;
+  } else if (A_mat_type == GrB_SPARSE && use_sparse_mask) {
+    CHECK(w->setStorage(GrB_SPARSE));
+    CHECK(spmvSparseMaskCpu(&w->sparse_, mask, accum, op, &A->sparse_,
+        &u->dense_, desc));
+    desc->lastmxv_ = GrB_PULLONLY;
   } else {
-    // TODO(@ctcyang): Some performance left on table, sparse2dense should
-    // only convert rather than setStorage if accum is being used
-    CHECK(w->setStorage(GrB_DENSE));
-    // CHECK(w->sparse2dense(op.identity(), desc));
+    // Only accum reads w, so otherwise it is not worth converting
+    if (AccumTraits<BinaryOpT>::enabled)
+      CHECK(w->sparse2dense(op.identity(), desc));
+    else
+      CHECK(w->setStorage(GrB_DENSE));
     if (A_mat_type == GrB_SPARSE)
       CHECK(spmv(&w->dense_, mask, accum, op, &A->sparse_, &u->dense_,
           desc));
@@ -221,14 +252,15 @@ Info mxv(Vector<W>*       w,
   Storage A_mat_type;
   CHECK(u->getStorage(&u_vec_type));
   CHECK(A->getStorage(&A_mat_type));
+  bool use_delta;
+  CHECK(compactForSpmvCpu(A, desc, &use_delta));
 
   // Transpose:
   Desc_value inp1_mode;
   CHECK(desc->get(GrB_INP1, &inp1_mode));
   if (inp1_mode != GrB_DEFAULT) return GrB_INVALID_VALUE;
 
-  LoadBalanceMode lb_mode = getEnv("GRB_LOAD_BALANCE_MODE",
-      GrB_LOAD_BALANCE_MERGE);
+  LoadBalanceMode lb_mode = desc->lbmode();
   if (desc->debug())
     std::cout << "Load balance mode: " << lb_mode << std::endl;
 
@@ -242,8 +274,9 @@ Info mxv(Vector<W>*       w,
   CHECK(desc->get(GrB_MXVMODE, &mxv_mode));
   CHECK(desc->get(GrB_TOL,     &tol));
 
-  // Fallback for lacking CSC storage overrides any mxvmode selections
-  if (!A_symmetric && A_format == GrB_SPARSE_MATRIX_CSRONLY) {
+  // Pending updates are only merged on the fly by CPU SpMV, so they keep mxv
+  // on pull. Fallback for lacking CSC storage overrides any mxvmode selections
+  if (use_delta || (!A_symmetric && A_format == GrB_SPARSE_MATRIX_CSRONLY)) {
     if (u_vec_type == GrB_SPARSE)
       CHECK(u_t->sparse2dense(op.identity(), desc));
   } else if (mxv_mode == GrB_PUSHPULL) {
@@ -257,6 +290,10 @@ Info mxv(Vector<W>*       w,
   // Check if vector type was changed due to conversion!
   CHECK(u->getStorage(&u_vec_type));
 
+  // Pull with sparse mask on CPU only computes rows of mask
+  bool use_sparse_mask;
+  CHECK(useSparseMaskCpu(mask, accum, desc, &use_sparse_mask));
+
   // 3 cases:
   // 1) SpMSpV: SpMat x SpVec (preferred to 3)
   // 2) SpMV:   SpMat x DeVec
@@ -292,6 +329,11 @@ Info mxv(Vector<W>*       w,
       std::cout << "Error: Invalid load-balance algorithm!\n";
     }
     desc->lastmxv_ = GrB_PUSHONLY;
+  } else if (A_mat_type == GrB_SPARSE && use_sparse_mask) {
+    CHECK(w->setStorage(GrB_SPARSE));
+    CHECK(spmvSparseMaskCpu(&w->sparse_, mask, accum, op, &A->sparse_,
+        &u->dense_, desc));
+    desc->lastmxv_ = GrB_PULLONLY;
   } else {
     CHECK(w->sparse2dense(op.identity(), desc));
     if (A_mat_type == GrB_SPARSE) {
@@ -351,7 +393,10 @@ Info eWiseMult(Vector<W>*       w,
       Storage mask_type;
       CHECK(mask->getStorage(&mask_type));
       if (mask_type == GrB_DENSE) {
-        CHECK(w->setStorage(GrB_DENSE));
+        if (AccumTraits<BinaryOpT>::enabled)
+          CHECK(w->sparse2dense(op.identity(), desc));
+        else
+          CHECK(w->setStorage(GrB_DENSE));
         CHECK(eWiseMultInner(&w->dense_, mask, accum, op, &u->dense_,
             &v->dense_, desc));
       } else if (mask_type == GrB_SPARSE) {
@@ -362,7 +407,10 @@ Info eWiseMult(Vector<W>*       w,
         return GrB_INVALID_OBJECT;
       }
     } else {
-      CHECK(w->setStorage(GrB_DENSE));
+      if (AccumTraits<BinaryOpT>::enabled)
+        CHECK(w->sparse2dense(op.identity(), desc));
+      else
+        CHECK(w->setStorage(GrB_DENSE));
       CHECK(eWiseMultInner(&w->dense_, mask, accum, op, &u->dense_,
           &v->dense_, desc));
     }
@@ -420,6 +468,7 @@ Info eWiseMult(Matrix<c>*       C,
 
   Storage A_mat_type;
   CHECK(A->getStorage(&A_mat_type));
+  CHECK(const_cast<Matrix<a>*>(A)->compact());
 
   if (A_mat_type == GrB_DENSE) {
     std::cout << "eWiseMult Dense Matrix Broadcast Scalar\n";
@@ -473,6 +522,7 @@ Info eWiseMult(Matrix<c>*       C,
   Storage A_mat_type;
   Storage B_vec_type;
   CHECK(A->getStorage(&A_mat_type));
+  CHECK(const_cast<Matrix<a>*>(A)->compact());
   CHECK(B->getStorage(&B_vec_type));
 
   // u is column vector which gets broadcasted
@@ -572,7 +622,11 @@ Info eWiseAdd(Vector<W>*       w,
     }
   }
 
-  CHECK(w->setStorage(GrB_DENSE));
+  // Under accum, existing entries of w are kept as operand
+  if (AccumTraits<BinaryOpT>::enabled)
+    CHECK(w->sparse2dense(op.identity(), desc));
+  else
+    CHECK(w->setStorage(GrB_DENSE));
   if (u_vec_type == GrB_SPARSE && v_vec_type == GrB_SPARSE) {
     CHECK(eWiseAddInner(&w->dense_, mask, accum, op, &u->sparse_,
         &v->sparse_, desc));
@@ -664,6 +718,19 @@ Info eWiseAdd(Vector<W>*       w,
   return GrB_SUCCESS;
 }
 
+// Dense vector that extract and assign read u from
+template <typename U>
+Info denseInput(const DenseVector<U>** u_t,
+                const Vector<U>*       u,
+                Descriptor*            desc) {
+  Storage u_vec_type;
+  CHECK(u->getStorage(&u_vec_type));
+  if (u_vec_type == GrB_SPARSE)
+    CHECK(const_cast<Vector<U>*>(u)->sparse2dense(static_cast<U>(0), desc));
+  *u_t = &u->dense_;
+  return GrB_SUCCESS;
+}
+
 template <typename W, typename U, typename M,
           typename BinaryOpT>
 Info extract(Vector<W>*                w,
@@ -673,7 +740,76 @@ Info extract(Vector<W>*                w,
              const std::vector<Index>* indices,
              Index                     nindices,
              Descriptor*               desc) {
-  std::cout << "Error: extract vector variant not implemented yet!\n";
+  // Masked variant is not supported yet
+  if (mask != NULL)
+    return GrB_INVALID_VALUE;
+  if (desc->debug())
+    std::cout << "===Begin extract===\n";
+
+  const DenseVector<U>* u_t = NULL;
+  CHECK(denseInput(&u_t, u, desc));
+  if (AccumTraits<BinaryOpT>::enabled)
+    CHECK(w->sparse2dense(static_cast<W>(0), desc));
+  else
+    CHECK(w->setStorage(GrB_DENSE));
+
+  // GrB_ALL is the identity permutation
+  if (indices == NULL) {
+    std::vector<Index> all(nindices);
+    for (Index k = 0; k < nindices; ++k)
+      all[k] = k;
+    CHECK(extractDense(&w->dense_, accum, u_t, all.data(), NULL, nindices,
+        desc));
+  } else {
+    CHECK(extractDense(&w->dense_, accum, u_t, indices->data(), NULL,
+        nindices, desc));
+  }
+
+  if (desc->debug()) {
+    std::cout << "===End extract===\n";
+    CHECK(w->print());
+  }
+  return GrB_SUCCESS;
+}
+
+// Extension: indices are given by dense vector, so that they can be computed
+// on device and never copied to host on GPU path
+template <typename W, typename U, typename M,
+          typename BinaryOpT>
+Info extract(Vector<W>*           w,
+             const Vector<M>*     mask,
+             BinaryOpT            accum,
+             const Vector<U>*     u,
+             const Vector<Index>* indices,
+             Descriptor*          desc) {
+  // Masked variant is not supported yet
+  if (mask != NULL)
+    return GrB_INVALID_VALUE;
+  if (desc->debug())
+    std::cout << "===Begin extract===\n";
+
+  Index nindices = indices->nsize_;
+  const DenseVector<U>*     u_t   = NULL;
+  const DenseVector<Index>* ind_t = NULL;
+  CHECK(denseInput(&u_t, u, desc));
+  CHECK(denseInput(&ind_t, indices, desc));
+  if (AccumTraits<BinaryOpT>::enabled)
+    CHECK(w->sparse2dense(static_cast<W>(0), desc));
+  else
+    CHECK(w->setStorage(GrB_DENSE));
+
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+  if (backend == GrB_SEQUENTIAL)
+    CHECK(const_cast<DenseVector<Index>*>(ind_t)->gpuToCpu());
+  CHECK(extractDense(&w->dense_, accum, u_t, ind_t->h_val_, ind_t->d_val_,
+      nindices, desc));
+
+  if (desc->debug()) {
+    std::cout << "===End extract===\n";
+    CHECK(w->print());
+  }
+  return GrB_SUCCESS;
 }
 
 template <typename c, typename a, typename m,
@@ -712,7 +848,70 @@ Info assign(Vector<W>*                w,
             const std::vector<Index>* indices,
             Index                     nindices,
             Descriptor*               desc) {
-  std::cout << "Error: assign vector variant not implemented yet!\n";
+  // Masked variant is not supported yet
+  if (mask != NULL)
+    return GrB_INVALID_VALUE;
+  if (desc->debug())
+    std::cout << "===Begin assign===\n";
+
+  // Entries of w not in indices keep their value
+  const DenseVector<U>* u_t = NULL;
+  CHECK(denseInput(&u_t, u, desc));
+  CHECK(w->sparse2dense(static_cast<W>(0), desc));
+
+  // GrB_ALL is the identity permutation
+  if (indices == NULL) {
+    std::vector<Index> all(nindices);
+    for (Index k = 0; k < nindices; ++k)
+      all[k] = k;
+    CHECK(assignDenseVector(&w->dense_, accum, u_t, all.data(), NULL,
+        nindices, desc));
+  } else {
+    CHECK(assignDenseVector(&w->dense_, accum, u_t, indices->data(), NULL,
+        nindices, desc));
+  }
+
+  if (desc->debug()) {
+    std::cout << "===End assign===\n";
+    CHECK(w->print());
+  }
+  return GrB_SUCCESS;
+}
+
+// Extension: indices are given by dense vector, so that they can be computed
+// on device and never copied to host on GPU path
+template <typename W, typename U, typename M,
+          typename BinaryOpT>
+Info assign(Vector<W>*           w,
+            const Vector<M>*     mask,
+            BinaryOpT            accum,
+            const Vector<U>*     u,
+            const Vector<Index>* indices,
+            Descriptor*          desc) {
+  // Masked variant is not supported yet
+  if (mask != NULL)
+    return GrB_INVALID_VALUE;
+  if (desc->debug())
+    std::cout << "===Begin assign===\n";
+
+  Index nindices = indices->nsize_;
+  const DenseVector<U>*     u_t   = NULL;
+  const DenseVector<Index>* ind_t = NULL;
+  CHECK(denseInput(&u_t, u, desc));
+  CHECK(denseInput(&ind_t, indices, desc));
+  CHECK(w->sparse2dense(static_cast<W>(0), desc));
+
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+  if (backend == GrB_SEQUENTIAL)
+    CHECK(const_cast<DenseVector<Index>*>(ind_t)->gpuToCpu());
+  CHECK(assignDenseVector(&w->dense_, accum, u_t, ind_t->h_val_,
+      ind_t->d_val_, nindices, desc));
+
+  if (desc->debug()) {
+    std::cout << "===End assign===\n";
+    CHECK(w->print());
+  }
   return GrB_SUCCESS;
 }
 
@@ -832,7 +1031,10 @@ Info apply(Vector<W>*       w,
     applySparse(&w->sparse_, mask, accum, op, &u_t->sparse_, desc);
   // dense variant
   } else if (u_vec_type == GrB_DENSE) {
-    CHECK(w->setStorage(GrB_DENSE));
+    if (AccumTraits<BinaryOpT>::enabled)
+      CHECK(w->sparse2dense(static_cast<W>(0), desc));
+    else
+      CHECK(w->setStorage(GrB_DENSE));
     applyDense(&w->dense_, mask, accum, op, &u_t->dense_, desc);
   } else {
     return GrB_UNINITIALIZED_OBJECT;
@@ -862,6 +1064,7 @@ Info apply(Matrix<c>*       C,
 
   Storage A_mat_type;
   CHECK(A->getStorage(&A_mat_type));
+  CHECK(const_cast<Matrix<a>*>(A)->compact());
 
   // sparse variant
   if (A_mat_type == GrB_SPARSE) {
@@ -882,6 +1085,38 @@ Info apply(Matrix<c>*       C,
   return GrB_SUCCESS;
 }
 
+template <typename c, typename a, typename m,
+          typename BinaryOpT,     typename SelectOpT, typename T>
+Info select(Matrix<c>*       C,
+            const Matrix<m>* mask,
+            BinaryOpT        accum,
+            SelectOpT        op,
+            const Matrix<a>* A,
+            T                thunk,
+            Descriptor*      desc) {
+  if (desc->debug()) {
+    std::cout << "===Begin select===\n";
+    CHECK(const_cast<Matrix<a>*>(A)->print());
+  }
+
+  Storage A_mat_type;
+  CHECK(A->getStorage(&A_mat_type));
+  CHECK(const_cast<Matrix<a>*>(A)->compact());
+
+  // TODO: add mask and accum support
+  if (mask != NULL || AccumTraits<BinaryOpT>::enabled)
+    return GrB_INVALID_VALUE;
+  if (A_mat_type != GrB_SPARSE)
+    return GrB_INVALID_OBJECT;
+  CHECK(selectSparse(C, op, &A->sparse_, thunk, desc));
+
+  if (desc->debug()) {
+    std::cout << "===End select===\n";
+    CHECK(C->print());
+  }
+  return GrB_SUCCESS;
+}
+
 template <typename W, typename a, typename M,
           typename BinaryOpT,     typename MonoidT>
 Info reduce(Vector<W>*       w,
@@ -897,9 +1132,13 @@ Info reduce(Vector<W>*       w,
   // Get storage:
   Storage mat_type;
   CHECK(A->getStorage(&mat_type));
+  CHECK(const_cast<Matrix<a>*>(A)->compact());
   CHECK(w->setStorage(GrB_DENSE));
 
-  if (mask == NULL) {
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+
+  if (mask == NULL || backend == GrB_SEQUENTIAL) {
   // 2 cases:
   // 1) SpMat
   // 2) DeMat
@@ -911,6 +1150,7 @@ Info reduce(Vector<W>*       w,
       return GrB_UNINITIALIZED_OBJECT;
   } else {
     std::cout << "Error: Masked reduce not implemented yet!\n";
+    return GrB_INVALID_VALUE;
   }
 
   if (desc->debug()) {
@@ -955,6 +1195,106 @@ Info reduce(T*               val,
   return GrB_SUCCESS;
 }
 
+template <typename T, typename U, typename V,
+          typename BinaryOpT, typename SemiringT>
+Info eWiseMultReduce(T*               val,
+                     BinaryOpT        accum,
+                     SemiringT        op,
+                     const Vector<U>* u,
+                     const Vector<V>* v,
+                     Descriptor*      desc) {
+  if (desc->debug()) {
+    std::cout << "===Begin eWiseMultReduce===\n";
+    CHECK(const_cast<Vector<U>*>(u)->print());
+    CHECK(const_cast<Vector<V>*>(v)->print());
+  }
+
+  Storage u_vec_type;
+  Storage v_vec_type;
+  CHECK(u->getStorage(&u_vec_type));
+  CHECK(v->getStorage(&v_vec_type));
+
+  // Intersection of u and v, so sparse operand drives the loop, and with
+  // two sparse operands u does and v is looked up by index
+  T identity = op.identity();
+  T result;
+  if (u_vec_type == GrB_DENSE && v_vec_type == GrB_DENSE) {
+    CHECK(eWiseReduceInner(&result, identity, extractMul(op), extractAdd(op),
+        &u->dense_, &v->dense_, desc));
+  } else if (u_vec_type == GrB_SPARSE && v_vec_type == GrB_DENSE) {
+    CHECK(eWiseReduceInner(&result, identity, extractMul(op), extractAdd(op),
+        &u->sparse_, &v->dense_, false, desc));
+  } else if (u_vec_type == GrB_DENSE && v_vec_type == GrB_SPARSE) {
+    CHECK(eWiseReduceInner(&result, identity, extractMul(op), extractAdd(op),
+        &v->sparse_, &u->dense_, true, desc));
+  } else if (u_vec_type == GrB_SPARSE && v_vec_type == GrB_SPARSE) {
+    CHECK(eWiseReduceInner(&result, identity, extractMul(op), extractAdd(op),
+        &u->sparse_, &v->sparse_, false, false, false, desc));
+  } else {
+    return GrB_UNINITIALIZED_OBJECT;
+  }
+  accumScalar(val, result, accum);
+
+  if (desc->debug()) {
+    std::cout << "===End eWiseMultReduce===\n";
+    std::cout << "Output: " << *val << std::endl;
+  }
+  return GrB_SUCCESS;
+}
+
+template <typename T, typename U, typename V,
+          typename BinaryOpT, typename MonoidT, typename SemiringT>
+Info eWiseAddReduce(T*               val,
+                    BinaryOpT        accum,
+                    MonoidT          monoid,
+                    SemiringT        op,
+                    const Vector<U>* u,
+                    const Vector<V>* v,
+                    Descriptor*      desc) {
+  if (desc->debug()) {
+    std::cout << "===Begin eWiseAddReduce===\n";
+    CHECK(const_cast<Vector<U>*>(u)->print());
+    CHECK(const_cast<Vector<V>*>(v)->print());
+  }
+
+  Storage u_vec_type;
+  Storage v_vec_type;
+  CHECK(u->getStorage(&u_vec_type));
+  CHECK(v->getStorage(&v_vec_type));
+
+  // Union of u and v. Dense operand drives the loop and sparse one is looked
+  // up by index, and with two sparse operands, u and then entries of v that
+  // u does not have are each visited once
+  T identity = monoid.identity();
+  T result;
+  if (u_vec_type == GrB_DENSE && v_vec_type == GrB_DENSE) {
+    CHECK(eWiseReduceInner(&result, identity, extractAdd(op), monoid,
+        &u->dense_, &v->dense_, desc));
+  } else if (u_vec_type == GrB_SPARSE && v_vec_type == GrB_DENSE) {
+    CHECK(eWiseReduceInner(&result, identity, extractAdd(op), monoid,
+        &v->dense_, &u->sparse_, true, false, true, desc));
+  } else if (u_vec_type == GrB_DENSE && v_vec_type == GrB_SPARSE) {
+    CHECK(eWiseReduceInner(&result, identity, extractAdd(op), monoid,
+        &u->dense_, &v->sparse_, true, false, false, desc));
+  } else if (u_vec_type == GrB_SPARSE && v_vec_type == GrB_SPARSE) {
+    T v_only;
+    CHECK(eWiseReduceInner(&result, identity, extractAdd(op), monoid,
+        &u->sparse_, &v->sparse_, true, false, false, desc));
+    CHECK(eWiseReduceInner(&v_only, identity, extractAdd(op), monoid,
+        &v->sparse_, &u->sparse_, true, true, false, desc));
+    result = monoid(result, v_only);
+  } else {
+    return GrB_UNINITIALIZED_OBJECT;
+  }
+  accumScalar(val, result, accum);
+
+  if (desc->debug()) {
+    std::cout << "===End eWiseAddReduce===\n";
+    std::cout << "Output: " << *val << std::endl;
+  }
+  return GrB_SUCCESS;
+}
+
 template <typename T, typename a,
           typename BinaryOpT,     typename MonoidT>
 Info reduce(T*               val,
@@ -969,6 +1309,7 @@ Info reduce(T*               val,
   // Get storage:
   Storage mat_type;
   CHECK(A->getStorage(&mat_type));
+  CHECK(const_cast<Matrix<a>*>(A)->compact());
 
   // 2 cases:
   // 1) SpMat
@@ -987,6 +1328,7 @@ Info reduce(T*               val,
     std::cout << "===End reduce===\n";
     std::cout << "Output: " << *val << std::endl;
   }
+  return GrB_SUCCESS;
 }
 
 template <typename c, typename a, typename m,
@@ -1017,7 +1359,9 @@ Info traceMxmTranspose(T*               val,
   Storage A_mat_type;
   Storage B_mat_type;
   CHECK(A->getStorage(&A_mat_type));
+  CHECK(const_cast<Matrix<a>*>(A)->compact());
   CHECK(B->getStorage(&B_mat_type));
+  CHECK(const_cast<Matrix<b>*>(B)->compact());
 
   // 4 cases:
   // 1) SpMat x SpMat
@@ -1078,7 +1422,8 @@ Info graphColor(Vector<W>*       w,
     std::cout << "===Begin cuSPARSE graph color===\n";
 
   CHECK(w->setStorage(GrB_DENSE));
-  
+  CHECK(const_cast<Matrix<a>*>(A)->compact());
+
   cusparse_color(&w->dense_, &A->sparse_, desc);
 
   if (desc->debug()) {
@@ -1109,6 +1454,7 @@ Info applyVxm(Vector<W>*       w,
   Storage A_mat_type;
   CHECK(u->getStorage(&u_vec_type));
   CHECK(A->getStorage(&A_mat_type));
+  CHECK(const_cast<Matrix<a>*>(A)->compact());
 
   // Transpose
   Desc_value inp0_mode;
@@ -1118,8 +1464,7 @@ Info applyVxm(Vector<W>*       w,
   // Treat vxm as an mxv with transposed matrix
   CHECK(desc->toggle(GrB_INP1));
 
-  LoadBalanceMode lb_mode = getEnv("GRB_LOAD_BALANCE_MODE",
-      GrB_LOAD_BALANCE_MERGE);
+  LoadBalanceMode lb_mode = desc->lbmode();
 
   // Conversions
   // TODO(@ctcyang): add tol
@@ -1217,6 +1562,174 @@ Info applyVxm(Vector<W>*       w,
   }
   return GrB_SUCCESS;
 }
+
+template <typename W, typename T, typename U, typename a>
+Info traverse(Vector<W>*       w,
+              Vector<T>*       v,
+              Index*           w_nvals,
+              T                depth,
+              const Vector<U>* u,
+              const Matrix<a>* A,
+              Descriptor*      desc) {
+  if (desc->debug()) {
+    std::cout << "===Begin traverse===\n";
+    CHECK(const_cast<Vector<U>*>(u)->print());
+  }
+
+  Storage A_mat_type;
+  CHECK(A->getStorage(&A_mat_type));
+  CHECK(const_cast<Matrix<a>*>(A)->compact());
+
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+
+  if (backend == GrB_SEQUENTIAL && A_mat_type == GrB_SPARSE) {
+    CHECK(v->sparse2dense(static_cast<T>(0), desc));
+    TraverseDepth<T> visit = {v->dense_.h_val_, depth};
+    CHECK(traverseCpu(w, &v->dense_, w_nvals, visit, u, &A->sparse_, desc));
+  } else {
+    // TODO: fuse GPU variant
+    CHECK(desc->toggle(GrB_MASK));
+    CHECK(vxm<W, U, a, T>(w, v, GrB_NULL, LogicalOrAndSemiring<W>(), u, A,
+        desc));
+    CHECK(desc->toggle(GrB_MASK));
+
+    Index w_nsize;
+    CHECK(w->size(&w_nsize));
+    CHECK(assign(v, w, GrB_NULL, depth, GrB_ALL, w_nsize, desc));
+
+    // Count is accumulated in Index, so it neither overflows W nor rounds
+    Index count = 0;
+    CHECK(reduce(&count, GrB_NULL, PlusMonoid<Index>(), w, desc));
+    *w_nvals = count;
+  }
+
+  if (desc->debug()) {
+    std::cout << "===End traverse===\n";
+    CHECK(w->print());
+    std::cout << "Output: " << *w_nvals << std::endl;
+  }
+  return GrB_SUCCESS;
+}
+
+template <typename W, typename U, typename a>
+Info traverseParent(Vector<W>*       w,
+                    Vector<Index>*   p,
+                    Index*           w_nvals,
+                    const Vector<U>* u,
+                    const Matrix<a>* A,
+                    Descriptor*      desc) {
+  if (desc->debug()) {
+    std::cout << "===Begin traverseParent===\n";
+    CHECK(const_cast<Vector<U>*>(u)->print());
+  }
+
+  Storage A_mat_type;
+  CHECK(A->getStorage(&A_mat_type));
+  CHECK(const_cast<Matrix<a>*>(A)->compact());
+  if (A_mat_type != GrB_SPARSE)
+    return GrB_INVALID_OBJECT;
+
+  CHECK(p->sparse2dense(static_cast<Index>(-1), desc));
+  TraverseParent visit = {p->dense_.h_val_};
+  CHECK(traverseCpu(w, &p->dense_, w_nvals, visit, u, &A->sparse_, desc));
+
+  if (desc->debug()) {
+    std::cout << "===End traverseParent===\n";
+    CHECK(w->print());
+    std::cout << "Output: " << *w_nvals << std::endl;
+  }
+  return GrB_SUCCESS;
+}
+
+template <typename T, typename a>
+Info msbfs(T*               depths,
+           Index*           ecc,
+           const Index*     sources,
+           Index            nsources,
+           const Matrix<a>* A,
+           Descriptor*      desc) {
+  Storage A_mat_type;
+  CHECK(A->getStorage(&A_mat_type));
+  CHECK(const_cast<Matrix<a>*>(A)->compact());
+
+  if (A_mat_type != GrB_SPARSE)
+    return GrB_INVALID_OBJECT;
+  CHECK(msbfsCpu(depths, ecc, sources, nsources, &A->sparse_, desc));
+  return GrB_SUCCESS;
+}
+
+template <typename T, typename a>
+Info pprBatch(Matrix<T>*       P,
+              Index*           topk_ind,
+              T*               topk_val,
+              Index            topk,
+              const Index*     seeds,
+              Index            nseeds,
+              T                alpha,
+              T                eps,
+              const Matrix<a>* A,
+              Descriptor*      desc) {
+  Storage A_mat_type;
+  CHECK(A->getStorage(&A_mat_type));
+  CHECK(const_cast<Matrix<a>*>(A)->compact());
+  if (A_mat_type != GrB_SPARSE)
+    return GrB_INVALID_OBJECT;
+
+  T* P_val = NULL;
+  if (P != NULL) {
+    CHECK(P->setStorage(GrB_DENSE));
+    P_val = P->dense_.h_denseVal_;
+  }
+  CHECK(pprBatchCpu(P_val, topk_ind, topk_val, topk, seeds, nseeds, alpha,
+      eps, &A->sparse_, desc));
+  if (P != NULL)
+    CHECK(P->dense_.cpuToGpu());
+  return GrB_SUCCESS;
+}
+
+template <typename T, typename a>
+Info bcBatch(T*               bc,
+             const Index*     sources,
+             Index            nsources,
+             const Matrix<a>* A,
+             Descriptor*      desc) {
+  Storage A_mat_type;
+  CHECK(A->getStorage(&A_mat_type));
+  CHECK(const_cast<Matrix<a>*>(A)->compact());
+
+  if (A_mat_type != GrB_SPARSE)
+    return GrB_INVALID_OBJECT;
+  CHECK(bcCpu(bc, sources, nsources, &A->sparse_, desc));
+  return GrB_SUCCESS;
+}
+
+template <typename T>
+Info residualUpdate(Vector<T>*       p,
+                    Vector<T>*       r,
+                    Vector<T>*       f,
+                    Index*           f_nvals,
+                    const Vector<T>* t,
+                    const Vector<T>* thr,
+                    Descriptor*      desc) {
+  if (desc->debug()) {
+    std::cout << "===Begin residualUpdate===\n";
+    CHECK(const_cast<Vector<T>*>(t)->print());
+  }
+
+  CHECK(p->sparse2dense(static_cast<T>(0), desc));
+  CHECK(r->sparse2dense(static_cast<T>(0), desc));
+  CHECK(const_cast<Vector<T>*>(thr)->sparse2dense(static_cast<T>(0), desc));
+  CHECK(residualUpdateCpu(&p->dense_, &r->dense_, f, f_nvals, t, &thr->dense_,
+      desc));
+
+  if (desc->debug()) {
+    std::cout << "===End residualUpdate===\n";
+    CHECK(f->print());
+    std::cout << "Output: " << *f_nvals << std::endl;
+  }
+  return GrB_SUCCESS;
+}
 }  // namespace backend
 }  // namespace graphblas
 
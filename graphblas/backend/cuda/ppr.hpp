@@ -0,0 +1,331 @@
+#ifndef GRAPHBLAS_BACKEND_CUDA_PPR_HPP_
+#define GRAPHBLAS_BACKEND_CUDA_PPR_HPP_
+
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace graphblas {
+namespace backend {
+
+// Number of seeds iterated together. Each row of the block is then 32 values,
+// which are read together for every edge
+const Index kPprBatch = 32;
+
+// One iteration for k seeds of the block: next = cur*A + (1-alpha)*E, where
+// column c of E is 1 at seed[c]. Blocks are row-major, so row j holds the k
+// values of vertex j. Returns squared l2 distance between next and cur of
+// each column
+template <typename T, typename a>
+std::vector<T> pprBatchIter(T*           next,
+                            const T*     cur,
+                            const Index* seed,
+                            Index        k,
+                            Index        nrows,
+                            T            alpha,
+                            bool         use_push,
+                            const Index* A_ptr,
+                            const Index* A_ind,
+                            const a*     A_val) {
+  // Push scatters along out-edges, so it is left to one thread
+  if (use_push) {
+    std::fill(next, next + static_cast<size_t>(nrows)*k, static_cast<T>(0));
+    for (Index row = 0; row < nrows; ++row) {
+      const T* in = cur + static_cast<size_t>(row)*k;
+      for (Index edge = A_ptr[row]; edge < A_ptr[row+1]; ++edge) {
+        T  val = static_cast<T>(A_val[edge]);
+        T* out = next + static_cast<size_t>(A_ind[edge])*k;
+        for (Index c = 0; c < k; ++c)
+          out[c] += val*in[c];
+      }
+    }
+  }
+
+  // Each vertex only writes its own row of next
+  return threadPool().parallelReduce(0, nrows, std::vector<T>(k, 0),
+      [&](Index begin, Index end) {
+    std::vector<T> error(k, 0);
+    for (Index col = begin; col < end; ++col) {
+      T*       out  = next + static_cast<size_t>(col)*k;
+      const T* prev = cur  + static_cast<size_t>(col)*k;
+      if (!use_push) {
+        std::fill(out, out + k, static_cast<T>(0));
+        for (Index edge = A_ptr[col]; edge < A_ptr[col+1]; ++edge) {
+          T        val = static_cast<T>(A_val[edge]);
+          const T* in  = cur + static_cast<size_t>(A_ind[edge])*k;
+          for (Index c = 0; c < k; ++c)
+            out[c] += val*in[c];
+        }
+      }
+      for (Index c = 0; c < k; ++c) {
+        if (seed[c] == col)
+          out[c] += 1 - alpha;
+        T diff    = out[c] - prev[c];
+        error[c] += diff*diff;
+      }
+    }
+    return error;
+  }, [](std::vector<T> x, const std::vector<T>& y) {
+    for (size_t c = 0; c < x.size(); ++c)
+      x[c] += y[c];
+    return x;
+  }, 256);
+}
+
+// Writes column c of block (k columns) as result of seed number i
+template <typename T>
+void pprBatchStore(T*       P_val,
+                   Index*   topk_ind,
+                   T*       topk_val,
+                   Index    topk,
+                   Index    nseeds,
+                   Index    i,
+                   const T* block,
+                   Index    k,
+                   Index    c,
+                   Index    nrows) {
+  if (P_val != NULL) {
+    threadPool().parallelFor(0, nrows, [&](Index begin, Index end) {
+      for (Index row = begin; row < end; ++row)
+        P_val[static_cast<size_t>(row)*nseeds + i] =
+            block[static_cast<size_t>(row)*k + c];
+    }, 4096);
+  }
+
+  // Largest values first, and smaller index first among equal values
+  if (topk_ind != NULL && topk > 0) {
+    std::vector<Index> order(nrows);
+    for (Index row = 0; row < nrows; ++row)
+      order[row] = row;
+    std::partial_sort(order.begin(), order.begin() + topk, order.end(),
+        [&](Index x, Index y) {
+      T x_val = block[static_cast<size_t>(x)*k + c];
+      T y_val = block[static_cast<size_t>(y)*k + c];
+      return (x_val > y_val) || (x_val == y_val && x < y);
+    });
+    for (Index j = 0; j < topk; ++j) {
+      topk_ind[static_cast<size_t>(i)*topk + j] = order[j];
+      if (topk_val != NULL)
+        topk_val[static_cast<size_t>(i)*topk + j] =
+            block[static_cast<size_t>(order[j])*k + c];
+    }
+  }
+}
+
+/*!
+ * \brief CPU personalized PageRank for many seeds, iterated as dense block
+ *
+ * Up to kPprBatch seeds share every pass over A. Seed i leaves the block once
+ * its l2 change is at most eps or it has done desc->max_niter_ iterations,
+ * and pending seeds take over freed columns, so the block stays full until
+ * seeds run out. Result of seed i goes to column i of P_val (nrows x nseeds,
+ * row-major) and/or its top-k entries to topk_ind and topk_val, starting at
+ * i*topk. Outputs that are NULL are skipped.
+ */
+template <typename T, typename a>
+Info pprBatchCpu(T*                     P_val,
+                 Index*                 topk_ind,
+                 T*                     topk_val,
+                 Index                  topk,
+                 const Index*           seeds,
+                 Index                  nseeds,
+                 T                      alpha,
+                 T                      eps,
+                 const SparseMatrix<a>* A,
+                 Descriptor*            desc) {
+  Desc_value inp1_mode;
+  CHECK(desc->get(GrB_INP1, &inp1_mode));
+
+  SparseMatrixFormat A_format;
+  bool A_symmetric;
+  CHECK(A->getFormat(&A_format));
+  CHECK(A->getSymmetry(&A_symmetric));
+
+  // p = pA pulls along columns of A, and p = pA^T along rows, same as vxm
+  bool use_tran = (inp1_mode == GrB_TRAN);
+  bool has_csc  = (A_format == GrB_SPARSE_MATRIX_CSRCSC);
+  bool use_push = !(A_symmetric || use_tran || has_csc);
+  const Index* A_ptr;
+  const Index* A_ind;
+  const a*     A_val;
+  if (use_tran || use_push) {
+    A_ptr = A->h_csrRowPtr_;
+    A_ind = A->h_csrColInd_;
+    A_val = A->h_csrVal_;
+  } else {
+    A_ptr = (A_symmetric) ? A->h_csrRowPtr_ : A->h_cscColPtr_;
+    A_ind = (A_symmetric) ? A->h_csrColInd_ : A->h_cscRowInd_;
+    A_val = (A_symmetric) ? A->h_csrVal_    : A->h_cscVal_;
+  }
+
+  CHECK(const_cast<SparseMatrix<a>*>(A)->gpuToCpu());
+
+  WorkspaceScope scope(desc->workspace());
+  Index  nrows  = A->nrows_;
+  size_t nblock = static_cast<size_t>(nrows)*kPprBatch;
+  T* cur  = desc->workspace()->allocate<T>(nblock);
+  T* next = desc->workspace()->allocate<T>(nblock);
+
+  // Seed number, seed vertex and iteration count of every active column
+  std::vector<Index> number, seed, niter;
+  std::vector<bool>  done;
+  Index k       = 0;
+  Index pending = 0;
+  while (true) {
+    // Retire converged columns, then fill up block with pending seeds
+    std::vector<Index> keep;
+    for (Index c = 0; c < k; ++c) {
+      if (done[c])
+        pprBatchStore(P_val, topk_ind, topk_val, topk, nseeds, number[c], cur,
+            k, c, nrows);
+      else
+        keep.push_back(c);
+    }
+    Index nkeep = keep.size();
+    Index nnew  = std::min(kPprBatch - nkeep, nseeds - pending);
+    if (nkeep != k || nnew > 0) {
+      Index k_new = nkeep + nnew;
+      threadPool().parallelFor(0, nrows, [&](Index begin, Index end) {
+        for (Index row = begin; row < end; ++row) {
+          T* out = next + static_cast<size_t>(row)*k_new;
+          const T* in = cur + static_cast<size_t>(row)*k;
+          for (Index c = 0; c < nkeep; ++c)
+            out[c] = in[keep[c]];
+          for (Index c = 0; c < nnew; ++c)
+            out[nkeep + c] = (seeds[pending + c] == row) ? 1 : 0;
+        }
+      }, 4096);
+
+      std::vector<Index> number_new, seed_new, niter_new;
+      for (Index c = 0; c < nkeep; ++c) {
+        number_new.push_back(number[keep[c]]);
+        seed_new.push_back(seed[keep[c]]);
+        niter_new.push_back(niter[keep[c]]);
+      }
+      for (Index c = 0; c < nnew; ++c) {
+        number_new.push_back(pending + c);
+        seed_new.push_back(seeds[pending + c]);
+        niter_new.push_back(0);
+      }
+      number.swap(number_new);
+      seed.swap(seed_new);
+      niter.swap(niter_new);
+      std::swap(cur, next);
+      k        = k_new;
+      pending += nnew;
+    }
+    if (k == 0)
+      break;
+
+    std::vector<T> error = pprBatchIter(next, cur, seed.data(), k, nrows,
+        alpha, use_push, A_ptr, A_ind, A_val);
+    std::swap(cur, next);
+
+    done.assign(k, false);
+    for (Index c = 0; c < k; ++c) {
+      niter[c]++;
+      done[c] = std::sqrt(error[c]) <= eps || niter[c] >= desc->max_niter_;
+    }
+    if (desc->debug())
+      std::cout << "PPR block: " << k << " seeds, " << pending << "/"
+          << nseeds << " started" << std::endl;
+  }
+  return GrB_SUCCESS;
+}
+
+/*!
+ * \brief CPU residual update of push PageRank, after t = fA has pushed
+ * residual f of active vertices along their out-edges
+ *
+ * p(f) += f and r(f) = 0, then r(t) += t, and f is rebuilt as SpVec of those
+ * touched by t with r(i) > thr(i), holding r(i). Vertices missed by both f and
+ * t keep r below threshold, so this is all of active set. Only entries of f
+ * and t are visited while they are SpVec. f with no storage yet is empty
+ */
+template <typename T>
+Info residualUpdateCpu(DenseVector<T>*       p,
+                       DenseVector<T>*       r,
+                       Vector<T>*            f,
+                       Index*                f_nvals,
+                       const Vector<T>*      t,
+                       const DenseVector<T>* thr,
+                       Descriptor*           desc) {
+  CHECK(p->gpuToCpu());
+  CHECK(r->gpuToCpu());
+  CHECK(const_cast<DenseVector<T>*>(thr)->gpuToCpu());
+  T*       p_val   = p->h_val_;
+  T*       r_val   = r->h_val_;
+  const T* thr_val = thr->h_val_;
+  Index    nsize   = r->nvals_;
+
+  // Residual of f moves into p. Indices of f are distinct, so no races
+  Storage f_vec_type;
+  CHECK(f->getStorage(&f_vec_type));
+  if (f_vec_type == GrB_SPARSE) {
+    CHECK(f->sparse_.gpuToCpu());
+    const Index* f_ind = f->sparse_.h_ind_;
+    const T*     f_val = f->sparse_.h_val_;
+    threadPool().parallelFor(0, f->sparse_.nvals_, [&](Index begin,
+        Index end) {
+      for (Index k = begin; k < end; ++k) {
+        p_val[f_ind[k]] += f_val[k];
+        r_val[f_ind[k]]  = static_cast<T>(0);
+      }
+    }, 4096);
+  } else if (f_vec_type == GrB_DENSE) {
+    CHECK(f->dense_.gpuToCpu());
+    const T* f_val = f->dense_.h_val_;
+    threadPool().parallelFor(0, nsize, [&](Index begin, Index end) {
+      for (Index i = begin; i < end; ++i) {
+        if (f_val[i] != static_cast<T>(0)) {
+          p_val[i] += f_val[i];
+          r_val[i]  = static_cast<T>(0);
+        }
+      }
+    }, 4096);
+  }
+
+  // Next frontier is written in index order, since t is
+  CHECK(f->setStorage(GrB_SPARSE));
+  Index* f_ind   = f->sparse_.h_ind_;
+  T*     f_val   = f->sparse_.h_val_;
+  Index  nactive = 0;
+  auto   spread  = [&](Index i, T val) {
+    r_val[i] += val;
+    if (r_val[i] > thr_val[i]) {
+      f_ind[nactive]   = i;
+      f_val[nactive++] = r_val[i];
+    }
+  };
+  Storage t_vec_type;
+  CHECK(t->getStorage(&t_vec_type));
+  if (t_vec_type == GrB_SPARSE) {
+    CHECK(const_cast<SparseVector<T>*>(&t->sparse_)->gpuToCpu());
+    for (Index k = 0; k < t->sparse_.nvals_; ++k)
+      spread(t->sparse_.h_ind_[k], t->sparse_.h_val_[k]);
+  } else if (t_vec_type == GrB_DENSE) {
+    CHECK(const_cast<DenseVector<T>*>(&t->dense_)->gpuToCpu());
+    for (Index i = 0; i < nsize; ++i)
+      if (t->dense_.h_val_[i] != static_cast<T>(0))
+        spread(i, t->dense_.h_val_[i]);
+  } else {
+    return GrB_UNINITIALIZED_OBJECT;
+  }
+  f->sparse_.nvals_ = nactive;
+  *f_nvals = nactive;
+
+  if (desc->debug())
+    std::cout << "Residual update: " << nactive << "/" << nsize
+        << " active" << std::endl;
+
+  CHECK(f->sparse_.cpuToGpu());
+  CHECK(p->cpuToGpu());
+  CHECK(r->cpuToGpu());
+  return GrB_SUCCESS;
+}
+}  // namespace backend
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_BACKEND_CUDA_PPR_HPP_
@@ -3,7 +3,15 @@
 
 #include <cub.cuh>
 
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <type_traits>
+#include <vector>
+#include <algorithm>
+
+#include "graphblas/backend/cuda/kernels/kernels.hpp"
 
 namespace graphblas {
 namespace backend {
@@ -47,6 +55,45 @@ Info reduceCommon(T*          val,
   return GrB_SUCCESS;
 }
 
+// CPU reduction of f(i) over [first, last) with op. If op has a terminal
+// value, a chunk stops once its own sum reaches it, and the others stop soon
+// after, since no remaining element can change result
+template <typename T, typename MonoidT, typename F>
+T reduceCpu(Index first, Index last, T identity, MonoidT op, const F& f) {
+  if (!MonoidT::has_terminal) {
+    return threadPool().parallelReduce(first, last, identity,
+        [&](Index begin, Index end) {
+      T sum = identity;
+      for (Index i = begin; i < end; ++i)
+        sum = op(sum, f(i));
+      return sum;
+    }, op, 4096);
+  }
+
+  const T terminal = static_cast<T>(op.terminal());
+  return threadPool().parallelReduceUntil(first, last, identity, terminal,
+      [&](Index begin, Index end, const std::atomic<bool>& stop) {
+    T sum = identity;
+    for (Index i = begin; i < end && sum != terminal; ++i) {
+      sum = op(sum, f(i));
+      // Flag is only polled every so often to keep it out of inner loop
+      if ((i & 1023) == 0 && stop.load(std::memory_order_relaxed))
+        break;
+    }
+    return sum;
+  }, op, 4096);
+}
+
+template <typename T, typename U, typename MonoidT>
+Info reduceCommonCpu(T*          val,
+                     MonoidT     op,
+                     const U*    h_val,
+                     Index       nvals) {
+  *val = reduceCpu(0, nvals, static_cast<T>(op.identity()), op,
+      [&](Index i) { return h_val[i]; });
+  return GrB_SUCCESS;
+}
+
 // Dense vector variant
 template <typename T, typename U,
           typename BinaryOpT, typename MonoidT>
@@ -55,6 +102,13 @@ Info reduceInner(T*                     val,
                  MonoidT                op,
                  const DenseVector<U>*  u,
                  Descriptor*            desc) {
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+
+  if (backend == GrB_SEQUENTIAL) {
+    CHECK(const_cast<DenseVector<U>*>(u)->gpuToCpu());
+    return reduceCommonCpu(val, op, u->h_val_, u->nvals_);
+  }
   return reduceCommon(val, accum, op, u->d_val_, u->nvals_, desc);
 }
 
@@ -66,10 +120,17 @@ Info reduceInner(T*                     val,
                  MonoidT                op,
                  const SparseVector<U>* u,
                  Descriptor*            desc) {
-  if (desc->struconly())
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+
+  if (desc->struconly()) {
     *val = u->nvals_;
-  else
+  } else if (backend == GrB_SEQUENTIAL) {
+    CHECK(const_cast<SparseVector<U>*>(u)->gpuToCpu());
+    return reduceCommonCpu(val, op, u->h_val_, u->nvals_);
+  } else {
     return reduceCommon(val, accum, op, u->d_val_, u->nvals_, desc);
+  }
   return GrB_SUCCESS;
 }
 
@@ -81,10 +142,17 @@ Info reduceInner(T*                     val,
                  MonoidT                op,
                  const SparseMatrix<a>* A,
                  Descriptor*            desc) {
-  if (desc->struconly())
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+
+  if (desc->struconly()) {
     *val = A->nvals_;
-  else
+  } else if (backend == GrB_SEQUENTIAL) {
+    CHECK(const_cast<SparseMatrix<a>*>(A)->gpuToCpu());
+    return reduceCommonCpu(val, op, A->h_csrVal_, A->nvals_);
+  } else {
     return reduceCommon(val, accum, op, A->d_csrVal_, A->nvals_, desc);
+  }
   return GrB_SUCCESS;
 }
 
@@ -110,6 +178,58 @@ Info reduceInner(DenseVector<W>*        w,
                  MonoidT                op,
                  const SparseMatrix<a>* A,
                  Descriptor*            desc) {
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+
+  // Row stops once it reaches terminal of op, if op has one. Rows left out by
+  // mask are identity, and non-complemented sparse mask only visits its rows
+  if (backend == GrB_SEQUENTIAL) {
+    Desc_value scmp_mode;
+    CHECK(desc->get(GrB_MASK, &scmp_mode));
+    WorkspaceScope scope(desc->workspace());
+    MaskCpu<M> mask_cpu;
+    CHECK(mask_cpu.init(mask, scmp_mode == GrB_SCMP, false,
+        desc->workspace()));
+
+    CHECK(const_cast<SparseMatrix<a>*>(A)->gpuToCpu());
+    const W identity = op.identity();
+    const W terminal = op.terminal();
+    auto row_op = [&](Index row) {
+      W sum = identity;
+      for (Index edge = A->h_csrRowPtr_[row];
+           edge < A->h_csrRowPtr_[row+1]; ++edge) {
+        sum = op(sum, A->h_csrVal_[edge]);
+        if (MonoidT::has_terminal && sum == terminal)
+          break;
+      }
+      w->h_val_[row] = sum;
+    };
+
+    if (mask_cpu.indexed()) {
+      threadPool().parallelFor(0, A->nrows_, [&](Index begin, Index end) {
+        std::fill(w->h_val_ + begin, w->h_val_ + end, identity);
+      }, 4096);
+      Index nindex = mask_cpu.nindex();
+      threadPool().parallelFor(0, nindex, [&](Index begin, Index end) {
+        for (Index k = begin; k < end; ++k)
+          row_op(mask_cpu.index(k));
+      }, 64);
+    } else {
+      threadPool().parallelFor(0, A->nrows_, [&](Index begin, Index end) {
+        for (Index row = begin; row < end; ++row) {
+          if (mask_cpu.allowed(row))
+            row_op(row);
+          else
+            w->h_val_[row] = identity;
+        }
+      }, 1024);
+    }
+    w->nnz_ = A->nrows_;
+    CHECK(w->cpuToGpu());
+    w->need_update_ = false;
+    return GrB_SUCCESS;
+  }
+
   // TODO(@ctcyang): Structure-only optimization uses CSR row pointers
   if (desc->struconly()) {
   } else {
@@ -117,7 +237,7 @@ Info reduceInner(DenseVector<W>*        w,
     // first_argument_type requirement for mgpu ops
     // mgpu::SegReduceCsr( A->d_csrVal_, A->d_csrRowPtr_,
     //     static_cast<int>(A->nvals_), static_cast<int>(A->nrows_),
-    //     true, w->d_val_, op.identity(), op, *desc->d_context_ );
+    //     true, w->d_val_, op.identity(), op, desc->context() );
 
     // Use CUB
     size_t temp_storage_bytes = 0;
@@ -141,6 +261,308 @@ Info reduceInner(DenseVector<W>*        w,
 
   return GrB_SUCCESS;
 }
+
+// *val = accum(*val, t), or t if no accum is given
+template <typename T, typename BinaryOpT>
+inline void accumScalar(T* val, T t, BinaryOpT accum, std::true_type) {
+  *val = accum(*val, t);
+}
+
+template <typename T, typename BinaryOpT>
+inline void accumScalar(T* val, T t, BinaryOpT accum, std::false_type) {
+  *val = t;
+}
+
+template <typename T, typename BinaryOpT>
+inline void accumScalar(T* val, T t, BinaryOpT accum) {
+  accumScalar(val, t, accum, std::integral_constant<bool,
+      AccumTraits<BinaryOpT>::enabled>());
+}
+
+/*!
+ * \brief Fused element-wise op and reduction to scalar
+ *   val = \sum_i ewise_op(u(i), v(i))    sum: reduce_op
+ *
+ * One pass over u and v with no temporary vector, unlike eWiseMult or
+ * eWiseAdd followed by reduce. u is dense (u_ind == NULL) or sparse. v is
+ * dense (v_pos == NULL), or sparse and looked up through v_pos, which holds
+ * position of each index in v or -1. Entries of u that v does not have count
+ * as u(i) if keep_unmatched, and entries both have are left out if
+ * skip_matched, which together give union of two sparse vectors over two
+ * calls. reverse means ewise_op(v(i), u(i)) is used for non-commutative ops
+ */
+template <typename T, typename U, typename V,
+          typename EWiseOpT, typename ReduceOpT>
+Info eWiseReduceCommon(T*           val,
+                       T            identity,
+                       EWiseOpT     ewise_op,
+                       ReduceOpT    reduce_op,
+                       const Index* u_ind,
+                       const U*     u_val,
+                       Index        u_nvals,
+                       const Index* v_pos,
+                       const V*     v_val,
+                       bool         keep_unmatched,
+                       bool         skip_matched,
+                       bool         reverse,
+                       Descriptor*  desc) {
+  // Block size is fixed, since it is a template parameter of cub::BlockReduce
+  const int nt = 256;
+  const int max_nb = 1024;
+  int nb = static_cast<int>(std::min<Index>((u_nvals + nt - 1) / nt, max_nb));
+
+  *val = identity;
+  if (nb == 0)
+    return GrB_SUCCESS;
+
+  CHECK(desc->resize(nb*sizeof(T), "buffer"));
+  T* d_block_val = reinterpret_cast<T*>(desc->d_buffer_);
+
+  dim3 NT, NB;
+  NT.x = nt;
+  NT.y = 1;
+  NT.z = 1;
+  NB.x = nb;
+  NB.y = 1;
+  NB.z = 1;
+
+  eWiseReduceKernel<nt><<<NB, NT>>>(d_block_val, identity, ewise_op,
+      reduce_op, u_ind, u_val, u_nvals, v_pos, v_val, keep_unmatched,
+      skip_matched, reverse);
+
+  // At most max_nb partial results, so finish on host
+  std::vector<T> h_block_val(nb);
+  CUDA_CALL(cudaMemcpy(h_block_val.data(), d_block_val, nb*sizeof(T),
+      cudaMemcpyDeviceToHost));
+  for (int block = 0; block < nb; ++block)
+    *val = reduce_op(*val, h_block_val[block]);
+
+  if (desc->debug())
+    std::cout << "nvals: " << u_nvals << ", blocks: " << nb << std::endl;
+  return GrB_SUCCESS;
+}
+
+// Dense x dense vector variant
+template <typename T, typename U, typename V,
+          typename EWiseOpT, typename ReduceOpT>
+Info eWiseReduceInner(T*                    val,
+                      T                     identity,
+                      EWiseOpT              ewise_op,
+                      ReduceOpT             reduce_op,
+                      const DenseVector<U>* u,
+                      const DenseVector<V>* v,
+                      Descriptor*           desc) {
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+
+  if (backend == GrB_SEQUENTIAL) {
+    CHECK(const_cast<DenseVector<U>*>(u)->gpuToCpu());
+    CHECK(const_cast<DenseVector<V>*>(v)->gpuToCpu());
+    *val = reduceCpu(0, u->nvals_, identity, reduce_op, [&](Index i) {
+      return ewise_op(u->h_val_[i], v->h_val_[i]);
+    });
+    return GrB_SUCCESS;
+  }
+  return eWiseReduceCommon(val, identity, ewise_op, reduce_op,
+      static_cast<const Index*>(NULL), u->d_val_, u->nvals_,
+      static_cast<const Index*>(NULL), v->d_val_, false, false, false, desc);
+}
+
+// Sparse x dense vector variant
+template <typename T, typename U, typename V,
+          typename EWiseOpT, typename ReduceOpT>
+Info eWiseReduceInner(T*                     val,
+                      T                      identity,
+                      EWiseOpT               ewise_op,
+                      ReduceOpT              reduce_op,
+                      const SparseVector<U>* u,
+                      const DenseVector<V>*  v,
+                      bool                   reverse,
+                      Descriptor*            desc) {
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+
+  if (backend == GrB_SEQUENTIAL) {
+    CHECK(const_cast<SparseVector<U>*>(u)->gpuToCpu());
+    CHECK(const_cast<DenseVector<V>*>(v)->gpuToCpu());
+    *val = reduceCpu(0, u->nvals_, identity, reduce_op, [&](Index i) {
+      U u_t = u->h_val_[i];
+      V v_t = v->h_val_[u->h_ind_[i]];
+      return (reverse) ? ewise_op(v_t, u_t) : ewise_op(u_t, v_t);
+    });
+    return GrB_SUCCESS;
+  }
+  return eWiseReduceCommon(val, identity, ewise_op, reduce_op, u->d_ind_,
+      u->d_val_, u->nvals_, static_cast<const Index*>(NULL), v->d_val_, false,
+      false, reverse, desc);
+}
+
+/*!
+ * \brief Host lookup of sparse vector entries by index, for fused reductions
+ * whose other operand is matched against it
+ *
+ * Indices of sparse vector need not be sorted. Bitmap says which indices it
+ * has, and position of each in h_ind_ is only written and read where bit is
+ * set, so only bitmap is cleared. Both are taken from workspace, so caller
+ * must hold a WorkspaceScope.
+ */
+template <typename V>
+class SparseLookupCpu {
+ public:
+  SparseLookupCpu() : bitmap_(NULL), pos_(NULL) {}
+
+  Info init(const SparseVector<V>* v, Workspace* workspace);
+
+  inline bool has(Index i) const {
+    return static_cast<bool>((bitmap_[i >> 6] >> (i & 63)) & 1);
+  }
+  inline Index pos(Index i) const { return pos_[i]; }
+
+ private:
+  uint64_t* bitmap_;
+  Index*    pos_;
+};
+
+template <typename V>
+Info SparseLookupCpu<V>::init(const SparseVector<V>* v,
+                              Workspace*             workspace) {
+  CHECK(const_cast<SparseVector<V>*>(v)->gpuToCpu());
+  size_t nword = (static_cast<size_t>(v->nsize_) + 63)/64;
+  bitmap_ = workspace->allocate<uint64_t>(nword + 1);
+  pos_    = workspace->allocate<Index>(v->nsize_ + 1);
+  if (bitmap_ == NULL || pos_ == NULL)
+    return GrB_OUT_OF_MEMORY;
+  std::memset(bitmap_, 0, (nword + 1)*sizeof(uint64_t));
+  for (Index k = 0; k < v->nvals_; ++k) {
+    Index i = v->h_ind_[k];
+    bitmap_[i >> 6] |= static_cast<uint64_t>(1) << (i & 63);
+    pos_[i] = k;
+  }
+  return GrB_SUCCESS;
+}
+
+// Same as eWiseReduceCommon on host, for sparse v looked up by index of u
+template <typename T, typename U, typename V,
+          typename EWiseOpT, typename ReduceOpT>
+T eWiseReduceLookupCpu(T                         identity,
+                       EWiseOpT                  ewise_op,
+                       ReduceOpT                 reduce_op,
+                       const Index*              u_ind,
+                       const U*                  u_val,
+                       Index                     u_nvals,
+                       const SparseLookupCpu<V>& v_lookup,
+                       const V*                  v_val,
+                       bool                      keep_unmatched,
+                       bool                      skip_matched,
+                       bool                      reverse) {
+  return reduceCpu(0, u_nvals, identity, reduce_op, [&](Index k) -> T {
+    U     u_t = u_val[k];
+    Index ind = (u_ind == NULL) ? k : u_ind[k];
+    if (!v_lookup.has(ind))
+      return (keep_unmatched) ? static_cast<T>(u_t) : identity;
+    if (skip_matched)
+      return identity;
+    V v_t = v_val[v_lookup.pos(ind)];
+    return (reverse) ? ewise_op(v_t, u_t) : ewise_op(u_t, v_t);
+  });
+}
+
+// Same as eWiseReduceCommon on device, for sparse v looked up by index of u.
+// Positions of v are scattered into temp buffer, whose contents are not kept
+template <typename T, typename U, typename V,
+          typename EWiseOpT, typename ReduceOpT>
+Info eWiseReduceLookupCommon(T*                     val,
+                             T                      identity,
+                             EWiseOpT               ewise_op,
+                             ReduceOpT              reduce_op,
+                             const Index*           u_ind,
+                             const U*               u_val,
+                             Index                  u_nvals,
+                             const SparseVector<V>* v,
+                             bool                   keep_unmatched,
+                             bool                   skip_matched,
+                             bool                   reverse,
+                             Descriptor*            desc) {
+  CHECK(desc->resize(v->nsize_*sizeof(Index), "temp"));
+  Index* d_pos = reinterpret_cast<Index*>(desc->d_temp_);
+  CUDA_CALL(cudaMemset(d_pos, -1, v->nsize_*sizeof(Index)));
+
+  const int nt = 256;
+  dim3 NT, NB;
+  NT.x = nt;
+  NT.y = 1;
+  NT.z = 1;
+  NB.x = std::min<Index>((v->nvals_ + nt - 1) / nt, 1024);
+  NB.y = 1;
+  NB.z = 1;
+  if (v->nvals_ > 0)
+    scatterPositionKernel<<<NB, NT>>>(d_pos, v->d_ind_, v->nvals_);
+
+  return eWiseReduceCommon(val, identity, ewise_op, reduce_op, u_ind, u_val,
+      u_nvals, d_pos, v->d_val_, keep_unmatched, skip_matched, reverse, desc);
+}
+
+// Dense x sparse vector variant, where v is looked up by index of u
+template <typename T, typename U, typename V,
+          typename EWiseOpT, typename ReduceOpT>
+Info eWiseReduceInner(T*                     val,
+                      T                      identity,
+                      EWiseOpT               ewise_op,
+                      ReduceOpT              reduce_op,
+                      const DenseVector<U>*  u,
+                      const SparseVector<V>* v,
+                      bool                   keep_unmatched,
+                      bool                   skip_matched,
+                      bool                   reverse,
+                      Descriptor*            desc) {
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+
+  if (backend == GrB_SEQUENTIAL) {
+    WorkspaceScope scope(desc->workspace());
+    SparseLookupCpu<V> v_lookup;
+    CHECK(v_lookup.init(v, desc->workspace()));
+    CHECK(const_cast<DenseVector<U>*>(u)->gpuToCpu());
+    *val = eWiseReduceLookupCpu(identity, ewise_op, reduce_op,
+        static_cast<const Index*>(NULL), u->h_val_, u->nvals_, v_lookup,
+        v->h_val_, keep_unmatched, skip_matched, reverse);
+    return GrB_SUCCESS;
+  }
+  return eWiseReduceLookupCommon(val, identity, ewise_op, reduce_op,
+      static_cast<const Index*>(NULL), u->d_val_, u->nvals_, v,
+      keep_unmatched, skip_matched, reverse, desc);
+}
+
+// Sparse x sparse vector variant, where v is looked up by index of u
+template <typename T, typename U, typename V,
+          typename EWiseOpT, typename ReduceOpT>
+Info eWiseReduceInner(T*                     val,
+                      T                      identity,
+                      EWiseOpT               ewise_op,
+                      ReduceOpT              reduce_op,
+                      const SparseVector<U>* u,
+                      const SparseVector<V>* v,
+                      bool                   keep_unmatched,
+                      bool                   skip_matched,
+                      bool                   reverse,
+                      Descriptor*            desc) {
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+
+  if (backend == GrB_SEQUENTIAL) {
+    WorkspaceScope scope(desc->workspace());
+    SparseLookupCpu<V> v_lookup;
+    CHECK(v_lookup.init(v, desc->workspace()));
+    CHECK(const_cast<SparseVector<U>*>(u)->gpuToCpu());
+    *val = eWiseReduceLookupCpu(identity, ewise_op, reduce_op, u->h_ind_,
+        u->h_val_, u->nvals_, v_lookup, v->h_val_, keep_unmatched,
+        skip_matched, reverse);
+    return GrB_SUCCESS;
+  }
+  return eWiseReduceLookupCommon(val, identity, ewise_op, reduce_op,
+      u->d_ind_, u->d_val_, u->nvals_, v, keep_unmatched, skip_matched,
+      reverse, desc);
+}
 }  // namespace backend
 }  // namespace graphblas
 
@@ -0,0 +1,76 @@
+#ifndef GRAPHBLAS_BACKEND_CUDA_SELECT_HPP_
+#define GRAPHBLAS_BACKEND_CUDA_SELECT_HPP_
+
+#include <iostream>
+#include <vector>
+
+namespace graphblas {
+namespace backend {
+
+/*!
+ * \brief C = entries A(i,j) of sparse A for which op(A(i,j), thunk) holds
+ *
+ * Rows are counted and filled in parallel on host, and C is built from them.
+ * If C is A, entries are instead dropped in place by SparseMatrix::prune(),
+ * which is what iterative pruning (e.g. ktruss) wants. Runs on host for both
+ * backends
+ */
+template <typename c, typename a,
+          typename SelectOpT, typename T>
+Info selectSparse(Matrix<c>*             C,
+                  SelectOpT              op,
+                  const SparseMatrix<a>* A,
+                  T                      thunk,
+                  Descriptor*            desc) {
+  if (desc->debug())
+    std::cout << "Executing selectSparse\n";
+
+  // TODO: GPU variant that compacts CSR with device scan
+  if (static_cast<const void*>(&C->sparse_) == A) {
+    CHECK(const_cast<SparseMatrix<a>*>(A)->prune(
+        [&](Index row, Index col, a val) { return op(val, thunk); }));
+    return GrB_SUCCESS;
+  }
+
+  CHECK(const_cast<SparseMatrix<a>*>(A)->gpuToCpu());
+  Index        A_nrows = A->nrows_;
+  const Index* A_ptr   = A->h_csrRowPtr_;
+  const Index* A_ind   = A->h_csrColInd_;
+  const a*     A_val   = A->h_csrVal_;
+
+  std::vector<Index> C_ptr(A_nrows + 1, 0);
+  threadPool().parallelFor(0, A_nrows, [&](Index begin, Index end) {
+    for (Index row = begin; row < end; ++row) {
+      Index count = 0;
+      for (Index edge = A_ptr[row]; edge < A_ptr[row+1]; ++edge)
+        if (op(A_val[edge], thunk))
+          count++;
+      C_ptr[row + 1] = count;
+    }
+  }, 1024);
+  for (Index row = 0; row < A_nrows; ++row)
+    C_ptr[row + 1] += C_ptr[row];
+
+  Index C_nvals = C_ptr[A_nrows];
+  std::vector<Index> C_row(C_nvals), C_col(C_nvals);
+  std::vector<c>     C_val(C_nvals);
+  threadPool().parallelFor(0, A_nrows, [&](Index begin, Index end) {
+    for (Index row = begin; row < end; ++row) {
+      Index dest = C_ptr[row];
+      for (Index edge = A_ptr[row]; edge < A_ptr[row+1]; ++edge) {
+        if (op(A_val[edge], thunk)) {
+          C_row[dest]   = row;
+          C_col[dest]   = A_ind[edge];
+          C_val[dest++] = static_cast<c>(A_val[edge]);
+        }
+      }
+    }
+  }, 1024);
+
+  CHECK(C->build(&C_row, &C_col, &C_val, C_nvals, GrB_NULL, NULL));
+  return GrB_SUCCESS;
+}
+}  // namespace backend
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_BACKEND_CUDA_SELECT_HPP_
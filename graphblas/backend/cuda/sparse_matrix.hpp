@@ -10,6 +10,7 @@
 #include <algorithm>
 
 #include "graphblas/util.hpp"
+#include "graphblas/backend/cuda/delta_buffer.hpp"
 
 namespace graphblas {
 namespace backend {
@@ -29,7 +30,7 @@ class SparseMatrix {
         h_cscColPtr_(NULL), h_cscRowInd_(NULL), h_cscVal_(NULL),
         d_csrRowPtr_(NULL), d_csrColInd_(NULL), d_csrVal_(NULL),
         d_cscColPtr_(NULL), d_cscRowInd_(NULL), d_cscVal_(NULL),
-        need_update_(0), symmetric_(0) {
+        delta_nvals_(0), need_update_(0), symmetric_(0) {
     format_ = getEnv("GRB_SPARSE_MATRIX_FORMAT", GrB_SPARSE_MATRIX_CSRCSC);
   }
 
@@ -39,10 +40,20 @@ class SparseMatrix {
         h_cscColPtr_(NULL), h_cscRowInd_(NULL), h_cscVal_(NULL),
         d_csrRowPtr_(NULL), d_csrColInd_(NULL), d_csrVal_(NULL),
         d_cscColPtr_(NULL), d_cscRowInd_(NULL), d_cscVal_(NULL),
-        need_update_(0), symmetric_(0) {
+        delta_nvals_(0), need_update_(0), symmetric_(0) {
     format_ = getEnv("GRB_SPARSE_MATRIX_FORMAT", GrB_SPARSE_MATRIX_CSRCSC);
   }
 
+  // Move constructor and move assignment are O(1). Moved-from matrix is left
+  // holding this matrix's old contents, which it frees on destruction
+  SparseMatrix(SparseMatrix&& rhs) : SparseMatrix() {
+    swap(&rhs);
+  }
+  SparseMatrix& operator=(SparseMatrix&& rhs) {
+    swap(&rhs);
+    return *this;
+  }
+
   ~SparseMatrix();
 
   // C API Methods
@@ -68,6 +79,11 @@ class SparseMatrix {
              Index  nvals);
   Info setElement(Index row_index,
                   Index col_index);
+  Info setElement(T     val,
+                  Index row_index,
+                  Index col_index);
+  Info removeElement(Index row_index,
+                     Index col_index);
   Info extractElement(T*    val,
                       Index row_index,
                       Index col_index);
@@ -87,13 +103,51 @@ class SparseMatrix {
   Info setNvals(Index nvals);
   Info getFormat(SparseMatrixFormat* format) const;
   Info getSymmetry(bool* symmetry) const;
+  Info getMemory(MemorySpace space, size_t* bytes) const;
   Info resize(Index nrows, Index ncols);
   template <typename U>
   Info fill(Index axis, Index nvals, U start);
   template <typename U>
   Info fillAscending(Index axis, Index nvals, U start);
 
+  // Batched updates go to delta buffer and are merged into CSR/CSC once
+  // there are more than desc->compactratio()*nvals of them. Until then, CPU
+  // SpMV merges them on the fly
+  Info setElements(const std::vector<Index>* row_indices,
+                   const std::vector<Index>* col_indices,
+                   const std::vector<T>*     values,
+                   Index                     nvals,
+                   Descriptor*               desc);
+  Info removeElements(const std::vector<Index>* row_indices,
+                      const std::vector<Index>* col_indices,
+                      Index                     nvals,
+                      Descriptor*               desc);
+  // Merges pending updates into CSR/CSC, must be called before GPU kernels
+  // read matrix
+  Info compact();
+  // Merges pending updates only if there are more than
+  // desc->compactratio()*nvals of them, for kernels that read delta()
+  Info compact(Descriptor* desc);
+  inline Index ndelta() const { return delta_.size(); }
+  inline const DeltaBuffer<T>& delta() const { return delta_; }
+  // Drops entries for which keep(row, col, val) is false by compacting CSR and
+  // CSC in place, so nothing is reallocated, sorted or transposed
+  template <typename PredT>
+  Info prune(PredT keep);
+
+  Info swap(SparseMatrix* rhs);
+  // Gives matrix its own copy of arrays it shares with a dup. Callers about
+  // to overwrite the whole matrix pass copy_values = false, which drops the
+  // shared arrays instead
+  Info unshare(bool copy_values = true);
+
  private:
+  // Maximum number of arrays a SparseMatrix owns
+  static const int kmax_arrays_ = 12;
+
+  Info copy(const SparseMatrix* rhs);
+  int  arrays(const void** ptrs) const;
+
   Info allocateCpu();
   Info allocateGpu();
   Info allocate();  // 3 ways to allocate: (1) dup, (2) build, (3) spgemm
@@ -105,6 +159,34 @@ class SparseMatrix {
 
   Info syncCpu();   // synchronizes CSR and CSC representations
 
+  typedef typename DeltaBuffer<T>::Update DeltaUpdate;
+
+  Info addDelta(const Index* row_indices,
+                const Index* col_indices,
+                const T*     values,
+                Index        n,
+                bool         remove,
+                Descriptor*  desc);
+  bool findBase(Index row_index, Index col_index, T* val) const;
+  Info mergeDelta(const Index*       ptr,
+                  const Index*       ind,
+                  const T*           val,
+                  Index              nmajor,
+                  const DeltaUpdate* upd,
+                  Index              nupd,
+                  bool               transposed,
+                  Index              capacity,
+                  Index**            out_ptr,
+                  Index**            out_ind,
+                  T**                out_val);
+  template <typename PredT>
+  Index pruneCompressed(Index* ptr,
+                        Index* ind,
+                        T*     val,
+                        Index  nmajor,
+                        bool   transposed,
+                        PredT  keep);
+
  private:
   const T kcap_ratio_    = 1.2f;  // Note: nasty bug if this is set to 1.f!
   const T kresize_ratio_ = 1.2f;
@@ -129,6 +211,10 @@ class SparseMatrix {
   Index* d_cscRowInd_;
   T*     d_cscVal_;
 
+  // Pending updates not yet merged into CSR/CSC
+  DeltaBuffer<T> delta_;
+  Index          delta_nvals_;  // Change in nvals once delta_ is merged
+
   // GPU variables
   bool need_update_;
   // Symmetric can mean 2 things:
@@ -161,22 +247,22 @@ class SparseMatrix {
 
 template <typename T>
 SparseMatrix<T>::~SparseMatrix() {
-  if (h_csrRowPtr_) free(h_csrRowPtr_);
-  if (h_csrColInd_) free(h_csrColInd_);
-  if (h_csrVal_   ) free(h_csrVal_);
-  if (d_csrRowPtr_) CUDA_CALL(cudaFree(d_csrRowPtr_));
-  if (d_csrColInd_) CUDA_CALL(cudaFree(d_csrColInd_));
-  if (d_csrVal_   ) CUDA_CALL(cudaFree(d_csrVal_   ));
+  if (h_csrRowPtr_) hostFree(h_csrRowPtr_);
+  if (h_csrColInd_) hostFree(h_csrColInd_);
+  if (h_csrVal_   ) hostFree(h_csrVal_);
+  if (d_csrRowPtr_) deviceFree(d_csrRowPtr_);
+  if (d_csrColInd_) deviceFree(d_csrColInd_);
+  if (d_csrVal_   ) deviceFree(d_csrVal_);
 
   if (format_ == GrB_SPARSE_MATRIX_CSRCSC) {
-    if (h_cscColPtr_) free(h_cscColPtr_);
-    if (h_cscRowInd_) free(h_cscRowInd_);
-    if (h_cscVal_   ) free(h_cscVal_);
-    if (d_cscVal_   ) CUDA_CALL(cudaFree(d_cscVal_));
+    if (h_cscColPtr_) hostFree(h_cscColPtr_);
+    if (h_cscRowInd_) hostFree(h_cscRowInd_);
+    if (h_cscVal_   ) hostFree(h_cscVal_);
+    if (d_cscVal_   ) deviceFree(d_cscVal_);
 
     if (!symmetric_) {
-      if (d_cscColPtr_) CUDA_CALL(cudaFree(d_cscColPtr_));
-      if (d_cscRowInd_) CUDA_CALL(cudaFree(d_cscRowInd_));
+      if (d_cscColPtr_) deviceFree(d_cscColPtr_);
+      if (d_cscRowInd_) deviceFree(d_cscRowInd_);
     }
   }
 }
@@ -191,10 +277,49 @@ Info SparseMatrix<T>::nnew(Index nrows, Index ncols) {
   return GrB_SUCCESS;
 }
 
+// Shares arrays of rhs rather than copying them, so dup is O(1) apart from
+// pending updates. Whichever of the two is written to first makes its own
+// copy (see unshare())
 template <typename T>
 Info SparseMatrix<T>::dup(const SparseMatrix* rhs) {
   if (nrows_ != rhs->nrows_) return GrB_DIMENSION_MISMATCH;
   if (ncols_ != rhs->ncols_) return GrB_DIMENSION_MISMATCH;
+  if (rhs == this)
+    return GrB_SUCCESS;
+
+  // Falls back to deep copy if rhs holds memory we do not own
+  const void* ptrs[kmax_arrays_];
+  bool share = memoryTracker().retain(ptrs, rhs->arrays(ptrs));
+  CHECK(clear());
+  if (!share)
+    return copy(rhs);
+
+  nvals_       = rhs->nvals_;
+  ncapacity_   = rhs->ncapacity_;
+  nempty_      = rhs->nempty_;
+  h_csrRowPtr_ = rhs->h_csrRowPtr_;
+  h_csrColInd_ = rhs->h_csrColInd_;
+  h_csrVal_    = rhs->h_csrVal_;
+  h_cscColPtr_ = rhs->h_cscColPtr_;
+  h_cscRowInd_ = rhs->h_cscRowInd_;
+  h_cscVal_    = rhs->h_cscVal_;
+  d_csrRowPtr_ = rhs->d_csrRowPtr_;
+  d_csrColInd_ = rhs->d_csrColInd_;
+  d_csrVal_    = rhs->d_csrVal_;
+  d_cscColPtr_ = rhs->d_cscColPtr_;
+  d_cscRowInd_ = rhs->d_cscRowInd_;
+  d_cscVal_    = rhs->d_cscVal_;
+  delta_       = rhs->delta_;
+  delta_nvals_ = rhs->delta_nvals_;
+  need_update_ = rhs->need_update_;
+  symmetric_   = rhs->symmetric_;
+  format_      = rhs->format_;
+  return GrB_SUCCESS;
+}
+
+// Deep copy of device arrays of rhs into newly allocated arrays
+template <typename T>
+Info SparseMatrix<T>::copy(const SparseMatrix* rhs) {
   nvals_     = rhs->nvals_;
   symmetric_ = rhs->symmetric_;
   format_    = rhs->format_;
@@ -208,17 +333,49 @@ Info SparseMatrix<T>::dup(const SparseMatrix* rhs) {
   CUDA_CALL(cudaMemcpy(d_csrVal_,    rhs->d_csrVal_,    nvals_*sizeof(T),
       cudaMemcpyDeviceToDevice));
 
-  if (format_ == GrB_SPARSE_MATRIX_CSRCSC) {
+  // Output of mxm has no CSC copy
+  if (format_ == GrB_SPARSE_MATRIX_CSRCSC && rhs->d_cscVal_ != NULL) {
     CUDA_CALL(cudaMemcpy(d_cscVal_, rhs->d_cscVal_, nvals_*sizeof(T),
         cudaMemcpyDeviceToDevice));
-    if (!symmetric_ && format_ == GrB_SPARSE_MATRIX_CSRCSC) {
-      CUDA_CALL(cudaMemcpy(d_cscColPtr_, rhs->d_cscColPtr_, 
+    if (!symmetric_) {
+      CUDA_CALL(cudaMemcpy(d_cscColPtr_, rhs->d_cscColPtr_,
           (ncols_+1)*sizeof(Index), cudaMemcpyDeviceToDevice));
       CUDA_CALL(cudaMemcpy(d_cscRowInd_, rhs->d_cscRowInd_,
           nvals_*sizeof(Index), cudaMemcpyDeviceToDevice));
+    } else {
+      d_cscColPtr_ = d_csrRowPtr_;
+      d_cscRowInd_ = d_csrColInd_;
     }
+  } else if (format_ == GrB_SPARSE_MATRIX_CSRCSC) {
+    if (d_cscVal_) deviceFree(d_cscVal_);
+    if (!symmetric_) {
+      if (d_cscColPtr_) deviceFree(d_cscColPtr_);
+      if (d_cscRowInd_) deviceFree(d_cscRowInd_);
+    }
+    d_cscColPtr_ = NULL;
+    d_cscRowInd_ = NULL;
+    d_cscVal_    = NULL;
   }
 
+  // In CSRONLY format CSC aliases CSR
+  if (format_ == GrB_SPARSE_MATRIX_CSRONLY) {
+    if (h_cscColPtr_ != NULL) hostFree(h_cscColPtr_);
+    if (h_cscRowInd_ != NULL) hostFree(h_cscRowInd_);
+    if (h_cscVal_    != NULL) hostFree(h_cscVal_);
+    h_cscColPtr_ = h_csrRowPtr_;
+    h_cscRowInd_ = h_csrColInd_;
+    h_cscVal_    = h_csrVal_;
+  } else if (h_cscColPtr_ && h_cscRowInd_ && h_cscVal_ &&
+      rhs->h_cscColPtr_ && rhs->h_cscRowInd_ && rhs->h_cscVal_) {
+    // Host CSC structure of symmetric matrix is not kept on GPU, so it is
+    // copied from host
+    memcpy(h_cscColPtr_, rhs->h_cscColPtr_, (ncols_+1)*sizeof(Index));
+    memcpy(h_cscRowInd_, rhs->h_cscRowInd_, nvals_*sizeof(Index));
+    memcpy(h_cscVal_,    rhs->h_cscVal_,    nvals_*sizeof(T));
+  }
+
+  delta_       = rhs->delta_;
+  delta_nvals_ = rhs->delta_nvals_;
   need_update_ = true;
   return GrB_SUCCESS;
 }
@@ -227,13 +384,15 @@ template <typename T>
 Info SparseMatrix<T>::clear() {
   nvals_     = 0;
   ncapacity_ = 0;
+  CHECK(delta_.clear());
+  delta_nvals_ = 0;
 
-  if (h_csrRowPtr_) free(h_csrRowPtr_);
-  if (h_csrColInd_) free(h_csrColInd_);
-  if (h_csrVal_   ) free(h_csrVal_);
-  if (d_csrRowPtr_) CUDA_CALL(cudaFree(d_csrRowPtr_));
-  if (d_csrColInd_) CUDA_CALL(cudaFree(d_csrColInd_));
-  if (d_csrVal_   ) CUDA_CALL(cudaFree(d_csrVal_));
+  if (h_csrRowPtr_) hostFree(h_csrRowPtr_);
+  if (h_csrColInd_) hostFree(h_csrColInd_);
+  if (h_csrVal_   ) hostFree(h_csrVal_);
+  if (d_csrRowPtr_) deviceFree(d_csrRowPtr_);
+  if (d_csrColInd_) deviceFree(d_csrColInd_);
+  if (d_csrVal_   ) deviceFree(d_csrVal_);
 
   h_csrRowPtr_ = NULL;
   h_csrColInd_ = NULL;
@@ -243,16 +402,24 @@ Info SparseMatrix<T>::clear() {
   d_csrVal_    = NULL;
 
   if (format_ == GrB_SPARSE_MATRIX_CSRCSC) {
-    if (h_cscColPtr_) free(h_cscColPtr_);
-    if (h_cscRowInd_) free(h_cscRowInd_);
-    if (h_cscVal_   ) free(h_cscVal_);
-    if (d_cscVal_   ) CUDA_CALL(cudaFree(d_cscVal_));
+    if (h_cscColPtr_) hostFree(h_cscColPtr_);
+    if (h_cscRowInd_) hostFree(h_cscRowInd_);
+    if (h_cscVal_   ) hostFree(h_cscVal_);
+    if (d_cscVal_   ) deviceFree(d_cscVal_);
 
     if (!symmetric_) {
-      if (d_cscColPtr_) CUDA_CALL(cudaFree(d_cscColPtr_));
-      if (d_cscRowInd_) CUDA_CALL(cudaFree(d_cscRowInd_));
+      if (d_cscColPtr_) deviceFree(d_cscColPtr_);
+      if (d_cscRowInd_) deviceFree(d_cscRowInd_);
     }
   }
+
+  // CSC may alias CSR, so it is reset regardless of format
+  h_cscColPtr_ = NULL;
+  h_cscRowInd_ = NULL;
+  h_cscVal_    = NULL;
+  d_cscColPtr_ = NULL;
+  d_cscRowInd_ = NULL;
+  d_cscVal_    = NULL;
   return GrB_SUCCESS;
 }
 
@@ -270,7 +437,7 @@ inline Info SparseMatrix<T>::ncols(Index* ncols_t) const {
 
 template <typename T>
 inline Info SparseMatrix<T>::nvals(Index* nvals_t) const {
-  *nvals_t = nvals_;
+  *nvals_t = nvals_ + delta_nvals_;
   return GrB_SUCCESS;
 }
 
@@ -282,7 +449,10 @@ Info SparseMatrix<T>::build(const std::vector<Index>* row_indices,
                             Index                     nvals,
                             BinaryOpT                 dup,
                             char*                     dat_name) {
+  CHECK(unshare(false));
   nvals_ = nvals;
+  CHECK(delta_.clear());
+  delta_nvals_ = 0;
   CHECK(allocateCpu());
 
   if (dat_name != NULL) {
@@ -298,9 +468,9 @@ Info SparseMatrix<T>::build(const std::vector<Index>* row_indices,
 
   if (format_ == GrB_SPARSE_MATRIX_CSRONLY) {
     //if (symmetric_ || format_ == GrB_SPARSE_MATRIX_CSRONLY) {
-    if (h_cscColPtr_ != NULL) free(h_cscColPtr_);
-    if (h_cscRowInd_ != NULL) free(h_cscRowInd_);
-    if (h_cscVal_    != NULL) free(h_cscVal_);
+    if (h_cscColPtr_ != NULL) hostFree(h_cscColPtr_);
+    if (h_cscRowInd_ != NULL) hostFree(h_cscRowInd_);
+    if (h_cscVal_    != NULL) hostFree(h_cscVal_);
     h_cscColPtr_ = h_csrRowPtr_;
     h_cscRowInd_ = h_csrColInd_;
     h_cscVal_    = h_csrVal_;
@@ -344,6 +514,7 @@ Info SparseMatrix<T>::build(char* dat_name) {
       std::cout << "Error: Unable to open file for reading!\n";
     } else {
       printf("Reading %s\n", dat_name);
+      CHECK(unshare(false));
       char* pch = strstr(dat_name, ".ud.");
       if (pch == NULL)
         symmetric_ = false;
@@ -367,9 +538,9 @@ Info SparseMatrix<T>::build(char* dat_name) {
 
       if (format_ == GrB_SPARSE_MATRIX_CSRONLY) {
       //if (symmetric_ || format_ == GrB_SPARSE_MATRIX_CSRONLY) {
-        if (h_cscColPtr_ != NULL) free(h_cscColPtr_);
-        if (h_cscRowInd_ != NULL) free(h_cscRowInd_);
-        if (h_cscVal_    != NULL) free(h_cscVal_);
+        if (h_cscColPtr_ != NULL) hostFree(h_cscColPtr_);
+        if (h_cscRowInd_ != NULL) hostFree(h_cscRowInd_);
+        if (h_cscVal_    != NULL) hostFree(h_cscVal_);
         h_cscColPtr_ = h_csrRowPtr_;
         h_cscRowInd_ = h_csrColInd_;
         h_cscVal_    = h_csrVal_;
@@ -400,6 +571,7 @@ Info SparseMatrix<T>::build(Index* row_ptr,
                             Index* col_ind,
                             T*     values,
                             Index  nvals) {
+  CHECK(unshare(false));
   d_csrRowPtr_ = row_ptr;
   d_csrColInd_ = col_ind;
   d_csrVal_    = values;
@@ -415,16 +587,68 @@ Info SparseMatrix<T>::build(Index* row_ptr,
 
 template <typename T>
 Info SparseMatrix<T>::setElement(Index row_index, Index col_index) {
-  std::cout << "SparseMatrix setElement\n";
-  std::cout << "Error: Feature not implemented yet!\n";
-  return GrB_SUCCESS;
+  return setElement(static_cast<T>(1), row_index, col_index);
+}
+
+// Single element updates never trigger compaction, since there is no
+// descriptor to read threshold from. Use setElements for streams of updates
+template <typename T>
+Info SparseMatrix<T>::setElement(T val, Index row_index, Index col_index) {
+  return addDelta(&row_index, &col_index, &val, 1, false, NULL);
+}
+
+template <typename T>
+Info SparseMatrix<T>::removeElement(Index row_index, Index col_index) {
+  return addDelta(&row_index, &col_index, NULL, 1, true, NULL);
+}
+
+template <typename T>
+Info SparseMatrix<T>::setElements(const std::vector<Index>* row_indices,
+                                  const std::vector<Index>* col_indices,
+                                  const std::vector<T>*     values,
+                                  Index                     nvals,
+                                  Descriptor*               desc) {
+  if (row_indices->size() < nvals || col_indices->size() < nvals ||
+      values->size() < nvals)
+    return GrB_INDEX_OUT_OF_BOUNDS;
+  if (nvals == 0)
+    return GrB_SUCCESS;
+  return addDelta(&(*row_indices)[0], &(*col_indices)[0], &(*values)[0],
+      nvals, false, desc);
+}
+
+template <typename T>
+Info SparseMatrix<T>::removeElements(const std::vector<Index>* row_indices,
+                                     const std::vector<Index>* col_indices,
+                                     Index                     nvals,
+                                     Descriptor*               desc) {
+  if (row_indices->size() < nvals || col_indices->size() < nvals)
+    return GrB_INDEX_OUT_OF_BOUNDS;
+  if (nvals == 0)
+    return GrB_SUCCESS;
+  return addDelta(&(*row_indices)[0], &(*col_indices)[0], NULL, nvals, true,
+      desc);
 }
 
 template <typename T>
 Info SparseMatrix<T>::extractElement(T* val, Index row_index, Index col_index) {
-  std::cout << "SparseMatrix extractElement\n";
-  std::cout << "Error: Feature not implemented yet!\n";
-  return GrB_SUCCESS;
+  if (row_index < 0 || row_index >= nrows_ || col_index < 0 ||
+      col_index >= ncols_)
+    return GrB_INVALID_INDEX;
+
+  // Pending update takes precedence over CSR
+  const DeltaUpdate* update = delta_.find(row_index, col_index);
+  if (update != NULL) {
+    if (update->remove)
+      return GrB_NO_VALUE;
+    *val = update->val;
+    return GrB_SUCCESS;
+  }
+
+  if (h_csrRowPtr_ == NULL)
+    return GrB_NO_VALUE;
+  CHECK(gpuToCpu());
+  return findBase(row_index, col_index, val) ? GrB_SUCCESS : GrB_NO_VALUE;
 }
 
 template <typename T>
@@ -437,24 +661,46 @@ Info SparseMatrix<T>::extractTuples(std::vector<Index>* row_indices,
   col_indices->clear();
   values->clear();
 
-  if (*n > nvals_) {
+  Index nvals = nvals_ + delta_nvals_;
+  if (*n > nvals) {
     std::cout << "Error: Too many tuples requested!\n";
     return GrB_UNINITIALIZED_OBJECT;
   }
 
-  if (*n < nvals_) {
+  if (*n < nvals) {
     std::cout << "Error: Insufficient space!\n";
     return GrB_INSUFFICIENT_SPACE;
   }
 
+  // Pending updates are merged row by row without compacting
+  std::vector<Index> row_ind;
+  std::vector<T>     row_val;
   Index count = 0;
-  for (Index row = 0; row < nrows_; row++) {
-    for (Index ind = h_csrRowPtr_[row]; ind < h_csrRowPtr_[row+1]; ind++) {
-      if (h_csrVal_[ind] != 0 && count < *n) {
+  for (Index row = 0; row < nrows_ && h_csrRowPtr_ != NULL; row++) {
+    Index row_start = h_csrRowPtr_[row];
+    Index row_end   = h_csrRowPtr_[row+1];
+    Index upd_start, upd_end;
+    delta_.range(row, false, &upd_start, &upd_end);
+
+    const Index* ind = h_csrColInd_ + row_start;
+    const T*     val = h_csrVal_    + row_start;
+    Index row_length = row_end - row_start;
+    if (upd_start < upd_end) {
+      row_ind.resize(row_length + upd_end - upd_start);
+      row_val.resize(row_length + upd_end - upd_start);
+      row_length = DeltaBuffer<T>::mergeRow(ind, val, row_length,
+          delta_.sorted(false) + upd_start, upd_end - upd_start, false,
+          &row_ind[0], &row_val[0]);
+      ind = &row_ind[0];
+      val = &row_val[0];
+    }
+
+    for (Index i = 0; i < row_length; i++) {
+      if (val[i] != 0 && count < *n) {
         count++;
         row_indices->push_back(row);
-        col_indices->push_back(h_csrColInd_[ind]);
-        values->push_back(h_csrVal_[ind]);
+        col_indices->push_back(ind[i]);
+        values->push_back(val[i]);
       }
     }
   }
@@ -478,6 +724,7 @@ const T SparseMatrix<T>::operator[](Index ind) {
 
 template <typename T>
 Info SparseMatrix<T>::print(bool force_update) {
+  CHECK(compact());
   CHECK(gpuToCpu(force_update));
   printArray("csrColInd", h_csrColInd_, std::min(nvals_, 40));
   printArray("csrRowPtr", h_csrRowPtr_, std::min(nrows_+1, 40));
@@ -558,6 +805,28 @@ Info SparseMatrix<T>::getSymmetry(bool* symmetry) const {
   return GrB_SUCCESS;
 }
 
+// Bytes held by this matrix in given memory space. Arrays shared between CSR
+// and CSC (CSRONLY format and symmetric matrices) are only counted once
+template <typename T>
+Info SparseMatrix<T>::getMemory(MemorySpace space, size_t* bytes) const {
+  const void* h_ptrs[] = {h_csrRowPtr_, h_csrColInd_, h_csrVal_,
+                          h_cscColPtr_, h_cscRowInd_, h_cscVal_};
+  const void* d_ptrs[] = {d_csrRowPtr_, d_csrColInd_, d_csrVal_,
+                          d_cscColPtr_, d_cscRowInd_, d_cscVal_};
+  const void** ptrs = (space == GrB_MEMORY_HOST) ? h_ptrs : d_ptrs;
+
+  *bytes = 0;
+  for (int i = 0; i < 6; ++i) {
+    bool unique = true;
+    for (int j = 0; j < i; ++j)
+      if (ptrs[j] == ptrs[i])
+        unique = false;
+    if (unique && ptrs[i] != NULL)
+      *bytes += memoryTracker().bytes(ptrs[i]);
+  }
+  return GrB_SUCCESS;
+}
+
 // Note: has different meaning from sequential resize
 //      -that one makes SparseMatrix bigger
 //      -this one accounts for smaller nrows
@@ -578,6 +847,7 @@ Info SparseMatrix<T>::resize(Index nrows, Index ncols) {
 template <typename T>
 template <typename U>
 Info SparseMatrix<T>::fill(Index axis, Index nvals, U start) {
+  CHECK(unshare());
   CHECK(setNvals(nvals));
   CHECK(allocate());
 
@@ -599,6 +869,7 @@ Info SparseMatrix<T>::fill(Index axis, Index nvals, U start) {
 template <typename T>
 template <typename U>
 Info SparseMatrix<T>::fillAscending(Index axis, Index nvals, U start) {
+  CHECK(unshare());
   CHECK(setNvals(nvals));
   CHECK(allocate());
 
@@ -624,33 +895,18 @@ Info SparseMatrix<T>::allocateCpu() {
 
   // Host malloc
   if (nrows_ > 0 && h_csrRowPtr_ == NULL)
-    h_csrRowPtr_ = reinterpret_cast<Index*>(malloc((nrows_+1)*sizeof(Index)));
+    CHECK(hostMalloc(&h_csrRowPtr_, nrows_+1, GrB_MEMORY_MATRIX));
   if (nvals_ > 0 && h_csrColInd_ == NULL)
-    h_csrColInd_ = reinterpret_cast<Index*>(malloc(ncapacity_*sizeof(Index)));
+    CHECK(hostMalloc(&h_csrColInd_, ncapacity_, GrB_MEMORY_MATRIX));
   if (nvals_ > 0 && h_csrVal_ == NULL)
-    h_csrVal_    = reinterpret_cast<T*>(malloc(ncapacity_*sizeof(T)));
-
-  if (ncols_ > 0 && h_cscColPtr_ == NULL) {
-    h_cscColPtr_ = reinterpret_cast<Index*>(malloc((ncols_+1)*sizeof(Index)));
-
-    std::cout << "Allocate " << ncols_ + 1 << std::endl;
-  } else {
-    std::cout << "Do not allocate " << ncols_ << " " << h_cscColPtr_ << std::endl;
-  }
+    CHECK(hostMalloc(&h_csrVal_, ncapacity_, GrB_MEMORY_MATRIX));
 
-  if (nvals_ > 0 && h_cscRowInd_ == NULL) {
-    h_cscRowInd_ = reinterpret_cast<Index*>(malloc(ncapacity_*sizeof(Index)));
-    std::cout << "Allocate " << ncapacity_ << std::endl;
-  } else {
-    std::cout << "Do not allocate " << nvals_ << " " << h_cscRowInd_ << std::endl;
-  }
-
-  if (nvals_ > 0 && h_cscVal_ == NULL) {
-    h_cscVal_    = reinterpret_cast<T*>(malloc(ncapacity_*sizeof(T)));
-    std::cout << "Allocate " << ncapacity_ << std::endl;
-  } else {
-    std::cout << "Do not allocate " << nvals_ << " " << h_cscVal_ << std::endl;
-  }
+  if (ncols_ > 0 && h_cscColPtr_ == NULL)
+    CHECK(hostMalloc(&h_cscColPtr_, ncols_+1, GrB_MEMORY_MATRIX));
+  if (nvals_ > 0 && h_cscRowInd_ == NULL)
+    CHECK(hostMalloc(&h_cscRowInd_, ncapacity_, GrB_MEMORY_MATRIX));
+  if (nvals_ > 0 && h_cscVal_ == NULL)
+    CHECK(hostMalloc(&h_cscVal_, ncapacity_, GrB_MEMORY_MATRIX));
 
   // TODO(@ctcyang): does not need to be so strict since mxm may need to
   // only set storage type, but not allocate yet since nvals_ not known
@@ -664,23 +920,23 @@ template <typename T>
 Info SparseMatrix<T>::allocateGpu() {
   // GPU malloc
   if (nrows_ > 0 && d_csrRowPtr_ == NULL)
-    CUDA_CALL(cudaMalloc(&d_csrRowPtr_, (nrows_+1)*sizeof(Index)));
+    CHECK(deviceMalloc(&d_csrRowPtr_, nrows_+1, GrB_MEMORY_MATRIX));
   if (nvals_ > 0 && d_csrColInd_ == NULL)
-    CUDA_CALL(cudaMalloc(&d_csrColInd_, ncapacity_*sizeof(Index)));
+    CHECK(deviceMalloc(&d_csrColInd_, ncapacity_, GrB_MEMORY_MATRIX));
   if (nvals_ > 0 && d_csrVal_ == NULL) {
-    CUDA_CALL(cudaMalloc(&d_csrVal_, ncapacity_*sizeof(T)));
+    CHECK(deviceMalloc(&d_csrVal_, ncapacity_, GrB_MEMORY_MATRIX));
     printMemory("csrVal");
   }
   if (format_ == GrB_SPARSE_MATRIX_CSRCSC) {
     if (nvals_ > 0 && d_cscVal_ == NULL) {
-      CUDA_CALL(cudaMalloc(&d_cscVal_, ncapacity_*sizeof(T)));
+      CHECK(deviceMalloc(&d_cscVal_, ncapacity_, GrB_MEMORY_MATRIX));
       printMemory("cscVal");
 
     if (!symmetric_) {
       if (nrows_ > 0 && d_cscColPtr_ == NULL)
-        CUDA_CALL(cudaMalloc(&d_cscColPtr_, (ncols_+1)*sizeof(Index)));
+        CHECK(deviceMalloc(&d_cscColPtr_, ncols_+1, GrB_MEMORY_MATRIX));
       if (nvals_ > 0 && d_cscRowInd_ == NULL)
-        CUDA_CALL(cudaMalloc(&d_cscRowInd_, ncapacity_*sizeof(Index)));
+        CHECK(deviceMalloc(&d_cscRowInd_, ncapacity_, GrB_MEMORY_MATRIX));
       }
     }
   }
@@ -822,6 +1078,381 @@ Info SparseMatrix<T>::syncCpu() {
     return GrB_INVALID_OBJECT;
   return GrB_SUCCESS;
 }
+
+// Private method that adds n insertions or deletions to delta buffer and
+// compacts if buffer has grown past threshold set in desc
+template <typename T>
+Info SparseMatrix<T>::addDelta(const Index* row_indices,
+                               const Index* col_indices,
+                               const T*     values,
+                               Index        n,
+                               bool         remove,
+                               Descriptor*  desc) {
+  for (Index i = 0; i < n; ++i) {
+    if (row_indices[i] < 0 || row_indices[i] >= nrows_ ||
+        col_indices[i] < 0 || col_indices[i] >= ncols_) {
+      std::cout << "Error: Index out of bounds!\n";
+      return GrB_INVALID_INDEX;
+    }
+  }
+
+  // Matrix that has never been built starts out as empty CSR
+  if (h_csrRowPtr_ == NULL) {
+    nvals_ = 0;
+    CHECK(allocateCpu());
+    for (Index i = 0; i <= nrows_; ++i)
+      h_csrRowPtr_[i] = 0;
+    if (h_cscColPtr_ != NULL)
+      for (Index i = 0; i <= ncols_; ++i)
+        h_cscColPtr_[i] = 0;
+    CHECK(cpuToGpu());
+  }
+  CHECK(gpuToCpu());
+
+  // Keep count of how nvals will change once delta is merged, so that only
+  // new updates are looked up in CSR
+  for (Index i = 0; i < n; ++i) {
+    bool in_base = findBase(row_indices[i], col_indices[i], NULL);
+    bool prev_remove;
+    if (delta_.set(row_indices[i], col_indices[i],
+        remove ? static_cast<T>(0) : values[i], remove, &prev_remove)) {
+      if (prev_remove && in_base)
+        delta_nvals_++;
+      else if (!prev_remove && !in_base)
+        delta_nvals_--;
+    }
+    if (remove && in_base)
+      delta_nvals_--;
+    else if (!remove && !in_base)
+      delta_nvals_++;
+  }
+
+  if (desc != NULL)
+    CHECK(compact(desc));
+  return GrB_SUCCESS;
+}
+
+// Private method that looks up element in host CSR (requires gpuToCpu)
+template <typename T>
+bool SparseMatrix<T>::findBase(Index row_index, Index col_index, T* val) const {
+  if (h_csrRowPtr_ == NULL || nvals_ == 0)
+    return false;
+  const Index* row_start = h_csrColInd_ + h_csrRowPtr_[row_index];
+  const Index* row_end   = h_csrColInd_ + h_csrRowPtr_[row_index+1];
+  const Index* it = std::lower_bound(row_start, row_end, col_index);
+  if (it == row_end || *it != col_index)
+    return false;
+  if (val != NULL)
+    *val = h_csrVal_[it - h_csrColInd_];
+  return true;
+}
+
+// Private method that merges compressed matrix (ptr, ind, val) with updates
+// sorted in the same order into newly allocated arrays. Both passes are
+// parallel over rows (columns if transposed)
+template <typename T>
+Info SparseMatrix<T>::mergeDelta(const Index*       ptr,
+                                 const Index*       ind,
+                                 const T*           val,
+                                 Index              nmajor,
+                                 const DeltaUpdate* upd,
+                                 Index              nupd,
+                                 bool               transposed,
+                                 Index              capacity,
+                                 Index**            out_ptr,
+                                 Index**            out_ind,
+                                 T**                out_val) {
+  // Offsets of each row's updates
+  std::vector<Index> upd_ptr(nmajor+1, 0);
+  for (Index i = 0; i < nupd; ++i)
+    upd_ptr[(transposed ? upd[i].col : upd[i].row) + 1]++;
+  for (Index i = 0; i < nmajor; ++i)
+    upd_ptr[i+1] += upd_ptr[i];
+
+  // Pass 1: length of each merged row
+  CHECK(hostMalloc(out_ptr, nmajor+1, GrB_MEMORY_MATRIX));
+  Index* new_ptr = *out_ptr;
+  threadPool().parallelFor(0, nmajor, [&](Index begin, Index end) {
+    for (Index i = begin; i < end; ++i) {
+      new_ptr[i] = DeltaBuffer<T>::mergeRow(ind + ptr[i], val + ptr[i],
+          ptr[i+1] - ptr[i], upd + upd_ptr[i], upd_ptr[i+1] - upd_ptr[i],
+          transposed, NULL, NULL);
+    }
+  }, 1024);
+
+  Index cumsum = 0;
+  for (Index i = 0; i < nmajor; ++i) {
+    Index temp = new_ptr[i];
+    new_ptr[i] = cumsum;
+    cumsum    += temp;
+  }
+  new_ptr[nmajor] = cumsum;
+
+  // Pass 2: write merged rows
+  CHECK(hostMalloc(out_ind, std::max(capacity, cumsum), GrB_MEMORY_MATRIX));
+  CHECK(hostMalloc(out_val, std::max(capacity, cumsum), GrB_MEMORY_MATRIX));
+  Index* new_ind = *out_ind;
+  T*     new_val = *out_val;
+  threadPool().parallelFor(0, nmajor, [&](Index begin, Index end) {
+    for (Index i = begin; i < end; ++i) {
+      DeltaBuffer<T>::mergeRow(ind + ptr[i], val + ptr[i], ptr[i+1] - ptr[i],
+          upd + upd_ptr[i], upd_ptr[i+1] - upd_ptr[i], transposed,
+          new_ind + new_ptr[i], new_val + new_ptr[i]);
+    }
+  }, 1024);
+  return GrB_SUCCESS;
+}
+
+template <typename T>
+Info SparseMatrix<T>::compact() {
+  if (delta_.empty())
+    return GrB_SUCCESS;
+  CHECK(unshare());
+  CHECK(gpuToCpu());
+
+  Index new_nvals    = nvals_ + delta_nvals_;
+  Index new_capacity = ncapacity_;
+  bool  grow         = new_nvals > ncapacity_;
+  if (grow)
+    new_capacity = std::max(static_cast<Index>(kresize_ratio_*new_nvals),
+        new_nvals);
+
+  // CSR
+  Index* csrRowPtr = NULL;
+  Index* csrColInd = NULL;
+  T*     csrVal    = NULL;
+  CHECK(mergeDelta(h_csrRowPtr_, h_csrColInd_, h_csrVal_, nrows_,
+      delta_.sorted(false), delta_.size(), false, new_capacity, &csrRowPtr,
+      &csrColInd, &csrVal));
+
+  // CSC: merge if host copy is valid, otherwise transpose merged CSR
+  Index* cscColPtr = csrRowPtr;
+  Index* cscRowInd = csrColInd;
+  T*     cscVal    = csrVal;
+  if (format_ == GrB_SPARSE_MATRIX_CSRCSC) {
+    if (d_cscVal_ && d_cscColPtr_ && d_cscRowInd_ &&
+        h_cscVal_ && h_cscColPtr_ && h_cscRowInd_) {
+      CHECK(mergeDelta(h_cscColPtr_, h_cscRowInd_, h_cscVal_, ncols_,
+          delta_.sorted(true), delta_.size(), true, new_capacity, &cscColPtr,
+          &cscRowInd, &cscVal));
+    } else {
+      CHECK(hostMalloc(&cscColPtr, ncols_+1, GrB_MEMORY_MATRIX));
+      CHECK(hostMalloc(&cscRowInd, std::max(new_capacity, new_nvals),
+          GrB_MEMORY_MATRIX));
+      CHECK(hostMalloc(&cscVal, std::max(new_capacity, new_nvals),
+          GrB_MEMORY_MATRIX));
+      csr2csc(cscColPtr, cscRowInd, cscVal, csrRowPtr, csrColInd, csrVal,
+          nrows_, ncols_);
+    }
+  }
+
+  // Swap in new host arrays. In CSRONLY format CSC aliases CSR
+  if (h_cscColPtr_ != h_csrRowPtr_) {
+    if (h_cscColPtr_) hostFree(h_cscColPtr_);
+    if (h_cscRowInd_) hostFree(h_cscRowInd_);
+    if (h_cscVal_   ) hostFree(h_cscVal_);
+  }
+  if (h_csrRowPtr_) hostFree(h_csrRowPtr_);
+  if (h_csrColInd_) hostFree(h_csrColInd_);
+  if (h_csrVal_   ) hostFree(h_csrVal_);
+  h_csrRowPtr_ = csrRowPtr;
+  h_csrColInd_ = csrColInd;
+  h_csrVal_    = csrVal;
+  h_cscColPtr_ = cscColPtr;
+  h_cscRowInd_ = cscRowInd;
+  h_cscVal_    = cscVal;
+
+  // Updates need not preserve symmetry, so CSC gets its own device arrays.
+  // Device arrays sized by capacity are reallocated if matrix has grown
+  if (grow || symmetric_) {
+    if (d_csrColInd_) deviceFree(d_csrColInd_);
+    if (d_csrVal_   ) deviceFree(d_csrVal_);
+    if (d_cscVal_   ) deviceFree(d_cscVal_);
+    if (!symmetric_) {
+      if (d_cscColPtr_) deviceFree(d_cscColPtr_);
+      if (d_cscRowInd_) deviceFree(d_cscRowInd_);
+    }
+    d_csrColInd_ = NULL;
+    d_csrVal_    = NULL;
+    d_cscColPtr_ = NULL;
+    d_cscRowInd_ = NULL;
+    d_cscVal_    = NULL;
+    symmetric_   = false;
+  }
+
+  nvals_     = new_nvals;
+  ncapacity_ = std::max(new_capacity, new_nvals);
+  CHECK(delta_.clear());
+  delta_nvals_ = 0;
+
+  CHECK(cpuToGpu());
+  need_update_ = false;
+  return GrB_SUCCESS;
+}
+
+template <typename T>
+Info SparseMatrix<T>::compact(Descriptor* desc) {
+  if (delta_.size() > desc->compactratio()*std::max(nvals_, 1))
+    CHECK(compact());
+  return GrB_SUCCESS;
+}
+
+// Private method that drops entries of compressed matrix (ptr, ind, val) that
+// fail keep, moving the rest down in place. Rows (columns if transposed) are
+// compacted to the front of their block in parallel, since entries only ever
+// move down, and blocks are then moved down one after another
+template <typename T>
+template <typename PredT>
+Index SparseMatrix<T>::pruneCompressed(Index* ptr,
+                                       Index* ind,
+                                       T*     val,
+                                       Index  nmajor,
+                                       bool   transposed,
+                                       PredT  keep) {
+  const Index kblock = 1024;
+  Index nblocks = (nmajor + kblock - 1)/kblock;
+  std::vector<Index> row_nvals(nmajor);
+  std::vector<Index> block_nvals(nblocks);
+
+  // Pass 1: compact rows within each block
+  threadPool().parallelFor(0, nblocks, [&](Index block_begin,
+      Index block_end) {
+    for (Index block = block_begin; block < block_end; ++block) {
+      Index begin = block*kblock;
+      Index end   = std::min(begin + kblock, nmajor);
+      Index dest  = ptr[begin];
+      for (Index i = begin; i < end; ++i) {
+        Index row_begin = dest;
+        for (Index edge = ptr[i]; edge < ptr[i+1]; ++edge) {
+          bool pass = (transposed) ? keep(ind[edge], i, val[edge]) :
+              keep(i, ind[edge], val[edge]);
+          if (pass) {
+            ind[dest]   = ind[edge];
+            val[dest++] = val[edge];
+          }
+        }
+        row_nvals[i] = dest - row_begin;
+      }
+      block_nvals[block] = dest - ptr[begin];
+    }
+  });
+
+  // Pass 2: close gaps between blocks, then rebuild ptr
+  Index nvals = 0;
+  for (Index block = 0; block < nblocks; ++block) {
+    Index src = ptr[block*kblock];
+    if (src != nvals) {
+      std::copy(ind + src, ind + src + block_nvals[block], ind + nvals);
+      std::copy(val + src, val + src + block_nvals[block], val + nvals);
+    }
+    nvals += block_nvals[block];
+  }
+  ptr[0] = 0;
+  for (Index i = 0; i < nmajor; ++i)
+    ptr[i+1] = ptr[i] + row_nvals[i];
+  return nvals;
+}
+
+template <typename T>
+template <typename PredT>
+Info SparseMatrix<T>::prune(PredT keep) {
+  CHECK(compact());
+  CHECK(unshare());
+  CHECK(gpuToCpu());
+
+  Index new_nvals = pruneCompressed(h_csrRowPtr_, h_csrColInd_, h_csrVal_,
+      nrows_, false, keep);
+
+  // CSC is pruned by same test only if host copy is valid, as in compact().
+  // In CSRONLY format CSC aliases CSR
+  if (format_ == GrB_SPARSE_MATRIX_CSRCSC && h_cscColPtr_ != h_csrRowPtr_ &&
+      d_cscVal_ && d_cscColPtr_ && d_cscRowInd_ &&
+      h_cscVal_ && h_cscColPtr_ && h_cscRowInd_)
+    pruneCompressed(h_cscColPtr_, h_cscRowInd_, h_cscVal_, ncols_, true,
+        keep);
+
+  // keep need not preserve symmetry, so CSC gets its own device arrays
+  // instead of aliasing CSR ones. Capacity is unchanged, so arrays that are
+  // there already are big enough
+  if (symmetric_) {
+    d_cscColPtr_ = NULL;
+    d_cscRowInd_ = NULL;
+    symmetric_   = false;
+  }
+
+  nvals_ = new_nvals;
+  CHECK(cpuToGpu());
+  need_update_ = false;
+  return GrB_SUCCESS;
+}
+
+template <typename T>
+Info SparseMatrix<T>::swap(SparseMatrix* rhs) {  // NOLINT(build/include_what_you_use)
+  std::swap(nrows_,       rhs->nrows_);
+  std::swap(ncols_,       rhs->ncols_);
+  std::swap(nvals_,       rhs->nvals_);
+  std::swap(ncapacity_,   rhs->ncapacity_);
+  std::swap(nempty_,      rhs->nempty_);
+
+  std::swap(h_csrRowPtr_, rhs->h_csrRowPtr_);
+  std::swap(h_csrColInd_, rhs->h_csrColInd_);
+  std::swap(h_csrVal_,    rhs->h_csrVal_);
+  std::swap(h_cscColPtr_, rhs->h_cscColPtr_);
+  std::swap(h_cscRowInd_, rhs->h_cscRowInd_);
+  std::swap(h_cscVal_,    rhs->h_cscVal_);
+
+  std::swap(d_csrRowPtr_, rhs->d_csrRowPtr_);
+  std::swap(d_csrColInd_, rhs->d_csrColInd_);
+  std::swap(d_csrVal_,    rhs->d_csrVal_);
+  std::swap(d_cscColPtr_, rhs->d_cscColPtr_);
+  std::swap(d_cscRowInd_, rhs->d_cscRowInd_);
+  std::swap(d_cscVal_,    rhs->d_cscVal_);
+
+  std::swap(delta_,       rhs->delta_);
+  std::swap(delta_nvals_, rhs->delta_nvals_);
+  std::swap(need_update_, rhs->need_update_);
+  std::swap(symmetric_,   rhs->symmetric_);
+  std::swap(format_,      rhs->format_);
+  return GrB_SUCCESS;
+}
+
+template <typename T>
+Info SparseMatrix<T>::unshare(bool copy_values) {
+  const void* ptrs[kmax_arrays_];
+  if (!memoryTracker().shared(ptrs, arrays(ptrs)))
+    return GrB_SUCCESS;
+  if (!copy_values)
+    return clear();
+
+  SparseMatrix<T> temp(nrows_, ncols_);
+  temp.format_ = format_;
+  CHECK(temp.copy(this));
+  CHECK(swap(&temp));
+  return GrB_SUCCESS;
+}
+
+// Arrays owned by this matrix i.e. the ones freed by its destructor
+template <typename T>
+int SparseMatrix<T>::arrays(const void** ptrs) const {
+  int nptrs = 0;
+  ptrs[nptrs++] = h_csrRowPtr_;
+  ptrs[nptrs++] = h_csrColInd_;
+  ptrs[nptrs++] = h_csrVal_;
+  ptrs[nptrs++] = d_csrRowPtr_;
+  ptrs[nptrs++] = d_csrColInd_;
+  ptrs[nptrs++] = d_csrVal_;
+  if (format_ == GrB_SPARSE_MATRIX_CSRCSC) {
+    ptrs[nptrs++] = h_cscColPtr_;
+    ptrs[nptrs++] = h_cscRowInd_;
+    ptrs[nptrs++] = h_cscVal_;
+    ptrs[nptrs++] = d_cscVal_;
+    if (!symmetric_) {
+      ptrs[nptrs++] = d_cscColPtr_;
+      ptrs[nptrs++] = d_cscRowInd_;
+    }
+  }
+  return nptrs;
+}
 }  // namespace backend
 }  // namespace graphblas
 
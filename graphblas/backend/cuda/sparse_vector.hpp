@@ -31,6 +31,16 @@ class SparseVector {
     allocate();
   }
 
+  // Move constructor and move assignment are O(1). Moved-from vector is left
+  // holding this vector's old contents, which it frees on destruction
+  SparseVector(SparseVector&& rhs) : SparseVector() {
+    swap(&rhs);
+  }
+  SparseVector& operator=(SparseVector&& rhs) {
+    swap(&rhs);
+    return *this;
+  }
+
   // Need to write Default Destructor
   ~SparseVector();
 
@@ -70,6 +80,11 @@ class SparseVector {
   Info cpuToGpu();
   Info gpuToCpu(bool force_update = false);
   Info swap(SparseVector* rhs);
+  Info unshare();
+
+ private:
+  Info copy(const SparseVector* rhs);
+  int  arrays(const void** ptrs) const;
 
  private:
   Index  nsize_;  // 5 ways to set: (1) Vector (2) nnew (3) dup (4) resize
@@ -86,10 +101,10 @@ class SparseVector {
 
 template <typename T>
 SparseVector<T>::~SparseVector() {
-  if (h_ind_ != NULL) free(h_ind_);
-  if (h_val_ != NULL) free(h_val_);
-  if (d_ind_ != NULL) CUDA_CALL(cudaFree(d_ind_));
-  if (d_ind_ != NULL) CUDA_CALL(cudaFree(d_val_));
+  if (h_ind_ != NULL) hostFree(h_ind_);
+  if (h_val_ != NULL) hostFree(h_val_);
+  if (d_ind_ != NULL) deviceFree(d_ind_);
+  if (d_val_ != NULL) deviceFree(d_val_);
 }
 
 template <typename T>
@@ -99,8 +114,36 @@ Info SparseVector<T>::nnew(Index nsize) {
   return GrB_SUCCESS;
 }
 
+// Shares arrays of rhs rather than copying them. Whichever of the two is
+// written to first makes its own copy (see unshare())
 template <typename T>
 Info SparseVector<T>::dup(const SparseVector* rhs) {
+  if (rhs == this)
+    return GrB_SUCCESS;
+
+  // Falls back to deep copy if rhs holds memory we do not own
+  const void* ptrs[4];
+  if (!memoryTracker().retain(ptrs, rhs->arrays(ptrs))) {
+    CHECK(unshare());
+    return copy(rhs);
+  }
+
+  if (h_ind_ != NULL) hostFree(h_ind_);
+  if (h_val_ != NULL) hostFree(h_val_);
+  if (d_ind_ != NULL) deviceFree(d_ind_);
+  if (d_val_ != NULL) deviceFree(d_val_);
+  nsize_       = rhs->nsize_;
+  nvals_       = rhs->nvals_;
+  h_ind_       = rhs->h_ind_;
+  h_val_       = rhs->h_val_;
+  d_ind_       = rhs->d_ind_;
+  d_val_       = rhs->d_val_;
+  need_update_ = rhs->need_update_;
+  return GrB_SUCCESS;
+}
+
+template <typename T>
+Info SparseVector<T>::copy(const SparseVector* rhs) {
   nvals_ = rhs->nvals_;
   nsize_ = rhs->nsize_;
 
@@ -151,6 +194,7 @@ Info SparseVector<T>::build(const std::vector<Index>* indices,
     std::cout << "Error: SpVec Uninitialized object!\n";
     return GrB_UNINITIALIZED_OBJECT;
   }
+  CHECK(unshare());
 
   nvals_ = nvals;
 
@@ -186,6 +230,7 @@ Info SparseVector<T>::build(Index* indices,
 
 template <typename T>
 Info SparseVector<T>::setElement(T val, Index index) {
+  CHECK(unshare());
   CHECK(gpuToCpu());
   h_ind_[nvals_] = index;
   h_val_[nvals_] = val;
@@ -250,15 +295,15 @@ Info SparseVector<T>::resize(Index nsize) {
   Index to_copy = min(nsize, nvals_);
 
   nsize_ = nsize;
-  h_ind_ = reinterpret_cast<Index*>(malloc( nsize_*sizeof(Index)));
-  h_val_ = reinterpret_cast<T*>(malloc( (nsize_+1)*sizeof(T)));
+  CHECK(hostMalloc(&h_ind_, nsize_, GrB_MEMORY_VECTOR));
+  CHECK(hostMalloc(&h_val_, nsize_+1, GrB_MEMORY_VECTOR));
   if (h_temp_ind != NULL)
     memcpy(h_ind_, h_temp_ind, to_copy*sizeof(Index));
   if (h_temp_val != NULL)
     memcpy(h_val_, h_temp_val, to_copy*sizeof(T));
 
-  CUDA_CALL(cudaMalloc(&d_ind_, nsize_*sizeof(Index)));
-  CUDA_CALL(cudaMalloc(&d_val_, (nsize_+1)*sizeof(T)));
+  CHECK(deviceMalloc(&d_ind_, nsize_, GrB_MEMORY_VECTOR));
+  CHECK(deviceMalloc(&d_val_, nsize_+1, GrB_MEMORY_VECTOR));
   printMemory("SpVec");
   if (d_temp_ind != NULL)
     CUDA_CALL(cudaMemcpy(d_ind_, d_temp_ind, to_copy*sizeof(Index),
@@ -268,16 +313,17 @@ Info SparseVector<T>::resize(Index nsize) {
         cudaMemcpyDeviceToDevice));
   nvals_ = to_copy;
 
-  free(h_temp_ind);
-  free(h_temp_val);
-  CUDA_CALL(cudaFree(d_temp_ind));
-  CUDA_CALL(cudaFree(d_temp_val));
+  if (h_temp_ind != NULL) hostFree(h_temp_ind);
+  if (h_temp_val != NULL) hostFree(h_temp_val);
+  if (d_temp_ind != NULL) deviceFree(d_temp_ind);
+  if (d_temp_val != NULL) deviceFree(d_temp_val);
 
   return GrB_SUCCESS;
 }
 
 template <typename T>
 Info SparseVector<T>::fill(Index nvals) {
+  CHECK(unshare());
   for (Index i = 0; i < nvals; i++)
     h_val_[i] = i;
 
@@ -315,8 +361,8 @@ template <typename T>
 Info SparseVector<T>::allocateCpu() {
   // Host malloc
   if (nsize_ != 0 && h_ind_ == NULL && h_val_ == NULL) {
-    h_ind_ = reinterpret_cast<Index*>(malloc(nsize_*sizeof(Index)));
-    h_val_ = reinterpret_cast<T*>(malloc((nsize_+1)*sizeof(T)));
+    CHECK(hostMalloc(&h_ind_, nsize_, GrB_MEMORY_VECTOR));
+    CHECK(hostMalloc(&h_val_, nsize_+1, GrB_MEMORY_VECTOR));
   } else {
     // std::cout << "Error: SpVec Host allocation unsuccessful!\n";
   }
@@ -333,8 +379,8 @@ template <typename T>
 Info SparseVector<T>::allocateGpu() {
   // GPU malloc
   if (nsize_ != 0 && d_ind_ == NULL && d_val_ == NULL) {
-    CUDA_CALL(cudaMalloc(&d_ind_, nsize_*sizeof(Index)));
-    CUDA_CALL(cudaMalloc(&d_val_, (nsize_+1)*sizeof(T)));
+    CHECK(deviceMalloc(&d_ind_, nsize_, GrB_MEMORY_VECTOR));
+    CHECK(deviceMalloc(&d_val_, nsize_+1, GrB_MEMORY_VECTOR));
     printMemory("d_ind, d_val");
   } else {
     // std::cout << "Error: SpVec Device allocation unsuccessful!\n";
@@ -411,6 +457,30 @@ Info SparseVector<T>::swap(SparseVector* rhs) {  // NOLINT(build/include_what_yo
 
   return GrB_SUCCESS;
 }
+
+// Gives this vector its own copy of arrays it shares with a dup. Must be
+// called before writing to h_ind_, h_val_, d_ind_ or d_val_
+template <typename T>
+Info SparseVector<T>::unshare() {
+  const void* ptrs[4];
+  if (!memoryTracker().shared(ptrs, arrays(ptrs)))
+    return GrB_SUCCESS;
+
+  SparseVector<T> temp;
+  CHECK(temp.copy(this));
+  CHECK(swap(&temp));
+  return GrB_SUCCESS;
+}
+
+// Arrays owned by this vector i.e. freed by its destructor
+template <typename T>
+int SparseVector<T>::arrays(const void** ptrs) const {
+  ptrs[0] = h_ind_;
+  ptrs[1] = h_val_;
+  ptrs[2] = d_ind_;
+  ptrs[3] = d_val_;
+  return 4;
+}
 }  // namespace backend
 }  // namespace graphblas
 
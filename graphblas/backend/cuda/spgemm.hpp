@@ -75,7 +75,7 @@ Info cusparse_spgemm(SparseMatrix<c>*       C,
   int baseC;
   int *nnzTotalDevHostPtr = &(C_nvals);
   if (C->d_csrRowPtr_ == NULL) {
-    CUDA_CALL( cudaMalloc( &C->d_csrRowPtr_, (A_nrows+1)*sizeof(Index) ));
+    CHECK(deviceMalloc(&C->d_csrRowPtr_, A_nrows+1, GrB_MEMORY_MATRIX));
   }
   /*else
   {
@@ -84,8 +84,7 @@ Info cusparse_spgemm(SparseMatrix<c>*       C,
   }*/
 
   if (C->h_csrRowPtr_ == NULL)
-    C->h_csrRowPtr_ = reinterpret_cast<Index*>(malloc((A_nrows+1)*
-        sizeof(Index)));
+    CHECK(hostMalloc(&C->h_csrRowPtr_, A_nrows+1, GrB_MEMORY_MATRIX));
   /*else
   {
     free( C->h_csrRowPtr_ );
@@ -141,19 +140,18 @@ Info cusparse_spgemm(SparseMatrix<c>*       C,
       std::cout << "Increasing matrix C: " << C->ncapacity_ << " -> " << C_nvals << std::endl;
     C->ncapacity_ = C_nvals*C->kresize_ratio_;
     if (C->d_csrColInd_ != NULL) {
-      CUDA_CALL(cudaFree(C->d_csrColInd_));
-      CUDA_CALL(cudaFree(C->d_csrVal_));
+      deviceFree(C->d_csrColInd_);
+      deviceFree(C->d_csrVal_);
     }
-    CUDA_CALL(cudaMalloc(&C->d_csrColInd_, C->ncapacity_*sizeof(Index)));
-    CUDA_CALL(cudaMalloc(&C->d_csrVal_, C->ncapacity_*sizeof(c)));
+    CHECK(deviceMalloc(&C->d_csrColInd_, C->ncapacity_, GrB_MEMORY_MATRIX));
+    CHECK(deviceMalloc(&C->d_csrVal_, C->ncapacity_, GrB_MEMORY_MATRIX));
 
     if (C->h_csrColInd_ != NULL) {
-      free(C->h_csrColInd_);
-      free(C->h_csrVal_);
+      hostFree(C->h_csrColInd_);
+      hostFree(C->h_csrVal_);
     }
-    C->h_csrColInd_ = reinterpret_cast<Index*>(malloc(C->ncapacity_*sizeof(
-        Index)));
-    C->h_csrVal_    = reinterpret_cast<T*>(malloc(C->ncapacity_*sizeof(T)));
+    CHECK(hostMalloc(&C->h_csrColInd_, C->ncapacity_, GrB_MEMORY_MATRIX));
+    CHECK(hostMalloc(&C->h_csrVal_, C->ncapacity_, GrB_MEMORY_MATRIX));
   }
 
   // Compute
@@ -248,7 +246,7 @@ Info cusparse_spgemm2(SparseMatrix<c>*       C,
   int baseC;
   int *nnzTotalDevHostPtr = &(C_nvals);
   if (C->d_csrRowPtr_ == NULL) {
-    CUDA_CALL(cudaMalloc(&C->d_csrRowPtr_, (A_nrows+1)*sizeof(Index)));
+    CHECK(deviceMalloc(&C->d_csrRowPtr_, A_nrows+1, GrB_MEMORY_MATRIX));
   }
   /*else
   {
@@ -257,8 +255,7 @@ Info cusparse_spgemm2(SparseMatrix<c>*       C,
   }*/
 
   if (C->h_csrRowPtr_ == NULL)
-    C->h_csrRowPtr_ = reinterpret_cast<Index*>(malloc((A_nrows+1)*sizeof(
-        Index)));
+    CHECK(hostMalloc(&C->h_csrRowPtr_, A_nrows+1, GrB_MEMORY_MATRIX));
   /*else
   {
     free( C.h_csrRowPtr_ );
@@ -353,18 +350,18 @@ Info cusparse_spgemm2(SparseMatrix<c>*       C,
     if (desc->debug())
       std::cout << "Increasing matrix C: " << C->ncapacity_ << " -> " << C_nvals << std::endl;
     if (C->d_csrColInd_ != NULL) {
-      CUDA_CALL(cudaFree(C->d_csrColInd_));
-      CUDA_CALL(cudaFree(C->d_csrVal_));
+      deviceFree(C->d_csrColInd_);
+      deviceFree(C->d_csrVal_);
     }
-    CUDA_CALL(cudaMalloc(&C->d_csrColInd_, C_nvals*sizeof(Index)));
-    CUDA_CALL(cudaMalloc(&C->d_csrVal_, C_nvals*sizeof(c)));
+    CHECK(deviceMalloc(&C->d_csrColInd_, C_nvals, GrB_MEMORY_MATRIX));
+    CHECK(deviceMalloc(&C->d_csrVal_, C_nvals, GrB_MEMORY_MATRIX));
 
     if (C->h_csrColInd_ != NULL) {
-      free(C->h_csrColInd_);
-      free(C->h_csrVal_);
+      hostFree(C->h_csrColInd_);
+      hostFree(C->h_csrVal_);
     }
-    C->h_csrColInd_ = reinterpret_cast<Index*>(malloc(C_nvals*sizeof(Index)));
-    C->h_csrVal_    = reinterpret_cast<T*>(malloc(C_nvals*sizeof(T)));
+    CHECK(hostMalloc(&C->h_csrColInd_, C_nvals, GrB_MEMORY_MATRIX));
+    CHECK(hostMalloc(&C->h_csrVal_, C_nvals, GrB_MEMORY_MATRIX));
 
     C->ncapacity_ = C_nvals;
   }
@@ -411,6 +408,106 @@ Info cusparse_spgemm2(SparseMatrix<c>*       C,
     std::cout << C_nvals << " nonzeroes!\n";
   return GrB_SUCCESS;
 }
+
+/*!
+ * \brief C = mask .* (A * B), computed only where mask has nonzero entry
+ *
+ * Each such C(i,j) is dot product of row i of A with column j of B, found by
+ * merging sorted CSR row of A with sorted CSC column of B, so no entry outside
+ * mask is ever formed. Entries with no common k are left out of C, as in
+ * unmasked product. Counting triangles per edge (support in ktruss) is this
+ * with mask = A = B. Runs on host for both backends
+ */
+template <typename c, typename a, typename b, typename m,
+          typename SemiringT>
+Info spgemmMasked(Matrix<c>*             C,
+                  const SparseMatrix<m>* mask,
+                  SemiringT              op,
+                  const SparseMatrix<a>* A,
+                  const SparseMatrix<b>* B,
+                  Descriptor*            desc) {
+  if (desc->debug())
+    std::cout << "Executing spgemmMasked\n";
+
+  // TODO: GPU variant with one warp per mask row
+  CHECK(const_cast<SparseMatrix<m>*>(mask)->gpuToCpu());
+  CHECK(const_cast<SparseMatrix<a>*>(A)->gpuToCpu());
+  CHECK(const_cast<SparseMatrix<b>*>(B)->gpuToCpu());
+  // Dot products walk columns of B, so CSC of B is needed
+  if (B->format_ == GrB_SPARSE_MATRIX_CSRONLY)
+    return GrB_INVALID_OBJECT;
+
+  Index        M_nrows = mask->nrows_;
+  const Index* M_ptr   = mask->h_csrRowPtr_;
+  const Index* M_ind   = mask->h_csrColInd_;
+  const m*     M_val   = mask->h_csrVal_;
+  const Index* A_ptr   = A->h_csrRowPtr_;
+  const Index* A_ind   = A->h_csrColInd_;
+  const a*     A_val   = A->h_csrVal_;
+  const Index* B_ptr   = B->h_cscColPtr_;
+  const Index* B_ind   = B->h_cscRowInd_;
+  const b*     B_val   = B->h_cscVal_;
+
+  // Pass 1: value of every mask entry, and whether it has any term
+  Index M_nvals = mask->nvals_;
+  std::vector<c>     M_out(M_nvals);
+  std::vector<char>  M_hit(M_nvals, 0);
+  std::vector<Index> C_ptr(M_nrows + 1, 0);
+  threadPool().parallelFor(0, M_nrows, [&](Index begin, Index end) {
+    for (Index row = begin; row < end; ++row) {
+      Index count = 0;
+      for (Index edge = M_ptr[row]; edge < M_ptr[row+1]; ++edge) {
+        if (M_val[edge] == static_cast<m>(0))
+          continue;
+        Index col = M_ind[edge];
+        Index i = A_ptr[row], i_end = A_ptr[row+1];
+        Index j = B_ptr[col], j_end = B_ptr[col+1];
+        c     val = op.identity();
+        bool  hit = false;
+        while (i < i_end && j < j_end) {
+          if (A_ind[i] < B_ind[j]) {
+            ++i;
+          } else if (B_ind[j] < A_ind[i]) {
+            ++j;
+          } else {
+            val = op.add_op(val, op.mul_op(A_val[i], B_val[j]));
+            hit = true;
+            ++i;
+            ++j;
+          }
+        }
+        if (hit) {
+          M_out[edge] = val;
+          M_hit[edge] = 1;
+          count++;
+        }
+      }
+      C_ptr[row + 1] = count;
+    }
+  }, 64);
+  for (Index row = 0; row < M_nrows; ++row)
+    C_ptr[row + 1] += C_ptr[row];
+
+  // Pass 2: gather entries that have a term
+  Index C_nvals = C_ptr[M_nrows];
+  std::vector<Index> C_row(C_nvals), C_col(C_nvals);
+  std::vector<c>     C_val(C_nvals);
+  threadPool().parallelFor(0, M_nrows, [&](Index begin, Index end) {
+    for (Index row = begin; row < end; ++row) {
+      Index dest = C_ptr[row];
+      for (Index edge = M_ptr[row]; edge < M_ptr[row+1]; ++edge) {
+        if (M_hit[edge]) {
+          C_row[dest]   = row;
+          C_col[dest]   = M_ind[edge];
+          C_val[dest++] = M_out[edge];
+        }
+      }
+    }
+  }, 1024);
+
+  CHECK(C->build(&C_row, &C_col, &C_val, C_nvals, GrB_NULL, NULL));
+  return GrB_SUCCESS;
+}
 }  // namespace backend
 }  // namespace graphblas
 
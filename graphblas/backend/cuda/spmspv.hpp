@@ -26,14 +26,13 @@ Info spmspvMerge(SparseVector<W>*       w,
   CHECK(desc->get(GrB_INP0, &inp0_mode));
   CHECK(desc->get(GrB_INP1, &inp1_mode));
 
-  std::string accum_type = typeid(accum).name();
   // TODO(@ctcyang): add accum and replace support
   // -have masked variants as separate kernel
   // -accum and replace as parts in flow
   // -special case of inverting GrB_SCMP since we are using it to zero out
   // values in GrB_assign instead of passing them through
   bool use_mask  = (mask != NULL);
-  bool use_accum = (accum_type.size() > 1);
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
   bool use_scmp  = (scmp_mode != GrB_SCMP);
   bool use_repl  = (repl_mode == GrB_REPLACE);
   bool use_tran  = (inp0_mode == GrB_TRAN || inp1_mode == GrB_TRAN);
@@ -59,10 +58,10 @@ Info spmspvMerge(SparseVector<W>*       w,
   // this much memory for now. TODO(@ctcyang): optimize for memory
   int size = static_cast<float>(A->nvals_)*desc->memusage()+1;
   if (desc->struconly())
-    desc->resize((2*A_nrows+2*size)*std::max(sizeof(Index), sizeof(T)),
+    desc->resize((2*A_nrows+2*size)*std::max(sizeof(Index), sizeof(a)),
         "buffer");
   else
-    desc->resize((2*A_nrows+4*size)*std::max(sizeof(Index), sizeof(T)),
+    desc->resize((2*A_nrows+4*size)*std::max(sizeof(Index), sizeof(a)),
         "buffer");
 
   // Only difference between masked and unmasked versions if whether
@@ -125,13 +124,13 @@ Info spmspvMerge(SparseVector<W>*       w,
         }
 
         // Turn dense vector into sparse
-        desc->resize((4*A_nrows)*std::max(sizeof(Index), sizeof(T)), "buffer");
+        desc->resize((4*A_nrows)*std::max(sizeof(Index), sizeof(a)), "buffer");
         Index* d_scan = reinterpret_cast<Index*>(desc->d_buffer_)+2*A_nrows;
         Index* d_temp = reinterpret_cast<Index*>(desc->d_buffer_)+3*A_nrows;
 
         mgpu::ScanPrealloc<mgpu::MgpuScanTypeExc>(temp_ind, A_nrows,
             (Index)0, mgpu::plus<Index>(), reinterpret_cast<Index*>(0),
-            &w->nvals_, d_scan, d_temp, *(desc->d_context_));
+            &w->nvals_, d_scan, d_temp, desc->context());
 
         if (desc->debug()) {
           printDevice("d_scan", d_scan, A_nrows);
@@ -170,7 +169,7 @@ Info spmspvMerge(SparseVector<W>*       w,
         }
 
         // Prune 0.f's from vector
-        desc->resize((4*A_nrows)*std::max(sizeof(Index), sizeof(T)), "buffer");
+        desc->resize((4*A_nrows)*std::max(sizeof(Index), sizeof(a)), "buffer");
         Index* d_flag = reinterpret_cast<Index*>(desc->d_buffer_)+  A_nrows;
         Index* d_scan = reinterpret_cast<Index*>(desc->d_buffer_)+2*A_nrows;
         Index* d_temp = reinterpret_cast<Index*>(desc->d_buffer_)+3*A_nrows;
@@ -178,7 +177,7 @@ Info spmspvMerge(SparseVector<W>*       w,
         updateFlagKernel<<<NB, NT>>>(d_flag, -1, temp_ind, temp_nvals);
         mgpu::ScanPrealloc<mgpu::MgpuScanTypeExc>(d_flag, temp_nvals, (Index)0,
             mgpu::plus<Index>(), reinterpret_cast<Index*>(0), &w->nvals_,
-            d_scan, d_temp, *(desc->d_context_) );
+            d_scan, d_temp, desc->context() );
 
         if (desc->debug()) {
           printDevice("d_flag", d_flag, temp_nvals);
@@ -201,11 +200,11 @@ Info spmspvMerge(SparseVector<W>*       w,
       if (mask_vec_type == GrB_DENSE) {
         if (use_scmp)
           assignSparseKernel<true, true, true><<<NB, NT>>>(temp_ind, temp_val,
-              temp_nvals, (mask->dense_).d_val_, NULL, (U)0.f,
+              temp_nvals, (mask->dense_).d_val_, NULL, static_cast<a>(0),
               reinterpret_cast<Index*>(NULL), A_nrows);
         else
           assignSparseKernel<false, true, true><<<NB, NT>>>(temp_ind, temp_val,
-              temp_nvals, (mask->dense_).d_val_, NULL, (U)0.f,
+              temp_nvals, (mask->dense_).d_val_, NULL, static_cast<a>(0),
               reinterpret_cast<Index*>(NULL), A_nrows);
       } else if (mask_vec_type == GrB_SPARSE) {
         std::cout << "Spmspv Sparse Mask\n";
@@ -230,7 +229,7 @@ Info spmspvMerge(SparseVector<W>*       w,
       mgpu::ScanPrealloc<mgpu::MgpuScanTypeExc>(d_flag, temp_nvals, (Index)0,
           mgpu::plus<Index>(),  // NOLINT(build/include_what_you_use)
           reinterpret_cast<Index*>(0), &w->nvals_, d_scan,
-          d_temp, *(desc->d_context_));
+          d_temp, desc->context());
 
       if (desc->debug()) {
         printDevice("d_flag", d_flag, temp_nvals);
@@ -239,8 +238,8 @@ Info spmspvMerge(SparseVector<W>*       w,
         std::cout << "Frontier size: " << w->nvals_ << std::endl;
       }
 
-      streamCompactSparseKernel<<<NB, NT>>>(w->d_ind_, w->d_val_, d_scan, (W)0,
-          temp_ind, temp_val, temp_nvals);
+      streamCompactSparseKernel<<<NB, NT>>>(w->d_ind_, w->d_val_, d_scan,
+          static_cast<a>(0), temp_ind, temp_val, temp_nvals);
 
       if (desc->debug()) {
         printDevice("w_ind", w->d_ind_, w->nvals_);
@@ -272,12 +271,11 @@ Info spmspvSimple(DenseVector<W>*        w,
   CHECK(desc->get(GrB_INP0, &inp0_mode));
   CHECK(desc->get(GrB_INP1, &inp1_mode));
 
-  std::string accum_type = typeid(accum).name();
   // TODO(@ctcyang): add accum and replace support
   // -have masked variants as separate kernel
   // -accum and replace as parts in flow
   bool use_mask  = (mask != NULL);
-  bool use_accum = (accum_type.size() > 1);
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
   bool use_scmp  = (scmp_mode == GrB_SCMP);
   bool use_repl  = (repl_mode == GrB_REPLACE);
   bool use_tran  = (inp0_mode == GrB_TRAN || inp1_mode == GrB_TRAN);
@@ -323,25 +321,16 @@ Info spmspvSimple(DenseVector<W>*        w,
   if (!use_accum)
     zeroKernel<<<NB, NT>>>(w->d_val_, op.identity(), A_nrows);
 
-  /*!
-   * /brief atomicAdd() 3+5  = 8
-   *        atomicSub() 3-5  =-2
-   *        atomicMin() 3,5  = 3
-   *        atomicMax() 3,5  = 5
-   *        atomicOr()  3||5 = 1
-   *        atomicXor() 3^^5 = 0
-   */
   auto add_op = extractAdd(op);
-  int functor = add_op(3, 5);
   if (desc->debug())
-    std::cout << "Functor: " << functor << "\n";
-  if (functor == 8) {
+    std::cout << "Atomic: " << SemiringT::atomic << "\n";
+  if (SemiringT::atomic == GrB_ATOMIC_ADD) {
     spmspvSimpleAddKernel<<<NB, NT>>>(w->d_val_, NULL, op.identity(),
         extractMul(op), A_csrRowPtr, A_csrColInd, A_csrVal, u->d_ind_,
         u->d_val_, u_nvals);
     if (desc->debug())
       std::cout << "Using atomicAdd!\n";
-  } else if (functor == 1 && !desc->atomic()) {
+  } else if (SemiringT::atomic == GrB_ATOMIC_OR && !desc->atomic()) {
     spmspvSimpleOrKernel<<<NB, NT>>>(w->d_val_, NULL, op.identity(),
         extractMul(op), A_csrRowPtr, A_csrColInd, A_csrVal, u->d_ind_,
         u->d_val_, u_nvals);
@@ -116,7 +116,7 @@ Info spmspvApspieMerge(Index*       w_ind,
       d_temp_nvals), *u_nvals, (Index)0, mgpu::plus<Index>(),
       reinterpret_cast<Index*>(d_scan)+*u_nvals, w_nvals,
       reinterpret_cast<Index*>(d_scan), reinterpret_cast<Index*>(d_temp),
-      *(desc->d_context_));
+      desc->context());
   CUDA_CALL(cudaDeviceSynchronize());
 
   if (desc->debug()) {
@@ -150,6 +150,8 @@ Info spmspvApspieMerge(Index*       w_ind,
   //   output: 1) expanded index array 2) expanded value array
   //   -> d_csrSwapInd |E| x desc->memusage()
   //   -> d_csrSwapVal |E| x desc->memusage()
+  // Expanded frontier values keep type U and gathered matrix values type a,
+  // so a narrow frontier (e.g. uint8_t) only moves sizeof(U) bytes per edge
   void* d_csrSwapInd;
   void* d_csrSwapVal;
 
@@ -176,9 +178,9 @@ Info spmspvApspieMerge(Index*       w_ind,
    *
    */
     IntervalExpand(*w_nvals, reinterpret_cast<Index*>(d_scan), u_val, *u_nvals,
-        reinterpret_cast<T*>(d_temp), *(desc->d_context_));
+        reinterpret_cast<U*>(d_temp), desc->context());
     if (desc->debug())
-      printDevice("d_temp", reinterpret_cast<T*>(d_temp), *w_nvals);
+      printDevice("d_temp", reinterpret_cast<U*>(d_temp), *w_nvals);
   }
 
   /*!
@@ -193,24 +195,24 @@ Info spmspvApspieMerge(Index*       w_ind,
    */ 
   IntervalGatherIndirect(*w_nvals, A_csrRowPtr,
       reinterpret_cast<Index*>(d_scan), *u_nvals, A_csrColInd, u_ind,
-      reinterpret_cast<Index*>(d_csrSwapInd), *(desc->d_context_));
+      reinterpret_cast<Index*>(d_csrSwapInd), desc->context());
   if (!desc->struconly()) {
     IntervalGatherIndirect(*w_nvals, A_csrRowPtr,
         reinterpret_cast<Index*>(d_scan), *u_nvals, A_csrVal, u_ind,
-        reinterpret_cast<T*>(d_csrSwapVal), *(desc->d_context_));
+        reinterpret_cast<a*>(d_csrSwapVal), desc->context());
 
   // Step 4) Element-wise multiplication
     NB.x = (*w_nvals+nt-1)/nt;
-    eWiseMultKernel<<<NB, NT>>>(reinterpret_cast<T*>(d_csrSwapVal),
+    eWiseMultKernel<<<NB, NT>>>(reinterpret_cast<a*>(d_csrSwapVal),
         extractAdd(op), op.identity(), extractMul(op),
-        reinterpret_cast<T*>(d_csrSwapVal), reinterpret_cast<T*>(d_temp),
+        reinterpret_cast<a*>(d_csrSwapVal), reinterpret_cast<U*>(d_temp),
         *w_nvals);
   }
 
   if (desc->debug()) {
     printDevice("SwapInd", reinterpret_cast<Index*>(d_csrSwapInd), *w_nvals);
     if (!desc->struconly())
-      printDevice("SwapVal", reinterpret_cast<T*>(d_csrSwapVal), *w_nvals);
+      printDevice("SwapVal", reinterpret_cast<a*>(d_csrSwapVal), *w_nvals);
   }
 
   // Step 5) Sort step
@@ -257,8 +259,8 @@ Info spmspvApspieMerge(Index*       w_ind,
       CUDA_CALL(cub::DeviceRadixSort::SortPairs(NULL, temp_storage_bytes,
           reinterpret_cast<Index*>(d_csrSwapInd),
           reinterpret_cast<Index*>(d_csrTempInd),
-          reinterpret_cast<T*>(d_csrSwapVal),
-          reinterpret_cast<T*>(d_csrTempVal), *w_nvals, 0, endbit));
+          reinterpret_cast<a*>(d_csrSwapVal),
+          reinterpret_cast<a*>(d_csrTempVal), *w_nvals, 0, endbit));
     else
       temp_storage_bytes = desc->d_temp_size_;
 
@@ -270,14 +272,14 @@ Info spmspvApspieMerge(Index*       w_ind,
     CUDA_CALL(cub::DeviceRadixSort::SortPairs(desc->d_temp_, temp_storage_bytes,
         reinterpret_cast<Index*>(d_csrSwapInd),
         reinterpret_cast<Index*>(d_csrTempInd),
-        reinterpret_cast<T*>(d_csrSwapVal),
-        reinterpret_cast<T*>(d_csrTempVal), *w_nvals, 0, endbit));
+        reinterpret_cast<a*>(d_csrSwapVal),
+        reinterpret_cast<a*>(d_csrTempVal), *w_nvals, 0, endbit));
 
-    // MergesortKeys(d_csrVecInd, total, mgpu::less<int>(), desc->d_context_);
+    // MergesortKeys(d_csrVecInd, total, mgpu::less<int>(), desc->context());
 
     if (desc->debug()) {
       printDevice("TempInd", reinterpret_cast<Index*>(d_csrTempInd), *w_nvals);
-      printDevice("TempVal", reinterpret_cast<T*>    (d_csrTempVal), *w_nvals);
+      printDevice("TempVal", reinterpret_cast<a*>    (d_csrTempVal), *w_nvals);
     }
   }
 
@@ -302,17 +304,17 @@ Info spmspvApspieMerge(Index*       w_ind,
       ReduceByKey(reinterpret_cast<Index*>(d_csrTempInd),
           reinterpret_cast<T*>(d_csrSwapInd), *w_nvals,
           op.identity(), extractAdd(op), mgpu::equal_to<Index>(), w_ind,
-          w_val, &w_nvals_t, reinterpret_cast<int*>(0), *(desc->d_context_));
+          w_val, &w_nvals_t, reinterpret_cast<int*>(0), desc->context());
       *w_nvals = w_nvals_t;
     }
   } else {
     Index  w_nvals_t = 0;
     ReduceByKey(reinterpret_cast<Index*>(d_csrTempInd),
-        reinterpret_cast<T*>(d_csrTempVal), *w_nvals, op.identity(),
+        reinterpret_cast<a*>(d_csrTempVal), *w_nvals, op.identity(),
         extractAdd(op),
         mgpu::equal_to<Index>(),  // NOLINT(build/include_what_you_use)
         w_ind, w_val, &w_nvals_t, reinterpret_cast<int*>(0),
-        *(desc->d_context_));
+        desc->context());
     *w_nvals = w_nvals_t;
   }
 
@@ -7,6 +7,7 @@
 #include <moderngpu.cuh>
 #include <cub.cuh>
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 
@@ -15,6 +16,248 @@
 namespace graphblas {
 namespace backend {
 
+/*!
+ * \brief Sum over row of A (row of A^T if use_tran) of A(row, j) * u(j), with
+ * pending updates to that row merged on the fly
+ *
+ * Stops as soon as sum reaches terminal of add. Returns false if row has no
+ * entries, in which case there is no result. delta.sorted(use_tran) must have
+ * been called before any parallel loop calling this
+ */
+template <typename SemiringT, typename a, typename U>
+inline bool spmvRowCpu(typename SemiringT::T_out_type* sum,
+                       SemiringT                       op,
+                       const Index*                    A_ptr,
+                       const Index*                    A_ind,
+                       const a*                        A_val,
+                       const DeltaBuffer<a>&           delta,
+                       bool                            use_tran,
+                       const U*                        u_val,
+                       Index                           row) {
+  typedef typename SemiringT::T_out_type T;
+  auto add_op = extractAdd(op);
+  auto mul_op = extractMul(op);
+  const T terminal = op.terminal();
+  *sum = op.identity();
+
+  Index upd_begin = 0, upd_end = 0;
+  if (!delta.empty())
+    delta.range(row, use_tran, &upd_begin, &upd_end);
+  if (upd_begin == upd_end) {
+    if (A_ptr[row] == A_ptr[row+1])
+      return false;
+    for (Index edge = A_ptr[row]; edge < A_ptr[row+1]; ++edge) {
+      *sum = add_op(*sum, mul_op(A_val[edge], u_val[A_ind[edge]]));
+      if (SemiringT::has_terminal && *sum == terminal)
+        break;
+    }
+    return true;
+  }
+
+  bool found = false;
+  DeltaBuffer<a>::forEachMerged(A_ind + A_ptr[row], A_val + A_ptr[row],
+      A_ptr[row+1] - A_ptr[row], delta.sorted(use_tran) + upd_begin,
+      upd_end - upd_begin, use_tran, [&](Index ind, a val) {
+    found = true;
+    *sum = add_op(*sum, mul_op(val, u_val[ind]));
+    return !(SemiringT::has_terminal && *sum == terminal);
+  });
+  return found;
+}
+
+/*!
+ * \brief CPU row-wise SpMV w = w + mask .* (A * u)
+ *
+ * Each row stops as soon as its sum reaches terminal of add, e.g. true for
+ * logical-or or lowest value for min, since no later product can change it.
+ * Rows left out by mask are not read, and accum and GrB_REPLACE are applied
+ * by OutputCpu as each row is written, so accumulating costs no extra pass.
+ * Row without any edge has no result, so it keeps w under accum.
+ * Non-complemented sparse mask only computes its own rows, and complemented
+ * one is looked up in a bitmap
+ */
+template <typename W, typename a, typename U, typename M,
+          typename BinaryOpT,      typename SemiringT>
+Info spmvCpu(DenseVector<W>*        w,
+             const Vector<M>*       mask,
+             BinaryOpT              accum,
+             bool                   use_scmp,
+             bool                   use_repl,
+             bool                   use_tran,
+             SemiringT              op,
+             const SparseMatrix<a>* A,
+             const DenseVector<U>*  u,
+             Descriptor*            desc) {
+  SparseMatrixFormat A_format;
+  bool A_symmetric;
+  CHECK(A->getFormat(&A_format));
+  CHECK(A->getSymmetry(&A_symmetric));
+  if (use_tran && !A_symmetric && A_format != GrB_SPARSE_MATRIX_CSRCSC) {
+    std::cout << "Error: Transposed CPU SpMV needs CSC storage!\n";
+    return GrB_INVALID_OBJECT;
+  }
+
+  // Symmetric matrix uses CSR for both
+  bool use_csc = use_tran && !A_symmetric;
+  const Index* A_ptr   = (use_csc) ? A->h_cscColPtr_ : A->h_csrRowPtr_;
+  const Index* A_ind   = (use_csc) ? A->h_cscRowInd_ : A->h_csrColInd_;
+  const a*     A_val   = (use_csc) ? A->h_cscVal_    : A->h_csrVal_;
+  const Index  A_nrows = (use_tran) ? A->ncols_       : A->nrows_;
+
+  OutputCpu<W, BinaryOpT> out(accum, use_repl, op.identity());
+  WorkspaceScope scope(desc->workspace());
+  MaskCpu<M> mask_cpu;
+  CHECK(mask_cpu.init(mask, use_scmp, out.needLookup(false),
+      desc->workspace()));
+
+  CHECK(const_cast<SparseMatrix<a>*>(A)->gpuToCpu());
+  CHECK(const_cast<DenseVector<U>*>(u)->gpuToCpu());
+  if (out.accumulates())
+    CHECK(w->gpuToCpu());
+
+  typedef typename SemiringT::T_out_type T;
+  const DeltaBuffer<a>& delta = A->delta();
+  delta.sorted(use_tran);
+  const U* u_val = u->h_val_;
+  forEachOutputCpu(mask_cpu, out, w->h_val_, A_nrows, false, [&](Index row) {
+    T sum;
+    if (spmvRowCpu(&sum, op, A_ptr, A_ind, A_val, delta, use_tran, u_val, row))
+      out.write(w->h_val_ + row, sum);
+    else
+      out.empty(w->h_val_ + row);
+  }, 64);
+
+  w->nvals_ = A_nrows;
+  CHECK(w->cpuToGpu());
+  w->need_update_ = false;
+  return GrB_SUCCESS;
+}
+
+// Whether pull with this mask can go to spmvSparseMaskCpu, i.e. CPU backend,
+// non-complemented sparse mask and no accum
+template <typename M, typename BinaryOpT>
+Info useSparseMaskCpu(const Vector<M>* mask,
+                      BinaryOpT        accum,
+                      Descriptor*      desc,
+                      bool*            use_sparse_mask) {
+  *use_sparse_mask = false;
+  if (mask == NULL || AccumTraits<BinaryOpT>::enabled)
+    return GrB_SUCCESS;
+
+  Desc_value scmp_mode, backend;
+  Storage mask_vec_type;
+  CHECK(desc->get(GrB_MASK, &scmp_mode));
+  CHECK(desc->get(GrB_BACKEND, &backend));
+  CHECK(mask->getStorage(&mask_vec_type));
+  *use_sparse_mask = (backend == GrB_SEQUENTIAL && scmp_mode != GrB_SCMP &&
+      mask_vec_type == GrB_SPARSE);
+  return GrB_SUCCESS;
+}
+
+// Pending updates to A are merged now, unless mxv/vxm will run on CPU, whose
+// SpMV merges them on the fly. Then they are left in delta buffer until there
+// are more than desc->compactratio() of nvals, and use_delta says whether
+// there are any left, in which case caller must stay on CPU SpMV (pull)
+template <typename a>
+Info compactForSpmvCpu(const Matrix<a>* A,
+                       Descriptor*      desc,
+                       bool*            use_delta) {
+  Matrix<a>* A_t = const_cast<Matrix<a>*>(A);
+  Desc_value backend;
+  Storage A_mat_type;
+  SparseMatrixFormat A_format;
+  bool A_symmetric;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+  CHECK(A->getStorage(&A_mat_type));
+  *use_delta = false;
+  if (backend != GrB_SEQUENTIAL || A_mat_type != GrB_SPARSE)
+    return A_t->compact();
+
+  // Transposed CPU SpMV reads CSC unless A is symmetric
+  CHECK(A->getFormat(&A_format));
+  CHECK(A->getSymmetry(&A_symmetric));
+  if (!A_symmetric && A_format != GrB_SPARSE_MATRIX_CSRCSC)
+    return A_t->compact();
+
+  CHECK(A_t->sparse_.compact(desc));
+  *use_delta = A->sparse_.ndelta() > 0;
+  return GrB_SUCCESS;
+}
+
+/*!
+ * \brief CPU SpMV w = mask .* (A * u) that writes only rows of sparse mask
+ *
+ * For non-complemented sparse mask with no accum. w comes out sparse, holding
+ * rows of mask whose result is not identity, in order of mask, so work and
+ * memory touched are O(mask nvals + edges of those rows), not O(nrows)
+ */
+template <typename W, typename a, typename U, typename M,
+          typename BinaryOpT,      typename SemiringT>
+Info spmvSparseMaskCpu(SparseVector<W>*       w,
+                       const Vector<M>*       mask,
+                       BinaryOpT              accum,
+                       SemiringT              op,
+                       const SparseMatrix<a>* A,
+                       const DenseVector<U>*  u,
+                       Descriptor*            desc) {
+  Desc_value inp0_mode, inp1_mode;
+  CHECK(desc->get(GrB_INP0, &inp0_mode));
+  CHECK(desc->get(GrB_INP1, &inp1_mode));
+  bool use_tran = (inp0_mode == GrB_TRAN || inp1_mode == GrB_TRAN);
+
+  SparseMatrixFormat A_format;
+  bool A_symmetric;
+  CHECK(A->getFormat(&A_format));
+  CHECK(A->getSymmetry(&A_symmetric));
+  if (use_tran && !A_symmetric && A_format != GrB_SPARSE_MATRIX_CSRCSC) {
+    std::cout << "Error: Transposed CPU SpMV needs CSC storage!\n";
+    return GrB_INVALID_OBJECT;
+  }
+
+  if (desc->debug())
+    std::cout << "Executing Spmv with sparse mask\n";
+
+  bool use_csc = use_tran && !A_symmetric;
+  const Index* A_ptr = (use_csc) ? A->h_cscColPtr_ : A->h_csrRowPtr_;
+  const Index* A_ind = (use_csc) ? A->h_cscRowInd_ : A->h_csrColInd_;
+  const a*     A_val = (use_csc) ? A->h_cscVal_    : A->h_csrVal_;
+
+  WorkspaceScope scope(desc->workspace());
+  MaskCpu<M> mask_cpu;
+  CHECK(mask_cpu.init(mask, false, false, desc->workspace()));
+
+  CHECK(const_cast<SparseMatrix<a>*>(A)->gpuToCpu());
+  CHECK(const_cast<DenseVector<U>*>(u)->gpuToCpu());
+
+  typedef typename SemiringT::T_out_type T;
+  const T identity = op.identity();
+  const DeltaBuffer<a>& delta = A->delta();
+  delta.sorted(use_tran);
+  const U* u_val = u->h_val_;
+  Index nindex = mask_cpu.nindex();
+  T* sum = desc->workspace()->allocate<T>(nindex + 1);
+  threadPool().parallelFor(0, nindex, [&](Index begin, Index end) {
+    for (Index k = begin; k < end; ++k) {
+      if (!spmvRowCpu(sum + k, op, A_ptr, A_ind, A_val, delta, use_tran,
+          u_val, mask_cpu.index(k)))
+        sum[k] = identity;
+    }
+  }, 64);
+
+  Index w_nvals = 0;
+  for (Index k = 0; k < nindex; ++k) {
+    if (sum[k] != identity) {
+      w->h_ind_[w_nvals] = mask_cpu.index(k);
+      w->h_val_[w_nvals] = static_cast<W>(sum[k]);
+      w_nvals++;
+    }
+  }
+  w->nvals_ = w_nvals;
+  CHECK(w->cpuToGpu());
+  w->need_update_ = false;
+  return GrB_SUCCESS;
+}
+
 template <typename W, typename a, typename U, typename M,
           typename BinaryOpT,      typename SemiringT>
 Info spmv(DenseVector<W>*        w,
@@ -31,13 +274,8 @@ Info spmv(DenseVector<W>*        w,
   CHECK(desc->get(GrB_INP0, &inp0_mode));
   CHECK(desc->get(GrB_INP1, &inp1_mode));
 
-  std::string accum_type = typeid(accum).name();
-  // TODO(@ctcyang): add accum and replace support
-  // -have masked variants as separate kernel
-  // -have scmp as template parameter
-  // -accum and replace as parts in flow
   bool use_mask  = (mask != NULL);
-  bool use_accum = (accum_type.size() > 1);
+  bool use_accum = AccumTraits<BinaryOpT>::enabled;
   bool use_scmp  = (scmp_mode == GrB_SCMP);
   bool use_repl  = (repl_mode == GrB_REPLACE);
   bool use_tran  = (inp0_mode == GrB_TRAN || inp1_mode == GrB_TRAN);
@@ -47,6 +285,16 @@ Info spmv(DenseVector<W>*        w,
     printState(use_mask, use_accum, use_scmp, use_repl, use_tran);
   }
 
+  Desc_value backend;
+  CHECK(desc->get(GrB_BACKEND, &backend));
+  if (backend == GrB_SEQUENTIAL)
+    return spmvCpu(w, mask, accum, use_scmp, use_repl, use_tran, op, A, u,
+        desc);
+
+  // TODO(@ctcyang): add accum and replace support to GPU path
+  // -have masked variants as separate kernel
+  // -have scmp as template parameter
+  // -accum and replace as parts in flow
   // Transpose (default is CSR):
   const Index* A_csrRowPtr = (use_tran) ? A->d_cscColPtr_ : A->d_csrRowPtr_;
   const Index* A_csrColInd = (use_tran) ? A->d_cscRowInd_ : A->d_csrColInd_;
@@ -73,34 +321,23 @@ Info spmv(DenseVector<W>*        w,
   const int tb = static_cast<int>(tb_mode);
   const int nt = static_cast<int>(nt_mode);
 
-  /*!
-   * /brief atomicAdd() 3+5  = 8
-   *        atomicSub() 3-5  =-2
-   *        atomicMin() 3,5  = 3
-   *        atomicMax() 3,5  = 5
-   *        atomicOr()  3||5 = 1
-   *        atomicXor() 3^^5 = 0
-   */
-  auto add_op = extractAdd(op);
-  int functor = add_op(3, 5);
-
-  if (desc->debug()) {
+  if (desc->debug())
     std::cout << "Fused mask: " << desc->fusedmask() << std::endl;
-    std::cout << "Functor:    " << functor << std::endl;
-  }
 
-  if (desc->struconly() && functor != 1)
-    std::cout << "Warning: Using structure-only mode and not using logical or "
-        << "semiring may result in unintended behaviour. Is this intended?\n";
+  if (desc->struconly() && !SemiringT::struconly)
+    std::cout << "Warning: Using structure-only mode with semiring whose "
+        << "result depends on values may result in unintended behaviour. Is "
+        << "this intended?\n";
+
+  Storage mask_vec_type = GrB_UNKNOWN;
+  if (use_mask)
+    CHECK(mask->getStorage(&mask_vec_type));
 
-  if (use_mask && desc->fusedmask() && functor == 1) {
+  if (use_mask && desc->fusedmask() && SemiringT::struconly) {
     // Mask type
     // 1) Dense mask
     // 2) Sparse mask TODO(@ctcyang)
     // 3) Uninitialized
-    Storage mask_vec_type;
-    CHECK(mask->getStorage(&mask_vec_type));
-
     if (mask_vec_type == GrB_DENSE) {
       dim3 NT, NB;
       NT.x = nt;
@@ -175,6 +412,41 @@ Info spmv(DenseVector<W>*        w,
     } else {
       return GrB_UNINITIALIZED_OBJECT;
     }
+  } else if (use_mask && desc->fusedmask() && !use_accum &&
+      mask_vec_type == GrB_DENSE) {
+    // Other semirings skip rows left out by mask too, and stop at terminal of
+    // add if it has one, e.g. min-plus at lowest value
+    dim3 NT, NB;
+    NT.x = nt;
+    NT.y = 1;
+    NT.z = 1;
+    NB.x = (A_nrows+nt-1)/nt;
+    NB.y = 1;
+    NB.z = 1;
+
+    const bool use_earlyexit = SemiringT::has_terminal && desc->earlyexit();
+    if (use_scmp && use_earlyexit)
+      spmvDenseMaskedKernel<true, true><<<NB, NT>>>(w->d_val_,
+          mask->dense_.d_val_, op.identity(), op.terminal(), extractMul(op),
+          extractAdd(op), A_nrows, A_csrRowPtr, A_csrColInd, A_csrVal,
+          u->d_val_);
+    else if (use_scmp)
+      spmvDenseMaskedKernel<true, false><<<NB, NT>>>(w->d_val_,
+          mask->dense_.d_val_, op.identity(), op.terminal(), extractMul(op),
+          extractAdd(op), A_nrows, A_csrRowPtr, A_csrColInd, A_csrVal,
+          u->d_val_);
+    else if (use_earlyexit)
+      spmvDenseMaskedKernel<false, true><<<NB, NT>>>(w->d_val_,
+          mask->dense_.d_val_, op.identity(), op.terminal(), extractMul(op),
+          extractAdd(op), A_nrows, A_csrRowPtr, A_csrColInd, A_csrVal,
+          u->d_val_);
+    else
+      spmvDenseMaskedKernel<false, false><<<NB, NT>>>(w->d_val_,
+          mask->dense_.d_val_, op.identity(), op.terminal(), extractMul(op),
+          extractAdd(op), A_nrows, A_csrRowPtr, A_csrColInd, A_csrVal,
+          u->d_val_);
+    if (desc->debug())
+      printDevice("w_val", w->d_val_, A_nrows);
   } else {
     Index* w_ind;
     W*     w_val;
@@ -187,7 +459,7 @@ Info spmv(DenseVector<W>*        w,
     }
     mgpu::SpmvCsrBinary(A_csrVal, A_csrColInd, A->nvals_, A_csrRowPtr, A_nrows,
         u->d_val_, true, w_val, op.identity(), extractMul(op), extractAdd(op),
-        *(desc->d_context_) );
+        desc->context() );
     dim3 NT, NB;
     NT.x = nt;
     NT.y = 1;
@@ -204,11 +476,13 @@ Info spmv(DenseVector<W>*        w,
       if (use_scmp)
         assignDenseDenseMaskedKernel<false, true, true><<<NB, NT>>>(
             w_val, w->nvals_, mask->dense_.d_val_, extractAdd(op),
-            op.identity(), reinterpret_cast<Index*>(NULL), A_nrows);
+            static_cast<W>(op.identity()), reinterpret_cast<Index*>(NULL),
+            A_nrows);
       else
         assignDenseDenseMaskedKernel< true, true, true><<<NB, NT>>>(
             w_val, w->nvals_, mask->dense_.d_val_, extractAdd(op),
-            op.identity(), reinterpret_cast<Index*>(NULL), A_nrows);
+            static_cast<W>(op.identity()), reinterpret_cast<Index*>(NULL),
+            A_nrows);
     }
     if (use_accum) {
       if (desc->debug()) {
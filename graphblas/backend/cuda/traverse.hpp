@@ -0,0 +1,286 @@
+#ifndef GRAPHBLAS_BACKEND_CUDA_TRAVERSE_HPP_
+#define GRAPHBLAS_BACKEND_CUDA_TRAVERSE_HPP_
+
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace graphblas {
+namespace backend {
+
+// Marks vertex reached at given depth in dense v, where 0 means unvisited.
+// Push claims vertices concurrently, and first claim writes depth
+template <typename T>
+struct TraverseDepth {
+  T* val;
+  T  depth;
+
+  inline bool visited(Index col) const {
+    return val[col] != static_cast<T>(0);
+  }
+  inline void visit(Index col, Index parent) const { val[col] = depth; }
+  inline bool claim(Index col, Index parent) const {
+    T expected;
+    T desired = depth;
+    __atomic_load(val + col, &expected, __ATOMIC_RELAXED);
+    return expected == static_cast<T>(0) && __atomic_compare_exchange(
+        val + col, &expected, &desired, false, __ATOMIC_RELAXED,
+        __ATOMIC_RELAXED);
+  }
+  inline void settle(Index col) const {}
+};
+
+// Marks vertex reached from parent in dense p, where -1 means unvisited.
+// While push claims vertices, a claimed one holds -2-parent, which only ever
+// grows, so smallest parent wins whatever order frontier is scanned in. It is
+// decoded by settle once every claim is done
+struct TraverseParent {
+  Index* val;
+
+  inline bool visited(Index col) const { return val[col] >= 0; }
+  inline void visit(Index col, Index parent) const { val[col] = parent; }
+  inline bool claim(Index col, Index parent) const {
+    Index desired  = -2 - parent;
+    Index expected = __atomic_load_n(val + col, __ATOMIC_RELAXED);
+    while (expected == -1 || expected < desired) {
+      if (__atomic_compare_exchange_n(val + col, &expected, desired, true,
+          __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        return expected == -1;
+    }
+    return false;
+  }
+  inline void settle(Index col) const { val[col] = -2 - val[col]; }
+};
+
+// Push variant: scans out-edges of frontier in parallel chunks. Unvisited
+// neighbours are claimed as soon as they are found, so each one is added once,
+// to list of chunk that claimed it first. Lists are packed into w at offsets
+// from parallelScan, so w is in chunk order rather than sorted
+template <typename W, typename VisitT>
+Index traversePush(SparseVector<W>* w,
+                   const VisitT&    visit,
+                   const Index*     u_ind,
+                   Index            u_nvals,
+                   const Index*     A_rowPtr,
+                   const Index*     A_colInd) {
+  const Index grain  = 64;
+  Index       nchunk = (u_nvals + grain - 1)/grain;
+  std::vector<std::vector<Index> > found(nchunk);
+  std::vector<Index> offset(nchunk, 0);
+  threadPool().parallelFor(0, nchunk, [&](Index begin, Index end) {
+    for (Index chunk = begin; chunk < end; ++chunk) {
+      std::vector<Index>& list = found[chunk];
+      Index last = std::min(u_nvals, (chunk + 1)*grain);
+      for (Index i = chunk*grain; i < last; ++i) {
+        Index row = u_ind[i];
+        for (Index edge = A_rowPtr[row]; edge < A_rowPtr[row+1]; ++edge) {
+          Index col = A_colInd[edge];
+          if (visit.claim(col, row))
+            list.push_back(col);
+        }
+      }
+      offset[chunk] = list.size();
+    }
+  });
+  Index w_nvals = threadPool().parallelScan(offset.data(), offset.data(),
+      nchunk, static_cast<Index>(0), std::plus<Index>());
+
+  threadPool().parallelFor(0, nchunk, [&](Index begin, Index end) {
+    for (Index chunk = begin; chunk < end; ++chunk) {
+      Index dest = offset[chunk];
+      for (Index col : found[chunk]) {
+        visit.settle(col);
+        w->h_ind_[dest] = col;
+        w->h_val_[dest] = static_cast<W>(1);
+        dest++;
+      }
+    }
+  });
+  w->nvals_ = w_nvals;
+  return w_nvals;
+}
+
+// Indices of nonzeros of dense u_val, in order, written to ind. Chunks count
+// their nonzeros into offset (nsize/4096 + 1 entries), parallelScan turns
+// counts into where each chunk writes, and a second pass writes them
+template <typename U>
+Index traverseDenseIndices(Index*   ind,
+                           Index*   offset,
+                           const U* u_val,
+                           Index    nsize) {
+  const Index grain  = 4096;
+  Index       nchunk = (nsize + grain - 1)/grain;
+  threadPool().parallelFor(0, nchunk, [&](Index begin, Index end) {
+    for (Index chunk = begin; chunk < end; ++chunk) {
+      Index count = 0;
+      Index last  = std::min(nsize, (chunk + 1)*grain);
+      for (Index i = chunk*grain; i < last; ++i)
+        if (u_val[i] != static_cast<U>(0))
+          count++;
+      offset[chunk] = count;
+    }
+  });
+  Index u_nvals = threadPool().parallelScan(offset, offset, nchunk,
+      static_cast<Index>(0), std::plus<Index>());
+
+  threadPool().parallelFor(0, nchunk, [&](Index begin, Index end) {
+    for (Index chunk = begin; chunk < end; ++chunk) {
+      Index dest = offset[chunk];
+      Index last = std::min(nsize, (chunk + 1)*grain);
+      for (Index i = chunk*grain; i < last; ++i)
+        if (u_val[i] != static_cast<U>(0))
+          ind[dest++] = i;
+    }
+  });
+  return u_nvals;
+}
+
+// Pull variant: every unvisited vertex scans its in-edges and stops at the
+// first one from the frontier, which is its parent. u_val is a dense lookup of
+// the frontier. In-edges are in order, so parent is same as push would pick
+template <typename W, typename U, typename VisitT>
+Index traversePull(DenseVector<W>* w,
+                   const VisitT&   visit,
+                   Index           nsize,
+                   const U*        u_val,
+                   const Index*    A_colPtr,
+                   const Index*    A_rowInd) {
+  // Each vertex only writes its own element of v and w, so no races
+  Index w_nvals = threadPool().parallelReduce(0, nsize, 0,
+      [&](Index begin, Index end) {
+    Index count = 0;
+    for (Index col = begin; col < end; ++col) {
+      W discovered = static_cast<W>(0);
+      if (!visit.visited(col)) {
+        for (Index edge = A_colPtr[col]; edge < A_colPtr[col+1]; ++edge) {
+          Index row = A_rowInd[edge];
+          if (u_val[row] != static_cast<U>(0)) {
+            discovered = static_cast<W>(1);
+            visit.visit(col, row);
+            count++;
+            break;
+          }
+        }
+      }
+      w->h_val_[col] = discovered;
+    }
+    return count;
+  }, std::plus<Index>(), 1024);
+  w->nnz_ = w_nvals;
+  return w_nvals;
+}
+
+/*!
+ * \brief CPU BFS level step, fusing masked vxm, assign and reduce
+ *
+ * w = !v .* (u ||.&& A), then v(w) = visit and w_nvals = nnz(w), in a single
+ * pass. visit marks vertices in v (depths or parents) and tells which ones
+ * are visited already. Direction is picked like vxm does: by GrB_MXVMODE, and
+ * for GrB_PUSHPULL by comparing frontier density against desc->switchpoint().
+ * Push writes w as a SpVec and pull writes it as a DeVec, so that the next
+ * level needs no conversion as long as direction does not change.
+ */
+template <typename W, typename T, typename U, typename a,
+          typename VisitT>
+Info traverseCpu(Vector<W>*             w,
+                 DenseVector<T>*        v,
+                 Index*                 w_nvals,
+                 const VisitT&          visit,
+                 const Vector<U>*       u,
+                 const SparseMatrix<a>* A,
+                 Descriptor*            desc) {
+  Desc_value inp1_mode, vxm_mode;
+  CHECK(desc->get(GrB_INP1,    &inp1_mode));
+  CHECK(desc->get(GrB_MXVMODE, &vxm_mode));
+
+  SparseMatrixFormat A_format;
+  bool A_symmetric;
+  CHECK(A->getFormat(&A_format));
+  CHECK(A->getSymmetry(&A_symmetric));
+
+  // w = uA pushes along rows and pulls along columns of A, and the other way
+  // around for w = uA^T. Symmetric matrix uses CSR for both
+  bool use_tran = (inp1_mode == GrB_TRAN);
+  bool has_csc  = (A_format == GrB_SPARSE_MATRIX_CSRCSC);
+  const Index* A_csrRowPtr = A->h_csrRowPtr_;
+  const Index* A_csrColInd = A->h_csrColInd_;
+  const Index* A_cscColPtr = (A_symmetric) ? A->h_csrRowPtr_ : A->h_cscColPtr_;
+  const Index* A_cscRowInd = (A_symmetric) ? A->h_csrColInd_ : A->h_cscRowInd_;
+  bool can_push = A_symmetric || !use_tran || has_csc;
+  bool can_pull = A_symmetric ||  use_tran || has_csc;
+
+  CHECK(const_cast<SparseMatrix<a>*>(A)->gpuToCpu());
+  CHECK(v->gpuToCpu());
+
+  WorkspaceScope scope(desc->workspace());
+  Index nsize = v->nvals_;
+
+  // Frontier as index list, which is needed by push and gives density
+  Storage u_vec_type;
+  CHECK(u->getStorage(&u_vec_type));
+  const Index* u_ind   = NULL;
+  Index        u_nvals = 0;
+  if (u_vec_type == GrB_SPARSE) {
+    CHECK(const_cast<SparseVector<U>*>(&u->sparse_)->gpuToCpu());
+    u_ind   = u->sparse_.h_ind_;
+    u_nvals = u->sparse_.nvals_;
+  } else if (u_vec_type == GrB_DENSE) {
+    CHECK(const_cast<DenseVector<U>*>(&u->dense_)->gpuToCpu());
+    Index* ind    = desc->workspace()->allocate<Index>(nsize);
+    Index* offset = desc->workspace()->allocate<Index>(nsize/4096 + 1);
+    if (ind == NULL || offset == NULL)
+      return GrB_OUT_OF_MEMORY;
+    u_nvals = traverseDenseIndices(ind, offset, u->dense_.h_val_, nsize);
+    u_ind   = ind;
+  } else {
+    return GrB_UNINITIALIZED_OBJECT;
+  }
+
+  bool use_push;
+  if (vxm_mode == GrB_PUSHONLY)
+    use_push = true;
+  else if (vxm_mode == GrB_PULLONLY)
+    use_push = false;
+  else
+    use_push = static_cast<float>(u_nvals)/nsize <= desc->switchpoint();
+  if (!can_pull) use_push = true;
+  if (!can_push) use_push = false;
+
+  if (desc->dirinfo())
+    std::cout << "Frontier: " << u_nvals << "/" << nsize << ", "
+        << ((use_push) ? "push" : "pull") << std::endl;
+
+  if (use_push) {
+    CHECK(w->setStorage(GrB_SPARSE));
+    *w_nvals = traversePush(&w->sparse_, visit, u_ind, u_nvals,
+        (use_tran) ? A_cscColPtr : A_csrRowPtr,
+        (use_tran) ? A_cscRowInd : A_csrColInd);
+    CHECK(w->sparse_.cpuToGpu());
+    desc->lastmxv_ = GrB_PUSHONLY;
+  } else {
+    // Pull needs random access into frontier
+    CHECK(w->setStorage(GrB_DENSE));
+    if (u_vec_type == GrB_DENSE) {
+      *w_nvals = traversePull(&w->dense_, visit, nsize, u->dense_.h_val_,
+          (use_tran) ? A_csrRowPtr : A_cscColPtr,
+          (use_tran) ? A_csrColInd : A_cscRowInd);
+    } else {
+      bool* u_val = desc->workspace()->allocate<bool>(nsize);
+      std::fill(u_val, u_val + nsize, false);
+      for (Index i = 0; i < u_nvals; ++i)
+        u_val[u_ind[i]] = true;
+      *w_nvals = traversePull(&w->dense_, visit, nsize, u_val,
+          (use_tran) ? A_csrRowPtr : A_cscColPtr,
+          (use_tran) ? A_csrColInd : A_cscRowInd);
+    }
+    CHECK(w->dense_.cpuToGpu());
+    desc->lastmxv_ = GrB_PULLONLY;
+  }
+  CHECK(v->cpuToGpu());
+  return GrB_SUCCESS;
+}
+}  // namespace backend
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_BACKEND_CUDA_TRAVERSE_HPP_
@@ -15,6 +15,28 @@ enum LoadBalanceMode {
   GrB_LOAD_BALANCE_TWC,
   GrB_LOAD_BALANCE_MERGE
 };
+
+enum MemorySpace {
+  GrB_MEMORY_HOST,
+  GrB_MEMORY_DEVICE,
+  GrB_MEMORY_NSPACE
+};
+
+// GrB_MEMORY_ALL is the sum over all other categories
+enum MemoryCategory {
+  GrB_MEMORY_MATRIX,
+  GrB_MEMORY_VECTOR,
+  GrB_MEMORY_DESCRIPTOR,  // desc device buffers
+  GrB_MEMORY_TEMP,        // CPU workspace and temporaries inside operations
+  GrB_MEMORY_ALL
+};
+
+struct MemoryStats {
+  size_t current;  // bytes
+  size_t peak;     // bytes
+  size_t nalloc;
+  size_t nfree;
+};
 }  // namespace backend
 }  // namespace graphblas
 
@@ -23,15 +23,6 @@
 namespace graphblas {
 namespace backend {
 
-void printMemory(const char* str) {
-  size_t free, total;
-  if (GrB_MEMORY) {
-    CUDA_CALL(cudaMemGetInfo(&free, &total));
-    std::cout << str << ": " << free << " bytes left out of " << total <<
-        " bytes\n";
-  }
-}
-
 template <typename T>
 void printDevice(const char* str, const T* array, int length = 40,
                  bool limit = true) {
@@ -31,6 +31,15 @@ class Vector {
       : nsize_(nsize), nvals_(0), sparse_(nsize), dense_(nsize),
         vec_type_(GrB_UNKNOWN), ratio_(0) {}
 
+  // O(1) moves, so Vector can be returned by value
+  Vector(Vector&& rhs) : Vector() {
+    swap(&rhs);
+  }
+  Vector& operator=(Vector&& rhs) {
+    swap(&rhs);
+    return *this;
+  }
+
   // Default destructor is good enough for this layer
   ~Vector() {}
 
@@ -72,6 +81,7 @@ class Vector {
   Info sparse2dense(T identity, Descriptor* desc = NULL);
   Info dense2sparse(T identity, Descriptor* desc);
   Info swap(Vector* rhs);
+  Info recycle();
 
  private:
   Index           nsize_;
@@ -91,6 +101,7 @@ Info Vector<T>::nnew(Index nsize_t) {
   return GrB_SUCCESS;
 }
 
+// O(1): arrays are shared with rhs until either vector is written to
 template <typename T>
 Info Vector<T>::dup(const Vector* rhs) {
   vec_type_ = rhs->vec_type_;
@@ -111,6 +122,22 @@ Info Vector<T>::clear() {
   return GrB_SUCCESS;
 }
 
+// Puts vector back in the state right after construction without freeing or
+// zero-filling its memory (used by VectorPool)
+template <typename T>
+Info Vector<T>::recycle() {
+  vec_type_ = GrB_UNKNOWN;
+  nvals_    = 0;
+  ratio_    = 0;
+
+  // Host copies are stale, so force next gpuToCpu() to copy
+  sparse_.nvals_       = 0;
+  sparse_.need_update_ = true;
+  dense_.nnz_          = 0;
+  dense_.need_update_  = true;
+  return GrB_SUCCESS;
+}
+
 // Calls size_ from SparseVector or DenseVector
 // Updates nsize_ with the latest value
 template <typename T>
@@ -269,13 +296,18 @@ Info Vector<T>::countUnique(Index* count) {
 }
 
 // Private method that sets mat_type, and tries to allocate
+// Every operation calls it on its output before writing, so this is also
+// where arrays shared with a dup are copied
 template <typename T>
 inline Info Vector<T>::setStorage(Storage vec_type) {
   vec_type_ = vec_type;
-  if (vec_type_ == GrB_SPARSE)
+  if (vec_type_ == GrB_SPARSE) {
     CHECK(sparse_.allocate());
-  else if (vec_type_ == GrB_DENSE)
+    CHECK(sparse_.unshare());
+  } else if (vec_type_ == GrB_DENSE) {
     CHECK(dense_.allocate());
+    CHECK(dense_.unshare());
+  }
   return GrB_SUCCESS;
 }
 
@@ -324,8 +356,9 @@ Info Vector<T>::convert(T identity, float switchpoint, Descriptor* desc) {
 
 template <typename T>
 Info Vector<T>::sparse2dense(T identity, Descriptor* desc) {
+  // Callers write to dense_ after this, so it must not be shared with a dup
   if (vec_type_ == GrB_DENSE)
-    return GrB_SUCCESS;
+    return dense_.unshare();
   if (vec_type_ == GrB_UNKNOWN) {
     CHECK(setStorage(GrB_DENSE));
     return GrB_SUCCESS;
@@ -374,6 +407,7 @@ Info Vector<T>::dense2sparse(T identity, Descriptor* desc) {
   // 2. Run kernel
 
   CHECK(setStorage(GrB_DENSE));
+  CHECK(sparse_.unshare());
   const int nt    = 128;
   const int nvals = dense_.nvals_;
 
@@ -392,7 +426,7 @@ Info Vector<T>::dense2sparse(T identity, Descriptor* desc) {
   mgpu::Scan<mgpu::MgpuScanTypeExc>(d_flag, nvals, (Index)0,
       mgpu::plus<Index>(),  // NOLINT(build/include_what_you_use)
       reinterpret_cast<Index*>(0), &sparse_.nvals_, d_scan,
-      *(desc->d_context_));
+      desc->context());
 
   if (desc->debug()) {
     printDevice("d_val",  dense_.d_val_, nvals);
@@ -402,8 +436,7 @@ Info Vector<T>::dense2sparse(T identity, Descriptor* desc) {
     std::cout << "Sparse frontier size: " << sparse_.nvals_ << std::endl;
   }
 
-  LoadBalanceMode mxv_mode = getEnv("GRB_LOAD_BALANCE_MODE",
-      GrB_LOAD_BALANCE_MERGE);
+  LoadBalanceMode mxv_mode = desc->lbmode();
 
   if (desc->struconly() && mxv_mode == GrB_LOAD_BALANCE_MERGE)
     streamCompactDenseKernel<<<NB, NT>>>(sparse_.d_ind_, d_scan, (Index)1,
@@ -424,27 +457,25 @@ Info Vector<T>::dense2sparse(T identity, Descriptor* desc) {
   return GrB_SUCCESS;
 }
 
-// Assume both are of the same type to make things easier
+// Exchanges both sparse and dense storage, so it is O(1) and works even if
+// the two vectors have different storage types
 template <typename T>
 Info Vector<T>::swap(Vector* rhs) {  // NOLINT(build/include_what_you_use)
-  if (vec_type_ != rhs->vec_type_ || vec_type_ == GrB_UNKNOWN)  {
-    // std::cout << vec_type_ << " != " << rhs->vec_type_ << std::endl;
-    // std::cout << "Error: Format not equivalent!\n";
-    return GrB_INVALID_OBJECT;
-  }
-
-  if (vec_type_ == GrB_SPARSE) CHECK(sparse_.swap(&rhs->sparse_));
-  else if (vec_type_ == GrB_DENSE) CHECK(dense_.swap(&rhs->dense_));
-
-  Index temp_nsize = nsize_;
-  Index temp_nvals = nvals_;
-  float temp_ratio = ratio_;
-  nsize_ = rhs->nsize_;
-  nvals_ = rhs->nvals_;
-  ratio_ = rhs->ratio_;
-  rhs->nsize_ = temp_nsize;
-  rhs->nvals_ = temp_nvals;
-  rhs->ratio_ = temp_ratio;
+  CHECK(sparse_.swap(&rhs->sparse_));
+  CHECK(dense_.swap(&rhs->dense_));
+
+  Index   temp_nsize    = nsize_;
+  Index   temp_nvals    = nvals_;
+  Storage temp_vec_type = vec_type_;
+  float   temp_ratio    = ratio_;
+  nsize_    = rhs->nsize_;
+  nvals_    = rhs->nvals_;
+  vec_type_ = rhs->vec_type_;
+  ratio_    = rhs->ratio_;
+  rhs->nsize_    = temp_nsize;
+  rhs->nvals_    = temp_nvals;
+  rhs->vec_type_ = temp_vec_type;
+  rhs->ratio_    = temp_ratio;
 
   return GrB_SUCCESS;
 }
@@ -0,0 +1,259 @@
+#ifndef GRAPHBLAS_BACKEND_CUDA_WORKSPACE_HPP_
+#define GRAPHBLAS_BACKEND_CUDA_WORKSPACE_HPP_
+
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <iostream>
+
+#include "graphblas/backend/cuda/memory.hpp"
+
+namespace graphblas {
+namespace backend {
+
+/*!
+ * \brief Host-side arena used by the CPU (GrB_SEQUENTIAL) code paths for
+ *        scratch memory
+ *
+ * Every thread owns one slab and bump-allocates out of it. Scratch memory is
+ * never freed individually: an operation takes a mark() on entry and calls
+ * reset() with that mark on exit (see WorkspaceScope).
+ *
+ * When a slab is too small, the request is served from an overflow chunk.
+ * The next time the slab is reset to empty, the overflow chunks are released
+ * and the slab is regrown to its high-water mark, so after the first
+ * iteration of an iterative algorithm no further malloc/free happens.
+ *
+ * Thread-safety: allocate(), mark() and reset(tid, mark) may be called
+ * concurrently as long as each thread uses its own tid. reserve() and
+ * reset() must be called from a single thread.
+ */
+class Workspace {
+ public:
+  // Cache line size: slabs are aligned to this and it is the default
+  // alignment of every sub-allocation
+  static const size_t kAlignment = 64;
+
+  struct Mark {
+    size_t offset;
+    size_t noverflow;
+  };
+
+  Workspace() : slabs_(1) {}
+  ~Workspace();
+
+  // Grows number of slabs to nslab and each slab to at least nbytes
+  Info reserve(int nslab, size_t nbytes);
+
+  // Typed sub-allocation of count elements from slab tid, aligned to
+  // kAlignment
+  template <typename T>
+  T* allocate(size_t count, int tid = 0);
+
+  // Operation boundary
+  Mark mark(int tid = 0) const;
+  Info reset(int tid, const Mark& mark);
+  Info reset();
+
+  // Statistics (bytes)
+  inline int    nslab() const { return slabs_.size(); }
+  size_t capacity() const;
+  size_t inUse() const;
+  size_t highWater() const;
+  // Number of times the system allocator was called
+  size_t nmalloc() const;
+  Info print(const char* str) const;
+
+ private:
+  struct Slab {
+    Slab() : raw(NULL), base(NULL), capacity(0), offset(0),
+             overflow_bytes(0), high_water(0), nmalloc(0) {}
+
+    char*  raw;             // Pointer returned by hostMalloc
+    char*  base;            // raw aligned to kAlignment
+    size_t capacity;
+    size_t offset;
+    size_t overflow_bytes;
+    size_t high_water;      // max(offset + overflow_bytes)
+    size_t nmalloc;
+    std::vector<std::pair<void*, size_t> > overflow;
+
+    // Keep slabs of different threads on different cache lines
+    char   pad[kAlignment];
+  };
+
+  Info grow(Slab* slab, size_t nbytes);
+  void* overflow(Slab* slab, size_t nbytes);
+
+  // Workspace holds raw memory, so it is not copyable
+  Workspace(const Workspace&);
+  Workspace& operator=(const Workspace&);
+
+ private:
+  std::vector<Slab> slabs_;
+};
+
+/*!
+ * \brief RAII helper that marks a slab on construction and resets it to the
+ *        mark on destruction
+ */
+class WorkspaceScope {
+ public:
+  explicit WorkspaceScope(Workspace* workspace, int tid = 0)
+      : workspace_(workspace), tid_(tid), mark_(workspace->mark(tid)) {}
+  ~WorkspaceScope() { workspace_->reset(tid_, mark_); }
+
+ private:
+  WorkspaceScope(const WorkspaceScope&);
+  WorkspaceScope& operator=(const WorkspaceScope&);
+
+  Workspace*      workspace_;
+  int             tid_;
+  Workspace::Mark mark_;
+};
+
+Workspace::~Workspace() {
+  for (size_t i = 0; i < slabs_.size(); ++i) {
+    Slab& slab = slabs_[i];
+    for (size_t j = 0; j < slab.overflow.size(); ++j)
+      hostFree(slab.overflow[j].first);
+    if (slab.raw != NULL) hostFree(slab.raw);
+  }
+}
+
+Info Workspace::reserve(int nslab, size_t nbytes) {
+  if (nslab > static_cast<int>(slabs_.size()))
+    slabs_.resize(nslab);
+  for (size_t i = 0; i < slabs_.size(); ++i)
+    CHECK(grow(&slabs_[i], nbytes));
+  return GrB_SUCCESS;
+}
+
+template <typename T>
+T* Workspace::allocate(size_t count, int tid) {
+  if (tid < 0 || tid >= static_cast<int>(slabs_.size())) {
+    std::cout << "Error: Workspace slab " << tid << " does not exist!\n";
+    return NULL;
+  }
+  Slab*  slab   = &slabs_[tid];
+  size_t nbytes = count*sizeof(T);
+  size_t start  = (slab->offset + kAlignment - 1) & ~(kAlignment - 1);
+
+  void* ptr;
+  if (start + nbytes <= slab->capacity) {
+    slab->offset = start + nbytes;
+    ptr = slab->base + start;
+  } else {
+    ptr = overflow(slab, nbytes);
+  }
+
+  size_t usage = slab->offset + slab->overflow_bytes;
+  if (usage > slab->high_water)
+    slab->high_water = usage;
+  return reinterpret_cast<T*>(ptr);
+}
+
+Workspace::Mark Workspace::mark(int tid) const {
+  const Slab& slab = slabs_[tid];
+  Mark mark = {slab.offset, slab.overflow.size()};
+  return mark;
+}
+
+Info Workspace::reset(int tid, const Mark& mark) {
+  if (tid < 0 || tid >= static_cast<int>(slabs_.size()))
+    return GrB_INVALID_INDEX;
+  Slab* slab = &slabs_[tid];
+  while (slab->overflow.size() > mark.noverflow) {
+    hostFree(slab->overflow.back().first);
+    slab->overflow_bytes -= slab->overflow.back().second;
+    slab->overflow.pop_back();
+  }
+  slab->offset = mark.offset;
+
+  // Slab is empty: coalesce so next time everything fits in one slab
+  if (mark.offset == 0 && mark.noverflow == 0)
+    CHECK(grow(slab, slab->high_water));
+  return GrB_SUCCESS;
+}
+
+Info Workspace::reset() {
+  Mark empty = {0, 0};
+  for (size_t i = 0; i < slabs_.size(); ++i)
+    CHECK(reset(i, empty));
+  return GrB_SUCCESS;
+}
+
+size_t Workspace::capacity() const {
+  size_t total = 0;
+  for (size_t i = 0; i < slabs_.size(); ++i)
+    total += slabs_[i].capacity + slabs_[i].overflow_bytes;
+  return total;
+}
+
+size_t Workspace::inUse() const {
+  size_t total = 0;
+  for (size_t i = 0; i < slabs_.size(); ++i)
+    total += slabs_[i].offset + slabs_[i].overflow_bytes;
+  return total;
+}
+
+size_t Workspace::highWater() const {
+  size_t total = 0;
+  for (size_t i = 0; i < slabs_.size(); ++i)
+    total += slabs_[i].high_water;
+  return total;
+}
+
+size_t Workspace::nmalloc() const {
+  size_t total = 0;
+  for (size_t i = 0; i < slabs_.size(); ++i)
+    total += slabs_[i].nmalloc;
+  return total;
+}
+
+Info Workspace::print(const char* str) const {
+  std::cout << str << ": workspace " << slabs_.size() << " slabs, "
+      << inUse() << " bytes in use, " << capacity() << " bytes capacity, "
+      << highWater() << " bytes high-water, " << nmalloc() << " mallocs\n";
+  return GrB_SUCCESS;
+}
+
+// Private method that regrows an empty slab; existing contents are discarded
+Info Workspace::grow(Slab* slab, size_t nbytes) {
+  if (nbytes <= slab->capacity || slab->offset != 0 ||
+      !slab->overflow.empty())
+    return GrB_SUCCESS;
+
+  nbytes = (nbytes + kAlignment - 1) & ~(kAlignment - 1);
+  char* raw = NULL;
+  CHECK(hostMalloc(&raw, nbytes + kAlignment, GrB_MEMORY_TEMP));
+  if (slab->raw != NULL) hostFree(slab->raw);
+  slab->nmalloc++;
+
+  slab->raw      = raw;
+  slab->base     = reinterpret_cast<char*>(
+      (reinterpret_cast<uintptr_t>(raw) + kAlignment - 1) &
+      ~static_cast<uintptr_t>(kAlignment - 1));
+  slab->capacity = nbytes;
+  return GrB_SUCCESS;
+}
+
+// Private method that serves a request that does not fit in the slab
+void* Workspace::overflow(Slab* slab, size_t nbytes) {
+  size_t padded = nbytes + kAlignment;
+  char*  raw    = NULL;
+  if (hostMalloc(&raw, padded, GrB_MEMORY_TEMP) != GrB_SUCCESS)
+    return NULL;
+  slab->nmalloc++;
+  slab->overflow.push_back(std::make_pair(raw, padded));
+  slab->overflow_bytes += padded;
+
+  return reinterpret_cast<void*>(
+      (reinterpret_cast<uintptr_t>(raw) + kAlignment - 1) &
+      ~static_cast<uintptr_t>(kAlignment - 1));
+}
+}  // namespace backend
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_BACKEND_CUDA_WORKSPACE_HPP_
@@ -1,9 +1,12 @@
 #ifndef GRAPHBLAS_DESCRIPTOR_HPP_
 #define GRAPHBLAS_DESCRIPTOR_HPP_
 
+#include <string>
 #include <vector>
 
 #include "graphblas/types.hpp"
+#include "graphblas/vector_pool.hpp"
+#include "graphblas/scheduler.hpp"
 
 // Opaque data members from the right backend
 #define __GRB_BACKEND_DESCRIPTOR_HEADER <graphblas/backend/__GRB_BACKEND_ROOT/descriptor.hpp>
@@ -19,7 +22,16 @@ class Descriptor {
   // Default Constructor, Standard Constructor (Replaces new in C++)
   //   -it's imperative to call constructor using descriptor or else the
   //     constructed object won't be tied to this outermost layer
-  Descriptor() : descriptor_() {}
+  Descriptor() : descriptor_(), scheduler_(&descriptor_) {}
+
+  // Copies settings only. Copy gets its own buffers, pool and scheduler, so
+  // Descriptor made once by loadArgs can be copied cheaply per query
+  Descriptor(const Descriptor& rhs)
+      : descriptor_(rhs.descriptor_), scheduler_(&descriptor_) {}
+  Descriptor& operator=(const Descriptor& rhs) {
+    descriptor_ = rhs.descriptor_;
+    return *this;
+  }
 
   // Default Destructor is good enough for this layer
   ~Descriptor() {}
@@ -33,9 +45,68 @@ class Descriptor {
   Info toggle(Desc_field field);
   Info loadArgs(const po::variables_map& vm);
 
+  // Typed setters, same as options read by loadArgs
+  inline Info setMxvMode(int mxvmode) {
+    return descriptor_.setMxvMode(mxvmode);
+  }
+  inline Info setNthread(int nthread) {
+    return descriptor_.setNthread(nthread);
+  }
+  inline Info setNonblocking(bool nonblocking) {
+    return descriptor_.setNonblocking(nonblocking);
+  }
+  inline Info setCpuThread(int cputhread, bool affinity) {
+    return descriptor_.setCpuThread(cputhread, affinity);
+  }
+  inline Info setSwitchpoint(float x) { return descriptor_.setSwitchpoint(x); }
+  inline Info setMemusage(float x) { return descriptor_.setMemusage(x); }
+  inline Info setCompactRatio(float x) {
+    return descriptor_.setCompactRatio(x);
+  }
+  inline Info setDirinfo(bool x) { return descriptor_.setDirinfo(x); }
+  inline Info setStruconly(bool x) { return descriptor_.setStruconly(x); }
+  inline Info setOpreuse(bool x) { return descriptor_.setOpreuse(x); }
+  inline Info setEndbit(bool x) { return descriptor_.setEndbit(x); }
+  inline Info setSort(bool x) { return descriptor_.setSort(x); }
+  inline Info setAtomic(bool x) { return descriptor_.setAtomic(x); }
+  inline Info setEarlyexit(bool x) { return descriptor_.setEarlyexit(x); }
+  inline Info setFusedmask(bool x) { return descriptor_.setFusedmask(x); }
+  inline Info setAutotune(int x) { return descriptor_.setAutotune(x); }
+  inline Info setNiter(int x) { return descriptor_.setNiter(x); }
+  inline Info setMaxNiter(int x) { return descriptor_.setMaxNiter(x); }
+  inline Info setDirected(int x) { return descriptor_.setDirected(x); }
+  inline Info setTiming(int x) { return descriptor_.setTiming(x); }
+  inline Info setTranspose(bool x) { return descriptor_.setTranspose(x); }
+  inline Info setMtxinfo(bool x) { return descriptor_.setMtxinfo(x); }
+  inline Info setVerbose(bool x) { return descriptor_.setVerbose(x); }
+  inline Info setDebug(bool x) { return descriptor_.setDebug(x); }
+  inline Info setTa(int x) { return descriptor_.setTa(x); }
+  inline Info setTb(int x) { return descriptor_.setTb(x); }
+  inline Info setMode(const std::string& x) { return descriptor_.setMode(x); }
+  inline Info setSplit(bool x) { return descriptor_.setSplit(x); }
+  inline Info setNdevice(int x) { return descriptor_.setNdevice(x); }
+  inline Info setMemory(bool memory) { return descriptor_.setMemory(memory); }
+
+  // Temporary vectors reused across calls to algorithms
+  inline VectorPool* pool() { return &pool_; }
+
+  // Operations recorded while GrB_EXECMODE is GrB_NONBLOCKING
+  inline Scheduler* scheduler() { return &scheduler_; }
+  bool nonblocking() const;
+  // Runs operations recorded using this Descriptor
+  Info wait();
+
+  // Current and peak bytes allocated by graphblas per memory space and
+  // category, e.g. getMemory(GrB_MEMORY_DEVICE, GrB_MEMORY_ALL, &stats)
+  Info getMemory(backend::MemorySpace    space,
+                 backend::MemoryCategory category,
+                 backend::MemoryStats*   stats) const;
+
  private:
   // Data members that are same for all backends
   backend::Descriptor descriptor_;
+  VectorPool          pool_;
+  Scheduler           scheduler_;
 };
 
 Info Descriptor::set(Desc_field field, Desc_value value) {
@@ -58,6 +129,23 @@ Info Descriptor::toggle(Desc_field field) {
 Info Descriptor::loadArgs(const po::variables_map& vm) {
   return descriptor_.loadArgs(vm);
 }
+
+bool Descriptor::nonblocking() const {
+  Desc_value execmode = GrB_BLOCKING;
+  descriptor_.get(GrB_EXECMODE, &execmode);
+  return execmode == GrB_NONBLOCKING;
+}
+
+Info Descriptor::wait() {
+  return scheduler_.wait();
+}
+
+Info Descriptor::getMemory(backend::MemorySpace    space,
+                           backend::MemoryCategory category,
+                           backend::MemoryStats*   stats) const {
+  if (stats == NULL) return GrB_NULL_POINTER;
+  return descriptor_.getMemory(space, category, stats);
+}
 }  // namespace graphblas
 
 #endif  // GRAPHBLAS_DESCRIPTOR_HPP_
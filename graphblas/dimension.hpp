@@ -112,6 +112,20 @@ inline Info checkDimSizeSize(const Vector<U>*   u,
   }
   return GrB_SUCCESS;
 }
+
+template <typename U>
+inline Info checkDimSizeNindices(const Vector<U>*   u,
+                                 Index              nindices,
+                                 const std::string& str) {
+  if (u == NULL) return GrB_SUCCESS;
+  Index u_size;
+  CHECK(u->size(&u_size));
+  if (u_size != nindices) {
+    std::cout << str << std::endl;
+    return GrB_DIMENSION_MISMATCH;
+  }
+  return GrB_SUCCESS;
+}
 }  // namespace graphblas
 
 #endif  // GRAPHBLAS_DIMENSION_HPP_
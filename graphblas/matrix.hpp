@@ -2,12 +2,15 @@
 #define GRAPHBLAS_MATRIX_HPP_
 
 #include <vector>
+#include <utility>
 
 // Opaque data members from the right backend
 #define __GRB_BACKEND_MATRIX_HEADER <graphblas/backend/__GRB_BACKEND_ROOT/matrix.hpp>
 #include __GRB_BACKEND_MATRIX_HEADER
 #undef __GRB_BACKEND_MATRIX_HEADER
 
+#include "graphblas/scheduler.hpp"
+
 namespace graphblas {
 
 template <typename T>
@@ -19,11 +22,28 @@ class Matrix {
   Matrix() : matrix_() {}
   Matrix(Index nrows, Index ncols) : matrix_(nrows, ncols) {}
 
-  // Default Destructor is good enough for this layer
-  ~Matrix() {}
+  // Moves are O(1). Copies must go through dup() or operator=
+  Matrix(Matrix&& rhs) : matrix_() {
+    CHECKVOID(Scheduler::flush(&rhs.matrix_));
+    matrix_ = std::move(rhs.matrix_);
+  }
+  Matrix& operator=(Matrix&& rhs) {
+    CHECKVOID(Scheduler::flush(&matrix_));
+    CHECKVOID(Scheduler::flush(&rhs.matrix_));
+    matrix_ = std::move(rhs.matrix_);
+    return *this;
+  }
+
+  // Pending operations writing this object are dropped, and those reading it
+  // are run before it goes away
+  ~Matrix() {
+    Scheduler::release(&matrix_);
+    Scheduler::flush(&matrix_);
+  }
 
   // C API Methods
   Info nnew(Index nrows, Index ncols);
+  // O(1) copy-on-write: rhs's memory is shared until either matrix is written
   Info dup(const Matrix* rhs);
   Info clear();
   Info nrows(Index* nrows_) const;
@@ -48,6 +68,11 @@ class Matrix {
              Index  nvals);
   Info setElement(Index row_index,
                   Index col_index);
+  Info setElement(T     val,
+                  Index row_index,
+                  Index col_index);
+  Info removeElement(Index row_index,
+                     Index col_index);
   Info extractElement(T*    val,
                       Index row_index,
                       Index col_index);
@@ -59,7 +84,7 @@ class Matrix {
                      Index* n);
 
   // Handy methods
-  void operator=(const Matrix& rhs);
+  void operator=(const Matrix& rhs);  // same as dup()
   const T operator[](Index ind);
   Info print(bool force_update = false);
   Info check();
@@ -68,6 +93,26 @@ class Matrix {
   Info resize(Index nrows, Index ncols);
   Info setStorage(Storage  mat_type);
   Info getStorage(Storage* mat_type) const;
+  Info swap(Matrix* rhs);  // O(1)
+
+  // Batched edge insertion (or overwrite) and deletion. Updates are buffered
+  // and merged into the matrix once their number exceeds
+  // desc->compactratio() of nvals. mxv and vxm on GrB_SEQUENTIAL merge them on
+  // the fly, and other operations merge them before they run. For repeated
+  // (row, col) the last update wins
+  Info setElements(const std::vector<Index>* row_indices,
+                   const std::vector<Index>* col_indices,
+                   const std::vector<T>*     values,
+                   Index                     nvals,
+                   Descriptor*               desc);
+  Info removeElements(const std::vector<Index>* row_indices,
+                      const std::vector<Index>* col_indices,
+                      Index                     nvals,
+                      Descriptor*               desc);
+  // Forces buffered updates to be merged now
+  Info compact();
+  // Bytes of host or device memory held by this matrix
+  Info getMemory(backend::MemorySpace space, size_t* bytes) const;
 
   template <typename U>
   Info fill(Index axis,
@@ -85,18 +130,22 @@ class Matrix {
 
 template <typename T>
 Info Matrix<T>::nnew(Index nrows, Index ncols) {
+  CHECK(Scheduler::flush(&matrix_));
   if (nrows == 0 || ncols == 0) return GrB_INVALID_VALUE;
   return matrix_.nnew( nrows, ncols );
 }
 
 template <typename T>
 Info Matrix<T>::dup(const Matrix* rhs) {
+  CHECK(Scheduler::flush(&matrix_));
   if (rhs == NULL) return GrB_NULL_POINTER;
+  CHECK(Scheduler::flush(&rhs->matrix_));
   return matrix_.dup(&rhs->matrix_);
 }
 
 template <typename T>
 Info Matrix<T>::clear() {
+  CHECK(Scheduler::flush(&matrix_));
   return matrix_.clear();
 }
 
@@ -116,6 +165,7 @@ Info Matrix<T>::ncols(Index* ncols) const {
 
 template <typename T>
 Info Matrix<T>::nvals(Index* nvals) const {
+  CHECK(Scheduler::flush(&matrix_));
   if (nvals == NULL) return GrB_NULL_POINTER;
   backend::Matrix<T>* matrix_t = const_cast<backend::Matrix<T>*>(&matrix_);
   return matrix_t->nvals( nvals );
@@ -129,6 +179,7 @@ Info Matrix<T>::build(const std::vector<Index>* row_indices,
                       Index                     nvals,
                       BinaryOpT                 dup,
                       char*                     dat_name) {
+  CHECK(Scheduler::flush(&matrix_));
   if (row_indices == NULL || col_indices == NULL || values == NULL)
     return GrB_NULL_POINTER;
 
@@ -141,6 +192,7 @@ Info Matrix<T>::build(const std::vector<Index>* row_indices,
 
 template <typename T>
 Info Matrix<T>::build(const std::vector<T>* values, Index nvals) {
+  CHECK(Scheduler::flush(&matrix_));
   return matrix_.build(values, nvals);
 }
 
@@ -149,6 +201,7 @@ Info Matrix<T>::build(Index* row_ptr,
                       Index* col_ind,
                       T*     values,
                       Index  nvals) {
+  CHECK(Scheduler::flush(&matrix_));
   if (row_ptr == NULL || col_ind == NULL || values == NULL)
     return GrB_NULL_POINTER;
   if (nvals == 0)
@@ -159,13 +212,30 @@ Info Matrix<T>::build(Index* row_ptr,
 template <typename T>
 Info Matrix<T>::setElement(Index row_index,
                            Index col_index) {
+  CHECK(Scheduler::flush(&matrix_));
   return matrix_.setElement(row_index, col_index);
 }
 
+template <typename T>
+Info Matrix<T>::setElement(T     val,
+                           Index row_index,
+                           Index col_index) {
+  CHECK(Scheduler::flush(&matrix_));
+  return matrix_.setElement(val, row_index, col_index);
+}
+
+template <typename T>
+Info Matrix<T>::removeElement(Index row_index,
+                              Index col_index) {
+  CHECK(Scheduler::flush(&matrix_));
+  return matrix_.removeElement(row_index, col_index);
+}
+
 template <typename T>
 Info Matrix<T>::extractElement(T*    val,
                                Index row_index,
                                Index col_index) {
+  CHECK(Scheduler::flush(&matrix_));
   if (val == NULL) return GrB_NULL_POINTER;
   return matrix_.extractElement(val, row_index, col_index);
 }
@@ -175,6 +245,7 @@ Info Matrix<T>::extractTuples(std::vector<Index>* row_indices,
                               std::vector<Index>* col_indices,
                               std::vector<T>*     values,
                               Index*              n) {
+  CHECK(Scheduler::flush(&matrix_));
   if (row_indices == NULL || col_indices == NULL || values == NULL || n == NULL)
     return GrB_NULL_POINTER;
   return matrix_.extractTuples(row_indices, col_indices, values, n);
@@ -183,6 +254,7 @@ Info Matrix<T>::extractTuples(std::vector<Index>* row_indices,
 template <typename T>
 Info Matrix<T>::extractTuples(std::vector<T>* values,
                               Index*          n) {
+  CHECK(Scheduler::flush(&matrix_));
   if (values == NULL) return GrB_NULL_POINTER;
   return matrix_.extractTuples(values, n);
 }
@@ -190,61 +262,118 @@ Info Matrix<T>::extractTuples(std::vector<T>* values,
 // Handy methods
 template <typename T>
 void Matrix<T>::operator=(const Matrix& rhs) {
+  CHECKVOID(Scheduler::flush(&matrix_));
+  CHECKVOID(Scheduler::flush(&rhs.matrix_));
   matrix_.dup(&rhs.matrix_);
 }
 
 template <typename T>
 const T Matrix<T>::operator[](Index ind) {
+  Scheduler::flush(&matrix_);
   return matrix_[ind];
 }
 
 template <typename T>
 Info Matrix<T>::print(bool force_update) {
+  CHECK(Scheduler::flush(&matrix_));
   return matrix_.print(force_update);
 }
 
 template <typename T>
 Info Matrix<T>::check() {
+  CHECK(Scheduler::flush(&matrix_));
   return matrix_.check();
 }
 
 template <typename T>
 Info Matrix<T>::setNrows(Index nrows) {
+  CHECK(Scheduler::flush(&matrix_));
   return matrix_.setNrows(nrows);
 }
 
 template <typename T>
 Info Matrix<T>::setNcols(Index ncols) {
+  CHECK(Scheduler::flush(&matrix_));
   return matrix_.setNcols(ncols);
 }
 
 template <typename T>
 Info Matrix<T>::resize(Index nrows, Index ncols) {
+  CHECK(Scheduler::flush(&matrix_));
   return matrix_.resize(nrows, ncols);
 }
 
 template <typename T>
 Info Matrix<T>::setStorage(Storage mat_type) {
+  CHECK(Scheduler::flush(&matrix_));
   return matrix_.setStorage(mat_type);
 }
 
 template <typename T>
 Info Matrix<T>::getStorage(Storage* mat_type) const {
+  CHECK(Scheduler::flush(&matrix_));
   if (mat_type == NULL) return GrB_NULL_POINTER;
   return matrix_.getStorage(mat_type);
 }
 
+template <typename T>
+Info Matrix<T>::getMemory(backend::MemorySpace space, size_t* bytes) const {
+  if (bytes == NULL) return GrB_NULL_POINTER;
+  return matrix_.getMemory(space, bytes);
+}
+
+template <typename T>
+Info Matrix<T>::setElements(const std::vector<Index>* row_indices,
+                            const std::vector<Index>* col_indices,
+                            const std::vector<T>*     values,
+                            Index                     nvals,
+                            Descriptor*               desc) {
+  CHECK(Scheduler::flush(&matrix_));
+  if (row_indices == NULL || col_indices == NULL || values == NULL ||
+      desc == NULL)
+    return GrB_NULL_POINTER;
+  return matrix_.setElements(row_indices, col_indices, values, nvals,
+      &desc->descriptor_);
+}
+
+template <typename T>
+Info Matrix<T>::removeElements(const std::vector<Index>* row_indices,
+                               const std::vector<Index>* col_indices,
+                               Index                     nvals,
+                               Descriptor*               desc) {
+  CHECK(Scheduler::flush(&matrix_));
+  if (row_indices == NULL || col_indices == NULL || desc == NULL)
+    return GrB_NULL_POINTER;
+  return matrix_.removeElements(row_indices, col_indices, nvals,
+      &desc->descriptor_);
+}
+
+template <typename T>
+Info Matrix<T>::compact() {
+  CHECK(Scheduler::flush(&matrix_));
+  return matrix_.compact();
+}
+
 template <typename T>
 template <typename U>
 Info Matrix<T>::fill(Index axis, Index nvals, U start) {
+  CHECK(Scheduler::flush(&matrix_));
   return matrix_.fill(axis, nvals, start);
 }
 
 template <typename T>
 template <typename U>
 Info Matrix<T>::fillAscending(Index axis, Index nvals, U start) {
+  CHECK(Scheduler::flush(&matrix_));
   return matrix_.fillAscending(axis, nvals, start);
 }
+
+template <typename T>
+Info Matrix<T>::swap(Matrix* rhs) {  // NOLINT(build/include_what_you_use)
+  if (rhs == NULL) return GrB_NULL_POINTER;
+  CHECK(Scheduler::flush(&rhs->matrix_));
+  return matrix_.swap(&rhs->matrix_);
+}
 }  // namespace graphblas
 
 #endif  // GRAPHBLAS_MATRIX_HPP_
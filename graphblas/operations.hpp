@@ -2,6 +2,11 @@
 #define GRAPHBLAS_OPERATIONS_HPP_
 
 #include <vector>
+#include <string>
+#include <typeinfo>
+#include <initializer_list>
+
+#include "graphblas/scheduler.hpp"
 
 #define __GRB_BACKEND_OPERATIONS_HEADER <graphblas/backend/__GRB_BACKEND_ROOT/operations.hpp>
 #include __GRB_BACKEND_OPERATIONS_HEADER
@@ -11,11 +16,54 @@ namespace graphblas {
 // TODO(@ctcyang): make all operations mxm, mxv, etc. follow vxm() and assign()
 // constant variant
 
+/*!
+ * Runs op right away after pending operations on objects have run. Used when
+ * result is needed right away e.g. reduction to scalar
+ */
+template <typename OperationT>
+Info executeNow(Descriptor*                        desc,
+                const OperationT&                  op,
+                std::initializer_list<const void*> objects) {
+  for (const void* obj : objects)
+    CHECK(Scheduler::flush(obj));
+  return op((desc == NULL) ? NULL : &desc->descriptor_);
+}
+
+/*!
+ * Runs op, or records it in desc's Scheduler if desc is set to non-blocking
+ * mode. op must only use backend objects
+ *   output:    backend object written by op
+ *   overwrite: op does not read previous value of output i.e. there is no
+ *              mask or accum, and output is not also an input
+ *   inputs:    backend objects read by op (NULL for no mask)
+ */
+template <typename OperationT>
+Info execute(Descriptor*                        desc,
+             const OperationT&                  op,
+             const void*                        output,
+             bool                               overwrite,
+             std::initializer_list<const void*> inputs) {
+  if (desc != NULL && desc->nonblocking())
+    return desc->scheduler()->record(op, output, overwrite, inputs);
+
+  // Objects may still be used by operations deferred on another Descriptor
+  CHECK(Scheduler::flush(output));
+  return executeNow(desc, op, inputs);
+}
+
+// Same test for GrB_NULL accum as used by backend
+template <typename BinaryOpT>
+bool useAccum(BinaryOpT accum) {
+  return AccumTraits<BinaryOpT>::enabled;
+}
+
 /*!
  * Matrix-matrix product
  *   C = C + mask .* (A * B)    +: accum
  *                              *: op
  *                             .*: Boolean and
+ * Masked product needs sparse mask without accum or GrB_SCMP, else returns
+ * GrB_INVALID_VALUE
  */
 template <typename c, typename m, typename a, typename b,
           typename BinaryOpT,     typename SemiringT>
@@ -41,11 +89,16 @@ Info mxm(Matrix<c>*       C,
   // Case 3: A *BT
   // Case 4: AT*BT
 
+  backend::Matrix<c>*       C_t    = &C->matrix_;
   const backend::Matrix<m>* mask_t = (mask == NULL) ? NULL : &mask->matrix_;
-  backend::Descriptor* desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
-
-  return backend::mxm<c, a, b, m>(&C->matrix_, mask_t, accum, op, &A->matrix_,
-      &B->matrix_, desc_t);
+  const backend::Matrix<a>* A_t    = &A->matrix_;
+  const backend::Matrix<b>* B_t    = &B->matrix_;
+  bool overwrite = (mask == NULL && !useAccum(accum) &&
+      static_cast<const void*>(C) != A && static_cast<const void*>(C) != B);
+
+  return execute(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::mxm<c, a, b, m>(C_t, mask_t, accum, op, A_t, B_t, desc_t);
+  }, C_t, overwrite, {A_t, B_t, mask_t});
 }
 
 /*!
@@ -68,22 +121,28 @@ Info vxm(Vector<W>*       w,
     return GrB_UNINITIALIZED_OBJECT;
 
   // Dimension check
-  Index u_nvals = 0;
-  CHECK(u->nvals(&u_nvals));
-  if (u_nvals == 0)
-    return GrB_UNINITIALIZED_OBJECT;
-
   // Case 1: u*A
   CHECK(checkDimRowSize(A,  u,    "A.nrows != u.size"));
   CHECK(checkDimColSize(A,  w,    "A.ncols != w.size"));
   CHECK(checkDimSizeSize(w, mask, "w.size  != mask.size"));
 
   // Case 2: u*AT
+  backend::Vector<W>*       w_t    = &w->vector_;
   const backend::Vector<M>* mask_t = (mask == NULL) ? NULL : &mask->vector_;
-  backend::Descriptor*      desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
-
-  return backend::vxm<W, U, a, M>(&w->vector_, mask_t, accum, op, &u->vector_,
-      &A->matrix_, desc_t);
+  const backend::Vector<U>* u_t    = &u->vector_;
+  const backend::Matrix<a>* A_t    = &A->matrix_;
+  bool overwrite = (mask == NULL && !useAccum(accum) &&
+      static_cast<const void*>(w) != u);
+
+  return execute(desc, [=](backend::Descriptor* desc_t) -> Info {
+    // Checked when run, since u may be output of a deferred operation
+    Index u_nvals = 0;
+    CHECK(const_cast<backend::Vector<U>*>(u_t)->nvals(&u_nvals));
+    if (u_nvals == 0)
+      return GrB_UNINITIALIZED_OBJECT;
+    return backend::vxm<W, U, a, M>(w_t, mask_t, accum, op, u_t, A_t,
+        desc_t);
+  }, w_t, overwrite, {u_t, A_t, mask_t});
 }
 
 /*!
@@ -108,22 +167,28 @@ Info mxv(Vector<W>*       w,
     return GrB_UNINITIALIZED_OBJECT;
 
   // Dimension check
-  Index u_nvals = 0;
-  CHECK(u->nvals(&u_nvals));
-  if (u_nvals == 0)
-    return GrB_UNINITIALIZED_OBJECT;
-
   // Case 1: A *u
   CHECK(checkDimColSize(A,  u,    "A.ncols != u.size"));
   CHECK(checkDimRowSize(A,  w,    "A.nrows != w.size"));
   CHECK(checkDimSizeSize(w, mask, "w.size  != mask.size"));
 
   // Case 2: AT*u
+  backend::Vector<W>*       w_t    = &w->vector_;
   const backend::Vector<M>* mask_t = (mask == NULL) ? NULL : &mask->vector_;
-  backend::Descriptor*      desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
-
-  return backend::mxv<W, U, a, M>(&w->vector_, mask_t, accum, op, &A->matrix_,
-      &u->vector_, desc_t);
+  const backend::Matrix<a>* A_t    = &A->matrix_;
+  const backend::Vector<U>* u_t    = &u->vector_;
+  bool overwrite = (mask == NULL && !useAccum(accum) &&
+      static_cast<const void*>(w) != u);
+
+  return execute(desc, [=](backend::Descriptor* desc_t) -> Info {
+    // Checked when run, since u may be output of a deferred operation
+    Index u_nvals = 0;
+    CHECK(const_cast<backend::Vector<U>*>(u_t)->nvals(&u_nvals));
+    if (u_nvals == 0)
+      return GrB_UNINITIALIZED_OBJECT;
+    return backend::mxv<W, U, a, M>(w_t, mask_t, accum, op, A_t, u_t,
+        desc_t);
+  }, w_t, overwrite, {A_t, u_t, mask_t});
 }
 
 /*!
@@ -150,11 +215,16 @@ Info eWiseMult(Vector<W>*       w,
   CHECK(checkDimSizeSize(u, w,    "u.size != mask.size"));
   CHECK(checkDimSizeSize(u, mask, "v.size != mask.size"));
 
+  backend::Vector<W>*       w_t    = &w->vector_;
   const backend::Vector<M>* mask_t = (mask == NULL) ? NULL : &mask->vector_;
-  backend::Descriptor*      desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
-
-  return backend::eWiseMult(&w->vector_, mask_t, accum, op, &u->vector_,
-      &v->vector_, desc_t);
+  const backend::Vector<U>* u_t    = &u->vector_;
+  const backend::Vector<V>* v_t    = &v->vector_;
+  bool overwrite = (mask == NULL && !useAccum(accum) &&
+      static_cast<const void*>(w) != u && static_cast<const void*>(w) != v);
+
+  return execute(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::eWiseMult(w_t, mask_t, accum, op, u_t, v_t, desc_t);
+  }, w_t, overwrite, {u_t, v_t, mask_t});
 }
 
 /*!
@@ -184,11 +254,16 @@ Info eWiseMult(Matrix<c>*       C,
   CHECK(checkDimRowRow(C, mask, "C.nrows != mask.nrows"));
   CHECK(checkDimColCol(C, mask, "C.ncols != mask.ncols"));
 
+  backend::Matrix<c>*       C_t    = &C->matrix_;
   const backend::Matrix<m>* mask_t = (mask == NULL) ? NULL : &mask->matrix_;
-  backend::Descriptor*      desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
-
-  return backend::eWiseMult(&C->matrix_, mask_t, accum, op, &A->matrix_,
-      &B->matrix_, desc_t);
+  const backend::Matrix<a>* A_t    = &A->matrix_;
+  const backend::Matrix<b>* B_t    = &B->matrix_;
+  bool overwrite = (mask == NULL && !useAccum(accum) &&
+      static_cast<const void*>(C) != A && static_cast<const void*>(C) != B);
+
+  return execute(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::eWiseMult(C_t, mask_t, accum, op, A_t, B_t, desc_t);
+  }, C_t, overwrite, {A_t, B_t, mask_t});
 }
 
 /*!
@@ -220,11 +295,15 @@ Info eWiseMult(Matrix<c>*       C,
   CHECK(checkDimRowRow(A, mask, "A.nrows != mask.nrows"));
   CHECK(checkDimColCol(A, mask, "A.ncols != mask.ncols"));
 
+  backend::Matrix<c>*       C_t    = &C->matrix_;
   const backend::Matrix<m>* mask_t = (mask == NULL) ? NULL : &mask->matrix_;
-  backend::Descriptor*      desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
+  const backend::Matrix<a>* A_t    = &A->matrix_;
+  bool overwrite = (mask == NULL && !useAccum(accum) &&
+      static_cast<const void*>(C) != A);
 
-  return backend::eWiseMult(&C->matrix_, mask_t, accum, op, &A->matrix_,
-      val, desc_t);
+  return execute(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::eWiseMult(C_t, mask_t, accum, op, A_t, val, desc_t);
+  }, C_t, overwrite, {A_t, mask_t});
 }
 
 /*!
@@ -259,11 +338,16 @@ Info eWiseMult(Matrix<c>*       C,
   CHECK(checkDimRowRow( A, mask, "A.nrows != mask.nrows"));
   CHECK(checkDimColCol( A, mask, "A.ncols != mask.ncols"));
 
+  backend::Matrix<c>*       C_t    = &C->matrix_;
   const backend::Matrix<m>* mask_t = (mask == NULL) ? NULL : &mask->matrix_;
-  backend::Descriptor*      desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
-
-  return backend::eWiseMult(&C->matrix_, mask_t, accum, op, &A->matrix_,
-      &B->vector_, desc_t);
+  const backend::Matrix<a>* A_t    = &A->matrix_;
+  const backend::Vector<b>* B_t    = &B->vector_;
+  bool overwrite = (mask == NULL && !useAccum(accum) &&
+      static_cast<const void*>(C) != A);
+
+  return execute(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::eWiseMult(C_t, mask_t, accum, op, A_t, B_t, desc_t);
+  }, C_t, overwrite, {A_t, B_t, mask_t});
 }
 
 /*!
@@ -291,11 +375,16 @@ Info eWiseAdd(Vector<W>*       w,
   CHECK(checkDimSizeSize(v, mask, "v.size != mask.size"));
   CHECK(checkDimSizeSize(w, mask, "w.size != mask.size"));
 
+  backend::Vector<W>*       w_t    = &w->vector_;
   const backend::Vector<M>* mask_t = (mask == NULL) ? NULL : &mask->vector_;
-  backend::Descriptor*      desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
-
-  return backend::eWiseAdd(&w->vector_, mask_t, accum, op, &u->vector_,
-      &v->vector_, desc_t);
+  const backend::Vector<U>* u_t    = &u->vector_;
+  const backend::Vector<V>* v_t    = &v->vector_;
+  bool overwrite = (mask == NULL && !useAccum(accum) &&
+      static_cast<const void*>(w) != u && static_cast<const void*>(w) != v);
+
+  return execute(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::eWiseAdd(w_t, mask_t, accum, op, u_t, v_t, desc_t);
+  }, w_t, overwrite, {u_t, v_t, mask_t});
 }
 
 /*!
@@ -344,11 +433,15 @@ Info eWiseAdd(Vector<W>*       w,
   CHECK(checkDimSizeSize(u, w,    "u.size != mask.size"));
   CHECK(checkDimSizeSize(u, mask, "v.size != mask.size"));
 
+  backend::Vector<W>*       w_t    = &w->vector_;
   const backend::Vector<M>* mask_t = (mask == NULL) ? NULL : &mask->vector_;
-  backend::Descriptor*      desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
+  const backend::Vector<U>* u_t    = &u->vector_;
+  bool overwrite = (mask == NULL && !useAccum(accum) &&
+      static_cast<const void*>(w) != u);
 
-  return backend::eWiseAdd(&w->vector_, mask_t, accum, op, &u->vector_,
-      val, desc_t);
+  return execute(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::eWiseAdd(w_t, mask_t, accum, op, u_t, val, desc_t);
+  }, w_t, overwrite, {u_t, mask_t});
 }
 
 /*!
@@ -365,7 +458,31 @@ Info extract(Vector<W>*                w,
              const std::vector<Index>* indices,
              Index                     nindices,
              Descriptor*               desc) {
-  std::cout << "Error: extract vector variant not implemented yet!\n";
+  // Null pointer check
+  if (w == NULL || u == NULL || desc == NULL)
+    return GrB_UNINITIALIZED_OBJECT;
+  if (static_cast<const void*>(w) == u)
+    return GrB_INVALID_OBJECT;
+
+  // Dimension check
+  CHECK(checkDimSizeNindices(w, nindices, "w.size != nindices"));
+  CHECK(checkDimSizeSize(w, mask, "w.size != mask.size"));
+  if (indices == NULL)
+    CHECK(checkDimSizeNindices(u, nindices, "u.size != nindices"));
+
+  backend::Vector<W>*       w_t    = &w->vector_;
+  const backend::Vector<M>* mask_t = (mask == NULL) ? NULL : &mask->vector_;
+  const backend::Vector<U>* u_t    = &u->vector_;
+  auto                      op_t   = [=](backend::Descriptor* desc_t) -> Info {
+    return backend::extract(w_t, mask_t, accum, u_t, indices, nindices,
+        desc_t);
+  };
+
+  // Caller may change indices after we return, so only GrB_ALL is deferred
+  if (indices != NULL)
+    return executeNow(desc, op_t, {w_t, mask_t, u_t});
+  bool overwrite = (mask == NULL && !useAccum(accum));
+  return execute(desc, op_t, w_t, overwrite, {u_t, mask_t});
 }
 
 /*!
@@ -413,13 +530,37 @@ Info extract(Vector<W>*                w,
 template <typename W, typename M, typename U,
           typename BinaryOpT>
 Info assign(Vector<W>*                w,
-            const Vector<U>*          mask,
+            const Vector<M>*          mask,
             BinaryOpT                 accum,
             const Vector<U>*          u,
             const std::vector<Index>* indices,
             Index                     nindices,
             Descriptor*               desc) {
-  std::cout << "Error: assign vector variant not implemented yet!\n";
+  // Null pointer check
+  if (w == NULL || u == NULL || desc == NULL)
+    return GrB_UNINITIALIZED_OBJECT;
+  if (static_cast<const void*>(w) == u)
+    return GrB_INVALID_OBJECT;
+
+  // Dimension check
+  CHECK(checkDimSizeNindices(u, nindices, "u.size != nindices"));
+  CHECK(checkDimSizeSize(w, mask, "w.size != mask.size"));
+  if (indices == NULL)
+    CHECK(checkDimSizeNindices(w, nindices, "w.size != nindices"));
+
+  backend::Vector<W>*       w_t    = &w->vector_;
+  const backend::Vector<M>* mask_t = (mask == NULL) ? NULL : &mask->vector_;
+  const backend::Vector<U>* u_t    = &u->vector_;
+  auto                      op_t   = [=](backend::Descriptor* desc_t) -> Info {
+    return backend::assign(w_t, mask_t, accum, u_t, indices, nindices,
+        desc_t);
+  };
+
+  // Caller may change indices after we return, so only GrB_ALL is deferred.
+  // Elements not in indices keep their value, so w is never overwritten
+  if (indices != NULL)
+    return executeNow(desc, op_t, {w_t, mask_t, u_t});
+  return execute(desc, op_t, w_t, false, {u_t, mask_t});
 }
 
 /*!
@@ -502,11 +643,18 @@ Info assign(Vector<W>*                w,
   // -only have one case (no transpose option)
   CHECK(checkDimSizeSize(w, mask, "w.size  != mask.size"));
 
-  auto                 mask_t = (mask == NULL) ? NULL : &mask->vector_;
-  backend::Descriptor* desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
-
-  return backend::assign(&w->vector_, mask_t, accum, val, indices, nindices,
-      desc_t);
+  backend::Vector<W>* w_t    = &w->vector_;
+  auto                mask_t = (mask == NULL) ? NULL : &mask->vector_;
+  auto                op_t   = [=](backend::Descriptor* desc_t) -> Info {
+    return backend::assign(w_t, mask_t, accum, val, indices, nindices,
+        desc_t);
+  };
+
+  // Caller may change indices after we return, so only GrB_ALL is deferred.
+  // Elements not in indices keep their value, so w is never overwritten
+  if (indices != NULL)
+    return executeNow(desc, op_t, {w_t, mask_t});
+  return execute(desc, op_t, w_t, false, {mask_t});
 }
 
 /*!
@@ -551,10 +699,15 @@ Info apply(Vector<W>*       w,
   CHECK(checkDimSizeSize(u, mask, "u.size != mask.size"));
   CHECK(checkDimSizeSize(w, mask, "w.size != mask.size"));
 
+  backend::Vector<W>*       w_t    = &w->vector_;
   const backend::Vector<M>* mask_t = (mask == NULL) ? NULL : &mask->vector_;
-  backend::Descriptor*      desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
+  const backend::Vector<U>* u_t    = &u->vector_;
+  bool overwrite = (mask == NULL && !useAccum(accum) &&
+      static_cast<const void*>(w) != u);
 
-  return backend::apply(&w->vector_, mask_t, accum, op, &u->vector_, desc_t);
+  return execute(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::apply(w_t, mask_t, accum, op, u_t, desc_t);
+  }, w_t, overwrite, {u_t, mask_t});
 }
 
 /*!
@@ -582,10 +735,53 @@ Info apply(Matrix<c>*       C,
   CHECK(checkDimRowRow(C, mask, "C.nrows != mask.nrows"));
   CHECK(checkDimColCol(C, mask, "C.ncols != mask.ncols"));
 
+  backend::Matrix<c>*       C_t    = &C->matrix_;
   const backend::Matrix<m>* mask_t = (mask == NULL) ? NULL : &mask->matrix_;
-  backend::Descriptor*      desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
+  const backend::Matrix<a>* A_t    = &A->matrix_;
+  bool overwrite = (mask == NULL && !useAccum(accum) &&
+      static_cast<const void*>(C) != A);
 
-  return backend::apply(&C->matrix_, mask_t, accum, op, &A->matrix_, desc_t);
+  return execute(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::apply(C_t, mask_t, accum, op, A_t, desc_t);
+  }, C_t, overwrite, {A_t, mask_t});
+}
+
+/*!
+ * Select entries of matrix that pass op against thunk
+ *   C = C + mask .* A(op(A, thunk))    +: accum
+ *                                     .*: Boolean and
+ * where op is binary predicate of stddef.hpp e.g. less_equal<a>() keeps
+ * A(i,j) <= thunk. Other entries are left out of C, which may be A. Mask
+ * and accum are not supported yet and return GrB_INVALID_VALUE
+ */
+template <typename c, typename m, typename a,
+          typename BinaryOpT,     typename SelectOpT, typename T>
+Info select(Matrix<c>*       C,
+            const Matrix<m>* mask,
+            BinaryOpT        accum,
+            SelectOpT        op,
+            const Matrix<a>* A,
+            T                thunk,
+            Descriptor*      desc) {
+  // Null pointer check
+  if (A == NULL || C == NULL || desc == NULL)
+    return GrB_UNINITIALIZED_OBJECT;
+
+  // Dimension check
+  CHECK(checkDimRowRow(A, C,    "A.nrows != C.nrows"));
+  CHECK(checkDimColCol(A, C,    "A.ncols != C.ncols"));
+  CHECK(checkDimRowRow(A, mask, "A.nrows != mask.nrows"));
+  CHECK(checkDimColCol(A, mask, "A.ncols != mask.ncols"));
+
+  backend::Matrix<c>*       C_t    = &C->matrix_;
+  const backend::Matrix<m>* mask_t = (mask == NULL) ? NULL : &mask->matrix_;
+  const backend::Matrix<a>* A_t    = &A->matrix_;
+  bool overwrite = (mask == NULL && !useAccum(accum) &&
+      static_cast<const void*>(C) != A);
+
+  return execute(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::select(C_t, mask_t, accum, op, A_t, thunk, desc_t);
+  }, C_t, overwrite, {A_t, mask_t});
 }
 
 /*!
@@ -605,10 +801,14 @@ Info reduce(Vector<W>*       w,
   if (w == NULL || A == NULL)
     return GrB_UNINITIALIZED_OBJECT;
 
+  backend::Vector<W>*       w_t    = &w->vector_;
   const backend::Vector<M>* mask_t = (mask == NULL) ? NULL : &mask->vector_;
-  backend::Descriptor*      desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
+  const backend::Matrix<a>* A_t    = &A->matrix_;
+  bool overwrite = (mask == NULL && !useAccum(accum));
 
-  return backend::reduce(&w->vector_, mask_t, accum, op, &A->matrix_, desc_t);
+  return execute(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::reduce(w_t, mask_t, accum, op, A_t, desc_t);
+  }, w_t, overwrite, {A_t, mask_t});
 }
 
 /*!
@@ -626,9 +826,11 @@ Info reduce(T*               val,
   if (val == NULL || u == NULL)
     return GrB_UNINITIALIZED_OBJECT;
 
-  backend::Descriptor* desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
-
-  return backend::reduce(val, accum, op, &u->vector_, desc_t);
+  // Scalar is read by caller as soon as we return, so it cannot be deferred
+  const backend::Vector<U>* u_t = &u->vector_;
+  return executeNow(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::reduce(val, accum, op, u_t, desc_t);
+  }, {u_t});
 }
 
 /*!
@@ -646,9 +848,411 @@ Info reduce(T*               val,
   if (val == NULL || A == NULL)
     return GrB_UNINITIALIZED_OBJECT;
 
-  backend::Descriptor* desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
+  // Scalar is read by caller as soon as we return, so it cannot be deferred
+  const backend::Matrix<a>* A_t = &A->matrix_;
+  return executeNow(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::reduce(val, accum, op, A_t, desc_t);
+  }, {A_t});
+}
+
+/*!
+ * Extension Method
+ * Fused element-wise multiply of two vectors and reduction to scalar, in one
+ * pass without a temporary vector e.g. dot product
+ *   val = val + \sum_i u(i) * v(i)    +: accum
+ *                                   sum: op (semiring add)
+ *                                     *: op (semiring multiply)
+ */
+template <typename T, typename U, typename V,
+          typename BinaryOpT, typename SemiringT>
+Info eWiseMultReduce(T*               val,
+                     BinaryOpT        accum,
+                     SemiringT        op,
+                     const Vector<U>* u,
+                     const Vector<V>* v,
+                     Descriptor*      desc) {
+  if (val == NULL || u == NULL || v == NULL)
+    return GrB_UNINITIALIZED_OBJECT;
+
+  // Dimension check
+  CHECK(checkDimSizeSize(u, v, "u.size != v.size"));
+
+  // Scalar is read by caller as soon as we return, so it cannot be deferred
+  const backend::Vector<U>* u_t = &u->vector_;
+  const backend::Vector<V>* v_t = &v->vector_;
+  return executeNow(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::eWiseMultReduce(val, accum, op, u_t, v_t, desc_t);
+  }, {u_t, v_t});
+}
+
+/*!
+ * Extension Method
+ * Fused element-wise addition of two vectors and reduction to scalar, in one
+ * pass without a temporary vector
+ *   val = val + \sum_i (u(i) .+ v(i))    +: accum
+ *                                      sum: monoid
+ *                                       .+: op (semiring add)
+ */
+template <typename T, typename U, typename V,
+          typename BinaryOpT, typename MonoidT, typename SemiringT>
+Info eWiseAddReduce(T*               val,
+                    BinaryOpT        accum,
+                    MonoidT          monoid,
+                    SemiringT        op,
+                    const Vector<U>* u,
+                    const Vector<V>* v,
+                    Descriptor*      desc) {
+  if (val == NULL || u == NULL || v == NULL)
+    return GrB_UNINITIALIZED_OBJECT;
+
+  // Dimension check
+  CHECK(checkDimSizeSize(u, v, "u.size != v.size"));
+
+  // Scalar is read by caller as soon as we return, so it cannot be deferred
+  const backend::Vector<U>* u_t = &u->vector_;
+  const backend::Vector<V>* v_t = &v->vector_;
+  return executeNow(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::eWiseAddReduce(val, accum, monoid, op, u_t, v_t, desc_t);
+  }, {u_t, v_t});
+}
+
+/*!
+ * Extension Method
+ * Gather from vector at indices held by another vector, which stay on device
+ * on GPU backend and so may be computed by earlier operations
+ *   w = w + mask .* (u[indices])   +: accum
+ *                                 .*: Boolean and
+ * w must not alias u or indices. Masked variant returns GrB_INVALID_VALUE
+ */
+template <typename W, typename M, typename U,
+          typename BinaryOpT>
+Info extract(Vector<W>*           w,
+             const Vector<M>*     mask,
+             BinaryOpT            accum,
+             const Vector<U>*     u,
+             const Vector<Index>* indices,
+             Descriptor*          desc) {
+  // Null pointer check
+  if (w == NULL || u == NULL || indices == NULL || desc == NULL)
+    return GrB_UNINITIALIZED_OBJECT;
+  if (static_cast<const void*>(w) == u ||
+      static_cast<const void*>(w) == indices)
+    return GrB_INVALID_OBJECT;
+
+  // Dimension check
+  CHECK(checkDimSizeSize(w, indices, "w.size != indices.size"));
+  CHECK(checkDimSizeSize(w, mask,    "w.size != mask.size"));
+
+  backend::Vector<W>*           w_t    = &w->vector_;
+  const backend::Vector<M>*     mask_t = (mask == NULL) ? NULL :
+      &mask->vector_;
+  const backend::Vector<U>*     u_t    = &u->vector_;
+  const backend::Vector<Index>* ind_t  = &indices->vector_;
+  bool overwrite = (mask == NULL && !useAccum(accum));
+
+  return execute(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::extract(w_t, mask_t, accum, u_t, ind_t, desc_t);
+  }, w_t, overwrite, {u_t, ind_t, mask_t});
+}
+
+/*!
+ * Extension Method
+ * Scatter into vector at indices held by another vector, which stay on device
+ * on GPU backend and so may be computed by earlier operations. Repeated
+ * indices are all combined by accum, and without accum any one of them wins
+ *   w[indices] = w[indices] + mask .* u   +: accum
+ *                                        .*: Boolean and
+ * w must not alias u or indices. Masked variant returns GrB_INVALID_VALUE
+ */
+template <typename W, typename M, typename U,
+          typename BinaryOpT>
+Info assign(Vector<W>*           w,
+            const Vector<M>*     mask,
+            BinaryOpT            accum,
+            const Vector<U>*     u,
+            const Vector<Index>* indices,
+            Descriptor*          desc) {
+  // Null pointer check
+  if (w == NULL || u == NULL || indices == NULL || desc == NULL)
+    return GrB_UNINITIALIZED_OBJECT;
+  if (static_cast<const void*>(w) == u ||
+      static_cast<const void*>(w) == indices)
+    return GrB_INVALID_OBJECT;
+
+  // Dimension check
+  CHECK(checkDimSizeSize(u, indices, "u.size != indices.size"));
+  CHECK(checkDimSizeSize(w, mask,    "w.size != mask.size"));
+
+  backend::Vector<W>*           w_t    = &w->vector_;
+  const backend::Vector<M>*     mask_t = (mask == NULL) ? NULL :
+      &mask->vector_;
+  const backend::Vector<U>*     u_t    = &u->vector_;
+  const backend::Vector<Index>* ind_t  = &indices->vector_;
+
+  // Elements not in indices keep their value, so w is never overwritten
+  return execute(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::assign(w_t, mask_t, accum, u_t, ind_t, desc_t);
+  }, w_t, false, {u_t, ind_t, mask_t});
+}
+
+/*!
+ * Extension Method
+ * Fused BFS level step: expands frontier u to vertices not yet visited in v,
+ * marks them visited and counts them. Same as masked vxm, assign and reduce,
+ * but in one pass on GrB_SEQUENTIAL backend
+ *   w       = !v .* (u ||.&& A)    !v: complement of v i.e. v(i) == 0
+ *   v(w)    = depth
+ *   w_nvals = nnz(w)
+ * Push or pull is chosen using GrB_MXVMODE and switchpoint, same as vxm
+ */
+template <typename W, typename T, typename U, typename a>
+Info traverse(Vector<W>*       w,
+              Vector<T>*       v,
+              Index*           w_nvals,
+              T                depth,
+              const Vector<U>* u,
+              const Matrix<a>* A,
+              Descriptor*      desc) {
+  // Null pointer check
+  if (w == NULL || v == NULL || w_nvals == NULL || u == NULL || A == NULL ||
+      desc == NULL)
+    return GrB_UNINITIALIZED_OBJECT;
+  if (static_cast<const void*>(w) == u)
+    return GrB_INVALID_OBJECT;
+
+  // Dimension check
+  CHECK(checkDimRowSize(A,  u, "A.nrows != u.size"));
+  CHECK(checkDimColSize(A,  w, "A.ncols != w.size"));
+  CHECK(checkDimSizeSize(w, v, "w.size  != v.size"));
+
+  // Count is read by caller as soon as we return, so it cannot be deferred
+  backend::Vector<W>*       w_t = &w->vector_;
+  backend::Vector<T>*       v_t = &v->vector_;
+  const backend::Vector<U>* u_t = &u->vector_;
+  const backend::Matrix<a>* A_t = &A->matrix_;
+  return executeNow(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::traverse(w_t, v_t, w_nvals, depth, u_t, A_t, desc_t);
+  }, {w_t, v_t, u_t, A_t});
+}
+
+/*!
+ * Extension Method
+ * Fused BFS level step that records BFS tree: same as traverse, except that
+ * each vertex j reached from frontier u gets its parent in p
+ *   w       = !p .* (u min.first A)    !p: p(j) == -1 i.e. j not visited
+ *   p(w)    = w
+ *   w_nvals = nnz(w)
+ * where min.first carries id i of frontier vertex along A(i,j), keeping the
+ * smallest. Pull stops at first in-edge from frontier, which is same parent
+ * since in-edges are in order, so tree does not depend on direction. Unlike
+ * traverse, there is no device path: GrB_CUDA runs the same host step and
+ * copies w and p back to device
+ */
+template <typename W, typename U, typename a>
+Info traverseParent(Vector<W>*       w,
+                    Vector<Index>*   p,
+                    Index*           w_nvals,
+                    const Vector<U>* u,
+                    const Matrix<a>* A,
+                    Descriptor*      desc) {
+  // Null pointer check
+  if (w == NULL || p == NULL || w_nvals == NULL || u == NULL || A == NULL ||
+      desc == NULL)
+    return GrB_UNINITIALIZED_OBJECT;
+  if (static_cast<const void*>(w) == u)
+    return GrB_INVALID_OBJECT;
 
-  return backend::reduce(val, accum, op, &A->matrix_, desc_t);
+  // Dimension check
+  CHECK(checkDimRowSize(A,  u, "A.nrows != u.size"));
+  CHECK(checkDimColSize(A,  w, "A.ncols != w.size"));
+  CHECK(checkDimSizeSize(w, p, "w.size  != p.size"));
+
+  // Count is read by caller as soon as we return, so it cannot be deferred
+  backend::Vector<W>*       w_t = &w->vector_;
+  backend::Vector<Index>*   p_t = &p->vector_;
+  const backend::Vector<U>* u_t = &u->vector_;
+  const backend::Matrix<a>* A_t = &A->matrix_;
+  return executeNow(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::traverseParent(w_t, p_t, w_nvals, u_t, A_t, desc_t);
+  }, {w_t, p_t, u_t, A_t});
+}
+
+/*!
+ * Extension Method
+ * Multi-source BFS: BFS from every one of sources[0, nsources), run 64 at a
+ * time as bit-parallel traversals (MS-BFS) that share each pass over A
+ *   depths[i*A.nrows + j] = depth of j from sources[i], with sources[i] at 1
+ *                           and unreached vertices at 0, same as bfs()
+ *   ecc[i]                = eccentricity of sources[i] within what it reaches
+ * depths needs nsources*A.nrows elements, and may be NULL if only ecc is
+ * needed. Traversal is along A, or A^T if GrB_INP1 is GrB_TRAN. Bit-parallel
+ * traversal only has a host implementation, which runs on threadPool for
+ * every GrB_BACKEND, GrB_CUDA included
+ */
+template <typename T, typename a>
+Info msbfs(T*               depths,
+           Index*           ecc,
+           const Index*     sources,
+           Index            nsources,
+           const Matrix<a>* A,
+           Descriptor*      desc) {
+  // Null pointer check
+  if (ecc == NULL || (sources == NULL && nsources > 0) || A == NULL ||
+      desc == NULL)
+    return GrB_UNINITIALIZED_OBJECT;
+
+  // Dimension and index check
+  CHECK(checkDimRowCol(A, A, "A.nrows != A.ncols"));
+  Index A_nrows;
+  CHECK(A->nrows(&A_nrows));
+  for (Index i = 0; i < nsources; ++i)
+    if (sources[i] < 0 || sources[i] >= A_nrows)
+      return GrB_INVALID_INDEX;
+
+  // Outputs are read by caller as soon as we return, so it cannot be deferred
+  const backend::Matrix<a>* A_t = &A->matrix_;
+  return executeNow(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::msbfs(depths, ecc, sources, nsources, A_t, desc_t);
+  }, {A_t});
+}
+
+/*!
+ * Extension Method
+ * Batched personalized PageRank: for every seed s of seeds[0, nseeds)
+ *   p_s = p_s A + (1-alpha) e_s    until ||p_s - p_s_prev||_2 <= eps
+ * Same update as pr() (A already scaled), but restarting at s only. Up to 32
+ * seeds are iterated together as a dense block so that each pass over A
+ * serves all of them, and a converged seed gives its column to the next one
+ *   P(:, i)             = p_(seeds[i])                  (A.nrows x nseeds)
+ *   topk_ind[i*topk+j]  = vertex with j-th largest entry of p_(seeds[i])
+ *   topk_val[i*topk+j]  = its value
+ * P, topk_ind and topk_val may be NULL if not needed. Iteration runs on host
+ * for every GrB_BACKEND, and with GrB_CUDA only P is copied to device after
+ */
+template <typename T, typename a>
+Info pprBatch(Matrix<T>*       P,
+              Index*           topk_ind,
+              T*               topk_val,
+              Index            topk,
+              const Index*     seeds,
+              Index            nseeds,
+              T                alpha,
+              T                eps,
+              const Matrix<a>* A,
+              Descriptor*      desc) {
+  // Null pointer check
+  if ((seeds == NULL && nseeds > 0) || A == NULL || desc == NULL)
+    return GrB_UNINITIALIZED_OBJECT;
+
+  // Dimension and index check
+  CHECK(checkDimRowCol(A, A, "A.nrows != A.ncols"));
+  CHECK(checkDimRowRow(A, P, "A.nrows != P.nrows"));
+  Index A_nrows;
+  CHECK(A->nrows(&A_nrows));
+  if (P != NULL) {
+    Index P_ncols;
+    CHECK(P->ncols(&P_ncols));
+    if (P_ncols != nseeds) {
+      std::cout << "P.ncols != nseeds" << std::endl;
+      return GrB_DIMENSION_MISMATCH;
+    }
+  }
+  if (topk < 0 || topk > A_nrows || (topk_val != NULL && topk_ind == NULL))
+    return GrB_INVALID_VALUE;
+  for (Index i = 0; i < nseeds; ++i)
+    if (seeds[i] < 0 || seeds[i] >= A_nrows)
+      return GrB_INVALID_INDEX;
+
+  // Outputs are read by caller as soon as we return, so it cannot be deferred
+  backend::Matrix<T>*       P_t = (P == NULL) ? NULL : &P->matrix_;
+  const backend::Matrix<a>* A_t = &A->matrix_;
+  return executeNow(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::pprBatch(P_t, topk_ind, topk_val, topk, seeds, nseeds,
+        alpha, eps, A_t, desc_t);
+  }, {P_t, A_t});
+}
+
+/*!
+ * Extension Method
+ * Betweenness centrality from sources[0, nsources) by Brandes' algorithm
+ *   bc[v] = \sum_s \sum_t sigma_st(v) / sigma_st     (s != v != t)
+ * where sigma_st counts shortest paths from s to t, and sigma_st(v) those of
+ * them through v. Up to 64 sources share each pass over A, fewer when free
+ * memory is short. bc needs A.nrows elements. Paths go along A, or A^T if
+ * GrB_INP1 is GrB_TRAN, so undirected A counts each pair both ways. bc is a
+ * host array, and is computed on host whatever GrB_BACKEND says
+ */
+template <typename T, typename a>
+Info bcBatch(T*               bc,
+             const Index*     sources,
+             Index            nsources,
+             const Matrix<a>* A,
+             Descriptor*      desc) {
+  // Null pointer check
+  if (bc == NULL || (sources == NULL && nsources > 0) || A == NULL ||
+      desc == NULL)
+    return GrB_UNINITIALIZED_OBJECT;
+
+  // Dimension and index check
+  CHECK(checkDimRowCol(A, A, "A.nrows != A.ncols"));
+  Index A_nrows;
+  CHECK(A->nrows(&A_nrows));
+  for (Index i = 0; i < nsources; ++i)
+    if (sources[i] < 0 || sources[i] >= A_nrows)
+      return GrB_INVALID_INDEX;
+
+  // Output is read by caller as soon as we return, so it cannot be deferred
+  const backend::Matrix<a>* A_t = &A->matrix_;
+  return executeNow(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::bcBatch(bc, sources, nsources, A_t, desc_t);
+  }, {A_t});
+}
+
+/*!
+ * Extension Method
+ * Residual update of push PageRank, after t = f A has pushed residual f of
+ * active vertices along their out-edges. Only entries of f and t are touched
+ * while they are sparse
+ *   p(f)    = p(f) + f
+ *   r(f)    = 0
+ *   r       = r + t
+ *   f       = r .* (t != 0) .* (r > thr)
+ *   f_nvals = nnz(f)
+ * f comes out sparse, so next vxm pushes while it is below switchpoint. f with
+ * no storage yet (e.g. after clear()) counts as empty. Update is done on host
+ * for every GrB_BACKEND, and p, r and f are copied back to device after it
+ */
+template <typename T>
+Info residualUpdate(Vector<T>*       p,
+                    Vector<T>*       r,
+                    Vector<T>*       f,
+                    Index*           f_nvals,
+                    const Vector<T>* t,
+                    const Vector<T>* thr,
+                    Descriptor*      desc) {
+  // Null pointer check
+  if (p == NULL || r == NULL || f == NULL || f_nvals == NULL || t == NULL ||
+      thr == NULL || desc == NULL)
+    return GrB_UNINITIALIZED_OBJECT;
+  if (p == r || p == f || r == f || t == p || t == r || t == f ||
+      thr == p || thr == r || thr == f)
+    return GrB_INVALID_OBJECT;
+
+  // Dimension check
+  CHECK(checkDimSizeSize(p, r,   "p.size  != r.size"));
+  CHECK(checkDimSizeSize(p, f,   "p.size  != f.size"));
+  CHECK(checkDimSizeSize(p, t,   "p.size  != t.size"));
+  CHECK(checkDimSizeSize(p, thr, "p.size  != thr.size"));
+
+  // Count is read by caller as soon as we return, so it cannot be deferred
+  backend::Vector<T>*       p_t   = &p->vector_;
+  backend::Vector<T>*       r_t   = &r->vector_;
+  backend::Vector<T>*       f_t   = &f->vector_;
+  const backend::Vector<T>* t_t   = &t->vector_;
+  const backend::Vector<T>* thr_t = &thr->vector_;
+  return executeNow(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::residualUpdate(p_t, r_t, f_t, f_nvals, t_t, thr_t, desc_t);
+  }, {p_t, r_t, f_t, t_t, thr_t});
 }
 
 /*!
@@ -682,9 +1286,12 @@ Info traceMxmTranspose(T*               val,
   if (val == NULL || A == NULL || B == NULL)
     return GrB_UNINITIALIZED_OBJECT;
 
-  backend::Descriptor* desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
-
-  return backend::traceMxmTranspose(val, op, &A->matrix_, &B->matrix_, desc_t);
+  // Scalar is read by caller as soon as we return, so it cannot be deferred
+  const backend::Matrix<a>* A_t = &A->matrix_;
+  const backend::Matrix<b>* B_t = &B->matrix_;
+  return executeNow(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::traceMxmTranspose(val, op, A_t, B_t, desc_t);
+  }, {A_t, B_t});
 }
 
 /*!
@@ -728,10 +1335,13 @@ Info scatter(Vector<W>*       w,
   if (u == NULL || w == NULL)
     return GrB_UNINITIALIZED_OBJECT;
 
+  backend::Vector<W>*       w_t    = &w->vector_;
   const backend::Vector<M>* mask_t = (mask == NULL) ? NULL : &mask->vector_;
-  backend::Descriptor*      desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
+  const backend::Vector<U>* u_t    = &u->vector_;
 
-  return backend::scatter(&w->vector_, mask_t, &u->vector_, val, desc_t);
+  return execute(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::scatter(w_t, mask_t, u_t, val, desc_t);
+  }, w_t, false, {u_t, mask_t});
 }
 
 template <typename W, typename a>
@@ -741,9 +1351,12 @@ Info graphColor(Vector<W>*       w,
   if (A == NULL || w == NULL)
     return GrB_UNINITIALIZED_OBJECT;
 
-  backend::Descriptor* desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
+  backend::Vector<W>*       w_t = &w->vector_;
+  const backend::Matrix<a>* A_t = &A->matrix_;
 
-  return backend::graphColor(&w->vector_, &A->matrix_, desc_t);
+  return execute(desc, [=](backend::Descriptor* desc_t) -> Info {
+    return backend::graphColor(w_t, A_t, desc_t);
+  }, w_t, true, {A_t});
 }
 
 /*!
@@ -766,22 +1379,28 @@ Info applyVxm(Vector<W>*       w,
     return GrB_UNINITIALIZED_OBJECT;
 
   // Dimension check
-  Index u_nvals = 0;
-  CHECK(u->nvals(&u_nvals));
-  if (u_nvals == 0)
-    return GrB_UNINITIALIZED_OBJECT;
-
   // Case 1: u*A
   CHECK(checkDimRowSize(A,  u,    "A.nrows != u.size"));
   CHECK(checkDimColSize(A,  w,    "A.ncols != w.size"));
   CHECK(checkDimSizeSize(w, mask, "w.size  != mask.size"));
 
   // Case 2: u*AT
+  backend::Vector<W>*       w_t    = &w->vector_;
   const backend::Vector<M>* mask_t = (mask == NULL) ? NULL : &mask->vector_;
-  backend::Descriptor*      desc_t = (desc == NULL) ? NULL : &desc->descriptor_;
-
-  return backend::applyVxm<W, U, a, M>(&w->vector_, mask_t, accum, op,
-      &u->vector_, &A->matrix_, desc_t);
+  const backend::Vector<U>* u_t    = &u->vector_;
+  const backend::Matrix<a>* A_t    = &A->matrix_;
+  bool overwrite = (mask == NULL && !useAccum(accum) &&
+      static_cast<const void*>(w) != u);
+
+  return execute(desc, [=](backend::Descriptor* desc_t) -> Info {
+    // Checked when run, since u may be output of a deferred operation
+    Index u_nvals = 0;
+    CHECK(const_cast<backend::Vector<U>*>(u_t)->nvals(&u_nvals));
+    if (u_nvals == 0)
+      return GrB_UNINITIALIZED_OBJECT;
+    return backend::applyVxm<W, U, a, M>(w_t, mask_t, accum, op, u_t, A_t,
+        desc_t);
+  }, w_t, overwrite, {u_t, A_t, mask_t});
 }
 
 }  // namespace graphblas
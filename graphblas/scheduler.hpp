@@ -0,0 +1,315 @@
+#ifndef GRAPHBLAS_SCHEDULER_HPP_
+#define GRAPHBLAS_SCHEDULER_HPP_
+
+#include <atomic>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <algorithm>
+
+#include "graphblas/types.hpp"
+#include "graphblas/thread_pool.hpp"
+
+// Opaque data members from the right backend
+#define __GRB_BACKEND_DESCRIPTOR_HEADER <graphblas/backend/__GRB_BACKEND_ROOT/descriptor.hpp>
+#include __GRB_BACKEND_DESCRIPTOR_HEADER
+#undef __GRB_BACKEND_DESCRIPTOR_HEADER
+
+namespace graphblas {
+
+/*!
+ * \brief Deferred execution of operations for non-blocking mode
+ *
+ * When a Descriptor is set to GrB_EXECMODE = GrB_NONBLOCKING, operations in
+ * operations.hpp are not run right away. Instead they are recorded here
+ * together with the objects they read and write, which forms a DAG. The DAG
+ * is run by wait(), which is called either explicitly, or implicitly as soon
+ * as an object touched by a recorded operation is accessed through any other
+ * method (e.g. nvals, extractTuples, setElement) or is destroyed.
+ *
+ * Before running, operations whose result is never read are dropped. The
+ * result is dead if the output is overwritten by a later operation before
+ * being read, or if the output is destroyed or returned to the VectorPool.
+ * Remaining operations are grouped into waves. Operations in the same wave
+ * touch disjoint objects, so they are run concurrently.
+ *
+ * Objects are identified by the address of their backend object. Recorded
+ * operations must only use backend objects, so that running them never calls
+ * back into the Scheduler.
+ */
+class Scheduler {
+ public:
+  typedef std::function<Info(backend::Descriptor*)> Operation;
+
+  explicit Scheduler(backend::Descriptor* desc);
+  ~Scheduler();
+
+  // Records op, which writes output and reads inputs (NULL inputs are
+  // ignored). overwrite means op does not read previous value of output
+  Info record(const Operation&                   op,
+              const void*                        output,
+              bool                               overwrite,
+              std::initializer_list<const void*> inputs);
+  // Runs all recorded operations and returns first error, if any
+  Info wait();
+
+  // Runs pending operations of every Scheduler that touches obj
+  static Info flush(const void* obj);
+  // Value of obj will not be read again (destroyed or returned to pool)
+  static void release(const void* obj);
+  // Runs pending operations of every Scheduler
+  static Info waitAll();
+
+  inline size_t npending()    const { return nodes_.size(); }
+  inline size_t nrecorded()   const { return nrecorded_;    }
+  inline size_t nexecuted()   const { return nexecuted_;    }
+  inline size_t neliminated() const { return neliminated_;  }
+  inline size_t nwaves()      const { return nwaves_;       }
+
+ private:
+  struct Node {
+    Operation                op;      // empty for release of output
+    const void*              output;
+    bool                     overwrite;
+    std::vector<const void*> inputs;
+    Desc_value               fields[GrB_NDESCFIELD];  // desc at record time
+  };
+
+  inline bool touches(const void* obj) const { return touched_.count(obj); }
+  Info run(Node* node, backend::Descriptor* desc);
+  Info runWave(std::vector<Node*>* wave);
+
+  // Registry of all Schedulers, so that objects can be flushed without
+  // knowing which Descriptor was used to record operations on them
+  static std::mutex&              registryMutex();
+  static std::vector<Scheduler*>& registry();
+  // Pending operations over all Schedulers, so flush() is cheap when 0
+  static std::atomic<size_t>&     npendingAll();
+
+  // Scheduler is tied to its Descriptor, so it is not copyable
+  Scheduler(const Scheduler&);
+  Scheduler& operator=(const Scheduler&);
+
+ private:
+  backend::Descriptor*              desc_;
+  std::vector<Node>                 nodes_;
+  std::unordered_set<const void*>   touched_;
+
+  // Descriptors used by threads other than caller's during waves
+  std::vector<backend::Descriptor*> workers_;
+
+  size_t nrecorded_;
+  size_t nexecuted_;
+  size_t neliminated_;
+  size_t nwaves_;
+};
+
+Scheduler::Scheduler(backend::Descriptor* desc)
+    : desc_(desc), nrecorded_(0), nexecuted_(0), neliminated_(0), nwaves_(0) {
+  std::lock_guard<std::mutex> lock(registryMutex());
+  registry().push_back(this);
+}
+
+Scheduler::~Scheduler() {
+  // Outputs may be user objects that outlive the Descriptor
+  wait();
+  {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    std::vector<Scheduler*>& schedulers = registry();
+    schedulers.erase(std::remove(schedulers.begin(), schedulers.end(), this),
+        schedulers.end());
+  }
+  for (size_t i = 0; i < workers_.size(); ++i)
+    delete workers_[i];
+}
+
+Info Scheduler::record(const Operation&                   op,
+                       const void*                        output,
+                       bool                               overwrite,
+                       std::initializer_list<const void*> inputs) {
+  if (output == NULL) return GrB_NULL_POINTER;
+
+  Node node;
+  node.op        = op;
+  node.output    = output;
+  node.overwrite = overwrite;
+  for (const void* input : inputs)
+    if (input != NULL)
+      node.inputs.push_back(input);
+  for (int field = 0; field < GrB_NDESCFIELD; ++field)
+    CHECK(desc_->get(static_cast<Desc_field>(field), &node.fields[field]));
+
+  touched_.insert(output);
+  touched_.insert(node.inputs.begin(), node.inputs.end());
+  nodes_.push_back(node);
+  nrecorded_++;
+  npendingAll()++;
+  return GrB_SUCCESS;
+}
+
+Info Scheduler::wait() {
+  if (nodes_.empty())
+    return GrB_SUCCESS;
+
+  // Take nodes first, so Scheduler is consistent even if an operation fails
+  std::vector<Node> nodes;
+  nodes.swap(nodes_);
+  touched_.clear();
+  npendingAll() -= nodes.size();
+
+  // Dead operation elimination: walking backwards, killed holds objects whose
+  // current value is overwritten or released before being read
+  std::vector<bool> live(nodes.size(), false);
+  std::unordered_set<const void*> killed;
+  for (size_t i = nodes.size(); i-- > 0;) {
+    Node& node = nodes[i];
+    if (!node.op) {
+      killed.insert(node.output);
+      continue;
+    }
+    if (killed.count(node.output)) {
+      neliminated_++;
+      continue;
+    }
+    live[i] = true;
+    if (node.overwrite)
+      killed.insert(node.output);
+    else
+      killed.erase(node.output);
+    for (size_t j = 0; j < node.inputs.size(); ++j)
+      killed.erase(node.inputs[j]);
+  }
+
+  // Each operation goes in the wave after the last one that touched any of
+  // its objects. Inputs count as well, since backend may change storage of
+  // inputs e.g. sparse to dense conversion
+  std::vector<std::vector<Node*> > waves;
+  std::unordered_map<const void*, size_t> last_wave;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (!live[i])
+      continue;
+    Node& node = nodes[i];
+    size_t wave = last_wave[node.output];
+    for (size_t j = 0; j < node.inputs.size(); ++j)
+      wave = std::max(wave, last_wave[node.inputs[j]]);
+    last_wave[node.output] = wave + 1;
+    for (size_t j = 0; j < node.inputs.size(); ++j)
+      last_wave[node.inputs[j]] = wave + 1;
+    if (waves.size() <= wave)
+      waves.resize(wave + 1);
+    waves[wave].push_back(&node);
+  }
+
+  for (size_t i = 0; i < waves.size(); ++i) {
+    nwaves_++;
+    CHECK(runWave(&waves[i]));
+  }
+  return GrB_SUCCESS;
+}
+
+Info Scheduler::flush(const void* obj) {
+  if (obj == NULL || npendingAll() == 0)
+    return GrB_SUCCESS;
+  std::lock_guard<std::mutex> lock(registryMutex());
+  std::vector<Scheduler*>& schedulers = registry();
+  for (size_t i = 0; i < schedulers.size(); ++i)
+    if (schedulers[i]->touches(obj))
+      CHECK(schedulers[i]->wait());
+  return GrB_SUCCESS;
+}
+
+void Scheduler::release(const void* obj) {
+  if (obj == NULL || npendingAll() == 0)
+    return;
+  std::lock_guard<std::mutex> lock(registryMutex());
+  std::vector<Scheduler*>& schedulers = registry();
+  for (size_t i = 0; i < schedulers.size(); ++i) {
+    Scheduler* scheduler = schedulers[i];
+    if (scheduler->touches(obj)) {
+      Node node;
+      node.output    = obj;
+      node.overwrite = true;
+      scheduler->nodes_.push_back(node);
+      npendingAll()++;
+    }
+  }
+}
+
+Info Scheduler::waitAll() {
+  if (npendingAll() == 0)
+    return GrB_SUCCESS;
+  std::lock_guard<std::mutex> lock(registryMutex());
+  std::vector<Scheduler*>& schedulers = registry();
+  for (size_t i = 0; i < schedulers.size(); ++i)
+    CHECK(schedulers[i]->wait());
+  return GrB_SUCCESS;
+}
+
+// Runs node with fields it was recorded with, then restores fields of desc
+Info Scheduler::run(Node* node, backend::Descriptor* desc) {
+  Desc_value fields[GrB_NDESCFIELD];
+  for (int field = 0; field < GrB_NDESCFIELD; ++field) {
+    CHECK(desc->get(static_cast<Desc_field>(field), &fields[field]));
+    CHECK(desc->set(static_cast<Desc_field>(field), node->fields[field]));
+  }
+  Info info = node->op(desc);
+  for (int field = 0; field < GrB_NDESCFIELD; ++field)
+    CHECK(desc->set(static_cast<Desc_field>(field), fields[field]));
+  return info;
+}
+
+// Nodes are dealt round-robin into one group per thread of the ThreadPool.
+// Each group runs its nodes in order with its own Descriptor, so a thread that
+// steals another group while waiting inside an operation never shares
+// Descriptor buffers with the operation it interrupted
+Info Scheduler::runWave(std::vector<Node*>* wave) {
+  size_t nnodes  = wave->size();
+  size_t ngroups = std::min(static_cast<size_t>(threadPool().nthread()),
+      nnodes);
+
+  // Worker Descriptors are kept across waves, since they own device buffers
+  while (workers_.size() + 1 < ngroups)
+    workers_.push_back(new backend::Descriptor());
+  for (size_t i = 0; i + 1 < ngroups; ++i)
+    CHECK(workers_[i]->copySettings(*desc_));
+
+  std::vector<Info> infos(nnodes, GrB_SUCCESS);
+  threadPool().parallelFor(0, ngroups, [&](Index begin, Index end) {
+    for (Index group = begin; group < end; ++group) {
+      backend::Descriptor* desc = (group == 0) ? desc_ : workers_[group-1];
+      for (size_t i = group; i < nnodes; i += ngroups)
+        infos[i] = run((*wave)[i], desc);
+    }
+  });
+
+  nexecuted_ += nnodes;
+  for (size_t i = 0; i < nnodes; ++i)
+    CHECK(infos[i]);
+  return GrB_SUCCESS;
+}
+
+std::mutex& Scheduler::registryMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::vector<Scheduler*>& Scheduler::registry() {
+  static std::vector<Scheduler*> schedulers;
+  return schedulers;
+}
+
+std::atomic<size_t>& Scheduler::npendingAll() {
+  static std::atomic<size_t> npending(0);
+  return npending;
+}
+
+// Same as GrB_wait(): runs all pending operations of every Descriptor
+Info wait() {
+  return Scheduler::waitAll();
+}
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_SCHEDULER_HPP_
@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <limits>
 #include <algorithm>
+#include <type_traits>
 
 namespace graphblas {
 // Unary Operations
@@ -88,6 +89,14 @@ struct second {
   }
 };
 
+// 1 for any pair of present entries, so that products count entries
+template <typename T_in1, typename T_in2 = T_in1, typename T_out = T_in1>
+struct pair {
+  inline GRB_HOST_DEVICE T_out operator()(T_in1 lhs, T_in2 rhs) {
+    return static_cast<T_out>(1);
+  }
+};
+
 template <typename T_in1, typename T_in2 = T_in1, typename T_out = T_in1>
 struct minimum {
   inline GRB_HOST_DEVICE T_out operator()(T_in1 lhs, T_in2 rhs) {
@@ -129,18 +138,50 @@ struct divides {
     return lhs / rhs;
   }
 };
+
+template <typename T_in1, typename T_in2 = T_in1, typename T_out = T_in1>
+struct squared_difference {
+  inline GRB_HOST_DEVICE T_out operator()(T_in1 lhs, T_in2 rhs) {
+    return (lhs - rhs) * (lhs - rhs);
+  }
+};
+
+// Atomic instruction that performs add of a monoid in place, so that push
+// kernels can scatter into output without a separate reduction
+enum AtomicKind {GrB_ATOMIC_NONE,
+                 GrB_ATOMIC_ADD,
+                 GrB_ATOMIC_MIN,
+                 GrB_ATOMIC_MAX,
+                 GrB_ATOMIC_OR,
+                 GrB_ATOMIC_AND};
 }  // namespace graphblas
 
 // Monoid generator macro provided by Scott McMillan
-#define REGISTER_MONOID(M_NAME, BINARYOP, IDENTITY)                          \
+//   TERMINAL:    annihilator z, i.e. z+x = z for every x, so that a reduction
+//                can stop as soon as it is reached. Only read if HAS_TERMINAL
+//   IDEMPOTENT:  x+x = x, so counting a contribution twice does no harm
+//   COMMUTATIVE: x+y = y+x, so contributions may be added in any order
+//   ATOMIC:      AtomicKind that implements add
+#define REGISTER_MONOID(M_NAME, BINARYOP, IDENTITY, HAS_TERMINAL, TERMINAL,  \
+                        IDEMPOTENT, COMMUTATIVE, ATOMIC)                     \
 template <typename T_out>                                                    \
 struct M_NAME                                                                \
 {                                                                            \
+  static constexpr bool       has_terminal = HAS_TERMINAL;                   \
+  static constexpr bool       idempotent   = IDEMPOTENT;                     \
+  static constexpr bool       commutative  = COMMUTATIVE;                    \
+  static constexpr AtomicKind atomic       = ATOMIC;                         \
+                                                                             \
   inline T_out identity() const                                              \
   {                                                                          \
     return static_cast<T_out>(IDENTITY);                                     \
   }                                                                          \
                                                                              \
+  inline T_out terminal() const                                              \
+  {                                                                          \
+    return static_cast<T_out>(TERMINAL);                                     \
+  }                                                                          \
+                                                                             \
   inline __host__ __device__ T_out operator()(T_out lhs, T_out rhs) const    \
   {                                                                          \
     return BINARYOP<T_out>()(lhs, rhs);                                      \
@@ -148,58 +189,121 @@ struct M_NAME                                                                \
 };
 
 namespace graphblas {
+// Annihilators of minimum and maximum. lowest() and max() are only that for
+// integer types, since floating types have infinities beyond them
+template <typename T>
+inline T minimumTerminal() {
+  return std::numeric_limits<T>::has_infinity ?
+      -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+}
+
+template <typename T>
+inline T maximumTerminal() {
+  return std::numeric_limits<T>::has_infinity ?
+      std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+}
+
 // Monoids
-REGISTER_MONOID(PlusMonoid, plus, 0)
-REGISTER_MONOID(MultipliesMonoid, multiplies, 1)
-REGISTER_MONOID(MinimumMonoid, minimum, std::numeric_limits<T_out>::max())
-REGISTER_MONOID(MaximumMonoid, maximum, 0)
-REGISTER_MONOID(LogicalOrMonoid, logical_or, false)
-REGISTER_MONOID(LogicalAndMonoid, logical_and, false)
+REGISTER_MONOID(PlusMonoid, plus, 0, false, 0, false, true, GrB_ATOMIC_ADD)
+REGISTER_MONOID(MultipliesMonoid, multiplies, 1, true, 0, false, true,
+    GrB_ATOMIC_NONE)
+REGISTER_MONOID(MinimumMonoid, minimum, std::numeric_limits<T_out>::max(),
+    true, minimumTerminal<T_out>(), true, true, GrB_ATOMIC_MIN)
+REGISTER_MONOID(MaximumMonoid, maximum, 0, true, maximumTerminal<T_out>(),
+    true, true, GrB_ATOMIC_MAX)
+REGISTER_MONOID(LogicalOrMonoid, logical_or, false, true, true, true, true,
+    GrB_ATOMIC_OR)
+REGISTER_MONOID(LogicalAndMonoid, logical_and, true, true, false, true, true,
+    GrB_ATOMIC_AND)
 
 // New monoids
-REGISTER_MONOID(GreaterMonoid, greater, std::numeric_limits<T_out>::min());
+REGISTER_MONOID(GreaterMonoid, greater, std::numeric_limits<T_out>::min(),
+    false, 0, false, false, GrB_ATOMIC_NONE);
 // Less is not a monoid because:
 // 1) has different left and right identity
 // 2) not associative
-REGISTER_MONOID(CustomLessMonoid, less, std::numeric_limits<T_out>::max());
-REGISTER_MONOID(NotEqualToMonoid, not_equal_to, std::numeric_limits<T_out>::max())
+REGISTER_MONOID(CustomLessMonoid, less, std::numeric_limits<T_out>::max(),
+    false, 0, false, false, GrB_ATOMIC_NONE);
+REGISTER_MONOID(NotEqualToMonoid, not_equal_to,
+    std::numeric_limits<T_out>::max(), false, 0, false, true, GrB_ATOMIC_NONE)
 }  // namespace graphblas
 
 // Semiring generator macro provided by Scott McMillan
-#define REGISTER_SEMIRING(SR_NAME, ADD_MONOID, MULT_BINARYOP)             \
+//   STRUCONLY: result of mxv only depends on which entries of A and u are
+//              present, so that "struconly" may drop their values. Holds when
+//              product of any two present values is terminal of add
+#define REGISTER_SEMIRING(SR_NAME, ADD_MONOID, MULT_BINARYOP, STRUCONLY)  \
 template <typename T_in1, typename T_in2 = T_in1, typename T_out = T_in1> \
 struct SR_NAME                                                            \
 {                                                                         \
   typedef T_out result_type;                                              \
   typedef T_out T_out_type;                                               \
+  typedef ADD_MONOID<T_out> add_monoid_type;                              \
+                                                                          \
+  static constexpr bool has_terminal = add_monoid_type::has_terminal;     \
+  static constexpr bool idempotent   = add_monoid_type::idempotent;       \
+  static constexpr bool commutative  = add_monoid_type::commutative;      \
+  static constexpr AtomicKind atomic = add_monoid_type::atomic;           \
+  static constexpr bool struconly    = STRUCONLY;                         \
                                                                           \
   inline T_out identity() const                                           \
   { return ADD_MONOID<T_out>().identity(); }                              \
                                                                           \
-  inline __host__ __device__ T_out add_op(T_out lhs, T_out rhs)           \
+  inline T_out terminal() const                                           \
+  { return ADD_MONOID<T_out>().terminal(); }                              \
+                                                                          \
+  inline __host__ __device__ T_out add_op(T_out lhs, T_out rhs) const     \
   { return ADD_MONOID<T_out>()(lhs, rhs); }                               \
                                                                           \
-  inline __host__ __device__ T_out mul_op(T_in1 lhs, T_in2 rhs)           \
+  inline __host__ __device__ T_out mul_op(T_in1 lhs, T_in2 rhs) const     \
   { return MULT_BINARYOP<T_in1, T_in2, T_out>()(lhs, rhs); }              \
 };
 
 namespace graphblas {
 // Semirings
-REGISTER_SEMIRING(LogicalOrAndSemiring, LogicalOrMonoid, logical_and)
-REGISTER_SEMIRING(PlusMultipliesSemiring, PlusMonoid, multiplies)
-REGISTER_SEMIRING(MinimumPlusSemiring, MinimumMonoid, plus)
-REGISTER_SEMIRING(MaximumMultipliesSemiring, MaximumMonoid, multiplies)
+REGISTER_SEMIRING(LogicalOrAndSemiring, LogicalOrMonoid, logical_and, true)
+REGISTER_SEMIRING(PlusMultipliesSemiring, PlusMonoid, multiplies, false)
+REGISTER_SEMIRING(MinimumPlusSemiring, MinimumMonoid, plus, false)
+REGISTER_SEMIRING(MaximumMultipliesSemiring, MaximumMonoid, multiplies, false)
 
 // New semirings
-REGISTER_SEMIRING(PlusDividesSemiring, PlusMonoid, divides)
-REGISTER_SEMIRING(PlusGreaterSemiring, PlusMonoid, greater)
-REGISTER_SEMIRING(GreaterPlusSemiring, GreaterMonoid, plus)
-REGISTER_SEMIRING(PlusMinusSemiring, PlusMonoid, minus)
-REGISTER_SEMIRING(PlusLessSemiring, PlusMonoid, less)
-REGISTER_SEMIRING(CustomLessPlusSemiring, CustomLessMonoid, plus)
-REGISTER_SEMIRING(MinimumMultipliesSemiring, MinimumMonoid, multiplies)
-REGISTER_SEMIRING(MultipliesMultipliesSemiring, MultipliesMonoid, multiplies)
-REGISTER_SEMIRING(NotEqualToPlusSemiring, NotEqualToMonoid, plus)
+REGISTER_SEMIRING(PlusDividesSemiring, PlusMonoid, divides, false)
+REGISTER_SEMIRING(PlusGreaterSemiring, PlusMonoid, greater, false)
+REGISTER_SEMIRING(GreaterPlusSemiring, GreaterMonoid, plus, false)
+REGISTER_SEMIRING(PlusMinusSemiring, PlusMonoid, minus, false)
+REGISTER_SEMIRING(PlusLessSemiring, PlusMonoid, less, false)
+REGISTER_SEMIRING(CustomLessPlusSemiring, CustomLessMonoid, plus, false)
+REGISTER_SEMIRING(MinimumMultipliesSemiring, MinimumMonoid, multiplies, false)
+REGISTER_SEMIRING(MultipliesMultipliesSemiring, MultipliesMonoid, multiplies,
+    false)
+REGISTER_SEMIRING(NotEqualToPlusSemiring, NotEqualToMonoid, plus, false)
+REGISTER_SEMIRING(PlusSquaredDifferenceSemiring, PlusMonoid,
+    squared_difference, false)
+REGISTER_SEMIRING(MinimumSelectSecondSemiring, MinimumMonoid, second, false)
+REGISTER_SEMIRING(PlusPairSemiring, PlusMonoid, pair, false)
+
+// GrB_NULL passed as accum is a null pointer constant, which has integer (or
+// nullptr_t) type rather than that of a BinaryOp
+template <typename BinaryOpT>
+struct AccumTraits {
+  static constexpr bool enabled = !std::is_arithmetic<BinaryOpT>::value &&
+      !std::is_same<BinaryOpT, std::nullptr_t>::value;
+};
+
+// Functor that GPU kernels can always call as accum: accum itself if enabled,
+// and otherwise second, so that accum(w, t) just stores t
+template <typename W, typename BinaryOpT,
+          bool Enabled = AccumTraits<BinaryOpT>::enabled>
+struct AccumOrSecond {
+  typedef BinaryOpT type;
+  static type get(BinaryOpT accum) { return accum; }
+};
+
+template <typename W, typename BinaryOpT>
+struct AccumOrSecond<W, BinaryOpT, false> {
+  typedef second<W> type;
+  static type get(BinaryOpT accum) { return second<W>(); }
+};
 
 // AddOp and MulOp extraction provided by Peter Zhang
 template <typename SemiringT>
@@ -214,12 +318,21 @@ struct AdditiveMonoidFromSemiring {
   AdditiveMonoidFromSemiring() : sr() {}
   explicit AdditiveMonoidFromSemiring(SemiringT const &sr) : sr(sr) {}
 
+  static constexpr bool       has_terminal = SemiringT::has_terminal;
+  static constexpr bool       idempotent   = SemiringT::idempotent;
+  static constexpr bool       commutative  = SemiringT::commutative;
+  static constexpr AtomicKind atomic       = SemiringT::atomic;
+
   inline GRB_HOST_DEVICE T_out_type identity() const {
     return sr.identity();
   }
 
+  inline GRB_HOST_DEVICE T_out_type terminal() const {
+    return sr.terminal();
+  }
+
   template <typename T_in1, typename T_in2>
-  inline GRB_HOST_DEVICE T_out_type operator()(T_in1 lhs, T_in2 rhs) {
+  inline GRB_HOST_DEVICE T_out_type operator()(T_in1 lhs, T_in2 rhs) const {
     return sr.add_op(lhs, rhs);
   }
 
@@ -244,7 +357,7 @@ struct MultiplicativeMonoidFromSemiring {
   }
 
   template <typename T_in1, typename T_in2>
-  inline GRB_HOST_DEVICE T_out_type operator()(T_in1 lhs, T_in2 rhs) {
+  inline GRB_HOST_DEVICE T_out_type operator()(T_in1 lhs, T_in2 rhs) const {
     return sr.mul_op(lhs, rhs);
   }
 
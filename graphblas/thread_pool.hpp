@@ -0,0 +1,422 @@
+#ifndef GRAPHBLAS_THREAD_POOL_HPP_
+#define GRAPHBLAS_THREAD_POOL_HPP_
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+
+#include "graphblas/types.hpp"
+
+namespace graphblas {
+
+/*!
+ * \brief Work-stealing thread pool shared by all CPU code paths
+ *
+ * Every thread has its own task deque. A thread pops work from the back of
+ * its own deque and, once that is empty, steals from the front of the others.
+ * Threads outside the pool share one extra deque, so that their work can be
+ * stolen too. A thread waiting for its tasks to finish runs tasks in the
+ * meantime, so parallel loops may be nested, e.g. inside an operation run by
+ * the Scheduler.
+ *
+ * Loops are split into contiguous chunks, and chunk c of nchunk is first
+ * queued to thread c*nthread/nchunk. Same split is used by firstTouch(), so
+ * when nothing is stolen a thread works on the memory it placed. Thread 0 is
+ * the caller.
+ *
+ * Use threadPool() to get the instance. Thread count and CPU affinity are set
+ * through Descriptor::loadArgs ("cputhread", "affinity").
+ */
+class ThreadPool {
+ public:
+  // Smaller allocations are not worth placing
+  static const size_t kFirstTouchBytes = 1 << 20;
+  // Chunks queued per thread by parallelFor, so there is work left to steal
+  static const int    kChunksPerThread = 4;
+
+  // nthread of 0 means one per hardware thread
+  explicit ThreadPool(int nthread = 0, bool affinity = false);
+  ~ThreadPool();
+
+  // Not safe to call while pool has work
+  Info resize(int nthread, bool affinity);
+  inline int  nthread()  const { return workers_.size() + 1; }
+  inline bool affinity() const { return affinity_;           }
+
+  // Runs f(begin, end) over chunks of [first, last) of at least grain
+  template <typename F>
+  void parallelFor(Index first, Index last, const F& f, Index grain = 1);
+
+  // Reduces f(begin, end) of every chunk with op, in chunk order
+  template <typename T, typename F, typename OpT>
+  T parallelReduce(Index first, Index last, T identity, const F& f,
+                   const OpT& op, Index grain = 1);
+
+  // parallelReduce for op with an annihilator terminal. f(begin, end, stop)
+  // of a chunk may return early once stop is set, which happens when any
+  // chunk returns terminal, and chunks that have not started by then are
+  // skipped. Returns terminal in that case
+  template <typename T, typename F, typename OpT>
+  T parallelReduceUntil(Index first, Index last, T identity, T terminal,
+                        const F& f, const OpT& op, Index grain = 1);
+
+  // out[i] = in[0] op ... op in[i-1] with out[0] = identity. Returns reduction
+  // of all of in. in and out may be the same array
+  template <typename T, typename OpT>
+  T parallelScan(const T* in, T* out, Index n, T identity, const OpT& op);
+
+  // Zeroes ptr[0, bytes) with every thread writing its own range, so that
+  // the OS places pages on the NUMA node of thread that uses them
+  void firstTouch(void* ptr, size_t bytes);
+
+  // [begin, end) of part of n (nparts parts) given to thread part
+  static void partition(Index n, int part, int nparts, Index* begin,
+                        Index* end);
+
+ private:
+  typedef std::function<void()> Task;
+
+  struct Queue {
+    std::mutex        mutex;
+    std::deque<Task>  tasks;
+  };
+
+  struct Worker {
+    std::thread thread;
+    Queue       queue;
+  };
+
+  // Runs f(chunk) for every chunk in [0, nchunk) and returns once all are done
+  void run(int nchunk, const std::function<void(int)>& f);
+  void push(int queue, const Task& task);
+  // Runs one queued task, if there is any
+  bool runOne(int self);
+  bool pop(Queue* queue, bool back, Task* task);
+  Queue* queue(int index);
+  void loop(int index);
+  void start();
+  void stop();
+
+  // Index of queue of calling thread: 0 outside pool, else 1 + worker number
+  static int& threadIndex();
+  static const ThreadPool*& threadOwner();
+  int self() const;
+
+  ThreadPool(const ThreadPool&);
+  ThreadPool& operator=(const ThreadPool&);
+
+ private:
+  std::vector<Worker*>    workers_;
+  Queue                   shared_;   // for threads outside pool
+  std::mutex              mutex_;    // protects sleeping on cond_
+  std::condition_variable cond_;
+  std::atomic<size_t>     nqueued_;
+  std::atomic<bool>       done_;
+  int                     nthread_;  // requested, 0 for hardware
+  bool                    affinity_;
+};
+
+ThreadPool::ThreadPool(int nthread, bool affinity)
+    : nqueued_(0), done_(false), nthread_(nthread), affinity_(affinity) {
+  start();
+}
+
+ThreadPool::~ThreadPool() {
+  stop();
+}
+
+Info ThreadPool::resize(int nthread, bool affinity) {
+  if (nthread < 0)
+    return GrB_INVALID_VALUE;
+  if (nthread == nthread_ && affinity == affinity_)
+    return GrB_SUCCESS;
+  stop();
+  nthread_  = nthread;
+  affinity_ = affinity;
+  start();
+  return GrB_SUCCESS;
+}
+
+void ThreadPool::start() {
+  int nthread = nthread_;
+  if (nthread == 0)
+    nthread = std::max(std::thread::hardware_concurrency(), 1u);
+
+  done_ = false;
+  for (int i = 1; i < nthread; ++i)
+    workers_.push_back(new Worker());
+  for (int i = 1; i < nthread; ++i) {
+    workers_[i-1]->thread = std::thread(&ThreadPool::loop, this, i);
+#ifdef __linux__
+    // Caller is left alone, since it belongs to the application
+    if (affinity_) {
+      int ncpu = std::max(std::thread::hardware_concurrency(), 1u);
+      cpu_set_t cpus;
+      CPU_ZERO(&cpus);
+      CPU_SET(i % ncpu, &cpus);
+      pthread_setaffinity_np(workers_[i-1]->thread.native_handle(),
+          sizeof(cpu_set_t), &cpus);
+    }
+#endif
+  }
+}
+
+void ThreadPool::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_ = true;
+  }
+  cond_.notify_all();
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i]->thread.join();
+    delete workers_[i];
+  }
+  workers_.clear();
+}
+
+void ThreadPool::loop(int index) {
+  threadIndex() = index;
+  threadOwner() = this;
+  while (true) {
+    if (runOne(index))
+      continue;
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] { return done_ || nqueued_ > 0; });
+    if (done_)
+      return;
+  }
+}
+
+int& ThreadPool::threadIndex() {
+  static thread_local int index = 0;
+  return index;
+}
+
+const ThreadPool*& ThreadPool::threadOwner() {
+  static thread_local const ThreadPool* owner = NULL;
+  return owner;
+}
+
+int ThreadPool::self() const {
+  return (threadOwner() == this) ? threadIndex() : 0;
+}
+
+ThreadPool::Queue* ThreadPool::queue(int index) {
+  return (index == 0) ? &shared_ : &workers_[index-1]->queue;
+}
+
+void ThreadPool::push(int index, const Task& task) {
+  Queue* q = queue(index);
+  {
+    std::lock_guard<std::mutex> lock(q->mutex);
+    q->tasks.push_back(task);
+  }
+  {
+    // Taken so that no worker misses the wakeup between test and wait
+    std::lock_guard<std::mutex> lock(mutex_);
+    nqueued_++;
+  }
+  cond_.notify_one();
+}
+
+bool ThreadPool::pop(Queue* q, bool back, Task* task) {
+  std::lock_guard<std::mutex> lock(q->mutex);
+  if (q->tasks.empty())
+    return false;
+  if (back) {
+    *task = q->tasks.back();
+    q->tasks.pop_back();
+  } else {
+    *task = q->tasks.front();
+    q->tasks.pop_front();
+  }
+  nqueued_--;
+  return true;
+}
+
+bool ThreadPool::runOne(int self) {
+  Task task;
+  bool found = pop(queue(self), true, &task);
+  for (int i = 1; !found && i < nthread(); ++i)
+    found = pop(queue((self + i) % nthread()), false, &task);
+  if (found)
+    task();
+  return found;
+}
+
+void ThreadPool::run(int nchunk, const std::function<void(int)>& f) {
+  int nthread = this->nthread();
+  if (nchunk <= 1 || nthread == 1) {
+    for (int chunk = 0; chunk < nchunk; ++chunk)
+      f(chunk);
+    return;
+  }
+
+  // Chunks of thread 0 are queued as well, so that they can be stolen
+  int caller = self();
+  std::atomic<int> nleft(nchunk);
+  for (int chunk = nchunk - 1; chunk >= 0; --chunk) {
+    int thread = static_cast<int64_t>(chunk)*nthread/nchunk;
+    push((thread == 0) ? caller : thread, [&f, &nleft, chunk] {
+      f(chunk);
+      nleft--;
+    });
+  }
+  while (nleft > 0)
+    if (!runOne(caller))
+      std::this_thread::yield();
+}
+
+void ThreadPool::partition(Index n, int part, int nparts, Index* begin,
+                           Index* end) {
+  *begin = static_cast<Index>(static_cast<double>(n)*part/nparts);
+  *end   = static_cast<Index>(static_cast<double>(n)*(part+1)/nparts);
+}
+
+template <typename F>
+void ThreadPool::parallelFor(Index first, Index last, const F& f,
+                             Index grain) {
+  if (last <= first)
+    return;
+  Index n      = last - first;
+  grain        = std::max(grain, static_cast<Index>(1));
+  Index nchunk = std::min((n + grain - 1)/grain,
+      static_cast<Index>(nthread()*kChunksPerThread));
+  run(nchunk, [&](int chunk) {
+    Index begin, end;
+    partition(n, chunk, nchunk, &begin, &end);
+    f(first + begin, first + end);
+  });
+}
+
+template <typename T, typename F, typename OpT>
+T ThreadPool::parallelReduce(Index first, Index last, T identity, const F& f,
+                             const OpT& op, Index grain) {
+  if (last <= first)
+    return identity;
+  Index n      = last - first;
+  grain        = std::max(grain, static_cast<Index>(1));
+  Index nchunk = std::min((n + grain - 1)/grain,
+      static_cast<Index>(nthread()*kChunksPerThread));
+  std::vector<T> partial(nchunk, identity);
+  run(nchunk, [&](int chunk) {
+    Index begin, end;
+    partition(n, chunk, nchunk, &begin, &end);
+    partial[chunk] = f(first + begin, first + end);
+  });
+
+  T result = identity;
+  for (Index chunk = 0; chunk < nchunk; ++chunk)
+    result = op(result, partial[chunk]);
+  return result;
+}
+
+template <typename T, typename F, typename OpT>
+T ThreadPool::parallelReduceUntil(Index first, Index last, T identity,
+                                  T terminal, const F& f, const OpT& op,
+                                  Index grain) {
+  if (last <= first)
+    return identity;
+  Index n      = last - first;
+  grain        = std::max(grain, static_cast<Index>(1));
+  Index nchunk = std::min((n + grain - 1)/grain,
+      static_cast<Index>(nthread()*kChunksPerThread));
+  std::vector<T> partial(nchunk, identity);
+  std::atomic<bool> stop(false);
+  run(nchunk, [&](int chunk) {
+    if (stop.load(std::memory_order_relaxed))
+      return;
+    Index begin, end;
+    partition(n, chunk, nchunk, &begin, &end);
+    partial[chunk] = f(first + begin, first + end,
+        static_cast<const std::atomic<bool>&>(stop));
+    if (partial[chunk] == terminal)
+      stop.store(true, std::memory_order_relaxed);
+  });
+  if (stop.load())
+    return terminal;
+
+  T result = identity;
+  for (Index chunk = 0; chunk < nchunk; ++chunk)
+    result = op(result, partial[chunk]);
+  return result;
+}
+
+template <typename T, typename OpT>
+T ThreadPool::parallelScan(const T* in, T* out, Index n, T identity,
+                           const OpT& op) {
+  // 1) Reduce each part 2) Scan part totals 3) Scan each part from its offset
+  int nparts = std::min(static_cast<Index>(nthread()), n);
+  if (nparts <= 1) {
+    T sum = identity;
+    for (Index i = 0; i < n; ++i) {
+      T val  = in[i];
+      out[i] = sum;
+      sum    = op(sum, val);
+    }
+    return sum;
+  }
+
+  std::vector<T> offset(nparts + 1, identity);
+  run(nparts, [&](int part) {
+    Index begin, end;
+    partition(n, part, nparts, &begin, &end);
+    T sum = identity;
+    for (Index i = begin; i < end; ++i)
+      sum = op(sum, in[i]);
+    offset[part+1] = sum;
+  });
+  for (int part = 0; part < nparts; ++part)
+    offset[part+1] = op(offset[part], offset[part+1]);
+  run(nparts, [&](int part) {
+    Index begin, end;
+    partition(n, part, nparts, &begin, &end);
+    T sum = offset[part];
+    for (Index i = begin; i < end; ++i) {
+      T val  = in[i];
+      out[i] = sum;
+      sum    = op(sum, val);
+    }
+  });
+  return offset[nparts];
+}
+
+void ThreadPool::firstTouch(void* ptr, size_t bytes) {
+  if (ptr == NULL)
+    return;
+  if (bytes < kFirstTouchBytes || nthread() == 1) {
+    std::memset(ptr, 0, bytes);
+    return;
+  }
+
+  // Same split as parallelFor, which queues kChunksPerThread chunks per thread
+  char* base   = reinterpret_cast<char*>(ptr);
+  int   nparts = nthread();
+  run(nparts, [=](int part) {
+    size_t begin = bytes*part/nparts;
+    size_t end   = bytes*(part+1)/nparts;
+    std::memset(base + begin, 0, end - begin);
+  });
+}
+
+// Singleton used by all CPU code paths
+ThreadPool& threadPool() {
+  static ThreadPool pool;
+  return pool;
+}
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_THREAD_POOL_HPP_
@@ -0,0 +1,102 @@
+#ifndef GRAPHBLAS_TUNE_PROFILE_HPP_
+#define GRAPHBLAS_TUNE_PROFILE_HPP_
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "graphblas/types.hpp"
+
+namespace graphblas {
+
+/*!
+ * \brief Descriptor settings tuned for one graph
+ *
+ * Written by algorithm::autotune() as a text file next to binary cache of the
+ * graph (.bin replaced by .tune), and read back by Descriptor::loadArgs when
+ * "autotune" is set. Profile holds fingerprint of the graph it was tuned on,
+ * so that a profile left over from an older version of the mtx is ignored.
+ */
+struct TuneProfile {
+  TuneProfile()
+      : fingerprint(0), mxvmode(1), switchpoint(0.01f), memusage(1.f),
+        lbmode(2), opreuse(false) {}
+
+  Info save(const std::string& path) const;
+  // GrB_NO_VALUE if there is no profile at path, or it is for another graph
+  Info load(const std::string& path, uint64_t graph);
+
+  uint64_t fingerprint;
+  int      mxvmode;      // same values as "mxvmode"
+  float    switchpoint;
+  float    memusage;
+  int      lbmode;       // same values as GRB_LOAD_BALANCE_MODE
+  bool     opreuse;
+};
+
+Info TuneProfile::save(const std::string& path) const {
+  std::ofstream ofs(path.c_str());
+  if (ofs.fail()) {
+    std::cout << "Error: Unable to open " << path << " for writing!\n";
+    return GrB_INVALID_VALUE;
+  }
+  ofs << "fingerprint " << fingerprint << "\n"
+      << "mxvmode "     << mxvmode     << "\n"
+      << "switchpoint " << switchpoint << "\n"
+      << "memusage "    << memusage    << "\n"
+      << "lbmode "      << lbmode      << "\n"
+      << "opreuse "     << opreuse     << "\n";
+  return GrB_SUCCESS;
+}
+
+Info TuneProfile::load(const std::string& path, uint64_t graph) {
+  std::ifstream ifs(path.c_str());
+  if (path.empty() || ifs.fail())
+    return GrB_NO_VALUE;
+
+  TuneProfile profile;
+  std::string key;
+  while (ifs >> key) {
+    if (key == "fingerprint")      ifs >> profile.fingerprint;
+    else if (key == "mxvmode")     ifs >> profile.mxvmode;
+    else if (key == "switchpoint") ifs >> profile.switchpoint;
+    else if (key == "memusage")    ifs >> profile.memusage;
+    else if (key == "lbmode")      ifs >> profile.lbmode;
+    else if (key == "opreuse")     ifs >> profile.opreuse;
+    else
+      return GrB_INVALID_VALUE;
+  }
+  if (profile.fingerprint != graph)
+    return GrB_NO_VALUE;
+  *this = profile;
+  return GrB_SUCCESS;
+}
+
+// Graph that tuned settings are loaded for and saved to. readMtx sets it to
+// the graph it reads, since that is where binary cache path is known
+struct TuneGraph {
+  TuneGraph() : fingerprint(0), nrows(0) {}
+
+  std::string profile;      // empty if graph has no binary cache
+  uint64_t    fingerprint;
+  Index       nrows;
+};
+
+TuneGraph& tuneGraph() {
+  static TuneGraph graph;
+  return graph;
+}
+
+// FNV-1a over whatever identifies graph, e.g. its size and how it was read
+inline uint64_t fingerprint(uint64_t hash, uint64_t value) {
+  for (int byte = 0; byte < 8; ++byte) {
+    hash ^= (value >> (8*byte)) & 0xff;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_TUNE_PROFILE_HPP_
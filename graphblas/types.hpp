@@ -3,9 +3,6 @@
 
 #define GrB_NULL   NULL
 #define GrB_ALL    NULL
-// TODO(@ctcyang): change GrB_MEMORY into commandline parameter
-// (requires some trickery with templates and singleton idiom)
-#define GrB_MEMORY false  // print memory usage info
 
 #include <cstddef>
 #include <cstdint>
@@ -51,6 +48,7 @@ enum Desc_field {GrB_MASK,
                  GrB_MXVMODE,
                  GrB_TOL,
                  GrB_BACKEND,
+                 GrB_EXECMODE,
                  GrB_NDESCFIELD};
 
 enum Desc_value {GrB_SCMP,               // for GrB_MASK
@@ -67,6 +65,8 @@ enum Desc_value {GrB_SCMP,               // for GrB_MASK
                  GrB_PULLONLY   =   12,  // for GrB_MXVMODE
                  GrB_SEQUENTIAL =   13,  // for GrB_BACKEND
                  GrB_CUDA       =   14,  // for GrB_BACKEND
+                 GrB_BLOCKING   =   15,  // for GrB_EXECMODE
+                 GrB_NONBLOCKING =  17,  // for GrB_EXECMODE
                  GrB_8          =    8,  // for GrB_TA, GrB_TB, GrB_NT
                  GrB_16         =   16,  // for GrB_TOL
                  GrB_32         =   32,
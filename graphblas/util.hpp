@@ -2,12 +2,14 @@
 #define GRAPHBLAS_UTIL_HPP_
 
 #include <sys/resource.h>
+#include <sys/stat.h>
 #include <sys/time.h>
 #include <libgen.h>
 #include <cstdio>
 #include <fstream>
 #include <vector>
 #include <tuple>
+#include <functional>
 #include <algorithm>
 #include <string>
 #include <iostream>
@@ -15,6 +17,9 @@
 // for commandline arguments
 #include <boost/program_options.hpp>
 
+#include "graphblas/thread_pool.hpp"
+#include "graphblas/tune_profile.hpp"
+
 #define CHECK(x) do {                                           \
   graphblas::Info err = x;                                      \
   if (err != graphblas::GrB_SUCCESS) {                          \
@@ -76,6 +81,8 @@ void parseArgs(int argc, char**argv, po::variables_map* vm) {
         "Source node range end")
     ("mxvmode", po::value<int>()->default_value(1),
         "0: push-pull, 1: push only, 2: pull only")
+    ("delta", po::value<float>()->default_value(-1.f),
+        "SSSP bucket width, <0: Bellman-Ford, 0: delta-stepping with mean edge weight, >0: delta-stepping with this width")  // NOLINT(whitespace/line_length)
     ("switchpoint", po::value<float>()->default_value(0.01),
         "Percentage of nnz needed in order to switch from sparse to dense when mxvmode=0")  // NOLINT(whitespace/line_length)
     ("dirinfo", po::value<bool>()->default_value(false),
@@ -101,6 +108,24 @@ void parseArgs(int argc, char**argv, po::variables_map* vm) {
     ("fusedmask", po::value<bool>()->default_value(true),
         "True means use fused mask in pull direction when using LogicalOrAnd semiring, False means do not do it")  // NOLINT(whitespace/line_length)
 
+    // Matrix update params
+    ("compactratio", po::value<float>()->default_value(0.1),
+        "Pending edge insertions and deletions are merged into CSR/CSC once there are more than this fraction of nnz")  // NOLINT(whitespace/line_length)
+
+    // Tuning params
+    ("autotune", po::value<int>()->default_value(0),
+        "0: use settings given on command line, 1: use settings tuned for graph if it has been tuned before, else tune it, 2: always tune graph again. Tuned settings are saved next to binary cache of graph")  // NOLINT(whitespace/line_length)
+
+    // Execution params
+    ("nonblocking", po::value<bool>()->default_value(false),
+        "True means operations are queued and run at wait() or when their result is read, False means they run immediately")  // NOLINT(whitespace/line_length)
+
+    // CPU params
+    ("cputhread", po::value<int>()->default_value(0),
+        "Number of threads used by CPU code paths, 0 means one per hardware thread")  // NOLINT(whitespace/line_length)
+    ("affinity", po::value<bool>()->default_value(false),
+        "True means pin each CPU worker thread to its own core")
+
     // algorithm-specific params
     ("maxcolors", po::value<int>()->default_value(10000),
         "Upper bound on colors when graph coloring algorithm is used")
@@ -356,6 +381,39 @@ char* convert(const char* fname, bool is_undirected = true) {
 // 0: If it is marked symmetric, then double the edges. Else do nothing.
 // 1: Force matrix to be unsymmetric.
 // 2: Force matrix to be symmetric.
+// Tuned settings of graph are kept next to its binary cache, and only used
+// for the same mtx file read the same way
+void setTuneGraph(const char*      fname,
+                  const char*      dat_name,
+                  graphblas::Index nrows,
+                  graphblas::Index ncols,
+                  graphblas::Index nvals,
+                  bool             is_undirected) {
+  struct stat results;
+  uint64_t size = (stat(fname, &results) == 0) ? results.st_size : 0;
+
+  uint64_t hash = 14695981039346656037ULL;
+  hash = graphblas::fingerprint(hash, nrows);
+  hash = graphblas::fingerprint(hash, ncols);
+  hash = graphblas::fingerprint(hash, nvals);
+  hash = graphblas::fingerprint(hash, size);
+  hash = graphblas::fingerprint(hash, is_undirected);
+  hash = graphblas::fingerprint(hash, sizeof(graphblas::Index));
+
+  // .name.ud.nosl.bin -> .name.ud.nosl.tune
+  std::string profile(dat_name);
+  size_t suffix = profile.size() - 3;
+  if (profile.size() >= 3 && profile.compare(suffix, 3, "bin") == 0)
+    profile.replace(suffix, 3, "tune");
+  else
+    profile += ".tune";
+
+  graphblas::TuneGraph& graph = graphblas::tuneGraph();
+  graph.profile     = profile;
+  graph.fingerprint = hash;
+  graph.nrows       = nrows;
+}
+
 template<typename T>
 int readMtx(const char*                    fname,
             std::vector<graphblas::Index>* row_indices,
@@ -391,8 +449,10 @@ int readMtx(const char*                    fname,
   bool is_undirected = mm_is_symmetric(matcode) || directed == 2;
   is_undirected = (directed == 1) ? false : is_undirected;
   printf("Undirected: %d\n", is_undirected);
-  if (dat_name != NULL)
+  if (dat_name != NULL) {
     *dat_name = convert(fname, is_undirected);
+    setTuneGraph(fname, *dat_name, *nrows, *ncols, *nvals, is_undirected);
+  }
 
   if (dat_name != NULL && exists(*dat_name)) {
     // The size of the file in bytes is in results.st_size
@@ -503,7 +563,6 @@ void coo2csr(Index*                    csrRowPtr,
              const std::vector<T>&     values,
              Index                     nrows,
              Index                     ncols) {
-  Index temp, row, col, dest, cumsum = 0;
   Index nvals = row_indices.size();
 
   std::vector<Index> row_indices_t = row_indices;
@@ -512,46 +571,28 @@ void coo2csr(Index*                    csrRowPtr,
 
   customSort<T>(&row_indices_t, &col_indices_t, &values_t);
 
-  // Set all rowPtr to 0
-  for (Index i = 0; i <= nrows; i++)
-    csrRowPtr[i] = 0;
-
-  // Go through all elements to see how many fall in each row
-  for (Index i = 0; i < nvals; i++) {
-    row = row_indices_t[i];
-    if (row >= nrows) std::cout << "Error: Index out of bounds!\n";
-    csrRowPtr[row]++;
-  }
-
-  // Cumulative sum to obtain rowPtr
-  for (Index i = 0; i < nrows; i++) {
-    temp = csrRowPtr[i];
-    csrRowPtr[i] = cumsum;
-    cumsum += temp;
-  }
-  csrRowPtr[nrows] = nvals;
-
-  // Store colInd and val
-  for (Index i = 0; i < nvals; i++) {
-    row = row_indices_t[i];
-    dest = csrRowPtr[row];
-    col = col_indices_t[i];
-    if (col >= ncols) std::cout << "Error: Index out of bounds!\n";
-    csrColInd[dest] = col;
-    csrVal[dest] = values_t[i];
-    csrRowPtr[row]++;
-  }
-  cumsum = 0;
-
-  // Undo damage done to rowPtr
-  for (Index i = 0; i < nrows; i++) {
-    temp = csrRowPtr[i];
-    csrRowPtr[i] = cumsum;
-    cumsum = temp;
-  }
-  temp = csrRowPtr[nrows];
-  csrRowPtr[nrows] = cumsum;
-  cumsum = temp;
+  // Tuples are sorted by row, so row starts at first tuple not before it
+  threadPool().parallelFor(0, nrows + 1, [&](Index begin, Index end) {
+    for (Index row = begin; row < end; ++row)
+      csrRowPtr[row] = std::lower_bound(row_indices_t.begin(),
+          row_indices_t.end(), row) - row_indices_t.begin();
+  }, 1024);
+  if (nvals > 0 && row_indices_t[nvals-1] >= nrows)
+    std::cout << "Error: Index out of bounds!\n";
+
+  // Store colInd and val, which are in the same order as tuples
+  Index nerrors = threadPool().parallelReduce(0, nvals, 0,
+      [&](Index begin, Index end) {
+    Index nerrors = 0;
+    for (Index i = begin; i < end; ++i) {
+      if (col_indices_t[i] >= ncols) nerrors++;
+      csrColInd[i] = col_indices_t[i];
+      csrVal[i]    = values_t[i];
+    }
+    return nerrors;
+  }, std::plus<Index>(), 1024);
+  if (nerrors > 0)
+    std::cout << "Error: Index out of bounds!\n";
 }
 
 template <typename T>
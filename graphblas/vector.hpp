@@ -2,25 +2,47 @@
 #define GRAPHBLAS_VECTOR_HPP_
 
 #include <vector>
+#include <utility>
 
 // Opaque data members from the right backend
 #define __GRB_BACKEND_VECTOR_HEADER <graphblas/backend/__GRB_BACKEND_ROOT/vector.hpp>
 #include __GRB_BACKEND_VECTOR_HEADER
 #undef __GRB_BACKEND_VECTOR_HEADER
 
+#include "graphblas/scheduler.hpp"
+
 namespace graphblas {
+class VectorPool;
+
 template <typename T>
 class Vector {
  public:
   Vector() : vector_() {}
   explicit Vector(Index nsize) : vector_(nsize) {}
 
-  // Default Destructor is good enough for this layer
-  ~Vector() {}
+  // Moves are O(1). Copies must go through dup() or operator=
+  Vector(Vector&& rhs) : vector_() {
+    CHECKVOID(Scheduler::flush(&rhs.vector_));
+    vector_ = std::move(rhs.vector_);
+  }
+  Vector& operator=(Vector&& rhs) {
+    CHECKVOID(Scheduler::flush(&vector_));
+    CHECKVOID(Scheduler::flush(&rhs.vector_));
+    vector_ = std::move(rhs.vector_);
+    return *this;
+  }
+
+  // Pending operations writing this object are dropped, and those reading it
+  // are run before it goes away
+  ~Vector() {
+    Scheduler::release(&vector_);
+    Scheduler::flush(&vector_);
+  }
 
   // C API Methods
   // Note: extractTuples no longer an accessor for GPU version
   Info nnew(Index nsize);
+  // O(1) copy-on-write: rhs's memory is shared until either vector is written
   Info dup(const Vector* rhs);
   Info clear();
   Info size(Index* nsize_) const;
@@ -48,7 +70,7 @@ class Vector {
                      Index*          n);
 
   // Some handy methods
-  void operator=(const Vector& rhs);
+  void operator=(const Vector& rhs);  // same as dup()
   const T& operator[](Index ind);
   Info resize(Index nvals);
   Info fill(T val);
@@ -57,24 +79,31 @@ class Vector {
   Info countUnique(Index* count);
   Info setStorage(Storage vec_type);
   Info getStorage(Storage* vec_type) const;
-  Info swap(Vector* rhs);
+  Info swap(Vector* rhs);  // O(1)
 
  private:
+  // Pool flushes and recycles backend storage of vectors it hands out
+  friend class VectorPool;
+
   backend::Vector<T> vector_;
 };
 
 template <typename T>
 Info Vector<T>::nnew(Index nsize) {
+  CHECK(Scheduler::flush(&vector_));
   return vector_.nnew(nsize);
 }
 
 template <typename T>
 Info Vector<T>::dup(const Vector* rhs) {
+  CHECK(Scheduler::flush(&vector_));
+  CHECK(Scheduler::flush(&rhs->vector_));
   return vector_.dup(&rhs->vector_);
 }
 
 template <typename T>
 Info Vector<T>::clear() {
+  CHECK(Scheduler::flush(&vector_));
   return vector_.clear();
 }
 
@@ -87,6 +116,7 @@ Info Vector<T>::size(Index* nsize_t) const {
 
 template <typename T>
 Info Vector<T>::nvals(Index* nvals_t) const {
+  CHECK(Scheduler::flush(&vector_));
   if (nvals_t == NULL) return GrB_NULL_POINTER;
   backend::Vector<T>* vector_t = const_cast<backend::Vector<T>*>(&vector_);
   return vector_t->nvals(nvals_t);
@@ -98,6 +128,7 @@ Info Vector<T>::build(const std::vector<Index>* indices,
                       const std::vector<T>*     values,
                       Index                     nvals,
                       BinaryOpT                 dup) {
+  CHECK(Scheduler::flush(&vector_));
   if (indices == NULL || values == NULL)
     return GrB_NULL_POINTER;
   return vector_.build(indices, values, nvals, dup);
@@ -106,6 +137,7 @@ Info Vector<T>::build(const std::vector<Index>* indices,
 template <typename T>
 Info Vector<T>::build(const std::vector<T>* values,
                       Index                 nvals) {
+  CHECK(Scheduler::flush(&vector_));
   if (values == NULL) return GrB_NULL_POINTER;
   return vector_.build(values, nvals);
 }
@@ -114,6 +146,7 @@ template <typename T>
 Info Vector<T>::build(Index* indices,
                       T*     values,
                       Index  nvals) {
+  CHECK(Scheduler::flush(&vector_));
   if (indices == NULL || values == NULL) return GrB_NULL_POINTER;
   if (nvals == 0) return GrB_INVALID_VALUE;
   return vector_.build(indices, values, nvals);
@@ -122,6 +155,7 @@ Info Vector<T>::build(Index* indices,
 template <typename T>
 Info Vector<T>::build(T*     values,
                       Index  nvals) {
+  CHECK(Scheduler::flush(&vector_));
   if (values == NULL) return GrB_NULL_POINTER;
   if (nvals == 0) return GrB_INVALID_VALUE;
   return vector_.build(values, nvals);
@@ -129,11 +163,13 @@ Info Vector<T>::build(T*     values,
 
 template <typename T>
 Info Vector<T>::setElement(T val, Index index) {
+  CHECK(Scheduler::flush(&vector_));
   return vector_.setElement(val, index);
 }
 
 template <typename T>
 Info Vector<T>::extractElement(T* val, Index index) {
+  CHECK(Scheduler::flush(&vector_));
   if (val == NULL) return GrB_NULL_POINTER;
   return vector_.extractElement(val, index);
 }
@@ -142,6 +178,7 @@ template <typename T>
 Info Vector<T>::extractTuples(std::vector<Index>* indices,
                               std::vector<T>*     values,
                               Index*              n) {
+  CHECK(Scheduler::flush(&vector_));
   if (indices == NULL || values == NULL || n == NULL) return GrB_NULL_POINTER;
   return vector_.extractTuples(indices, values, n);
 }
@@ -149,55 +186,66 @@ Info Vector<T>::extractTuples(std::vector<Index>* indices,
 template <typename T>
 Info Vector<T>::extractTuples(std::vector<T>* values,
                               Index*          n) {
+  CHECK(Scheduler::flush(&vector_));
   if (values == NULL || n == NULL) return GrB_NULL_POINTER;
   return vector_.extractTuples(values, n);
 }
 
 template <typename T>
 void Vector<T>::operator=(const Vector& rhs) {
+  CHECKVOID(Scheduler::flush(&vector_));
+  CHECKVOID(Scheduler::flush(&rhs.vector_));
   vector_.dup(&rhs.vector_);
 }
 
 template <typename T>
 const T& Vector<T>::operator[](Index ind) {
+  Scheduler::flush(&vector_);
   return vector_[ind];
 }
 
 // Copies the val to arrays kresize_ratio x bigger than capacity
 template <typename T>
 Info Vector<T>::resize(Index nvals) {
+  CHECK(Scheduler::flush(&vector_));
   return vector_.resize(nvals);
 }
 
 template <typename T>
 Info Vector<T>::fill(T val) {
+  CHECK(Scheduler::flush(&vector_));
   return vector_.fill(val);
 }
 
 template <typename T>
 Info Vector<T>::fillAscending(Index nvals) {
+  CHECK(Scheduler::flush(&vector_));
   return vector_.fillAscending(nvals);
 }
 
 template <typename T>
 Info Vector<T>::print(bool force_update) {
+  CHECK(Scheduler::flush(&vector_));
   return vector_.print(force_update);
 }
 
 // Count number of unique numbers
 template <typename T>
 Info Vector<T>::countUnique(Index* count) {
+  CHECK(Scheduler::flush(&vector_));
   if (count == NULL) return GrB_NULL_POINTER;
   return vector_.countUnique(count);
 }
 
 template <typename T>
 Info Vector<T>::setStorage(Storage vec_type) {
+  CHECK(Scheduler::flush(&vector_));
   return vector_.setStorage(vec_type);
 }
 
 template <typename T>
 Info Vector<T>::getStorage(Storage* vec_type) const {
+  CHECK(Scheduler::flush(&vector_));
   if (vec_type == NULL) return GrB_NULL_POINTER;
   return vector_.getStorage(vec_type);
 }
@@ -205,6 +253,7 @@ Info Vector<T>::getStorage(Storage* vec_type) const {
 template <typename T>
 Info Vector<T>::swap(Vector* rhs) {  // NOLINT(build/include_what_you_use)
   if (rhs == NULL) return GrB_NULL_POINTER;
+  CHECK(Scheduler::flush(&rhs->vector_));
   return vector_.swap(&rhs->vector_);
 }
 }  // namespace graphblas
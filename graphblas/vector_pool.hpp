@@ -0,0 +1,147 @@
+#ifndef GRAPHBLAS_VECTOR_POOL_HPP_
+#define GRAPHBLAS_VECTOR_POOL_HPP_
+
+#include <vector>
+#include <iostream>
+
+#include "graphblas/types.hpp"
+#include "graphblas/scheduler.hpp"
+
+namespace graphblas {
+template <typename T>
+class Vector;
+
+/*!
+ * \brief Pool of reusable temporary vectors keyed by size and type
+ *
+ * Algorithms that are called many times on the same graph (e.g. BFS from many
+ * sources) need the same frontier and buffer vectors every call. Rather than
+ * allocating and freeing them per call, they are acquired from the pool owned
+ * by the Descriptor and returned to it when the call finishes.
+ *
+ * A vector acquired from the pool is in the same state as a newly constructed
+ * Vector(nsize): its storage type is unknown and its contents are undefined.
+ * It is neither zero-filled nor reallocated.
+ */
+class VectorPool {
+ public:
+  VectorPool() : nhit_(0), nmiss_(0) {}
+  ~VectorPool();
+
+  template <typename T>
+  Info acquire(Vector<T>** vec, Index nsize);
+  template <typename T>
+  Info release(Vector<T>* vec);
+
+  // Frees all vectors currently held by the pool
+  Info clear();
+
+  inline size_t size()  const { return entries_.size(); }
+  inline size_t nhit()  const { return nhit_;  }
+  inline size_t nmiss() const { return nmiss_; }
+
+ private:
+  struct Entry {
+    const void* type;
+    Index       nsize;
+    void*       vec;
+    void      (*destroy)(void*);
+  };
+
+  // Unique address per type T used as key, so we do not need RTTI
+  template <typename T>
+  static const void* typeKey() {
+    static const char key = 0;
+    return &key;
+  }
+
+  template <typename T>
+  static void destroy(void* vec) {
+    delete reinterpret_cast<Vector<T>*>(vec);
+  }
+
+  // VectorPool owns the vectors it holds, so it is not copyable
+  VectorPool(const VectorPool&);
+  VectorPool& operator=(const VectorPool&);
+
+ private:
+  std::vector<Entry> entries_;
+  size_t             nhit_;
+  size_t             nmiss_;
+};
+
+/*!
+ * \brief RAII handle to a vector acquired from a VectorPool
+ *
+ * Usage:
+ *   PooledVector<float> f1_pool(desc->pool(), A_nrows);
+ *   Vector<float>& f1 = *f1_pool;
+ */
+template <typename T>
+class PooledVector {
+ public:
+  PooledVector(VectorPool* pool, Index nsize) : pool_(pool), vec_(NULL) {
+    CHECKVOID(pool_->acquire(&vec_, nsize));
+  }
+  ~PooledVector() {
+    if (vec_ != NULL) pool_->release(vec_);
+  }
+
+  inline Vector<T>* get()        { return vec_;  }
+  inline Vector<T>& operator*()  { return *vec_; }
+  inline Vector<T>* operator->() { return vec_;  }
+
+ private:
+  PooledVector(const PooledVector&);
+  PooledVector& operator=(const PooledVector&);
+
+  VectorPool* pool_;
+  Vector<T>*  vec_;
+};
+
+VectorPool::~VectorPool() {
+  clear();
+}
+
+template <typename T>
+Info VectorPool::acquire(Vector<T>** vec, Index nsize) {
+  if (vec == NULL) return GrB_NULL_POINTER;
+  const void* type = typeKey<T>();
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    if (entries_[i].type == type && entries_[i].nsize == nsize) {
+      *vec = reinterpret_cast<Vector<T>*>(entries_[i].vec);
+      entries_[i] = entries_.back();
+      entries_.pop_back();
+      nhit_++;
+      // Pending operations on its previous contents are dead by now
+      CHECK(Scheduler::flush(&(*vec)->vector_));
+      return (*vec)->vector_.recycle();
+    }
+  }
+  nmiss_++;
+  *vec = new Vector<T>(nsize);
+  return GrB_SUCCESS;
+}
+
+template <typename T>
+Info VectorPool::release(Vector<T>* vec) {
+  if (vec == NULL) return GrB_NULL_POINTER;
+  Index nsize;
+  CHECK(vec->size(&nsize));
+  // Contents are no longer needed, so pending operations writing them can be
+  // dropped in non-blocking mode
+  Scheduler::release(&vec->vector_);
+  Entry entry = {typeKey<T>(), nsize, vec, &VectorPool::destroy<T>};
+  entries_.push_back(entry);
+  return GrB_SUCCESS;
+}
+
+Info VectorPool::clear() {
+  for (size_t i = 0; i < entries_.size(); ++i)
+    entries_[i].destroy(entries_[i].vec);
+  entries_.clear();
+  return GrB_SUCCESS;
+}
+}  // namespace graphblas
+
+#endif  // GRAPHBLAS_VECTOR_POOL_HPP_
@@ -0,0 +1,153 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "graphblas/graphblas.hpp"
+#include "graphblas/algorithm/autotune.hpp"
+#include "test/test.hpp"
+
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_MODULE autotune_suite
+
+#include <boost/test/included/unit_test.hpp>
+#include <boost/program_options.hpp>
+
+struct TestMatrix
+{
+  TestMatrix() :
+    DEBUG(true) {}
+
+  bool DEBUG;
+};
+
+BOOST_AUTO_TEST_SUITE(autotune_suite)
+
+// Profile is read back as written, and only for the graph it was written for
+BOOST_FIXTURE_TEST_CASE( autotune1, TestMatrix )
+{
+  std::string path = "data/small/.autotune1.tune";
+  graphblas::TuneProfile profile;
+  profile.fingerprint = 1234;
+  profile.mxvmode     = 0;
+  profile.switchpoint = 0.05f;
+  profile.memusage    = 0.5f;
+  profile.lbmode      = 1;
+  profile.opreuse     = true;
+  CHECKVOID(profile.save(path));
+
+  graphblas::TuneProfile loaded;
+  CHECKVOID(loaded.load(path, 1234));
+  BOOST_ASSERT( loaded.mxvmode == 0 );
+  BOOST_ASSERT_FLOAT( loaded.switchpoint, 0.05f );
+  BOOST_ASSERT_FLOAT( loaded.memusage, 0.5f );
+  BOOST_ASSERT( loaded.lbmode == 1 );
+  BOOST_ASSERT( loaded.opreuse );
+
+  BOOST_ASSERT( loaded.load(path, 4321) == graphblas::GrB_NO_VALUE );
+  std::remove(path.c_str());
+  BOOST_ASSERT( loaded.load(path, 1234) == graphblas::GrB_NO_VALUE );
+}
+
+// loadArgs picks up profile of graph read last, but only with --autotune 1
+BOOST_FIXTURE_TEST_CASE( autotune2, TestMatrix )
+{
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  char* dat_name;
+  readMtx("data/small/chesapeake.mtx", &row_indices, &col_indices, &values,
+      &nrows, &ncols, &nvals, 0, false, &dat_name);
+
+  const graphblas::TuneGraph& graph = graphblas::tuneGraph();
+  BOOST_ASSERT( graph.nrows == nrows );
+  BOOST_ASSERT( graph.profile.find(".tune") != std::string::npos );
+
+  graphblas::TuneProfile profile;
+  profile.fingerprint = graph.fingerprint;
+  profile.mxvmode     = 2;
+  profile.switchpoint = 0.05f;
+  profile.lbmode      = 1;
+  profile.opreuse     = true;
+  CHECKVOID(profile.save(graph.profile));
+
+  int argc = 7;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0", "--autotune", "1"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+
+  graphblas::Desc_value mxv_mode;
+  CHECKVOID(desc.get(graphblas::GrB_MXVMODE, &mxv_mode));
+  BOOST_ASSERT( mxv_mode == graphblas::GrB_PULLONLY );
+  BOOST_ASSERT( desc.descriptor_.tuned() );
+  BOOST_ASSERT( desc.descriptor_.opreuse() );
+  BOOST_ASSERT_FLOAT( desc.descriptor_.switchpoint(), 0.05f );
+  BOOST_ASSERT( desc.descriptor_.lbmode() == 1 );
+
+  argv[6] = "0";
+  po::variables_map vm_off;
+  parseArgs(argc, argv, &vm_off);
+  graphblas::Descriptor desc_off;
+  CHECKVOID(desc_off.loadArgs(vm_off));
+  CHECKVOID(desc_off.get(graphblas::GrB_MXVMODE, &mxv_mode));
+  BOOST_ASSERT( mxv_mode == graphblas::GrB_PUSHONLY );
+  BOOST_ASSERT( !desc_off.descriptor_.tuned() );
+
+  std::remove(graph.profile.c_str());
+  free(dat_name);
+}
+
+// Tuning saves settings it picked, and next loadArgs gets the same ones
+BOOST_FIXTURE_TEST_CASE( autotune3, TestMatrix )
+{
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  char* dat_name;
+  readMtx("data/small/chesapeake.mtx", &row_indices, &col_indices, &values,
+      &nrows, &ncols, &nvals, 0, false, &dat_name);
+
+  graphblas::Matrix<float> a(nrows, ncols);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      dat_name));
+
+  int argc = 7;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0", "--autotune", "2"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, graphblas::GrB_SEQUENTIAL));
+  BOOST_ASSERT( !desc.descriptor_.tuned() );
+
+  graphblas::algorithm::autotune(&a, &desc);
+  BOOST_ASSERT( desc.descriptor_.tuned() );
+  graphblas::TuneProfile tuned = desc.descriptor_.getProfile();
+  BOOST_ASSERT( tuned.lbmode == graphblas::backend::GrB_LOAD_BALANCE_MERGE );
+  BOOST_ASSERT( std::getenv("GRB_LOAD_BALANCE_MODE") == NULL );
+
+  argv[6] = "1";
+  po::variables_map vm_load;
+  parseArgs(argc, argv, &vm_load);
+  graphblas::Descriptor desc_load;
+  CHECKVOID(desc_load.loadArgs(vm_load));
+  BOOST_ASSERT( desc_load.descriptor_.tuned() );
+  graphblas::TuneProfile loaded = desc_load.descriptor_.getProfile();
+  BOOST_ASSERT( loaded.mxvmode == tuned.mxvmode );
+  BOOST_ASSERT_FLOAT( loaded.switchpoint, tuned.switchpoint );
+  BOOST_ASSERT( loaded.lbmode == tuned.lbmode );
+  BOOST_ASSERT( loaded.opreuse == tuned.opreuse );
+
+  std::remove(graphblas::tuneGraph().profile.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,110 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "graphblas/graphblas.hpp"
+#include "graphblas/algorithm/bc.hpp"
+#include "test/test.hpp"
+
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_MODULE bc_suite
+
+#include <boost/test/included/unit_test.hpp>
+#include <boost/program_options.hpp>
+
+// Exact BC, and approximate BC from nsamples sources, match serial Brandes
+// from same sources. Graphs with over 64 vertices run in several batches
+void testBc( char const*            mtx,
+             graphblas::Index       nsamples,
+             graphblas::Desc_value  backend,
+             po::variables_map&     vm )
+{
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  char* dat_name;
+
+  readMtx(mtx, &row_indices, &col_indices, &values, &nrows, &ncols, &nvals, 0,
+      false, &dat_name);
+
+  graphblas::Matrix<float> a(nrows, ncols);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      dat_name));
+  CHECKVOID(a.nrows(&nrows));
+
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, backend));
+
+  std::vector<graphblas::Index> sources(nrows);
+  for (graphblas::Index s = 0; s < nrows; ++s)
+    sources[s] = s;
+  std::vector<float> h_bc_cpu;
+  graphblas::algorithm::bcCpu(&h_bc_cpu, &a, sources);
+
+  graphblas::Vector<float> v(nrows);
+  std::vector<float> h_bc;
+  graphblas::algorithm::bc(&v, &a, &desc);
+  CHECKVOID(v.extractTuples(&h_bc, &nrows));
+  BOOST_ASSERT( graphblas::algorithm::SimpleVerifyBc(nrows, h_bc,
+      h_bc_cpu) == 0 );
+
+  // Sampling every vertex gives exact BC back
+  graphblas::algorithm::bcApprox(&v, &a, nrows, 0, &desc);
+  CHECKVOID(v.extractTuples(&h_bc, &nrows));
+  BOOST_ASSERT( graphblas::algorithm::SimpleVerifyBc(nrows, h_bc,
+      h_bc_cpu) == 0 );
+
+  sources = graphblas::algorithm::bcSample(nrows, nsamples, 0);
+  BOOST_ASSERT( sources.size() == nsamples );
+  graphblas::algorithm::bcCpu(&h_bc_cpu, &a, sources);
+  for (float& val : h_bc_cpu)
+    val *= static_cast<float>(nrows)/nsamples;
+  graphblas::algorithm::bcApprox(&v, &a, nsamples, 0, &desc);
+  CHECKVOID(v.extractTuples(&h_bc, &nrows));
+  BOOST_ASSERT( graphblas::algorithm::SimpleVerifyBc(nrows, h_bc,
+      h_bc_cpu) == 0 );
+}
+
+struct TestBc
+{
+  TestBc() :
+    DEBUG(true) {}
+
+  bool DEBUG;
+};
+
+BOOST_AUTO_TEST_SUITE(bc_suite)
+
+BOOST_FIXTURE_TEST_CASE( bc1, TestBc )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testBc("data/small/test_bc.mtx",   3, graphblas::GrB_SEQUENTIAL, vm);
+  testBc("data/small/test_bc.mtx",   3, graphblas::GrB_CUDA,       vm);
+  testBc("data/small/chesapeake.mtx", 8, graphblas::GrB_SEQUENTIAL, vm);
+  testBc("data/small/simulated_blockmodel_graph_100_nodes.mtx", 70,
+      graphblas::GrB_SEQUENTIAL, vm);
+}
+
+// Batch shrinks with free memory, but always has at least one source
+BOOST_FIXTURE_TEST_CASE( bc2, TestBc )
+{
+  using graphblas::backend::bcBatchWidth;
+  BOOST_ASSERT( bcBatchWidth(1000, 100, size_t(1) << 30) == 64 );
+  BOOST_ASSERT( bcBatchWidth(1000,  10, size_t(1) << 30) == 10 );
+  BOOST_ASSERT( bcBatchWidth(1000, 100, 2*(24000 + 4*32000)) == 4 );
+  BOOST_ASSERT( bcBatchWidth(1000, 100, 0) == 1 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
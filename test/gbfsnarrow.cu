@@ -0,0 +1,217 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <random>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+
+#include <cuda_profiler_api.h>
+
+#include <boost/program_options.hpp>
+
+#include "graphblas/graphblas.hpp"
+#include "graphblas/algorithm/bfs.hpp"
+#include "test/test.hpp"
+
+bool debug_;
+bool memory_;
+
+// Level-synchronous pull BFS on the host, doing per level the same work as
+// the masked logical-or SpMV used by algorithm::bfs: every unvisited row scans
+// its neighbours until it finds one in the frontier. Writes depth (1 for
+// source, 0 if unreached) to depth and returns bytes read and written, so
+// effective bandwidth can be compared across value types.
+template <typename FrontierT, typename DepthT>
+double bfsPull(graphblas::Index        nrows,
+               const graphblas::Index* row_ptr,
+               const graphblas::Index* col_ind,
+               graphblas::Index        source,
+               std::vector<FrontierT>* frontier,
+               std::vector<FrontierT>* next,
+               std::vector<DepthT>*    depth) {
+  std::fill(depth->begin(), depth->end(), static_cast<DepthT>(0));
+  std::fill(frontier->begin(), frontier->end(), static_cast<FrontierT>(0));
+  (*depth)[source]    = static_cast<DepthT>(1);
+  (*frontier)[source] = static_cast<FrontierT>(1);
+
+  double bytes = 0.;
+  graphblas::Index succ = 1;
+  for (DepthT iter = 2; succ > 0; ++iter) {
+    succ = 0;
+    graphblas::Index nedges = 0;
+    for (graphblas::Index row = 0; row < nrows; ++row) {
+      FrontierT discovered = static_cast<FrontierT>(0);
+      if ((*depth)[row] == static_cast<DepthT>(0)) {
+        graphblas::Index edge = row_ptr[row];
+        for (; edge < row_ptr[row+1]; ++edge) {
+          if ((*frontier)[col_ind[edge]] != static_cast<FrontierT>(0)) {
+            discovered = static_cast<FrontierT>(1);
+            break;
+          }
+        }
+        nedges += edge - row_ptr[row];
+        if (discovered != static_cast<FrontierT>(0)) {
+          (*depth)[row] = iter;
+          succ++;
+        }
+      }
+      (*next)[row] = discovered;
+    }
+    frontier->swap(*next);
+
+    // Depth (mask) read and frontier written per row, column index and
+    // frontier read per edge scanned, depth written per discovered vertex
+    bytes += static_cast<double>(nrows)*(sizeof(DepthT)+sizeof(FrontierT)) +
+        static_cast<double>(nedges)*(sizeof(graphblas::Index)+
+        sizeof(FrontierT)) + static_cast<double>(succ)*sizeof(DepthT);
+  }
+  return bytes;
+}
+
+// Runs host pull BFS from every source and prints mean time (ms) and
+// effective bandwidth (GB/s). Depths of last source are written to depth
+template <typename FrontierT, typename DepthT>
+void benchmarkPull(const char*                          str,
+                   graphblas::Matrix<float>*            a,
+                   const std::vector<graphblas::Index>& sources,
+                   std::vector<DepthT>*                 depth) {
+  graphblas::Index nrows = a->matrix_.nrows_;
+  const graphblas::Index* row_ptr = a->matrix_.sparse_.h_csrRowPtr_;
+  const graphblas::Index* col_ind = a->matrix_.sparse_.h_csrColInd_;
+  std::vector<FrontierT> frontier(nrows), next(nrows);
+  depth->resize(nrows);
+
+  // Warmup
+  bfsPull(nrows, row_ptr, col_ind, sources[0], &frontier, &next, depth);
+
+  double bytes = 0.;
+  CpuTimer query;
+  query.Start();
+  for (size_t i = 0; i < sources.size(); i++)
+    bytes += bfsPull(nrows, row_ptr, col_ind, sources[i], &frontier, &next,
+        depth);
+  query.Stop();
+  double elapsed = query.ElapsedMillis();
+  std::cout << str << ", " << elapsed/sources.size() << ", "
+      << bytes/elapsed/1e6 << "\n";
+}
+
+// Compares BFS with float frontiers and depths against narrow types (uint8_t
+// frontiers, uint32_t depths), on the host using the same pull step as the
+// library, and through algorithm::bfs. Symmetric input is assumed, so that
+// CSR can be used for the pull direction.
+int main(int argc, char** argv) {
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+
+  // Parse arguments
+  bool debug;
+  bool transpose;
+  bool mtxinfo;
+  int  directed;
+  int  niter;
+  int  source;
+  char* dat_name;
+  po::variables_map vm;
+
+  // Read in sparse matrix
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s [matrix-market-filename]\n", argv[0]);
+    exit(1);
+  } else {
+    parseArgs(argc, argv, &vm);
+    debug     = vm["debug"    ].as<bool>();
+    transpose = vm["transpose"].as<bool>();
+    mtxinfo   = vm["mtxinfo"  ].as<bool>();
+    directed  = vm["directed" ].as<int>();
+    niter     = vm["niter"    ].as<int>();
+    source    = vm["source"   ].as<int>();
+
+    // This is an imperfect solution, because this should happen in
+    // desc.loadArgs(vm) instead of application code!
+    // TODO: fix this
+    readMtx(argv[argc-1], &row_indices, &col_indices, &values, &nrows, &ncols,
+        &nvals, directed, mtxinfo, &dat_name);
+  }
+
+  // Descriptor desc
+  graphblas::Descriptor desc;
+  CHECK(desc.loadArgs(vm));
+  if (transpose)
+    CHECK(desc.toggle(graphblas::GrB_INP1));
+
+  // Per-level timing output is not wanted here
+  desc.descriptor_.timing_ = 0;
+
+  // Matrix A
+  graphblas::Matrix<float> a(nrows, ncols);
+  CHECK(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      dat_name));
+  CHECK(a.nrows(&nrows));
+  CHECK(a.ncols(&ncols));
+  CHECK(a.nvals(&nvals));
+  if (debug) CHECK(a.print());
+
+  // Source randomization
+  niter = std::max(niter, 1);
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<> dis(0, nrows - 1);
+  std::vector<graphblas::Index> sources(niter);
+  sources[0] = source;
+  for (int i = 1; i < niter; i++)
+    sources[i] = dis(gen);
+
+  // CPU reference for last source
+  graphblas::Index* h_bfs_cpu = reinterpret_cast<graphblas::Index*>(
+      malloc(nrows*sizeof(graphblas::Index)));
+  graphblas::algorithm::bfsCpu(sources[niter-1], &a, h_bfs_cpu, 10000,
+      transpose);
+
+  std::cout << "mode, ms, GB/s\n";
+
+  // Host pull BFS
+  std::vector<float>    depth_float;
+  std::vector<uint32_t> depth_narrow;
+  benchmarkPull<float, float>("cpu float", &a, sources, &depth_float);
+  benchmarkPull<uint8_t, uint32_t>("cpu uint8/uint32", &a, sources,
+      &depth_narrow);
+  BOOST_ASSERT_LIST(h_bfs_cpu, depth_float, nrows);
+  BOOST_ASSERT_LIST(h_bfs_cpu, depth_narrow, nrows);
+
+  // algorithm::bfs
+  graphblas::Vector<float>    v_float(nrows);
+  graphblas::Vector<uint32_t> v_narrow(nrows);
+  graphblas::algorithm::bfs(&v_float, &a, sources[0], &desc);
+  graphblas::algorithm::bfs<uint8_t>(&v_narrow, &a, sources[0], &desc);
+
+  CpuTimer query;
+  query.Start();
+  for (int i = 0; i < niter; i++)
+    graphblas::algorithm::bfs(&v_float, &a, sources[i], &desc);
+  query.Stop();
+  std::cout << "bfs float, " << query.ElapsedMillis()/niter << ", -\n";
+
+  query.Start();
+  for (int i = 0; i < niter; i++)
+    graphblas::algorithm::bfs<uint8_t>(&v_narrow, &a, sources[i], &desc);
+  query.Stop();
+  std::cout << "bfs uint8/uint32, " << query.ElapsedMillis()/niter << ", -\n";
+
+  std::vector<float>    h_bfs_float;
+  std::vector<uint32_t> h_bfs_narrow;
+  CHECK(v_float.extractTuples(&h_bfs_float, &nrows));
+  CHECK(v_narrow.extractTuples(&h_bfs_narrow, &nrows));
+  BOOST_ASSERT_LIST(h_bfs_cpu, h_bfs_float, nrows);
+  BOOST_ASSERT_LIST(h_bfs_cpu, h_bfs_narrow, nrows);
+  free(h_bfs_cpu);
+
+  return 0;
+}
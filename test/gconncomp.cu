@@ -0,0 +1,140 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <iostream>
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "graphblas/graphblas.hpp"
+#include "graphblas/algorithm/cc.hpp"
+#include "test/test.hpp"
+
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_MODULE cc_suite
+
+#include <boost/test/included/unit_test.hpp>
+#include <boost/program_options.hpp>
+
+// Components found by given backend, with or without sampling, match CPU
+// union-find and known count, and are labeled by their smallest vertex
+void testCc( char const*            mtx,
+             int                    correct,
+             int                    nsample,
+             graphblas::Desc_value  backend,
+             po::variables_map&     vm )
+{
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  char* dat_name;
+
+  readMtx(mtx, &row_indices, &col_indices, &values, &nrows, &ncols, &nvals, 2,
+      false, &dat_name);
+  values.assign(nvals, 1.f);
+
+  graphblas::Matrix<float> a(nrows, ncols);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      dat_name));
+  CHECKVOID(a.nrows(&nrows));
+
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, backend));
+
+  graphblas::Vector<int> v(nrows);
+  graphblas::algorithm::cc(&v, &a, nsample, &desc);
+
+  std::vector<int> h_cc;
+  CHECKVOID(v.extractTuples(&h_cc, &nrows));
+  std::vector<int> h_cc_cpu;
+  graphblas::algorithm::ccCpu(&h_cc_cpu, &a);
+  BOOST_ASSERT( graphblas::algorithm::SimpleVerifyCc(nrows, h_cc,
+      h_cc_cpu) == 0 );
+  BOOST_ASSERT_LIST( h_cc, h_cc_cpu, nrows );
+  BOOST_ASSERT( static_cast<int>(std::set<int>(h_cc.begin(),
+      h_cc.end()).size()) == correct );
+}
+
+// Gather w = u[indices] and scatter w[indices] min= u, with repeated indices
+void testIndexVector( graphblas::Desc_value backend,
+                      po::variables_map&    vm )
+{
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, backend));
+
+  graphblas::Index n = 5;
+  std::vector<int> u_val{ 10, 11, 12, 13, 14 };
+  std::vector<int> ind_val{ 4, 0, 4, 2, 1 };
+  graphblas::Vector<int> u(n), ind(n), w(n);
+  CHECKVOID(u.build(&u_val, n));
+  CHECKVOID(ind.build(&ind_val, n));
+
+  CHECKVOID((graphblas::extract<int, int, int>(&w, GrB_NULL, GrB_NULL, &u,
+      &ind, &desc)));
+  std::vector<int> h_w;
+  std::vector<int> correct{ 14, 10, 14, 12, 11 };
+  CHECKVOID(w.extractTuples(&h_w, &n));
+  BOOST_ASSERT_LIST( h_w, correct, n );
+
+  std::vector<int> w_val{ 20, 20, 20, 20, 20 };
+  CHECKVOID(w.build(&w_val, n));
+  CHECKVOID((graphblas::assign<int, int, int>(&w, GrB_NULL,
+      graphblas::MinimumMonoid<int>(), &u, &ind, &desc)));
+  correct = { 11, 14, 13, 20, 10 };
+  CHECKVOID(w.extractTuples(&h_w, &n));
+  BOOST_ASSERT_LIST( h_w, correct, n );
+
+  // std::vector indices go through same path
+  std::vector<graphblas::Index> indices{ 3, 1 };
+  graphblas::Vector<int> x(2);
+  CHECKVOID((graphblas::extract<int, int, int>(&x, GrB_NULL, GrB_NULL, &u,
+      &indices, 2, &desc)));
+  correct = { 13, 11 };
+  graphblas::Index two = 2;
+  CHECKVOID(x.extractTuples(&h_w, &two));
+  BOOST_ASSERT_LIST( h_w, correct, two );
+}
+
+struct TestCc
+{
+  TestCc() :
+    DEBUG(true) {}
+
+  bool DEBUG;
+};
+
+BOOST_AUTO_TEST_SUITE(cc_suite)
+
+BOOST_FIXTURE_TEST_CASE( cc1, TestCc )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testIndexVector(graphblas::GrB_SEQUENTIAL, vm);
+  testIndexVector(graphblas::GrB_CUDA,       vm);
+}
+
+BOOST_FIXTURE_TEST_CASE( cc2, TestCc )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testCc("data/small/test_cc.mtx",    2, 0, graphblas::GrB_SEQUENTIAL, vm);
+  testCc("data/small/test_cc.mtx",    2, 0, graphblas::GrB_CUDA,       vm);
+  testCc("data/small/test_cc.mtx",    2, 2, graphblas::GrB_SEQUENTIAL, vm);
+  testCc("data/small/test_cc.mtx",    2, 2, graphblas::GrB_CUDA,       vm);
+  testCc("data/small/chesapeake.mtx", 1, 2, graphblas::GrB_SEQUENTIAL, vm);
+  testCc("data/small/chesapeake.mtx", 1, 2, graphblas::GrB_CUDA,       vm);
+  testCc("data/small/test_mesh.mtx",  1, 1, graphblas::GrB_SEQUENTIAL, vm);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,156 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "graphblas/graphblas.hpp"
+#include "graphblas/algorithm/sssp.hpp"
+#include "test/test.hpp"
+
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_MODULE deltastep_suite
+
+#include <boost/test/included/unit_test.hpp>
+#include <boost/program_options.hpp>
+
+// Weights between 1 and 64 that do not depend on random number generator
+void readWeighted( char const*                    mtx,
+                   std::vector<graphblas::Index>* row_indices,
+                   std::vector<graphblas::Index>* col_indices,
+                   std::vector<float>*            values,
+                   graphblas::Index*              nrows,
+                   graphblas::Index*              nvals )
+{
+  graphblas::Index ncols;
+  char* dat_name;
+
+  readMtx(mtx, row_indices, col_indices, values, nrows, &ncols, nvals, 0,
+      false, &dat_name);
+  free(dat_name);
+  for (graphblas::Index i = 0; i < *nvals; ++i)
+    (*values)[i] = static_cast<float>(1 + ((*row_indices)[i]*37 +
+        (*col_indices)[i]*11) % 64);
+}
+
+// Delta-stepping distances match Dijkstra for buckets narrower than any
+// edge, in between, and wider than all of them (Bellman-Ford)
+void testDeltaStep( char const*            mtx,
+                    float                  delta,
+                    graphblas::Index       source,
+                    graphblas::Desc_value  backend,
+                    po::variables_map&     vm )
+{
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, nvals;
+  readWeighted(mtx, &row_indices, &col_indices, &values, &nrows, &nvals);
+
+  graphblas::Matrix<float> a(nrows, nrows);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      NULL));
+
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, backend));
+
+  graphblas::Vector<float> v(nrows);
+  graphblas::algorithm::ssspDelta(&v, &a, source, delta, &desc);
+
+  std::vector<float> h_sssp;
+  CHECKVOID(v.extractTuples(&h_sssp, &nrows));
+  std::vector<float> h_sssp_cpu(nrows);
+  graphblas::algorithm::ssspCpu(source, &a, h_sssp_cpu.data(), 10000);
+  BOOST_ASSERT_LIST( h_sssp_cpu, h_sssp, nrows );
+}
+
+// Light and heavy parts of select split every edge between them
+void testSelect( char const*            mtx,
+                 float                  delta,
+                 graphblas::Desc_value  backend,
+                 po::variables_map&     vm )
+{
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, nvals;
+  readWeighted(mtx, &row_indices, &col_indices, &values, &nrows, &nvals);
+
+  graphblas::Matrix<float> a(nrows, nrows);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      NULL));
+  CHECKVOID(a.nvals(&nvals));
+
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, backend));
+
+  graphblas::Matrix<float> light(nrows, nrows);
+  graphblas::Matrix<float> heavy(nrows, nrows);
+  CHECKVOID((graphblas::select<float, float, float>(&light, GrB_NULL,
+      GrB_NULL, graphblas::less_equal<float>(), &a, delta, &desc)));
+  CHECKVOID((graphblas::select<float, float, float>(&heavy, GrB_NULL,
+      GrB_NULL, graphblas::greater<float>(), &a, delta, &desc)));
+
+  std::vector<graphblas::Index> row, col;
+  std::vector<float> val;
+  graphblas::Index light_nvals, heavy_nvals;
+  CHECKVOID(light.nvals(&light_nvals));
+  CHECKVOID(heavy.nvals(&heavy_nvals));
+  BOOST_ASSERT( light_nvals + heavy_nvals == nvals );
+  CHECKVOID(light.extractTuples(&row, &col, &val, &light_nvals));
+  for (float weight : val)
+    BOOST_ASSERT( weight <= delta );
+  CHECKVOID(heavy.extractTuples(&row, &col, &val, &heavy_nvals));
+  for (float weight : val)
+    BOOST_ASSERT( weight > delta );
+}
+
+struct TestDeltaStep
+{
+  TestDeltaStep() :
+    DEBUG(true) {}
+
+  bool DEBUG;
+};
+
+BOOST_AUTO_TEST_SUITE(deltastep_suite)
+
+BOOST_FIXTURE_TEST_CASE( deltastep1, TestDeltaStep )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testSelect("data/small/chesapeake.mtx", 20.f, graphblas::GrB_SEQUENTIAL, vm);
+  testSelect("data/small/chesapeake.mtx", 20.f, graphblas::GrB_CUDA,       vm);
+}
+
+BOOST_FIXTURE_TEST_CASE( deltastep2, TestDeltaStep )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testDeltaStep("data/small/chesapeake.mtx",  0.f,   0,
+      graphblas::GrB_SEQUENTIAL, vm);
+  testDeltaStep("data/small/chesapeake.mtx",  0.5f,  3,
+      graphblas::GrB_SEQUENTIAL, vm);
+  testDeltaStep("data/small/chesapeake.mtx",  16.f,  7,
+      graphblas::GrB_SEQUENTIAL, vm);
+  testDeltaStep("data/small/chesapeake.mtx",  100.f, 0,
+      graphblas::GrB_SEQUENTIAL, vm);
+  testDeltaStep("data/small/test_cc.mtx",     8.f,   0,
+      graphblas::GrB_SEQUENTIAL, vm);
+  testDeltaStep("data/small/chesapeake.mtx",  16.f,  0,
+      graphblas::GrB_CUDA,       vm);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,87 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <boost/program_options.hpp>
+
+#include "graphblas/graphblas.hpp"
+#include "test/test.hpp"
+
+// Per-query cost of getting a Descriptor ready for a small CPU reduce, either
+// by constructing and loading it from options every time, or by copying one
+// loaded once, with or without typed setters on the copy. Reduce alone is
+// timed too, so that overhead can be told apart from work
+int main( int argc, char** argv )
+{
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  // Queries are tiny, so each timed loop runs 1000 of them per "niter"
+  int niter = 1000*vm["niter"].as<int>();
+
+  graphblas::Index nrows = 1000;
+  std::vector<float> vec(nrows, 1.f);
+  graphblas::Vector<float> u(nrows);
+  CHECK( u.build(&vec, nrows) );
+
+  graphblas::Descriptor base;
+  CHECK( base.loadArgs(vm) );
+  CHECK( base.set(graphblas::GrB_BACKEND, graphblas::GrB_SEQUENTIAL) );
+
+  float val;
+  CHECK( graphblas::reduce<float, float>(&val, GrB_NULL,
+      graphblas::PlusMonoid<float>(), &u, &base) );
+
+  CpuTimer timer;
+  timer.Start();
+  for (int i = 0; i < niter; ++i) {
+    CHECK( graphblas::reduce<float, float>(&val, GrB_NULL,
+        graphblas::PlusMonoid<float>(), &u, &base) );
+  }
+  timer.Stop();
+  float reduce_only = timer.ElapsedMillis();
+
+  timer.Start();
+  for (int i = 0; i < niter; ++i) {
+    graphblas::Descriptor desc;
+    CHECK( desc.loadArgs(vm) );
+    CHECK( desc.set(graphblas::GrB_BACKEND, graphblas::GrB_SEQUENTIAL) );
+    CHECK( graphblas::reduce<float, float>(&val, GrB_NULL,
+        graphblas::PlusMonoid<float>(), &u, &desc) );
+  }
+  timer.Stop();
+  float load_args = timer.ElapsedMillis();
+
+  timer.Start();
+  for (int i = 0; i < niter; ++i) {
+    graphblas::Descriptor desc(base);
+    CHECK( graphblas::reduce<float, float>(&val, GrB_NULL,
+        graphblas::PlusMonoid<float>(), &u, &desc) );
+  }
+  timer.Stop();
+  float copy = timer.ElapsedMillis();
+
+  timer.Start();
+  for (int i = 0; i < niter; ++i) {
+    graphblas::Descriptor desc(base);
+    CHECK( desc.setMxvMode(2) );
+    CHECK( desc.setEarlyexit(true) );
+    CHECK( desc.setSwitchpoint(0.05f) );
+    CHECK( graphblas::reduce<float, float>(&val, GrB_NULL,
+        graphblas::PlusMonoid<float>(), &u, &desc) );
+  }
+  timer.Stop();
+  float copy_set = timer.ElapsedMillis();
+
+  std::cout << "queries, " << niter << std::endl;
+  std::cout << "reduce only, "        << 1000.f*reduce_only/niter << " us\n";
+  std::cout << "construct+loadArgs, " << 1000.f*load_args/niter   << " us\n";
+  std::cout << "copy, "               << 1000.f*copy/niter        << " us\n";
+  std::cout << "copy+setters, "       << 1000.f*copy_set/niter    << " us\n";
+  return 0;
+}
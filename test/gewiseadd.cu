@@ -347,6 +347,130 @@ void testeWiseMultVectorSparsemaskSparseDense(
   BOOST_ASSERT_LIST( values, correct_val, mask_nvals );
 }
 
+// Masked dense x dense and sparse x dense on CPU, plain and complemented
+// sparse mask. Entries left out by mask are identity
+void testeWiseAddVectorSparsemaskCpu(
+    const std::vector<graphblas::Index>& mask_ind,
+    const std::vector<graphblas::Index>& u_ind,
+    const std::vector<float>&            u_val,
+    const std::vector<float>&            v_val,
+    po::variables_map&                   vm )
+{
+  std::vector<float> values;
+  graphblas::Index nvals = v_val.size();
+
+  std::vector<float> u_dense(nvals, 0.f);
+  for (graphblas::Index i = 0; i < u_ind.size(); ++i)
+    u_dense[u_ind[i]] = u_val[i];
+
+  std::vector<float> mask_val(mask_ind.size(), 1.f);
+  graphblas::Vector<float> mask(nvals);
+  CHECKVOID(mask.build(&mask_ind, &mask_val, mask_ind.size(), GrB_NULL));
+
+  for (int use_scmp = 0; use_scmp < 2; ++use_scmp)
+  {
+    std::vector<float> correct(nvals, 0.f);
+    for (graphblas::Index i = 0; i < nvals; ++i)
+    {
+      bool in_mask = std::find(mask_ind.begin(), mask_ind.end(), i) !=
+          mask_ind.end();
+      if (in_mask != static_cast<bool>(use_scmp))
+        correct[i] = u_dense[i] + v_val[i];
+    }
+
+    graphblas::Descriptor desc;
+    CHECKVOID(desc.loadArgs(vm));
+    CHECKVOID(desc.set(graphblas::GrB_BACKEND, graphblas::GrB_SEQUENTIAL));
+    if (use_scmp)
+      CHECKVOID(desc.set(graphblas::GrB_MASK, graphblas::GrB_SCMP));
+
+    for (int u_sparse = 0; u_sparse < 2; ++u_sparse)
+    {
+      graphblas::Vector<float> u(nvals);
+      if (u_sparse)
+        CHECKVOID(u.build(&u_ind, &u_val, u_ind.size(), GrB_NULL));
+      else
+        CHECKVOID(u.build(&u_dense, nvals));
+      graphblas::Vector<float> v(nvals);
+      CHECKVOID(v.build(&v_val, nvals));
+
+      graphblas::Vector<float> vec(nvals);
+      CHECKVOID(graphblas::eWiseAdd<float, float, float, float>(&vec, &mask,
+          GrB_NULL, graphblas::PlusMultipliesSemiring<float>(), &u, &v,
+          &desc));
+
+      graphblas::Index nvals_t = nvals;
+      CHECKVOID(vec.extractTuples(&values, &nvals_t));
+      BOOST_ASSERT( nvals == nvals_t );
+      BOOST_ASSERT_LIST( values, correct, nvals );
+    }
+  }
+}
+
+// w = w + mask .* (u + v) on CPU, where entries left out by mask keep w
+// unless GrB_REPLACE, which sets them to identity
+void testeWiseAddVectorAccumCpu(
+    const std::vector<graphblas::Index>& mask_ind,
+    const std::vector<graphblas::Index>& u_ind,
+    const std::vector<float>&            u_val,
+    const std::vector<float>&            v_val,
+    const std::vector<float>&            w_val,
+    po::variables_map&                   vm )
+{
+  std::vector<float> values;
+  graphblas::Index nvals = v_val.size();
+
+  std::vector<float> u_dense(nvals, 0.f);
+  for (graphblas::Index i = 0; i < u_ind.size(); ++i)
+    u_dense[u_ind[i]] = u_val[i];
+
+  std::vector<float> mask_val(mask_ind.size(), 1.f);
+  graphblas::Vector<float> mask(nvals);
+  CHECKVOID(mask.build(&mask_ind, &mask_val, mask_ind.size(), GrB_NULL));
+
+  for (int use_repl = 0; use_repl < 2; ++use_repl)
+  {
+    std::vector<float> correct(nvals, 0.f);
+    for (graphblas::Index i = 0; i < nvals; ++i)
+    {
+      bool in_mask = std::find(mask_ind.begin(), mask_ind.end(), i) !=
+          mask_ind.end();
+      if (in_mask)
+        correct[i] = w_val[i] + u_dense[i] + v_val[i];
+      else if (!use_repl)
+        correct[i] = w_val[i];
+    }
+
+    graphblas::Descriptor desc;
+    CHECKVOID(desc.loadArgs(vm));
+    CHECKVOID(desc.set(graphblas::GrB_BACKEND, graphblas::GrB_SEQUENTIAL));
+    if (use_repl)
+      CHECKVOID(desc.set(graphblas::GrB_OUTP, graphblas::GrB_REPLACE));
+
+    for (int u_sparse = 0; u_sparse < 2; ++u_sparse)
+    {
+      graphblas::Vector<float> u(nvals);
+      if (u_sparse)
+        CHECKVOID(u.build(&u_ind, &u_val, u_ind.size(), GrB_NULL));
+      else
+        CHECKVOID(u.build(&u_dense, nvals));
+      graphblas::Vector<float> v(nvals);
+      CHECKVOID(v.build(&v_val, nvals));
+      graphblas::Vector<float> vec(nvals);
+      CHECKVOID(vec.build(&w_val, nvals));
+
+      CHECKVOID(graphblas::eWiseAdd<float, float, float, float>(&vec, &mask,
+          graphblas::PlusMonoid<float>(),
+          graphblas::PlusMultipliesSemiring<float>(), &u, &v, &desc));
+
+      graphblas::Index nvals_t = nvals;
+      CHECKVOID(vec.extractTuples(&values, &nvals_t));
+      BOOST_ASSERT( nvals == nvals_t );
+      BOOST_ASSERT_LIST( values, correct, nvals );
+    }
+  }
+}
+
 struct TestMatrix
 {
   TestMatrix() :
@@ -461,4 +585,31 @@ BOOST_FIXTURE_TEST_CASE( dup11, TestMatrix )
   testeWiseAddVectorNomaskSparseSparseInplace(u_ind, u_val, v_ind, v_val, 10, 3, vm);
 }
 
+BOOST_FIXTURE_TEST_CASE( dup12, TestMatrix )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  std::vector<graphblas::Index> mask_ind{ 0,  2,  5,  8 };
+  std::vector<graphblas::Index> u_ind   { 1,  2,  5,  6,  7,  8 };
+  std::vector<float>            u_val   { 3., 2., 2., 1., 3., 1.};
+  std::vector<float>            v_val   { 3., 2., 2., 3., 0., 0., 4., 2., 2.};
+  testeWiseAddVectorSparsemaskCpu(mask_ind, u_ind, u_val, v_val, vm);
+}
+
+BOOST_FIXTURE_TEST_CASE( dup13, TestMatrix )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  std::vector<graphblas::Index> mask_ind{ 0,  2,  5,  8 };
+  std::vector<graphblas::Index> u_ind   { 1,  2,  5,  6,  7,  8 };
+  std::vector<float>            u_val   { 3., 2., 2., 1., 3., 1.};
+  std::vector<float>            v_val   { 3., 2., 2., 3., 0., 0., 4., 2., 2.};
+  std::vector<float>            w_val   { 1., 5., 1., 2., 3., 4., 1., 2., 7.};
+  testeWiseAddVectorAccumCpu(mask_ind, u_ind, u_val, v_val, w_val, vm);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
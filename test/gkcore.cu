@@ -0,0 +1,210 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "graphblas/graphblas.hpp"
+#include "graphblas/algorithm/kcore.hpp"
+#include "graphblas/algorithm/ktruss.hpp"
+#include "test/test.hpp"
+
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_MODULE kcore_suite
+
+#include <boost/test/included/unit_test.hpp>
+#include <boost/program_options.hpp>
+
+// Reads mtx as undirected graph with 1 for each edge, as for tc
+void readUnit( char const*                    mtx,
+               std::vector<graphblas::Index>* row_indices,
+               std::vector<graphblas::Index>* col_indices,
+               std::vector<float>*            values,
+               graphblas::Index*              nrows,
+               graphblas::Index*              nvals,
+               char**                         dat_name )
+{
+  graphblas::Index ncols;
+  readMtx(mtx, row_indices, col_indices, values, nrows, &ncols, nvals, 2,
+      false, dat_name);
+  values->assign(*nvals, 1.f);
+}
+
+// Core numbers from bucketed peeling match Batagelj-Zaversnik
+void testKcore( char const*            mtx,
+                graphblas::Desc_value  backend,
+                po::variables_map&     vm )
+{
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, nvals;
+  char* dat_name;
+  readUnit(mtx, &row_indices, &col_indices, &values, &nrows, &nvals,
+      &dat_name);
+
+  graphblas::Matrix<float> a(nrows, nrows);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      dat_name));
+
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, backend));
+
+  graphblas::Vector<float> v(nrows);
+  graphblas::algorithm::kcore(&v, &a, &desc);
+
+  std::vector<float> core;
+  graphblas::Index nrows_t = nrows;
+  CHECKVOID(v.extractTuples(&core, &nrows_t));
+  BOOST_ASSERT( nrows_t == nrows );
+
+  std::vector<float> correct;
+  graphblas::algorithm::kcoreCpu(&correct, &a);
+  BOOST_ASSERT_LIST( correct, core, nrows );
+}
+
+// Edges of k-truss and their support match reference peeling
+void testKtruss( char const*            mtx,
+                 graphblas::Index       k,
+                 graphblas::Desc_value  backend,
+                 po::variables_map&     vm )
+{
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, nvals;
+  char* dat_name;
+  readUnit(mtx, &row_indices, &col_indices, &values, &nrows, &nvals,
+      &dat_name);
+
+  graphblas::Matrix<float> a(nrows, nrows);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      dat_name));
+
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, backend));
+
+  graphblas::Matrix<float> c(nrows, nrows);
+  graphblas::algorithm::ktruss(&c, &a, k, &desc);
+
+  std::vector<graphblas::Index> support;
+  graphblas::algorithm::ktrussCpu(&support, &a, k);
+
+  graphblas::Index c_nvals;
+  CHECKVOID(c.nvals(&c_nvals));
+  CHECKVOID(c.extractTuples(&row_indices, &col_indices, &values, &c_nvals));
+
+  graphblas::Index* row_ptr = a.matrix_.sparse_.h_csrRowPtr_;
+  graphblas::Index* col_ind = a.matrix_.sparse_.h_csrColInd_;
+  graphblas::Index correct_nvals = 0;
+  for (graphblas::Index edge = 0; edge < row_ptr[nrows]; ++edge)
+    if (support[edge] >= 0)
+      correct_nvals++;
+  BOOST_ASSERT( c_nvals == correct_nvals );
+
+  for (graphblas::Index i = 0; i < c_nvals; ++i) {
+    graphblas::Index row = row_indices[i];
+    graphblas::Index* edge = std::lower_bound(col_ind + row_ptr[row],
+        col_ind + row_ptr[row+1], col_indices[i]);
+    BOOST_ASSERT( edge != col_ind + row_ptr[row+1] );
+    BOOST_ASSERT( values[i] == support[edge - col_ind] );
+  }
+}
+
+// Select into its own input prunes CSR and CSC in place, and gives same
+// matrix as select into another one
+void testSelectInPlace( char const*         mtx,
+                        po::variables_map&  vm )
+{
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  char* dat_name;
+  readMtx(mtx, &row_indices, &col_indices, &values, &nrows, &ncols, &nvals, 0,
+      false, &dat_name);
+  free(dat_name);
+  for (graphblas::Index i = 0; i < nvals; ++i)
+    values[i] = static_cast<float>((row_indices[i] + col_indices[i]) % 5);
+
+  graphblas::Matrix<float> a(nrows, ncols);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      NULL));
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+
+  graphblas::Matrix<float> b(nrows, ncols);
+  CHECKVOID((graphblas::select<float, float, float>(&b, GrB_NULL, GrB_NULL,
+      graphblas::greater_equal<float>(), &a, 2.f, &desc)));
+  graphblas::Index* a_col_ptr = a.matrix_.sparse_.h_cscColPtr_;
+  CHECKVOID((graphblas::select<float, float, float>(&a, GrB_NULL, GrB_NULL,
+      graphblas::greater_equal<float>(), &a, 2.f, &desc)));
+
+  graphblas::Index a_nvals, b_nvals;
+  CHECKVOID(a.nvals(&a_nvals));
+  CHECKVOID(b.nvals(&b_nvals));
+  BOOST_ASSERT( a_nvals == b_nvals );
+  BOOST_ASSERT( a_nvals < nvals );
+  BOOST_ASSERT( a.matrix_.sparse_.h_cscColPtr_ == a_col_ptr );
+
+  graphblas::backend::SparseMatrix<float>& a_sp = a.matrix_.sparse_;
+  graphblas::backend::SparseMatrix<float>& b_sp = b.matrix_.sparse_;
+  BOOST_ASSERT_LIST( a_sp.h_csrRowPtr_, b_sp.h_csrRowPtr_, nrows + 1 );
+  BOOST_ASSERT_LIST( a_sp.h_csrColInd_, b_sp.h_csrColInd_, a_nvals );
+  BOOST_ASSERT_LIST( a_sp.h_csrVal_,    b_sp.h_csrVal_,    a_nvals );
+  BOOST_ASSERT_LIST( a_sp.h_cscColPtr_, b_sp.h_cscColPtr_, ncols + 1 );
+  BOOST_ASSERT_LIST( a_sp.h_cscRowInd_, b_sp.h_cscRowInd_, a_nvals );
+  BOOST_ASSERT_LIST( a_sp.h_cscVal_,    b_sp.h_cscVal_,    a_nvals );
+}
+
+struct TestKcore
+{
+  TestKcore() :
+    DEBUG(true) {}
+
+  bool DEBUG;
+};
+
+BOOST_AUTO_TEST_SUITE(kcore_suite)
+
+BOOST_FIXTURE_TEST_CASE( kcore1, TestKcore )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testKcore("data/small/chesapeake.mtx", graphblas::GrB_SEQUENTIAL, vm);
+  testKcore("data/small/chesapeake.mtx", graphblas::GrB_CUDA,       vm);
+  testKcore("data/small/test_cc.mtx",    graphblas::GrB_SEQUENTIAL, vm);
+  testKcore("data/small/test_mesh.mtx",  graphblas::GrB_SEQUENTIAL, vm);
+}
+
+BOOST_FIXTURE_TEST_CASE( kcore2, TestKcore )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testKtruss("data/small/chesapeake.mtx", 3, graphblas::GrB_SEQUENTIAL, vm);
+  testKtruss("data/small/chesapeake.mtx", 4, graphblas::GrB_SEQUENTIAL, vm);
+  testKtruss("data/small/chesapeake.mtx", 5, graphblas::GrB_CUDA,       vm);
+  testKtruss("data/small/test_cc.mtx",    3, graphblas::GrB_SEQUENTIAL, vm);
+}
+
+BOOST_FIXTURE_TEST_CASE( kcore3, TestKcore )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testSelectInPlace("data/small/chesapeake.mtx", vm);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,209 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <vector>
+#include <iostream>
+
+#include "graphblas/graphblas.hpp"
+#include "test/test.hpp"
+
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_MODULE memory_suite
+
+#include <boost/test/included/unit_test.hpp>
+#include <boost/program_options.hpp>
+
+using namespace graphblas;
+
+struct TestMemory {
+  TestMemory() :
+    DEBUG(true) {}
+
+  bool DEBUG;
+};
+
+BOOST_AUTO_TEST_SUITE(memory_suite)
+
+// Matrix allocations show up in tracker and are returned when it is destroyed
+BOOST_FIXTURE_TEST_CASE(memory1, TestMemory) {
+  Descriptor desc;
+  backend::MemoryStats before, during, after;
+  CHECKVOID(desc.getMemory(backend::GrB_MEMORY_DEVICE,
+      backend::GrB_MEMORY_MATRIX, &before));
+
+  size_t h_bytes, d_bytes;
+  {
+    std::vector<Index> row_indices = {0, 1, 2, 3, 3};
+    std::vector<Index> col_indices = {1, 2, 3, 0, 1};
+    std::vector<float> values      = {1.f, 1.f, 1.f, 1.f, 1.f};
+    Matrix<float> a(4, 4);
+    CHECKVOID(a.build(&row_indices, &col_indices, &values, 5, GrB_NULL));
+    CHECKVOID(a.getMemory(backend::GrB_MEMORY_HOST,   &h_bytes));
+    CHECKVOID(a.getMemory(backend::GrB_MEMORY_DEVICE, &d_bytes));
+    BOOST_ASSERT(h_bytes >= 5*(sizeof(Index) + sizeof(float)));
+    BOOST_ASSERT(d_bytes >= 5*(sizeof(Index) + sizeof(float)));
+
+    CHECKVOID(desc.getMemory(backend::GrB_MEMORY_DEVICE,
+        backend::GrB_MEMORY_MATRIX, &during));
+    BOOST_ASSERT(during.current == before.current + d_bytes);
+    BOOST_ASSERT(during.peak    >= during.current);
+  }
+
+  CHECKVOID(desc.getMemory(backend::GrB_MEMORY_DEVICE,
+      backend::GrB_MEMORY_MATRIX, &after));
+  BOOST_ASSERT(after.current == before.current);
+  BOOST_ASSERT(after.nfree   >  before.nfree);
+  BOOST_ASSERT(after.peak    >= before.current + d_bytes);
+}
+
+// Vector allocations are counted separately from matrix allocations
+BOOST_FIXTURE_TEST_CASE(memory2, TestMemory) {
+  Descriptor desc;
+  backend::MemoryStats vec_before, vec_after, mat_before, mat_after;
+  CHECKVOID(desc.getMemory(backend::GrB_MEMORY_DEVICE,
+      backend::GrB_MEMORY_VECTOR, &vec_before));
+  CHECKVOID(desc.getMemory(backend::GrB_MEMORY_DEVICE,
+      backend::GrB_MEMORY_MATRIX, &mat_before));
+
+  Vector<float> v(1000);
+  CHECKVOID(v.fill(0.f));
+
+  CHECKVOID(desc.getMemory(backend::GrB_MEMORY_DEVICE,
+      backend::GrB_MEMORY_VECTOR, &vec_after));
+  CHECKVOID(desc.getMemory(backend::GrB_MEMORY_DEVICE,
+      backend::GrB_MEMORY_MATRIX, &mat_after));
+  BOOST_ASSERT(vec_after.current >= vec_before.current + 1000*sizeof(float));
+  BOOST_ASSERT(mat_after.current == mat_before.current);
+}
+
+// Category GrB_MEMORY_ALL is sum over categories
+BOOST_FIXTURE_TEST_CASE(memory3, TestMemory) {
+  Descriptor desc;
+  Vector<float> v(1000);
+  CHECKVOID(v.fill(0.f));
+
+  for (int space = 0; space < backend::GrB_MEMORY_NSPACE; ++space) {
+    backend::MemoryStats total, stats;
+    size_t sum = 0;
+    for (int category = 0; category < backend::GrB_MEMORY_ALL; ++category) {
+      CHECKVOID(desc.getMemory(static_cast<backend::MemorySpace>(space),
+          static_cast<backend::MemoryCategory>(category), &stats));
+      sum += stats.current;
+    }
+    CHECKVOID(desc.getMemory(static_cast<backend::MemorySpace>(space),
+        backend::GrB_MEMORY_ALL, &total));
+    BOOST_ASSERT(total.current == sum);
+  }
+}
+
+// dup shares memory with its source until one of them is written to
+BOOST_FIXTURE_TEST_CASE(memory4, TestMemory) {
+  Descriptor desc;
+  backend::MemoryStats before, after;
+  std::vector<Index> row_indices = {0, 1, 2, 3, 3};
+  std::vector<Index> col_indices = {1, 2, 3, 0, 1};
+  std::vector<float> values      = {1.f, 2.f, 3.f, 4.f, 5.f};
+  Matrix<float> a(4, 4);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, 5, GrB_NULL));
+
+  CHECKVOID(desc.getMemory(backend::GrB_MEMORY_DEVICE,
+      backend::GrB_MEMORY_MATRIX, &before));
+  Matrix<float> b(4, 4);
+  CHECKVOID(b.dup(&a));
+  CHECKVOID(desc.getMemory(backend::GrB_MEMORY_DEVICE,
+      backend::GrB_MEMORY_MATRIX, &after));
+  BOOST_ASSERT(after.current == before.current);
+
+  // Writing to a gives it its own copy, so b is unchanged
+  CHECKVOID(a.setElement(6.f, 0, 0));
+  CHECKVOID(a.compact());
+  float val;
+  BOOST_ASSERT(b.extractElement(&val, 0, 0) == GrB_NO_VALUE);
+  CHECKVOID(a.extractElement(&val, 0, 0));
+  BOOST_ASSERT(val == 6.f);
+
+  std::vector<Index> out_rows, out_cols;
+  std::vector<float> out_vals;
+  Index nvals = 5;
+  CHECKVOID(b.extractTuples(&out_rows, &out_cols, &out_vals, &nvals));
+  BOOST_ASSERT_LIST(out_rows, row_indices, 5);
+  BOOST_ASSERT_LIST(out_cols, col_indices, 5);
+  BOOST_ASSERT_LIST(out_vals, values, 5);
+}
+
+// swap and moves exchange storage without copying, even for different
+// storage types
+BOOST_FIXTURE_TEST_CASE(memory5, TestMemory) {
+  std::vector<float> values = {1.f, 2.f, 3.f};
+  Vector<float> u(3);
+  Vector<float> v(3);
+  CHECKVOID(u.build(&values, 3));
+  const float* d_val = u.vector_.dense_.d_val_;
+
+  CHECKVOID(v.swap(&u));
+  Storage u_type, v_type;
+  CHECKVOID(u.getStorage(&u_type));
+  CHECKVOID(v.getStorage(&v_type));
+  BOOST_ASSERT(u_type == GrB_UNKNOWN);
+  BOOST_ASSERT(v_type == GrB_DENSE);
+  BOOST_ASSERT(v.vector_.dense_.d_val_ == d_val);
+
+  Vector<float> w(std::move(v));
+  BOOST_ASSERT(w.vector_.dense_.d_val_ == d_val);
+  std::vector<float> out;
+  Index nvals = 3;
+  CHECKVOID(w.extractTuples(&out, &nvals));
+  BOOST_ASSERT_LIST(out, values, 3);
+}
+
+// Accumulating into dense dup of a vector leaves source alone, for output
+// that is already dense and so skips conversion
+BOOST_FIXTURE_TEST_CASE(memory6, TestMemory) {
+  std::vector<Index> row_indices = {0, 1, 2, 3};
+  std::vector<Index> col_indices = {1, 2, 3, 0};
+  std::vector<float> values      = {1.f, 1.f, 1.f, 1.f};
+  Matrix<float> a(4, 4);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, 4, GrB_NULL));
+
+  std::vector<float> u_val = {1.f, 2.f, 3.f, 4.f};
+  std::vector<int>   ind_val = {3, 2, 1, 0};
+  std::vector<int>   w_val = {0, 0, 0, 0};
+  Desc_value backends[] = {GrB_CUDA, GrB_SEQUENTIAL};
+  for (int i = 0; i < 2; ++i) {
+    Descriptor desc;
+    CHECKVOID(desc.set(GrB_BACKEND, backends[i]));
+    CHECKVOID(desc.set(GrB_MXVMODE, GrB_PULLONLY));
+
+    Vector<float> u(4), v(4);
+    CHECKVOID(u.build(&u_val, 4));
+    CHECKVOID(v.dup(&u));
+    CHECKVOID((mxv<float, float, float, float>(&v, GrB_NULL,
+        PlusMonoid<float>(), PlusMultipliesSemiring<float>(), &a, &u,
+        &desc)));
+
+    std::vector<float> out;
+    Index nvals = 4;
+    CHECKVOID(u.extractTuples(&out, &nvals));
+    BOOST_ASSERT_LIST(out, u_val, 4);
+    std::vector<float> correct = {3.f, 5.f, 7.f, 5.f};
+    CHECKVOID(v.extractTuples(&out, &nvals));
+    BOOST_ASSERT_LIST(out, correct, 4);
+
+    // Scatter into dup of the vector its indices come from
+    Vector<int> w(4), x(4), ind(4);
+    CHECKVOID(w.build(&w_val, 4));
+    CHECKVOID(ind.build(&ind_val, 4));
+    CHECKVOID(x.dup(&ind));
+    CHECKVOID((assign<int, int, int>(&x, GrB_NULL, MinimumMonoid<int>(),
+        &w, &ind, &desc)));
+
+    std::vector<int> out_int;
+    CHECKVOID(ind.extractTuples(&out_int, &nvals));
+    BOOST_ASSERT_LIST(out_int, ind_val, 4);
+    std::vector<int> correct_int = {0, 0, 0, 0};
+    CHECKVOID(x.extractTuples(&out_int, &nvals));
+    BOOST_ASSERT_LIST(out_int, correct_int, 4);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
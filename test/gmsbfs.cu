@@ -0,0 +1,148 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+
+#include "graphblas/graphblas.hpp"
+#include "graphblas/algorithm/diameter.hpp"
+#include "test/test.hpp"
+
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_MODULE msbfs_suite
+
+#include <boost/test/included/unit_test.hpp>
+#include <boost/program_options.hpp>
+
+// Depths and eccentricity of every source must match CPU reference BFS. More
+// sources than fit in one batch, with repeats, so that batches are exercised
+template <typename DepthT>
+void testMsbfs( char const*            mtx,
+                graphblas::Index       nsources,
+                graphblas::Desc_value  backend,
+                po::variables_map&     vm )
+{
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  char* dat_name;
+
+  // Read in sparse matrix
+  readMtx(mtx, &row_indices, &col_indices, &values, &nrows, &ncols, &nvals, 0,
+      false, &dat_name);
+
+  graphblas::Matrix<float> a(nrows, ncols);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      dat_name));
+  CHECKVOID(a.nrows(&nrows));
+
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, backend));
+
+  std::vector<graphblas::Index> sources(nsources);
+  for (graphblas::Index i = 0; i < nsources; ++i)
+    sources[i] = (i*7) % nrows;
+
+  std::vector<DepthT>           depths;
+  std::vector<graphblas::Index> ecc;
+  graphblas::algorithm::msbfs(&depths, &ecc, &a, sources, &desc);
+  BOOST_ASSERT( depths.size() == nsources*nrows );
+  BOOST_ASSERT( ecc.size() == nsources );
+
+  std::vector<graphblas::Index> correct(nrows);
+  for (graphblas::Index i = 0; i < nsources; ++i) {
+    graphblas::algorithm::bfsCpu(sources[i], &a, correct.data(), 10000, false);
+    std::vector<DepthT> depth(depths.begin() + i*nrows,
+        depths.begin() + (i+1)*nrows);
+    BOOST_ASSERT_LIST( correct, depth, nrows );
+    graphblas::Index max_depth = *std::max_element(correct.begin(),
+        correct.end());
+    BOOST_ASSERT( ecc[i] == max_depth - 1 );
+  }
+}
+
+struct TestMatrix
+{
+  TestMatrix() :
+    DEBUG(true) {}
+
+  bool DEBUG;
+};
+
+BOOST_AUTO_TEST_SUITE(msbfs_suite)
+
+BOOST_FIXTURE_TEST_CASE( msbfs1, TestMatrix )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testMsbfs<float>("data/small/chesapeake.mtx", 1, graphblas::GrB_SEQUENTIAL,
+      vm);
+  testMsbfs<float>("data/small/chesapeake.mtx", 100,
+      graphblas::GrB_SEQUENTIAL, vm);
+  testMsbfs<uint32_t>("data/small/test_cc.mtx", 70, graphblas::GrB_CUDA, vm);
+}
+
+// Diameter over a range of sources matches per-source reference BFS, and v
+// holds depths from last source
+BOOST_FIXTURE_TEST_CASE( msbfs2, TestMatrix )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  char* dat_name;
+  readMtx("data/small/chesapeake.mtx", &row_indices, &col_indices, &values,
+      &nrows, &ncols, &nvals, 0, false, &dat_name);
+
+  graphblas::Matrix<float> a(nrows, ncols);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      dat_name));
+
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, graphblas::GrB_SEQUENTIAL));
+
+  int correct_max = 0;
+  int correct_ind = -1;
+  std::vector<graphblas::Index> correct(nrows);
+  for (graphblas::Index s = 0; s < nrows; ++s) {
+    graphblas::algorithm::bfsCpu(s, &a, correct.data(), 10000, false);
+    int ecc = *std::max_element(correct.begin(), correct.end()) - 1;
+    correct_max = std::max(correct_max, ecc);
+    correct_ind = (ecc == correct_max) ? s : correct_ind;
+  }
+
+  graphblas::Vector<float> v(nrows);
+  std::pair<int, int> val = graphblas::algorithm::diameter(&v, &a, 0, nrows,
+      &desc);
+  BOOST_ASSERT( val.first  == correct_max );
+  BOOST_ASSERT( val.second == correct_ind );
+
+  std::vector<float> depth;
+  graphblas::Index nrows_t = nrows;
+  CHECKVOID(v.extractTuples(&depth, &nrows_t));
+  BOOST_ASSERT_LIST( correct, depth, nrows );
+
+  // Sources must be in range
+  std::vector<graphblas::Index> ecc(1);
+  graphblas::Index source = nrows;
+  BOOST_ASSERT( graphblas::msbfs(static_cast<float*>(NULL), ecc.data(),
+      &source, 1, &a, &desc) == graphblas::GrB_INVALID_INDEX );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
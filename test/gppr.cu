@@ -0,0 +1,163 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "graphblas/graphblas.hpp"
+#include "graphblas/algorithm/ppr.hpp"
+#include "test/test.hpp"
+
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_MODULE ppr_suite
+
+#include <boost/test/included/unit_test.hpp>
+#include <boost/program_options.hpp>
+
+// Random walk matrix scaled by alpha, same as pr() expects
+void readPprMatrix( char const*                    mtx,
+                    float                          alpha,
+                    std::vector<graphblas::Index>* row_indices,
+                    std::vector<graphblas::Index>* col_indices,
+                    std::vector<float>*            values,
+                    graphblas::Index*              nrows,
+                    graphblas::Index*              ncols,
+                    graphblas::Index*              nvals )
+{
+  // Binary cache is skipped, since it would bring back unscaled values
+  readMtx(mtx, row_indices, col_indices, values, nrows, ncols, nvals, 0,
+      false);
+
+  std::vector<float> outdegrees(*nrows, 0.f);
+  for (graphblas::Index i = 0; i < *nvals; ++i)
+    outdegrees[(*row_indices)[i]] += 1.f;
+  for (graphblas::Index i = 0; i < *nvals; ++i)
+    (*values)[i] = alpha/outdegrees[(*row_indices)[i]];
+}
+
+// Every column of batched result matches reference PPR of its seed. More
+// seeds than fit in one block, so that converged columns are refilled
+void testPpr( char const*            mtx,
+              graphblas::Index       nseeds,
+              graphblas::Desc_value  backend,
+              po::variables_map&     vm )
+{
+  float alpha = 0.85f;
+  float eps   = 1e-6f;
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  readPprMatrix(mtx, alpha, &row_indices, &col_indices, &values, &nrows,
+      &ncols, &nvals);
+
+  graphblas::Matrix<float> a(nrows, ncols);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL));
+
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, backend));
+
+  std::vector<graphblas::Index> seeds(nseeds);
+  for (graphblas::Index i = 0; i < nseeds; ++i)
+    seeds[i] = (i*5) % nrows;
+
+  graphblas::Matrix<float> p(nrows, nseeds);
+  graphblas::algorithm::pprBatch(&p, &a, seeds, alpha, eps, &desc);
+
+  std::vector<float> p_val;
+  graphblas::Index p_nvals = nrows*nseeds;
+  CHECKVOID(p.extractTuples(&p_val, &p_nvals));
+
+  std::vector<float> correct(nrows);
+  for (graphblas::Index i = 0; i < nseeds; ++i) {
+    graphblas::algorithm::pprCpu(correct.data(), &a, seeds[i], alpha, eps,
+        desc.descriptor_.max_niter_);
+    for (graphblas::Index j = 0; j < nrows; ++j)
+      BOOST_ASSERT_FLOAT( p_val[j*nseeds + i], correct[j] );
+  }
+
+  // Top-k is largest entries of each column, in decreasing order
+  graphblas::Index k = 4;
+  std::vector<graphblas::Index> topk_ind;
+  std::vector<float>            topk_val;
+  graphblas::algorithm::pprBatchTopK(&topk_ind, &topk_val, k, &a, seeds,
+      alpha, eps, &desc);
+  for (graphblas::Index i = 0; i < nseeds; ++i) {
+    std::vector<float> column(nrows);
+    for (graphblas::Index j = 0; j < nrows; ++j)
+      column[j] = p_val[j*nseeds + i];
+    std::sort(column.begin(), column.end(), std::greater<float>());
+    for (graphblas::Index j = 0; j < k; ++j) {
+      BOOST_ASSERT_FLOAT( topk_val[i*k + j], column[j] );
+      BOOST_ASSERT_FLOAT( topk_val[i*k + j],
+          p_val[topk_ind[i*k + j]*nseeds + i] );
+    }
+  }
+}
+
+struct TestMatrix
+{
+  TestMatrix() :
+    DEBUG(true) {}
+
+  bool DEBUG;
+};
+
+BOOST_AUTO_TEST_SUITE(ppr_suite)
+
+BOOST_FIXTURE_TEST_CASE( ppr1, TestMatrix )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testPpr("data/small/chesapeake.mtx", 1,  graphblas::GrB_SEQUENTIAL, vm);
+  testPpr("data/small/chesapeake.mtx", 50, graphblas::GrB_SEQUENTIAL, vm);
+  testPpr("data/small/chesapeake.mtx", 40, graphblas::GrB_CUDA, vm);
+}
+
+// Wrong output shape, seed and k are caught before anything runs
+BOOST_FIXTURE_TEST_CASE( ppr2, TestMatrix )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  readPprMatrix("data/small/chesapeake.mtx", 0.85f, &row_indices,
+      &col_indices, &values, &nrows, &ncols, &nvals);
+
+  graphblas::Matrix<float> a(nrows, ncols);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL));
+
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+
+  graphblas::Index seed = 0;
+  graphblas::Matrix<float> p(nrows, 2);
+  BOOST_ASSERT( graphblas::pprBatch(&p, static_cast<graphblas::Index*>(NULL),
+      static_cast<float*>(NULL), 0, &seed, 1, 0.85f, 1e-6f, &a, &desc) ==
+      graphblas::GrB_DIMENSION_MISMATCH );
+
+  std::vector<graphblas::Index> topk_ind(nrows + 1);
+  BOOST_ASSERT( graphblas::pprBatch(static_cast<graphblas::Matrix<float>*>(
+      NULL), topk_ind.data(), static_cast<float*>(NULL), nrows + 1, &seed, 1,
+      0.85f, 1e-6f, &a, &desc) == graphblas::GrB_INVALID_VALUE );
+
+  seed = nrows;
+  BOOST_ASSERT( graphblas::pprBatch(static_cast<graphblas::Matrix<float>*>(
+      NULL), topk_ind.data(), static_cast<float*>(NULL), 1, &seed, 1, 0.85f,
+      1e-6f, &a, &desc) == graphblas::GrB_INVALID_INDEX );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
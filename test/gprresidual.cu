@@ -0,0 +1,223 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "graphblas/graphblas.hpp"
+#include "graphblas/algorithm/pr.hpp"
+#include "test/test.hpp"
+
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_MODULE pr_residual_suite
+
+#include <boost/test/included/unit_test.hpp>
+#include <boost/program_options.hpp>
+
+// Random walk matrix scaled by alpha, same as pr() expects
+void readPrMatrix( char const*                    mtx,
+                   float                          alpha,
+                   std::vector<graphblas::Index>* row_indices,
+                   std::vector<graphblas::Index>* col_indices,
+                   std::vector<float>*            values,
+                   graphblas::Index*              nrows,
+                   graphblas::Index*              ncols,
+                   graphblas::Index*              nvals )
+{
+  // Binary cache is skipped, since it would bring back unscaled values
+  readMtx(mtx, row_indices, col_indices, values, nrows, ncols, nvals, 0,
+      false);
+
+  std::vector<float> outdegrees(*nrows, 0.f);
+  for (graphblas::Index i = 0; i < *nvals; ++i)
+    outdegrees[(*row_indices)[i]] += 1.f;
+  for (graphblas::Index i = 0; i < *nvals; ++i)
+    (*values)[i] = alpha/outdegrees[(*row_indices)[i]];
+}
+
+// Residual push PageRank matches reference power iteration and pr()
+void testPrResidual( char const*            mtx,
+                     graphblas::Desc_value  backend,
+                     graphblas::Desc_value  mxvmode,
+                     po::variables_map&     vm )
+{
+  float alpha = 0.85f;
+  float eps   = 1e-8f;
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  readPrMatrix(mtx, alpha, &row_indices, &col_indices, &values, &nrows,
+      &ncols, &nvals);
+
+  graphblas::Matrix<float> a(nrows, ncols);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL));
+
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, backend));
+  CHECKVOID(desc.set(graphblas::GrB_MXVMODE, mxvmode));
+
+  graphblas::Vector<float> p(nrows);
+  graphblas::algorithm::prResidual(&p, &a, alpha, eps, &desc);
+  std::vector<float> h_pr;
+  CHECKVOID(p.extractTuples(&h_pr, &nrows));
+
+  graphblas::Vector<float> q(nrows);
+  graphblas::algorithm::pr(&q, &a, alpha, eps, &desc);
+  std::vector<float> h_pr_power;
+  CHECKVOID(q.extractTuples(&h_pr_power, &nrows));
+
+  std::vector<float> correct(nrows);
+  graphblas::algorithm::prCpu(correct.data(), &a, alpha, eps,
+      desc.descriptor_.max_niter_);
+  BOOST_ASSERT_LIST_FLOAT( correct.data(), h_pr, nrows );
+  BOOST_ASSERT_LIST_FLOAT( h_pr_power.data(), h_pr, nrows );
+}
+
+// At loose eps, prResidual stops as close to exact PageRank as pr() does,
+// since eps bounds l2 norm of change that is left for both
+void testPrResidualLoose( char const*            mtx,
+                          graphblas::Desc_value  backend,
+                          po::variables_map&     vm )
+{
+  float alpha = 0.85f;
+  float eps   = 1e-3f;
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  readPrMatrix(mtx, alpha, &row_indices, &col_indices, &values, &nrows,
+      &ncols, &nvals);
+
+  graphblas::Matrix<float> a(nrows, ncols);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL));
+
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, backend));
+
+  graphblas::Vector<float> p(nrows);
+  graphblas::algorithm::prResidual(&p, &a, alpha, eps, &desc);
+  std::vector<float> h_pr;
+  CHECKVOID(p.extractTuples(&h_pr, &nrows));
+
+  graphblas::Vector<float> q(nrows);
+  graphblas::algorithm::pr(&q, &a, alpha, eps, &desc);
+  std::vector<float> h_pr_power;
+  CHECKVOID(q.extractTuples(&h_pr_power, &nrows));
+
+  // Each is within about eps/(1-alpha) of exact PageRank
+  float error = 0.f;
+  for (graphblas::Index i = 0; i < nrows; ++i)
+    error += (h_pr[i] - h_pr_power[i])*(h_pr[i] - h_pr_power[i]);
+  BOOST_ASSERT( sqrt(error) < 2.f*eps/(1.f - alpha) );
+}
+
+// One residual update: p and r only change at f and t, and f keeps only
+// vertices t reached whose residual is now above threshold
+void testResidualUpdate( graphblas::Desc_value  backend,
+                         po::variables_map&     vm )
+{
+  graphblas::Index n = 4;
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, backend));
+
+  graphblas::Vector<float> p(n), r(n), f(n), t(n), thr(n);
+  CHECKVOID(p.fill(0.f));
+  CHECKVOID(r.fill(0.f));
+  CHECKVOID(thr.fill(0.1f));
+  std::vector<graphblas::Index> f_ind = {0};
+  std::vector<float>            f_val = {0.5f};
+  CHECKVOID(f.build(&f_ind, &f_val, 1, GrB_NULL));
+  std::vector<graphblas::Index> t_ind = {1, 2};
+  std::vector<float>            t_val = {0.3f, 0.01f};
+  CHECKVOID(t.build(&t_ind, &t_val, 2, GrB_NULL));
+
+  graphblas::Index active = 0;
+  CHECKVOID(graphblas::residualUpdate(&p, &r, &f, &active, &t, &thr, &desc));
+  BOOST_ASSERT(active == 1);
+
+  std::vector<float> h_p, h_r;
+  CHECKVOID(p.extractTuples(&h_p, &n));
+  CHECKVOID(r.extractTuples(&h_r, &n));
+  std::vector<float> correct_p = {0.5f, 0.f, 0.f, 0.f};
+  std::vector<float> correct_r = {0.f, 0.3f, 0.01f, 0.f};
+  BOOST_ASSERT_LIST_FLOAT( correct_p.data(), h_p, n );
+  BOOST_ASSERT_LIST_FLOAT( correct_r.data(), h_r, n );
+
+  std::vector<graphblas::Index> h_f_ind;
+  std::vector<float>            h_f_val;
+  graphblas::Index f_nvals = n;
+  CHECKVOID(f.extractTuples(&h_f_ind, &h_f_val, &f_nvals));
+  BOOST_ASSERT(f_nvals == 1);
+  BOOST_ASSERT(h_f_ind[0] == 1);
+  BOOST_ASSERT_FLOAT(h_f_val[0], 0.3f);
+}
+
+struct TestPrResidual
+{
+  TestPrResidual() :
+    DEBUG(true) {}
+
+  bool DEBUG;
+};
+
+BOOST_AUTO_TEST_SUITE(pr_residual_suite)
+
+BOOST_FIXTURE_TEST_CASE( pr_residual1, TestPrResidual )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testPrResidual("data/small/chesapeake.mtx", graphblas::GrB_SEQUENTIAL,
+      graphblas::GrB_PUSHPULL, vm);
+  testPrResidual("data/small/chesapeake.mtx", graphblas::GrB_CUDA,
+      graphblas::GrB_PUSHPULL, vm);
+  testPrResidual("data/small/test_cc.mtx",    graphblas::GrB_SEQUENTIAL,
+      graphblas::GrB_PUSHPULL, vm);
+}
+
+// Forced push and forced pull give same result as switching
+BOOST_FIXTURE_TEST_CASE( pr_residual2, TestPrResidual )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testPrResidual("data/small/chesapeake.mtx", graphblas::GrB_CUDA,
+      graphblas::GrB_PUSHONLY, vm);
+  testPrResidual("data/small/chesapeake.mtx", graphblas::GrB_CUDA,
+      graphblas::GrB_PULLONLY, vm);
+}
+
+BOOST_FIXTURE_TEST_CASE( pr_residual3, TestPrResidual )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testResidualUpdate(graphblas::GrB_SEQUENTIAL, vm);
+  testResidualUpdate(graphblas::GrB_CUDA, vm);
+}
+
+// Same eps means same tolerance as pr(), not a tighter or looser one
+BOOST_FIXTURE_TEST_CASE( pr_residual4, TestPrResidual )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testPrResidualLoose("data/small/chesapeake.mtx", graphblas::GrB_SEQUENTIAL,
+      vm);
+  testPrResidualLoose("data/small/chesapeake.mtx", graphblas::GrB_CUDA, vm);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
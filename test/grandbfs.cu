@@ -4,6 +4,7 @@
 #include <iostream>
 #include <algorithm>
 #include <string>
+#include <random>
 
 #include <cstdio>
 #include <cstdlib>
@@ -19,8 +20,24 @@
 bool debug_;
 bool memory_;
 
-int main( int argc, char** argv )
-{
+// Prints mean, median and 99th percentile of per-query latency
+void printLatency(const char* str, std::vector<double>* latency) {
+  if (latency->empty())
+    return;
+  double total = 0.;
+  for (size_t i = 0; i < latency->size(); ++i)
+    total += (*latency)[i];
+  std::sort(latency->begin(), latency->end());
+  size_t p99 = std::min(latency->size() - 1, latency->size()*99/100);
+  std::cout << str << ", " << total/latency->size() << ", "
+      << (*latency)[latency->size()/2] << ", " << (*latency)[p99] << "\n";
+}
+
+// Repeated BFS from random sources on the same graph, as in a query-serving
+// setting. Reports per-query latency (ms) with temporaries taken from the
+// descriptor's vector pool and with the pool emptied before every query
+// (equivalent to allocating fresh temporaries for every query).
+int main(int argc, char** argv) {
   std::vector<graphblas::Index> row_indices;
   std::vector<graphblas::Index> col_indices;
   std::vector<float> values;
@@ -33,13 +50,14 @@ int main( int argc, char** argv )
   int  directed;
   int  niter;
   int  source;
+  char* dat_name;
   po::variables_map vm;
 
   // Read in sparse matrix
   if (argc < 2) {
     fprintf(stderr, "Usage: %s [matrix-market-filename]\n", argv[0]);
     exit(1);
-  } else { 
+  } else {
     parseArgs(argc, argv, &vm);
     debug     = vm["debug"    ].as<bool>();
     transpose = vm["transpose"].as<bool>();
@@ -48,65 +66,80 @@ int main( int argc, char** argv )
     niter     = vm["niter"    ].as<int>();
     source    = vm["source"   ].as<int>();
 
-    // This is an imperfect solution, because this should happen in 
+    // This is an imperfect solution, because this should happen in
     // desc.loadArgs(vm) instead of application code!
     // TODO: fix this
     readMtx(argv[argc-1], &row_indices, &col_indices, &values, &nrows, &ncols,
-        &nvals, directed, mtxinfo );
+        &nvals, directed, mtxinfo, &dat_name);
   }
 
   // Descriptor desc
   graphblas::Descriptor desc;
-  CHECK( desc.loadArgs(vm) );
-  CHECK( desc.toggle(graphblas::GrB_INP1) );
+  CHECK(desc.loadArgs(vm));
+  CHECK(desc.toggle(graphblas::GrB_INP1));
+
+  // Per-query timing output is not wanted here
+  desc.descriptor_.timing_ = 0;
 
   // Matrix A
   graphblas::Matrix<float> a(nrows, ncols);
-  CHECK( a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL, 
-      argv[argc-1]) );
-  CHECK( a.nrows(&nrows) );
-  CHECK( a.ncols(&ncols) );
-  CHECK( a.nvals(&nvals) );
-  if( debug ) CHECK( a.print() );
+  CHECK(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      dat_name));
+  CHECK(a.nrows(&nrows));
+  CHECK(a.ncols(&ncols));
+  CHECK(a.nvals(&nvals));
+  if (debug) CHECK(a.print());
 
   // Vector v
   graphblas::Vector<float> v(nrows);
 
-  // Cpu BFS
-  CpuTimer bfs_cpu;
-  graphblas::Index* h_bfs_cpu = (graphblas::Index*)malloc(nrows*
-      sizeof(graphblas::Index));
-  int depth = 10000;
-  bfs_cpu.Start();
-  graphblas::algorithm::bfsCpu( source, &a, h_bfs_cpu, depth, transpose );
-  bfs_cpu.Stop();
-
   // Warmup
-  CpuTimer warmup;
-  warmup.Start();
   graphblas::algorithm::bfs(&v, &a, source, &desc);
-  warmup.Stop();
-
-  std::vector<float> h_bfs_gpu;
-  CHECK( v.extractTuples(&h_bfs_gpu, &nrows) );
-  BOOST_ASSERT_LIST( h_bfs_cpu, h_bfs_gpu, nrows );
 
   // Source randomization
   std::mt19937 gen(0);
-  std::uniform_int_distribution<> dis(0,nrows-1);
-
-  // Benchmark
-  CpuTimer vxm_gpu;
-  //cudaProfilerStart();
-  vxm_gpu.Start();
-  float tight = 0.f;
-  for( int i=0; i<niter; i++ )
-  {
-    source = dis(gen);
-    tight += graphblas::algorithm::bfs(&v, &a, source, &desc);
+  std::uniform_int_distribution<> dis(0, nrows - 1);
+  std::vector<graphblas::Index> sources(niter);
+  for (int i = 0; i < niter; i++)
+    sources[i] = dis(gen);
+
+  // Benchmark without pool reuse
+  std::vector<double> latency_fresh;
+  CpuTimer query;
+  for (int i = 0; i < niter; i++) {
+    CHECK(desc.pool()->clear());
+    query.Start();
+    graphblas::algorithm::bfs(&v, &a, sources[i], &desc);
+    query.Stop();
+    latency_fresh.push_back(query.ElapsedMillis());
   }
-  //cudaProfilerStop();
-  vxm_gpu.Stop();
+
+  // Benchmark with pool reuse
+  std::vector<double> latency_pool;
+  size_t nmiss = desc.pool()->nmiss();
+  for (int i = 0; i < niter; i++) {
+    query.Start();
+    graphblas::algorithm::bfs(&v, &a, sources[i], &desc);
+    query.Stop();
+    latency_pool.push_back(query.ElapsedMillis());
+  }
+  BOOST_ASSERT(desc.pool()->nmiss() - nmiss <= 2);
+
+  // Check last query against CPU
+  if (niter) {
+    graphblas::Index* h_bfs_cpu = reinterpret_cast<graphblas::Index*>(
+        malloc(nrows*sizeof(graphblas::Index)));
+    graphblas::algorithm::bfsCpu(sources[niter-1], &a, h_bfs_cpu, 10000,
+        transpose);
+    std::vector<float> h_bfs_gpu;
+    CHECK(v.extractTuples(&h_bfs_gpu, &nrows));
+    BOOST_ASSERT_LIST(h_bfs_cpu, h_bfs_gpu, nrows);
+    free(h_bfs_cpu);
+  }
+
+  std::cout << "mode, mean, p50, p99\n";
+  printLatency("fresh", &latency_fresh);
+  printLatency("pool", &latency_pool);
 
   return 0;
 }
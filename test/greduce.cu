@@ -7,9 +7,11 @@
 #include <numeric>
 #include <algorithm>
 #include <map>
+#include <limits>
 
 #include <cstdio>
 #include <cstdlib>
+#include <cmath>
 
 #include "graphblas/graphblas.hpp"
 #include "test/test.hpp"
@@ -52,6 +54,245 @@ void testReduce( char const* mtx,
   BOOST_ASSERT_LIST( values, correct, nrows );
 }
 
+// Fused eWiseMult + reduce must match eWiseMult followed by reduce
+void testEWiseMultReduce( const std::vector<float>& u_val,
+                          const std::vector<float>& v_val,
+                          graphblas::Desc_value     backend )
+{
+  graphblas::Index nvals = u_val.size();
+  graphblas::Info err;
+  graphblas::Descriptor desc;
+  err = desc.set(graphblas::GrB_BACKEND, backend);
+
+  graphblas::Vector<float> u(nvals);
+  err = u.build(&u_val, nvals);
+  graphblas::Vector<float> v(nvals);
+  err = v.build(&v_val, nvals);
+
+  float correct = 0.f;
+  for (graphblas::Index i = 0; i < nvals; ++i)
+    correct += (u_val[i] - v_val[i])*(u_val[i] - v_val[i]);
+
+  float val = -1.f;
+  err = graphblas::eWiseMultReduce<float, float, float>( &val, GrB_NULL,
+      graphblas::PlusSquaredDifferenceSemiring<float>(), &u, &v, &desc );
+  BOOST_ASSERT( err == graphblas::GrB_SUCCESS );
+  BOOST_ASSERT( fabs(val - correct) <= 1e-3*fabs(correct) );
+
+  // argmin of u(i) + i
+  std::vector<float> ascending_val(nvals);
+  for (graphblas::Index i = 0; i < nvals; ++i)
+    ascending_val[i] = static_cast<float>(i);
+  graphblas::Vector<float> ascending(nvals);
+  err = ascending.build(&ascending_val, nvals);
+
+  float min_correct = u_val[0];
+  for (graphblas::Index i = 0; i < nvals; ++i)
+    min_correct = std::min(min_correct, u_val[i] + ascending_val[i]);
+  err = graphblas::eWiseMultReduce<float, float, float>( &val, GrB_NULL,
+      graphblas::MinimumPlusSemiring<float>(), &u, &ascending, &desc );
+  BOOST_ASSERT( val == min_correct );
+}
+
+// Fused eWiseAdd + reduce with a monoid different from the semiring
+void testEWiseAddReduce( const std::vector<float>& u_val,
+                         const std::vector<float>& v_val )
+{
+  graphblas::Index nvals = u_val.size();
+  graphblas::Info err;
+  graphblas::Descriptor desc;
+
+  graphblas::Vector<float> u(nvals);
+  err = u.build(&u_val, nvals);
+  graphblas::Vector<float> v(nvals);
+  err = v.build(&v_val, nvals);
+
+  float correct = 0.f;
+  for (graphblas::Index i = 0; i < nvals; ++i)
+    correct = std::max(correct, u_val[i] + v_val[i]);
+
+  float val = -1.f;
+  err = graphblas::eWiseAddReduce<float, float, float>( &val, GrB_NULL,
+      graphblas::MaximumMonoid<float>(),
+      graphblas::PlusMultipliesSemiring<float>(), &u, &v, &desc );
+  BOOST_ASSERT( err == graphblas::GrB_SUCCESS );
+  BOOST_ASSERT( val == correct );
+}
+
+// Reductions whose monoid has a terminal value stop early, and must give
+// same result as when they do not
+void testReduceTerminal( graphblas::Desc_value backend )
+{
+  graphblas::Index nvals = 100000;
+  graphblas::Info err;
+  graphblas::Descriptor desc;
+  err = desc.set(graphblas::GrB_BACKEND, backend);
+
+  // Single nonzero near end, and none
+  std::vector<int> u_val(nvals, 0);
+  graphblas::Vector<int> u(nvals);
+  err = u.build(&u_val, nvals);
+  int val = -1;
+  err = graphblas::reduce<int, int>( &val, GrB_NULL,
+      graphblas::LogicalOrMonoid<int>(), &u, &desc );
+  BOOST_ASSERT( err == graphblas::GrB_SUCCESS );
+  BOOST_ASSERT( val == 0 );
+
+  u_val[nvals - 3] = 5;
+  err = u.build(&u_val, nvals);
+  err = graphblas::reduce<int, int>( &val, GrB_NULL,
+      graphblas::LogicalOrMonoid<int>(), &u, &desc );
+  BOOST_ASSERT( val == 1 );
+
+  // Minimum reaches lowest value halfway
+  std::vector<float> v_val(nvals);
+  for (graphblas::Index i = 0; i < nvals; ++i)
+    v_val[i] = static_cast<float>(i % 13);
+  v_val[nvals/2] = std::numeric_limits<float>::lowest();
+  graphblas::Vector<float> v(nvals);
+  err = v.build(&v_val, nvals);
+  float min_val = 0.f;
+  err = graphblas::reduce<float, float>( &min_val, GrB_NULL,
+      graphblas::MinimumMonoid<float>(), &v, &desc );
+  BOOST_ASSERT( min_val == std::numeric_limits<float>::lowest() );
+
+  // lowest does not stop float minimum, but -infinity past it does
+  v_val[nvals - 3] = -std::numeric_limits<float>::infinity();
+  err = v.build(&v_val, nvals);
+  err = graphblas::reduce<float, float>( &min_val, GrB_NULL,
+      graphblas::MinimumMonoid<float>(), &v, &desc );
+  BOOST_ASSERT( min_val == -std::numeric_limits<float>::infinity() );
+  BOOST_ASSERT( graphblas::MaximumMonoid<float>().terminal() ==
+      std::numeric_limits<float>::infinity() );
+  BOOST_ASSERT( graphblas::MaximumMonoid<int>().terminal() ==
+      std::numeric_limits<int>::max() );
+
+  // Or of and: is there an i where both are nonzero
+  std::vector<float> w_val(nvals, 0.f);
+  graphblas::Vector<float> w(nvals);
+  err = w.build(&w_val, nvals);
+  graphblas::Vector<float> x(nvals);
+  err = x.build(&w_val, nvals);
+  float any = -1.f;
+  err = graphblas::eWiseMultReduce<float, float, float>( &any, GrB_NULL,
+      graphblas::LogicalOrAndSemiring<float>(), &w, &x, &desc );
+  BOOST_ASSERT( any == 0.f );
+
+  w_val[12345] = 1.f;
+  err = w.build(&w_val, nvals);
+  err = x.build(&w_val, nvals);
+  err = graphblas::eWiseMultReduce<float, float, float>( &any, GrB_NULL,
+      graphblas::LogicalOrAndSemiring<float>(), &w, &x, &desc );
+  BOOST_ASSERT( any == 1.f );
+}
+
+// Fused reductions with sparse operands, whose indices need not be sorted,
+// and accum applied once to val
+void testEWiseReduceSparse( graphblas::Desc_value backend )
+{
+  graphblas::Index nvals = 10;
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, backend));
+
+  std::vector<graphblas::Index> u_ind{ 7, 1, 4 };
+  std::vector<float>            u_val{ 5.f, 2.f, 3.f };
+  graphblas::Vector<float> u(nvals);
+  CHECKVOID(u.build(&u_ind, &u_val, u_ind.size(), GrB_NULL));
+  std::vector<graphblas::Index> v_ind{ 8, 4 };
+  std::vector<float>            v_val{ 1.f, 10.f };
+  graphblas::Vector<float> v(nvals);
+  CHECKVOID(v.build(&v_ind, &v_val, v_ind.size(), GrB_NULL));
+  std::vector<float> d_val(nvals, 1.f);
+  graphblas::Vector<float> d(nvals);
+  CHECKVOID(d.build(&d_val, nvals));
+
+  // Intersection is index 4 only
+  float val = -1.f;
+  CHECKVOID((graphblas::eWiseMultReduce<float, float, float>(&val, GrB_NULL,
+      graphblas::PlusMultipliesSemiring<float>(), &u, &v, &desc)));
+  BOOST_ASSERT( val == 30.f );
+
+  // Union of u and v is 2, 13, 5 and 1
+  CHECKVOID((graphblas::eWiseAddReduce<float, float, float>(&val, GrB_NULL,
+      graphblas::PlusMonoid<float>(),
+      graphblas::PlusMultipliesSemiring<float>(), &u, &v, &desc)));
+  BOOST_ASSERT( val == 21.f );
+  CHECKVOID((graphblas::eWiseAddReduce<float, float, float>(&val, GrB_NULL,
+      graphblas::MaximumMonoid<float>(),
+      graphblas::PlusMultipliesSemiring<float>(), &v, &u, &desc)));
+  BOOST_ASSERT( val == 13.f );
+
+  // Union of u and dense d is 1 at 7 indices, and 3, 4 and 6
+  CHECKVOID((graphblas::eWiseAddReduce<float, float, float>(&val, GrB_NULL,
+      graphblas::PlusMonoid<float>(),
+      graphblas::PlusMultipliesSemiring<float>(), &u, &d, &desc)));
+  BOOST_ASSERT( val == 20.f );
+  CHECKVOID((graphblas::eWiseAddReduce<float, float, float>(&val, GrB_NULL,
+      graphblas::MaximumMonoid<float>(),
+      graphblas::PlusMultipliesSemiring<float>(), &d, &u, &desc)));
+  BOOST_ASSERT( val == 6.f );
+
+  val = 100.f;
+  CHECKVOID((graphblas::eWiseMultReduce<float, float, float>(&val,
+      graphblas::plus<float>(), graphblas::PlusMultipliesSemiring<float>(),
+      &u, &v, &desc)));
+  BOOST_ASSERT( val == 130.f );
+  CHECKVOID((graphblas::eWiseAddReduce<float, float, float>(&val,
+      graphblas::plus<float>(), graphblas::PlusMonoid<float>(),
+      graphblas::PlusMultipliesSemiring<float>(), &d, &d, &desc)));
+  BOOST_ASSERT( val == 150.f );
+}
+
+// Row reduce on CPU with sparse mask, plain and complemented. Rows left out
+// by mask are identity
+void testReduceMasked( char const*                          mtx,
+                       const std::vector<graphblas::Index>& mask_ind,
+                       const std::vector<float>&            row_sum )
+{
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  char* dat_name;
+
+  readMtx(mtx, row_indices, col_indices, values, nrows, ncols, nvals, 0, false,
+      &dat_name);
+
+  graphblas::Matrix<float> adj(nrows, ncols);
+  CHECKVOID(adj.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      dat_name));
+
+  std::vector<float> mask_val(mask_ind.size(), 1.f);
+  graphblas::Vector<float> mask(nrows);
+  CHECKVOID(mask.build(&mask_ind, &mask_val, mask_ind.size(), GrB_NULL));
+
+  for (int use_scmp = 0; use_scmp < 2; ++use_scmp)
+  {
+    std::vector<float> correct(nrows, 0.f);
+    for (graphblas::Index row = 0; row < nrows; ++row)
+    {
+      bool in_mask = std::find(mask_ind.begin(), mask_ind.end(), row) !=
+          mask_ind.end();
+      if (in_mask != static_cast<bool>(use_scmp))
+        correct[row] = row_sum[row];
+    }
+
+    graphblas::Descriptor desc;
+    CHECKVOID(desc.set(graphblas::GrB_BACKEND, graphblas::GrB_SEQUENTIAL));
+    if (use_scmp)
+      CHECKVOID(desc.set(graphblas::GrB_MASK, graphblas::GrB_SCMP));
+
+    graphblas::Vector<float> vec(nrows);
+    CHECKVOID(graphblas::reduce<float, float, float>(&vec, &mask, GrB_NULL,
+        graphblas::PlusMonoid<float>(), &adj, &desc));
+
+    graphblas::Index nrows_t = nrows;
+    CHECKVOID(vec.extractTuples(&values, &nrows_t));
+    BOOST_ASSERT( nrows == nrows_t );
+    BOOST_ASSERT_LIST( values, correct, nrows );
+  }
+}
+
 struct TestMatrix
 {
   TestMatrix() :
@@ -76,4 +317,37 @@ BOOST_FIXTURE_TEST_CASE( dup2, TestMatrix )
   testReduce( "data/small/test_bc.mtx", correct );
 }
 
+BOOST_FIXTURE_TEST_CASE( dup3, TestMatrix )
+{
+  // More elements than one block, so partial results are combined
+  std::vector<float> u_val(100000), v_val(100000);
+  for (int i = 0; i < 100000; ++i)
+  {
+    u_val[i] = static_cast<float>(i % 7);
+    v_val[i] = static_cast<float>(i % 5);
+  }
+  testEWiseMultReduce( u_val, v_val, graphblas::GrB_CUDA );
+  testEWiseMultReduce( u_val, v_val, graphblas::GrB_SEQUENTIAL );
+  testEWiseAddReduce( u_val, v_val );
+}
+
+BOOST_FIXTURE_TEST_CASE( dup4, TestMatrix )
+{
+  testReduceTerminal( graphblas::GrB_CUDA );
+  testReduceTerminal( graphblas::GrB_SEQUENTIAL );
+}
+
+BOOST_FIXTURE_TEST_CASE( dup5, TestMatrix )
+{
+  std::vector<float> correct{ 1., 1., 3., 2., 2., 3., 3., 0., 1., 2., 2. };
+  std::vector<graphblas::Index> mask_ind{ 0, 2, 5, 9 };
+  testReduceMasked( "data/small/test_cc.mtx", mask_ind, correct );
+}
+
+BOOST_FIXTURE_TEST_CASE( dup6, TestMatrix )
+{
+  testEWiseReduceSparse( graphblas::GrB_CUDA );
+  testEWiseReduceSparse( graphblas::GrB_SEQUENTIAL );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
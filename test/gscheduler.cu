@@ -0,0 +1,121 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <vector>
+#include <iostream>
+
+#include "graphblas/graphblas.hpp"
+#include "test/test.hpp"
+
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_MODULE scheduler_suite
+
+#include <boost/test/included/unit_test.hpp>
+#include <boost/program_options.hpp>
+
+using namespace graphblas;
+
+// w = u + v, dense
+Info add(Vector<float>* w, const Vector<float>* u, const Vector<float>* v,
+         Descriptor* desc) {
+  return eWiseAdd<float, float, float, float>(w, GrB_NULL, GrB_NULL,
+      PlusMultipliesSemiring<float>(), u, v, desc);
+}
+
+struct TestScheduler {
+  TestScheduler() :
+    DEBUG(true), nvals(100), u_val(100), v_val(100) {
+    for (Index i = 0; i < nvals; ++i) {
+      u_val[i] = static_cast<float>(i);
+      v_val[i] = static_cast<float>(2*i + 1);
+    }
+  }
+
+  bool               DEBUG;
+  Index              nvals;
+  std::vector<float> u_val;
+  std::vector<float> v_val;
+};
+
+BOOST_AUTO_TEST_SUITE(scheduler_suite)
+
+// Blocking mode (default) runs operations right away
+BOOST_FIXTURE_TEST_CASE(scheduler1, TestScheduler) {
+  Descriptor desc;
+  Vector<float> u(nvals), v(nvals), w(nvals);
+  CHECKVOID(u.build(&u_val, nvals));
+  CHECKVOID(v.build(&v_val, nvals));
+
+  CHECKVOID(add(&w, &u, &v, &desc));
+  BOOST_ASSERT(desc.scheduler()->npending() == 0);
+  BOOST_ASSERT(desc.scheduler()->nrecorded() == 0);
+}
+
+// Operations are deferred until result is read, and an overwritten
+// temporary is never computed
+BOOST_FIXTURE_TEST_CASE(scheduler2, TestScheduler) {
+  Descriptor desc;
+  CHECKVOID(desc.set(GrB_EXECMODE, GrB_NONBLOCKING));
+  Vector<float> u(nvals), v(nvals), t(nvals), w(nvals);
+  CHECKVOID(u.build(&u_val, nvals));
+  CHECKVOID(v.build(&v_val, nvals));
+
+  CHECKVOID(add(&t, &u, &v, &desc));  // dead: overwritten before read
+  CHECKVOID(add(&t, &u, &u, &desc));
+  CHECKVOID(add(&w, &t, &v, &desc));
+  BOOST_ASSERT(desc.scheduler()->npending() == 3);
+
+  std::vector<float> values;
+  Index nvals_t = nvals;
+  CHECKVOID(w.extractTuples(&values, &nvals_t));
+  BOOST_ASSERT(desc.scheduler()->npending()    == 0);
+  BOOST_ASSERT(desc.scheduler()->nexecuted()   == 2);
+  BOOST_ASSERT(desc.scheduler()->neliminated() == 1);
+
+  std::vector<float> correct(nvals);
+  for (Index i = 0; i < nvals; ++i)
+    correct[i] = 2*u_val[i] + v_val[i];
+  BOOST_ASSERT(nvals_t == nvals);
+  BOOST_ASSERT_LIST(values, correct, nvals);
+}
+
+// Operations on disjoint objects run in the same wave
+BOOST_FIXTURE_TEST_CASE(scheduler3, TestScheduler) {
+  Descriptor desc;
+  CHECKVOID(desc.set(GrB_EXECMODE, GrB_NONBLOCKING));
+  Vector<float> u(nvals), v(nvals), x(nvals), y(nvals), w1(nvals), w2(nvals);
+  CHECKVOID(u.build(&u_val, nvals));
+  CHECKVOID(v.build(&v_val, nvals));
+  CHECKVOID(x.build(&u_val, nvals));
+  CHECKVOID(y.build(&v_val, nvals));
+
+  CHECKVOID(add(&w1, &u, &v, &desc));
+  CHECKVOID(add(&w2, &x, &y, &desc));
+  CHECKVOID(desc.wait());
+  BOOST_ASSERT(desc.scheduler()->nexecuted() == 2);
+  BOOST_ASSERT(desc.scheduler()->nwaves()    == 1);
+
+  std::vector<float> values1, values2;
+  Index nvals_t = nvals;
+  CHECKVOID(w1.extractTuples(&values1, &nvals_t));
+  CHECKVOID(w2.extractTuples(&values2, &nvals_t));
+  BOOST_ASSERT_LIST(values1, values2, nvals);
+}
+
+// Temporary returned to pool before its value is read is never computed
+BOOST_FIXTURE_TEST_CASE(scheduler4, TestScheduler) {
+  Descriptor desc;
+  CHECKVOID(desc.set(GrB_EXECMODE, GrB_NONBLOCKING));
+  Vector<float> u(nvals), v(nvals);
+  CHECKVOID(u.build(&u_val, nvals));
+  CHECKVOID(v.build(&v_val, nvals));
+  {
+    PooledVector<float> t(desc.pool(), nvals);
+    CHECKVOID(add(t.get(), &u, &v, &desc));
+  }
+  CHECKVOID(graphblas::wait());
+  BOOST_ASSERT(desc.scheduler()->nexecuted()   == 0);
+  BOOST_ASSERT(desc.scheduler()->neliminated() == 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
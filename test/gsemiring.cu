@@ -0,0 +1,132 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "graphblas/graphblas.hpp"
+#include "test/test.hpp"
+
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_MODULE semiring_suite
+
+#include <boost/test/included/unit_test.hpp>
+#include <boost/program_options.hpp>
+
+// Masked pull vxm w = u min.+ A, where mask keeps even vertices, against CPU
+// reference. Vertices left out by mask hold identity
+void testVxmMinPlus( char const*            mtx,
+                     bool                   fusedmask,
+                     graphblas::Desc_value  backend,
+                     po::variables_map&     vm )
+{
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  char* dat_name;
+
+  readMtx(mtx, &row_indices, &col_indices, &values, &nrows, &ncols, &nvals, 0,
+      false, &dat_name);
+
+  graphblas::Matrix<float> a(nrows, ncols);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      dat_name));
+  CHECKVOID(a.nrows(&nrows));
+
+  std::vector<float> vec(nrows), mask_vec(nrows);
+  for (graphblas::Index i = 0; i < nrows; ++i) {
+    vec[i]      = static_cast<float>(i % 5);
+    mask_vec[i] = (i % 2 == 0) ? 1.f : 0.f;
+  }
+
+  float identity = std::numeric_limits<float>::max();
+  std::vector<float> correct(nrows, identity);
+  for (graphblas::Index row = 0; row < nrows; ++row) {
+    graphblas::Index row_start = a.matrix_.sparse_.h_csrRowPtr_[row];
+    graphblas::Index row_end   = a.matrix_.sparse_.h_csrRowPtr_[row+1];
+    for (; row_start < row_end; ++row_start) {
+      graphblas::Index col = a.matrix_.sparse_.h_csrColInd_[row_start];
+      float val = a.matrix_.sparse_.h_csrVal_[row_start];
+      if (mask_vec[col] != 0.f)
+        correct[col] = std::min(correct[col], val + vec[row]);
+    }
+  }
+
+  graphblas::Vector<float> u(nrows);
+  graphblas::Vector<float> m(nrows);
+  graphblas::Vector<float> w(nrows);
+  CHECKVOID(u.build(&vec, nrows));
+  CHECKVOID(m.build(&mask_vec, nrows));
+
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+  CHECKVOID(desc.set(graphblas::GrB_MXVMODE, graphblas::GrB_PULLONLY));
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, backend));
+  desc.descriptor_.fusedmask_ = fusedmask;
+
+  CHECKVOID(graphblas::vxm<float, float, float, float>(&w, &m, GrB_NULL,
+      graphblas::MinimumPlusSemiring<float>(), &u, &a, &desc));
+
+  graphblas::Index nrows_t = nrows;
+  CHECKVOID(w.extractTuples(&values, &nrows_t));
+  BOOST_ASSERT( nrows_t == nrows );
+  BOOST_ASSERT_LIST( values, correct, nrows );
+}
+
+struct TestSemiring
+{
+  TestSemiring() :
+    DEBUG(true) {}
+
+  bool DEBUG;
+};
+
+BOOST_AUTO_TEST_SUITE(semiring_suite)
+
+// Traits that kernels dispatch on
+BOOST_FIXTURE_TEST_CASE( semiring1, TestSemiring )
+{
+  typedef graphblas::LogicalOrAndSemiring<bool>       OrAnd;
+  typedef graphblas::PlusMultipliesSemiring<float>    PlusTimes;
+  typedef graphblas::MinimumPlusSemiring<float>       MinPlus;
+  typedef graphblas::MaximumMultipliesSemiring<float> MaxTimes;
+
+  BOOST_ASSERT( OrAnd::struconly );
+  BOOST_ASSERT( !PlusTimes::struconly && !MinPlus::struconly );
+  BOOST_ASSERT( OrAnd::has_terminal && OrAnd().terminal() == true );
+  BOOST_ASSERT( !PlusTimes::has_terminal );
+  BOOST_ASSERT( MinPlus::has_terminal &&
+      MinPlus().terminal() == std::numeric_limits<float>::lowest() );
+  BOOST_ASSERT( MaxTimes::has_terminal &&
+      MaxTimes().terminal() == std::numeric_limits<float>::max() );
+  BOOST_ASSERT( MinPlus::idempotent && !PlusTimes::idempotent );
+  BOOST_ASSERT( PlusTimes::atomic == graphblas::GrB_ATOMIC_ADD );
+  BOOST_ASSERT( OrAnd::atomic == graphblas::GrB_ATOMIC_OR );
+  BOOST_ASSERT( graphblas::LogicalAndMonoid<bool>().identity() == true );
+
+  BOOST_ASSERT( graphblas::extractAdd(MinPlus()).has_terminal );
+  BOOST_ASSERT( !graphblas::AccumTraits<decltype(GrB_NULL)>::enabled );
+  BOOST_ASSERT( graphblas::AccumTraits<graphblas::plus<float> >::enabled );
+}
+
+// Fused and unfused masked pull, and CPU pull, give same result for min-plus
+BOOST_FIXTURE_TEST_CASE( semiring2, TestSemiring )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testVxmMinPlus("data/small/chesapeake.mtx", true,  graphblas::GrB_CUDA, vm);
+  testVxmMinPlus("data/small/chesapeake.mtx", false, graphblas::GrB_CUDA, vm);
+  testVxmMinPlus("data/small/chesapeake.mtx", true,  graphblas::GrB_SEQUENTIAL,
+      vm);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <vector>
+#include <atomic>
+#include <iostream>
+#include <functional>
+
+#include "graphblas/graphblas.hpp"
+#include "test/test.hpp"
+
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_MODULE thread_pool_suite
+
+#include <boost/test/included/unit_test.hpp>
+#include <boost/program_options.hpp>
+
+using namespace graphblas;
+
+struct TestThreadPool {
+  TestThreadPool() :
+    DEBUG(true), nvals(100003), nthreads{1, 2, 4} {}
+
+  bool             DEBUG;
+  Index            nvals;
+  std::vector<int> nthreads;
+};
+
+BOOST_AUTO_TEST_SUITE(thread_pool_suite)
+
+// Every index is visited exactly once, also when loops are nested
+BOOST_FIXTURE_TEST_CASE(thread_pool1, TestThreadPool) {
+  for (size_t t = 0; t < nthreads.size(); ++t) {
+    CHECKVOID(threadPool().resize(nthreads[t], false));
+    BOOST_ASSERT(threadPool().nthread() == nthreads[t]);
+
+    std::vector<int> visited(nvals, 0);
+    threadPool().parallelFor(0, nvals, [&](Index begin, Index end) {
+      for (Index i = begin; i < end; ++i)
+        visited[i]++;
+    }, 64);
+    for (Index i = 0; i < nvals; ++i)
+      BOOST_ASSERT(visited[i] == 1);
+
+    std::atomic<Index> count(0);
+    threadPool().parallelFor(0, 32, [&](Index begin, Index end) {
+      for (Index i = begin; i < end; ++i)
+        threadPool().parallelFor(0, 1000, [&](Index begin, Index end) {
+          count += end - begin;
+        }, 10);
+    });
+    BOOST_ASSERT(count == 32000);
+  }
+}
+
+// Reduce and scan match sequential result
+BOOST_FIXTURE_TEST_CASE(thread_pool2, TestThreadPool) {
+  std::vector<Index> values(nvals);
+  for (Index i = 0; i < nvals; ++i)
+    values[i] = i % 7;
+
+  for (size_t t = 0; t < nthreads.size(); ++t) {
+    CHECKVOID(threadPool().resize(nthreads[t], false));
+
+    Index sum = threadPool().parallelReduce(0, nvals, 0,
+        [&](Index begin, Index end) {
+      Index sum = 0;
+      for (Index i = begin; i < end; ++i)
+        sum += values[i];
+      return sum;
+    }, std::plus<Index>());
+
+    std::vector<Index> scan(nvals);
+    Index total = threadPool().parallelScan(values.data(), scan.data(),
+        nvals, 0, std::plus<Index>());
+
+    Index correct = 0;
+    for (Index i = 0; i < nvals; ++i) {
+      BOOST_ASSERT(scan[i] == correct);
+      correct += values[i];
+    }
+    BOOST_ASSERT(sum   == correct);
+    BOOST_ASSERT(total == correct);
+  }
+}
+
+// Large host allocations are placed by first touch, which zeroes them
+BOOST_FIXTURE_TEST_CASE(thread_pool3, TestThreadPool) {
+  CHECKVOID(threadPool().resize(4, false));
+  size_t count = 2*ThreadPool::kFirstTouchBytes/sizeof(float);
+  float* ptr = NULL;
+  CHECKVOID(backend::hostMalloc(&ptr, count, backend::GrB_MEMORY_VECTOR));
+  for (size_t i = 0; i < count; ++i)
+    BOOST_ASSERT(ptr[i] == 0.f);
+  backend::hostFree(ptr);
+  CHECKVOID(threadPool().resize(0, false));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,222 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+
+#include "graphblas/graphblas.hpp"
+#include "graphblas/algorithm/bfs.hpp"
+#include "test/test.hpp"
+
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_MODULE traverse_suite
+
+#include <boost/test/included/unit_test.hpp>
+#include <boost/program_options.hpp>
+
+// BFS built on fused traverse must give same depths as CPU reference, for
+// every direction mode and both backends
+template <typename FrontierT, typename DepthT>
+void testBfs( char const*            mtx,
+              graphblas::Index       source,
+              graphblas::Desc_value  mxv_mode,
+              graphblas::Desc_value  backend,
+              po::variables_map&     vm )
+{
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  char* dat_name;
+
+  // Read in sparse matrix
+  readMtx(mtx, &row_indices, &col_indices, &values, &nrows, &ncols, &nvals, 0,
+      false, &dat_name);
+
+  graphblas::Matrix<float> a(nrows, ncols);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      dat_name));
+  CHECKVOID(a.nrows(&nrows));
+
+  std::vector<graphblas::Index> correct(nrows);
+  graphblas::algorithm::bfsCpu(source, &a, correct.data(), 10000, false);
+
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+  CHECKVOID(desc.set(graphblas::GrB_MXVMODE, mxv_mode));
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, backend));
+
+  graphblas::Vector<DepthT> v(nrows);
+  graphblas::algorithm::bfs<FrontierT>(&v, &a, source, &desc);
+
+  std::vector<DepthT> depth;
+  graphblas::Index nrows_t = nrows;
+  CHECKVOID(v.extractTuples(&depth, &nrows_t));
+  BOOST_ASSERT( nrows_t == nrows );
+  BOOST_ASSERT_LIST( correct, depth, nrows );
+}
+
+// BFS tree from bfsParent must be valid against CPU reference depths, and be
+// same tree for every direction mode, since push and pull both pick smallest
+// frontier vertex as parent
+void testBfsParent( char const*            mtx,
+                    graphblas::Index       source,
+                    graphblas::Desc_value  backend,
+                    po::variables_map&     vm )
+{
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  char* dat_name;
+
+  // Read in sparse matrix
+  readMtx(mtx, &row_indices, &col_indices, &values, &nrows, &ncols, &nvals, 0,
+      false, &dat_name);
+
+  graphblas::Matrix<float> a(nrows, ncols);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      dat_name));
+  CHECKVOID(a.nrows(&nrows));
+
+  // Reference tree must pass same check
+  std::vector<graphblas::Index> depth(nrows), correct(nrows);
+  graphblas::algorithm::SimpleReferenceBfs(nrows,
+      a.matrix_.sparse_.h_csrRowPtr_, a.matrix_.sparse_.h_csrColInd_,
+      depth.data(), correct.data(), source, nrows + 1);
+  BOOST_ASSERT( graphblas::algorithm::bfsVerifyTree(source, &a, correct) ==
+      0 );
+
+  graphblas::Desc_value modes[] = {graphblas::GrB_PUSHONLY,
+      graphblas::GrB_PULLONLY, graphblas::GrB_PUSHPULL};
+  std::vector<graphblas::Index> first;
+  for (graphblas::Desc_value mode : modes) {
+    graphblas::Descriptor desc;
+    CHECKVOID(desc.loadArgs(vm));
+    CHECKVOID(desc.set(graphblas::GrB_MXVMODE, mode));
+    CHECKVOID(desc.set(graphblas::GrB_BACKEND, backend));
+
+    graphblas::Vector<graphblas::Index> p(nrows);
+    graphblas::algorithm::bfsParent(&p, &a, source, &desc);
+
+    std::vector<graphblas::Index> parent;
+    graphblas::Index nrows_t = nrows;
+    CHECKVOID(p.extractTuples(&parent, &nrows_t));
+    BOOST_ASSERT( nrows_t == nrows );
+    BOOST_ASSERT( graphblas::algorithm::bfsVerifyTree(source, &a, parent) ==
+        0 );
+    if (first.empty())
+      first = parent;
+    BOOST_ASSERT_LIST( first, parent, nrows );
+  }
+}
+
+struct TestMatrix
+{
+  TestMatrix() :
+    DEBUG(true) {}
+
+  bool DEBUG;
+};
+
+BOOST_AUTO_TEST_SUITE(traverse_suite)
+
+BOOST_FIXTURE_TEST_CASE( traverse1, TestMatrix )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testBfs<float, float>("data/small/chesapeake.mtx", 0,
+      graphblas::GrB_PUSHONLY, graphblas::GrB_SEQUENTIAL, vm);
+  testBfs<float, float>("data/small/chesapeake.mtx", 0,
+      graphblas::GrB_PULLONLY, graphblas::GrB_SEQUENTIAL, vm);
+  testBfs<float, float>("data/small/chesapeake.mtx", 0,
+      graphblas::GrB_PUSHPULL, graphblas::GrB_SEQUENTIAL, vm);
+}
+
+BOOST_FIXTURE_TEST_CASE( traverse2, TestMatrix )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testBfs<uint8_t, uint32_t>("data/small/test_cc.mtx", 3,
+      graphblas::GrB_PUSHPULL, graphblas::GrB_SEQUENTIAL, vm);
+  testBfs<uint8_t, uint32_t>("data/small/test_cc.mtx", 3,
+      graphblas::GrB_PUSHPULL, graphblas::GrB_CUDA, vm);
+}
+
+// Count returned by a single level is number of new vertices
+BOOST_FIXTURE_TEST_CASE( traverse3, TestMatrix )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  char* dat_name;
+  readMtx("data/small/chesapeake.mtx", &row_indices, &col_indices, &values,
+      &nrows, &ncols, &nvals, 0, false, &dat_name);
+
+  graphblas::Matrix<float> a(nrows, ncols);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      dat_name));
+
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+  CHECKVOID(desc.set(graphblas::GrB_MXVMODE, graphblas::GrB_PUSHONLY));
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, graphblas::GrB_SEQUENTIAL));
+
+  graphblas::Index source = 0;
+  graphblas::Index* row_ptr = a.matrix_.sparse_.h_csrRowPtr_;
+  graphblas::Index* col_ind = a.matrix_.sparse_.h_csrColInd_;
+  std::vector<graphblas::Index> neighbours(col_ind + row_ptr[source],
+      col_ind + row_ptr[source+1]);
+  std::sort(neighbours.begin(), neighbours.end());
+  neighbours.erase(std::unique(neighbours.begin(), neighbours.end()),
+      neighbours.end());
+  neighbours.erase(std::remove(neighbours.begin(), neighbours.end(), source),
+      neighbours.end());
+
+  graphblas::Vector<float> v(nrows), f(nrows), w(nrows);
+  CHECKVOID(v.fill(0.f));
+  CHECKVOID(v.setElement(1.f, source));
+  std::vector<graphblas::Index> f_ind(1, source);
+  std::vector<float>            f_val(1, 1.f);
+  CHECKVOID(f.build(&f_ind, &f_val, 1, GrB_NULL));
+
+  graphblas::Index succ = 0;
+  CHECKVOID(graphblas::traverse(&w, &v, &succ, 2.f, &f, &a, &desc));
+  BOOST_ASSERT( succ == neighbours.size() );
+
+  graphblas::Index w_nvals;
+  CHECKVOID(w.nvals(&w_nvals));
+  BOOST_ASSERT( w_nvals == neighbours.size() );
+
+  // Frontier cannot be expanded in place
+  BOOST_ASSERT( graphblas::traverse(&f, &v, &succ, 2.f, &f, &a, &desc) ==
+      graphblas::GrB_INVALID_OBJECT );
+}
+
+BOOST_FIXTURE_TEST_CASE( traverse4, TestMatrix )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testBfsParent("data/small/chesapeake.mtx", 0, graphblas::GrB_SEQUENTIAL, vm);
+  testBfsParent("data/small/test_cc.mtx", 3, graphblas::GrB_SEQUENTIAL, vm);
+  testBfsParent("data/small/test_cc.mtx", 3, graphblas::GrB_CUDA, vm);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
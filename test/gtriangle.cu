@@ -0,0 +1,112 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "graphblas/graphblas.hpp"
+#include "graphblas/algorithm/tc.hpp"
+#include "test/test.hpp"
+
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_MODULE tc_suite
+
+#include <boost/test/included/unit_test.hpp>
+#include <boost/program_options.hpp>
+
+// Triangles counted on degree-ordered L by given backend match CPU reference
+// and known count
+void testTc( char const*            mtx,
+             int64_t                correct,
+             graphblas::Desc_value  backend,
+             po::variables_map&     vm )
+{
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  char* dat_name;
+
+  readMtx(mtx, &row_indices, &col_indices, &values, &nrows, &ncols, &nvals, 2,
+      false, &dat_name);
+  values.assign(nvals, 1.f);
+
+  graphblas::Matrix<float> a(nrows, ncols);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL,
+      dat_name));
+  CHECKVOID(a.nrows(&nrows));
+
+  graphblas::Descriptor desc;
+  CHECKVOID(desc.loadArgs(vm));
+  CHECKVOID(desc.set(graphblas::GrB_BACKEND, backend));
+
+  graphblas::Matrix<float> l(nrows, nrows);
+  CHECKVOID(graphblas::algorithm::tcLower(&l, &a, &desc));
+
+  // Every edge kept once, and only pointing to earlier (higher-degree) vertex
+  graphblas::Index l_nvals;
+  CHECKVOID(l.nvals(&l_nvals));
+  BOOST_ASSERT( 2*l_nvals == nvals );
+  for (graphblas::Index row = 0; row < nrows; ++row)
+    for (graphblas::Index edge = l.matrix_.sparse_.h_csrRowPtr_[row];
+         edge < l.matrix_.sparse_.h_csrRowPtr_[row+1]; ++edge)
+      BOOST_ASSERT( l.matrix_.sparse_.h_csrColInd_[edge] < row );
+
+  int64_t ntris = 0;
+  graphblas::algorithm::tc(&ntris, &l, &desc);
+  BOOST_ASSERT( ntris == graphblas::algorithm::tcCpu(&a) );
+  BOOST_ASSERT( ntris == correct );
+}
+
+// Merge and galloping intersection agree, including lists far apart in length
+void testTcIntersect()
+{
+  std::vector<graphblas::Index> hub(1000);
+  for (graphblas::Index i = 0; i < 1000; ++i)
+    hub[i] = 2*i;
+  std::vector<graphblas::Index> small{ 0, 3, 10, 11, 500, 1998, 2001 };
+
+  int64_t count = graphblas::algorithm::tcIntersect(small.data(),
+      small.data() + small.size(), hub.data(), hub.data() + hub.size());
+  BOOST_ASSERT( count == 4 );
+  count = graphblas::algorithm::tcIntersect(hub.data(),
+      hub.data() + hub.size(), small.data(), small.data() + small.size());
+  BOOST_ASSERT( count == 4 );
+  count = graphblas::algorithm::tcIntersect(hub.data(), hub.data() + 10,
+      small.data(), small.data() + 4);
+  BOOST_ASSERT( count == 2 );
+}
+
+struct TestTc
+{
+  TestTc() :
+    DEBUG(true) {}
+
+  bool DEBUG;
+};
+
+BOOST_AUTO_TEST_SUITE(tc_suite)
+
+BOOST_FIXTURE_TEST_CASE( tc1, TestTc )
+{
+  testTcIntersect();
+}
+
+BOOST_FIXTURE_TEST_CASE( tc2, TestTc )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  testTc("data/small/chesapeake.mtx", 194, graphblas::GrB_SEQUENTIAL, vm);
+  testTc("data/small/chesapeake.mtx", 194, graphblas::GrB_CUDA,       vm);
+  testTc("data/small/test_cc.mtx",    9,   graphblas::GrB_SEQUENTIAL, vm);
+  testTc("data/small/test_mesh.mtx",  0,   graphblas::GrB_SEQUENTIAL, vm);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
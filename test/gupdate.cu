@@ -0,0 +1,173 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <vector>
+#include <iostream>
+
+#include "graphblas/graphblas.hpp"
+#include "test/test.hpp"
+
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_MODULE update_suite
+
+#include <boost/test/included/unit_test.hpp>
+#include <boost/program_options.hpp>
+
+using namespace graphblas;
+
+struct TestUpdate {
+  TestUpdate() :
+    DEBUG(true) {}
+
+  bool DEBUG;
+};
+
+BOOST_AUTO_TEST_SUITE(update_suite)
+
+// Pending updates are visible to extractElement and extractTuples before
+// compaction
+BOOST_FIXTURE_TEST_CASE(update1, TestUpdate) {
+  std::vector<Index> row_indices = {0, 1, 2, 3};
+  std::vector<Index> col_indices = {1, 2, 3, 0};
+  std::vector<float> values      = {1.f, 2.f, 3.f, 4.f};
+  Matrix<float> a(4, 4);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, 4, GrB_NULL));
+
+  // Large ratio so nothing is compacted
+  Descriptor desc;
+  desc.descriptor_.compactratio_ = 100.f;
+
+  std::vector<Index> ins_row = {0, 2, 0};
+  std::vector<Index> ins_col = {3, 3, 3};
+  std::vector<float> ins_val = {5.f, 6.f, 7.f};
+  CHECKVOID(a.setElements(&ins_row, &ins_col, &ins_val, 3, &desc));
+  std::vector<Index> del_row = {3, 1};
+  std::vector<Index> del_col = {0, 1};
+  CHECKVOID(a.removeElements(&del_row, &del_col, 2, &desc));
+  BOOST_ASSERT(a.matrix_.sparse_.ndelta() > 0);
+
+  Index nvals;
+  CHECKVOID(a.nvals(&nvals));
+  BOOST_ASSERT(nvals == 4);
+
+  float val;
+  CHECKVOID(a.extractElement(&val, 0, 3));
+  BOOST_ASSERT(val == 7.f);
+  CHECKVOID(a.extractElement(&val, 2, 3));
+  BOOST_ASSERT(val == 6.f);
+  BOOST_ASSERT(a.extractElement(&val, 3, 0) == GrB_NO_VALUE);
+
+  std::vector<Index> out_row, out_col;
+  std::vector<float> out_val;
+  CHECKVOID(a.extractTuples(&out_row, &out_col, &out_val, &nvals));
+  std::vector<Index> correct_row = {0, 0, 1, 2};
+  std::vector<Index> correct_col = {1, 3, 2, 3};
+  std::vector<float> correct_val = {1.f, 7.f, 2.f, 6.f};
+  BOOST_ASSERT_LIST(out_row, correct_row, 4);
+  BOOST_ASSERT_LIST(out_col, correct_col, 4);
+  BOOST_ASSERT_LIST(out_val, correct_val, 4);
+}
+
+// Crossing threshold merges updates into CSR and CSC
+BOOST_FIXTURE_TEST_CASE(update2, TestUpdate) {
+  std::vector<Index> row_indices = {0, 1, 2, 3};
+  std::vector<Index> col_indices = {1, 2, 3, 0};
+  std::vector<float> values      = {1.f, 1.f, 1.f, 1.f};
+  Matrix<float> a(4, 4);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, 4, GrB_NULL));
+
+  Descriptor desc;
+  desc.descriptor_.compactratio_ = 0.5f;
+
+  std::vector<Index> ins_row = {1, 3, 3};
+  std::vector<Index> ins_col = {0, 1, 2};
+  std::vector<float> ins_val = {1.f, 1.f, 1.f};
+  CHECKVOID(a.setElements(&ins_row, &ins_col, &ins_val, 3, &desc));
+  BOOST_ASSERT(a.matrix_.sparse_.ndelta() == 0);
+
+  backend::SparseMatrix<float>* sparse = &a.matrix_.sparse_;
+  CHECKVOID(sparse->gpuToCpu(true));
+  std::vector<Index> correct_row_ptr = {0, 1, 3, 4, 7};
+  std::vector<Index> correct_col_ind = {1, 0, 2, 3, 0, 1, 2};
+  BOOST_ASSERT_LIST(correct_row_ptr, sparse->h_csrRowPtr_, 5);
+  BOOST_ASSERT_LIST(correct_col_ind, sparse->h_csrColInd_, 7);
+
+  if (sparse->format_ == backend::GrB_SPARSE_MATRIX_CSRCSC) {
+    std::vector<Index> correct_col_ptr = {0, 2, 4, 6, 7};
+    std::vector<Index> correct_row_ind = {1, 3, 0, 3, 1, 3, 2};
+    BOOST_ASSERT_LIST(correct_col_ptr, sparse->h_cscColPtr_, 5);
+    BOOST_ASSERT_LIST(correct_row_ind, sparse->h_cscRowInd_, 7);
+  }
+}
+
+// Updates to matrix that was never built
+BOOST_FIXTURE_TEST_CASE(update3, TestUpdate) {
+  Matrix<float> a(3, 3);
+  CHECKVOID(a.setElement(2.f, 1, 2));
+  CHECKVOID(a.setElement(0, 0));
+  CHECKVOID(a.removeElement(1, 2));
+  CHECKVOID(a.compact());
+
+  Index nvals;
+  CHECKVOID(a.nvals(&nvals));
+  BOOST_ASSERT(nvals == 1);
+  float val;
+  CHECKVOID(a.extractElement(&val, 0, 0));
+  BOOST_ASSERT(val == 1.f);
+}
+
+// mxv and vxm on CPU merge pending updates on the fly without compacting,
+// and give same result as matrix built with updates already in it
+BOOST_FIXTURE_TEST_CASE(update4, TestUpdate) {
+  std::vector<Index> row_indices = {0, 1, 2, 3};
+  std::vector<Index> col_indices = {1, 2, 3, 0};
+  std::vector<float> values      = {1.f, 2.f, 3.f, 4.f};
+  Matrix<float> a(4, 4);
+  CHECKVOID(a.build(&row_indices, &col_indices, &values, 4, GrB_NULL));
+
+  Descriptor desc;
+  desc.descriptor_.compactratio_ = 100.f;
+  CHECKVOID(desc.set(GrB_BACKEND, GrB_SEQUENTIAL));
+
+  std::vector<Index> ins_row = {0, 2, 3};
+  std::vector<Index> ins_col = {3, 0, 3};
+  std::vector<float> ins_val = {5.f, 6.f, 7.f};
+  CHECKVOID(a.setElements(&ins_row, &ins_col, &ins_val, 3, &desc));
+  std::vector<Index> del_row = {1};
+  std::vector<Index> del_col = {2};
+  CHECKVOID(a.removeElements(&del_row, &del_col, 1, &desc));
+
+  std::vector<Index> b_row = {0, 0, 2, 2, 3, 3};
+  std::vector<Index> b_col = {1, 3, 0, 3, 0, 3};
+  std::vector<float> b_val = {1.f, 5.f, 6.f, 3.f, 4.f, 7.f};
+  Matrix<float> b(4, 4);
+  CHECKVOID(b.build(&b_row, &b_col, &b_val, 6, GrB_NULL));
+
+  std::vector<float> u_val = {1.f, 2.f, 3.f, 4.f};
+  Vector<float> u(4);
+  CHECKVOID(u.build(&u_val, 4));
+
+  Vector<float> w(4), correct(4);
+  std::vector<float> w_val, correct_val;
+  Index nrows = 4;
+  CHECKVOID((mxv<float, float, float, float>(&w, GrB_NULL, GrB_NULL,
+      PlusMultipliesSemiring<float>(), &a, &u, &desc)));
+  CHECKVOID((mxv<float, float, float, float>(&correct, GrB_NULL, GrB_NULL,
+      PlusMultipliesSemiring<float>(), &b, &u, &desc)));
+  CHECKVOID(w.extractTuples(&w_val, &nrows));
+  CHECKVOID(correct.extractTuples(&correct_val, &nrows));
+  BOOST_ASSERT_LIST(w_val, correct_val, 4);
+
+  CHECKVOID((vxm<float, float, float, float>(&w, GrB_NULL, GrB_NULL,
+      PlusMultipliesSemiring<float>(), &u, &a, &desc)));
+  CHECKVOID((vxm<float, float, float, float>(&correct, GrB_NULL, GrB_NULL,
+      PlusMultipliesSemiring<float>(), &u, &b, &desc)));
+  CHECKVOID(w.extractTuples(&w_val, &nrows));
+  CHECKVOID(correct.extractTuples(&correct_val, &nrows));
+  BOOST_ASSERT_LIST(w_val, correct_val, 4);
+
+  if (a.matrix_.sparse_.format_ == backend::GrB_SPARSE_MATRIX_CSRCSC)
+    BOOST_ASSERT(a.matrix_.sparse_.ndelta() > 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -223,6 +223,150 @@ void testVxmSparseSparseDenseMask(
   BOOST_ASSERT( nrows == correct.size() );
   BOOST_ASSERT_LIST( values, correct, nrows );
 }
+// Pull with sparse mask on CPU, which writes only rows of mask, or looks
+// complemented mask up in a bitmap
+void testVxmSparseMaskCpu( char const*                          mtx,
+                           const std::vector<graphblas::Index>& mask_ind,
+                           int                                  use_scmp,
+                           po::variables_map&                   vm )
+{
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  char* dat_name;
+
+  readMtx(mtx, row_indices, col_indices, values, nrows, ncols,
+      nvals, 0, false, &dat_name);
+
+  graphblas::Matrix<float> a(nrows, ncols);
+  a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL, dat_name);
+  a.nrows(&nrows);
+
+  std::vector<float> vec(nrows);
+  for (graphblas::Index i = 0; i < nrows; ++i)
+    vec[i] = static_cast<float>(i % 3 + 1);
+
+  std::vector<bool> in_mask(nrows, false);
+  for (graphblas::Index i = 0; i < mask_ind.size(); ++i)
+    in_mask[mask_ind[i]] = true;
+
+  std::vector<float> correct(nrows, 0.f);
+  for (graphblas::Index row = 0; row < nrows; ++row)
+  {
+    graphblas::Index row_start = a.matrix_.sparse_.h_csrRowPtr_[row];
+    graphblas::Index row_end   = a.matrix_.sparse_.h_csrRowPtr_[row+1];
+    for (; row_start < row_end; ++row_start)
+    {
+      graphblas::Index col = a.matrix_.sparse_.h_csrColInd_[row_start];
+      if (in_mask[col] != static_cast<bool>(use_scmp))
+        correct[col] += a.matrix_.sparse_.h_csrVal_[row_start]*vec[row];
+    }
+  }
+
+  graphblas::Vector<float> x(nrows);
+  x.build(&vec, nrows);
+
+  std::vector<float> mask_val(mask_ind.size(), 1.f);
+  graphblas::Vector<float> mask(nrows);
+  mask.build(&mask_ind, &mask_val, mask_ind.size(), GrB_NULL);
+
+  graphblas::Vector<float> y(nrows);
+
+  graphblas::Descriptor desc;
+  desc.loadArgs(vm);
+  desc.set(graphblas::GrB_MXVMODE, graphblas::GrB_PULLONLY);
+  desc.set(graphblas::GrB_BACKEND, graphblas::GrB_SEQUENTIAL);
+  if (use_scmp == 1)
+    desc.set(graphblas::GrB_MASK, graphblas::GrB_SCMP);
+
+  graphblas::vxm<float, float, float, float>(&y, &mask, GrB_NULL,
+      graphblas::PlusMultipliesSemiring<float>(), &x, &a, &desc);
+
+  // Only non-complemented sparse mask gives sparse output
+  graphblas::Storage y_vec_type;
+  y.getStorage(&y_vec_type);
+  BOOST_ASSERT( (y_vec_type == graphblas::GrB_SPARSE) == (use_scmp == 0) );
+
+  y.vector_.sparse2dense(0.f, &desc.descriptor_);
+  y.extractTuples( &values, &nrows );
+  BOOST_ASSERT( nrows == correct.size() );
+  BOOST_ASSERT_LIST( values, correct, nrows );
+}
+
+// y = y + mask .* (x * A) on CPU, where rows left out by sparse mask keep y
+// unless GrB_REPLACE, which sets them to identity
+void testVxmAccumCpu( char const*                          mtx,
+                      const std::vector<graphblas::Index>& mask_ind,
+                      int                                  use_repl,
+                      po::variables_map&                   vm )
+{
+  std::vector<graphblas::Index> row_indices;
+  std::vector<graphblas::Index> col_indices;
+  std::vector<float> values;
+  graphblas::Index nrows, ncols, nvals;
+  char* dat_name;
+
+  readMtx(mtx, row_indices, col_indices, values, nrows, ncols,
+      nvals, 0, false, &dat_name);
+
+  graphblas::Matrix<float> a(nrows, ncols);
+  a.build(&row_indices, &col_indices, &values, nvals, GrB_NULL, dat_name);
+  a.nrows(&nrows);
+
+  std::vector<float> vec(nrows), y_val(nrows);
+  for (graphblas::Index i = 0; i < nrows; ++i)
+  {
+    vec[i]   = static_cast<float>(i % 3 + 1);
+    y_val[i] = static_cast<float>(i % 2 + 1);
+  }
+
+  std::vector<bool> in_mask(nrows, false);
+  for (graphblas::Index i = 0; i < mask_ind.size(); ++i)
+    in_mask[mask_ind[i]] = true;
+
+  std::vector<float> correct(nrows, 0.f);
+  for (graphblas::Index i = 0; i < nrows; ++i)
+    if (in_mask[i] || !use_repl)
+      correct[i] = y_val[i];
+  for (graphblas::Index row = 0; row < nrows; ++row)
+  {
+    graphblas::Index row_start = a.matrix_.sparse_.h_csrRowPtr_[row];
+    graphblas::Index row_end   = a.matrix_.sparse_.h_csrRowPtr_[row+1];
+    for (; row_start < row_end; ++row_start)
+    {
+      graphblas::Index col = a.matrix_.sparse_.h_csrColInd_[row_start];
+      if (in_mask[col])
+        correct[col] += a.matrix_.sparse_.h_csrVal_[row_start]*vec[row];
+    }
+  }
+
+  graphblas::Vector<float> x(nrows);
+  x.build(&vec, nrows);
+
+  std::vector<float> mask_val(mask_ind.size(), 1.f);
+  graphblas::Vector<float> mask(nrows);
+  mask.build(&mask_ind, &mask_val, mask_ind.size(), GrB_NULL);
+
+  graphblas::Vector<float> y(nrows);
+  y.build(&y_val, nrows);
+
+  graphblas::Descriptor desc;
+  desc.loadArgs(vm);
+  desc.set(graphblas::GrB_MXVMODE, graphblas::GrB_PULLONLY);
+  desc.set(graphblas::GrB_BACKEND, graphblas::GrB_SEQUENTIAL);
+  if (use_repl == 1)
+    desc.set(graphblas::GrB_OUTP, graphblas::GrB_REPLACE);
+
+  graphblas::vxm<float, float, float, float>(&y, &mask,
+      graphblas::PlusMonoid<float>(),
+      graphblas::PlusMultipliesSemiring<float>(), &x, &a, &desc);
+
+  y.extractTuples( &values, &nrows );
+  BOOST_ASSERT( nrows == correct.size() );
+  BOOST_ASSERT_LIST( values, correct, nrows );
+}
+
 struct TestMatrix
 {
   TestMatrix() :
@@ -302,4 +446,25 @@ BOOST_FIXTURE_TEST_CASE( dup6, TestMatrix )
   testVxmSparseSparseDenseMask( "data/small/test_sgm.mtx", vec_ind, vec_val, mask_val, 0, vm );
   testVxmSparseSparseDenseMask( "data/small/test_sgm.mtx", vec_ind, vec_val, mask_val, 1, vm );
 }
+BOOST_FIXTURE_TEST_CASE( dup7, TestMatrix )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  std::vector<graphblas::Index> mask_ind{ 1, 3, 6, 7, 15, 18 };
+  testVxmSparseMaskCpu( "data/small/test_sgm.mtx", mask_ind, 0, vm );
+  testVxmSparseMaskCpu( "data/small/test_sgm.mtx", mask_ind, 1, vm );
+}
+
+BOOST_FIXTURE_TEST_CASE( dup8, TestMatrix )
+{
+  int argc = 5;
+  char* argv[] = {"app", "--debug", "0", "--timing", "0"};
+  po::variables_map vm;
+  parseArgs(argc, argv, &vm);
+  std::vector<graphblas::Index> mask_ind{ 1, 3, 6, 7, 15, 18 };
+  testVxmAccumCpu( "data/small/test_sgm.mtx", mask_ind, 0, vm );
+  testVxmAccumCpu( "data/small/test_sgm.mtx", mask_ind, 1, vm );
+}
 BOOST_AUTO_TEST_SUITE_END()
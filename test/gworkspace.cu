@@ -0,0 +1,115 @@
+#define GRB_USE_CUDA
+#define private public
+
+#include <vector>
+#include <iostream>
+
+#include <cstdint>
+
+#include "graphblas/graphblas.hpp"
+#include "test/test.hpp"
+
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_MODULE workspace_suite
+
+#include <boost/test/included/unit_test.hpp>
+#include <boost/program_options.hpp>
+
+using namespace graphblas;
+
+// Emulates one iteration of an iterative algorithm that needs scratch memory
+void runIteration(backend::Workspace* workspace, int nvals) {
+  backend::WorkspaceScope scope(workspace);
+  float* ones  = workspace->allocate<float>(nvals);
+  Index* ind   = workspace->allocate<Index>(nvals);
+  char*  flags = workspace->allocate<char>(nvals);
+
+  BOOST_ASSERT(reinterpret_cast<uintptr_t>(ones)  %
+      backend::Workspace::kAlignment == 0);
+  BOOST_ASSERT(reinterpret_cast<uintptr_t>(ind)   %
+      backend::Workspace::kAlignment == 0);
+  BOOST_ASSERT(reinterpret_cast<uintptr_t>(flags) %
+      backend::Workspace::kAlignment == 0);
+
+  for (int i = 0; i < nvals; ++i) {
+    ones[i]  = 1.f;
+    ind[i]   = i;
+    flags[i] = 1;
+  }
+  for (int i = 0; i < nvals; ++i)
+    BOOST_ASSERT(ones[i] == 1.f && ind[i] == i && flags[i] == 1);
+}
+
+struct TestWorkspace {
+  TestWorkspace() :
+    DEBUG(true) {}
+
+  bool DEBUG;
+};
+
+BOOST_AUTO_TEST_SUITE(workspace_suite)
+
+// After warm-up no more system allocations happen
+BOOST_FIXTURE_TEST_CASE(workspace1, TestWorkspace) {
+  backend::Workspace workspace;
+  runIteration(&workspace, 1000);
+  size_t nmalloc = workspace.nmalloc();
+  size_t high_water = workspace.highWater();
+
+  for (int i = 0; i < 10; ++i)
+    runIteration(&workspace, 1000);
+  BOOST_ASSERT(workspace.nmalloc() == nmalloc);
+  BOOST_ASSERT(workspace.highWater() == high_water);
+  BOOST_ASSERT(workspace.inUse() == 0);
+  BOOST_ASSERT(workspace.capacity() >= high_water);
+}
+
+// Reset to a mark keeps allocations made before the mark
+BOOST_FIXTURE_TEST_CASE(workspace2, TestWorkspace) {
+  backend::Workspace workspace;
+  CHECKVOID(workspace.reserve(1, 1024));
+
+  int* outer = workspace.allocate<int>(16);
+  for (int i = 0; i < 16; ++i)
+    outer[i] = i;
+  size_t in_use = workspace.inUse();
+
+  backend::Workspace::Mark mark = workspace.mark();
+  workspace.allocate<double>(4096);
+  CHECKVOID(workspace.reset(0, mark));
+
+  BOOST_ASSERT(workspace.inUse() == in_use);
+  for (int i = 0; i < 16; ++i)
+    BOOST_ASSERT(outer[i] == i);
+}
+
+// Per-thread slabs are independent of each other
+BOOST_FIXTURE_TEST_CASE(workspace3, TestWorkspace) {
+  backend::Workspace workspace;
+  CHECKVOID(workspace.reserve(4, 4096));
+  BOOST_ASSERT(workspace.nslab() == 4);
+
+  std::vector<float*> ptrs(4);
+  for (int tid = 0; tid < 4; ++tid) {
+    ptrs[tid] = workspace.allocate<float>(256, tid);
+    for (int i = 0; i < 256; ++i)
+      ptrs[tid][i] = tid;
+  }
+  CHECKVOID(workspace.reset(2, backend::Workspace::Mark{0, 0}));
+  for (int tid = 0; tid < 4; ++tid)
+    if (tid != 2)
+      for (int i = 0; i < 256; ++i)
+        BOOST_ASSERT(ptrs[tid][i] == tid);
+}
+
+// Workspace attached to Descriptor
+BOOST_FIXTURE_TEST_CASE(workspace4, TestWorkspace) {
+  Descriptor desc;
+  backend::Workspace* workspace = desc.descriptor_.workspace();
+  runIteration(workspace, 100000);
+  size_t nmalloc = workspace->nmalloc();
+  runIteration(workspace, 100000);
+  BOOST_ASSERT(workspace->nmalloc() == nmalloc);
+}
+
+BOOST_AUTO_TEST_SUITE_END()